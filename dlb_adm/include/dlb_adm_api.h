@@ -306,6 +306,17 @@ dlb_adm_container_clear_all
     (dlb_adm_xml_container      *container
     );
 
+/**
+ * @brief Return the container to the state it had just after it was opened,
+ * without releasing or allocating any memory.  This allows one container to be
+ * reused for many reads, e.g. once per frame.
+ */
+DLB_ADM_DLL_ENTRY
+int
+dlb_adm_container_reset
+    (dlb_adm_xml_container      *container
+    );
+
 
 /* XML Reader */
 
@@ -711,6 +722,18 @@ dlb_adm_core_model_is_empty
     ,dlb_adm_bool               *is_empty
     );
 
+/**
+ * @brief Get the model's generation number.  The generation is unique within the
+ * process and changes every time the content of the model changes, so two equal
+ * generation values always describe the same, unchanged model.
+ */
+DLB_ADM_DLL_ENTRY
+int
+dlb_adm_core_model_get_generation
+    (const dlb_adm_core_model   *model
+    ,uint64_t                   *generation
+    );
+
 /**
  * @brief Return the size of memory needed to configure a dlb_adm_data_audio_element_data
  * struct for a maximum number of channels.
@@ -43,9 +43,7 @@ namespace DlbAdm
 
     AdmIdSequenceMap::AdmIdSequenceMap(managed_heap_memory &memory)
     {
-        mSubcomponentMap = memory.construct<SubcomponentMap>("SubcomponentMap")(std::less<dlb_adm_entity_id>(), memory.get_segment_manager());
-        mSequenceMap = memory.construct<SequenceMap>("SequenceMap")(std::less<DLB_ADM_ENTITY_TYPE>(), memory.get_segment_manager());
-        Init();
+        Attach(memory);
     }
 
     AdmIdSequenceMap::AdmIdSequenceMap(const AdmIdSequenceMap &x)
@@ -96,6 +94,19 @@ namespace DlbAdm
         return Next(mSubcomponentMap, parentID);
     }
 
+    void AdmIdSequenceMap::Attach(managed_heap_memory &memory)
+    {
+        // The memory may already hold the maps, e.g. when it was copied from a snapshot
+        mSubcomponentMap = memory.find<SubcomponentMap>("SubcomponentMap").first;
+        mSequenceMap = memory.find<SequenceMap>("SequenceMap").first;
+        if (mSequenceMap == nullptr)
+        {
+            mSubcomponentMap = memory.construct<SubcomponentMap>("SubcomponentMap")(std::less<dlb_adm_entity_id>(), memory.get_segment_manager());
+            mSequenceMap = memory.construct<SequenceMap>("SequenceMap")(std::less<DLB_ADM_ENTITY_TYPE>(), memory.get_segment_manager());
+            Init();
+        }
+    }
+
     void AdmIdSequenceMap::Clear()
     {
         mSubcomponentMap->clear();
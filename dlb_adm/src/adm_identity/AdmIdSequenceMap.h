@@ -69,6 +69,8 @@ namespace DlbAdm
 
         AdmIdSubcomponentNumber GetSubcomponentNumber(dlb_adm_entity_id parentID);
 
+        void Attach(boost::interprocess::managed_heap_memory &memory);
+
         void Clear();
 
         bool IsEmpty() const;
@@ -96,30 +96,33 @@ namespace DlbAdm
 
     static const size_t ATTRIBUTE_COUNT = sizeof(initializers) / sizeof(AttributeInitializer);
 
-    void InitializeAttributeIndex()
+    static bool BuildAttributeIndex()
     {
-        if (theAdmAttributeIndex.size() == 0)
+        for (size_t i = 0; i < ATTRIBUTE_COUNT; i++)
         {
-            for (size_t i = 0; i < ATTRIBUTE_COUNT; i++)
-            {
-                const AttributeInitializer *initializer = &initializers[i];
-                AttributeDescriptor descriptor;
-
-                descriptor.entityType = initializer->entityType;
-                descriptor.attributeName = initializer->attributeName;
-                descriptor.attributeTag = initializer->attributeTag;
-                descriptor.attributeValueType = initializer->attributeValueType;
-                theAdmAttributeIndex.insert(descriptor);
-            }
+            const AttributeInitializer *initializer = &initializers[i];
+            AttributeDescriptor descriptor;
+
+            descriptor.entityType = initializer->entityType;
+            descriptor.attributeName = initializer->attributeName;
+            descriptor.attributeTag = initializer->attributeTag;
+            descriptor.attributeValueType = initializer->attributeValueType;
+            theAdmAttributeIndex.insert(descriptor);
         }
+        return true;
+    }
+
+    void InitializeAttributeIndex()
+    {
+        // The initializer of a local static runs exactly once, even when
+        // several threads get here at the same time
+        static const bool built = BuildAttributeIndex();
+        (void)built;
     }
 
     int GetAttributeDescriptor(AttributeDescriptor &d, DLB_ADM_TAG tag)
     {
-        if (theAdmAttributeIndex.size() == 0)
-        {
-            InitializeAttributeIndex();
-        }
+        InitializeAttributeIndex();
 
         int status = DLB_ADM_STATUS_NOT_FOUND;
         AttributeIndex_TagIndex &index = theAdmAttributeIndex.get<AttributeIndex_Tag>();
@@ -136,10 +139,7 @@ namespace DlbAdm
 
     int GetAttributeDescriptor(AttributeDescriptor &d, DLB_ADM_ENTITY_TYPE entityType, const std::string &name)
     {
-        if (theAdmAttributeIndex.size() == 0)
-        {
-            InitializeAttributeIndex();
-        }
+        InitializeAttributeIndex();
 
         int status = DLB_ADM_STATUS_NOT_FOUND;
 
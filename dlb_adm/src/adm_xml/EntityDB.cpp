@@ -67,8 +67,12 @@ namespace DlbAdm
         EntityData(boost::interprocess::managed_heap_memory &memory)
         :mMemory(memory)
         {
-            mEntities = memory.construct<EntityContainer>("EntityContainer")(EntityContainer::ctor_args_list(), memory.get_allocator<EntityRecord>());
-            mAttributes = memory.construct<AttributesVector>("AttributesVector")(memory.get_segment_manager());
+            Attach();
+        }
+        void Attach()
+        {
+            mEntities = mMemory.find_or_construct<EntityContainer>("EntityContainer")(EntityContainer::ctor_args_list(), mMemory.get_allocator<EntityRecord>());
+            mAttributes = mMemory.find_or_construct<AttributesVector>("AttributesVector")(mMemory.get_segment_manager());
         }
         EntityContainer  &GetEntities()   { return *mEntities; }
         AttributesVector &GetAttributes() { return *mAttributes; }
@@ -408,6 +412,16 @@ namespace DlbAdm
         return status;
     }
 
+    void EntityDB::Attach()
+    {
+        mEntityData->Attach();
+    }
+
+    bool EntityDB::IsEmpty() const
+    {
+        return mEntityData->GetEntities().empty();
+    }
+
     void EntityDB::Clear()
     {
         mEntityData->GetEntities().clear();
@@ -82,6 +82,10 @@ namespace DlbAdm
 
         int ForEach(dlb_adm_entity_id id, AttributeCallbackFn callbackFn);
 
+        void Attach();
+
+        bool IsEmpty() const;
+
         void Clear();
 
     private:
@@ -77,7 +77,7 @@ namespace DlbAdm
 
     static const size_t INITIALIZER_COUNT = sizeof(initializers) / sizeof(EntityDescriptor);
 
-    void InitializeEntityIndex()
+    static bool BuildEntityIndex()
     {
         size_t i;
 
@@ -85,14 +85,20 @@ namespace DlbAdm
         {
             theADMEntityIndex.insert(initializers[i]);
         }
+        return true;
+    }
+
+    void InitializeEntityIndex()
+    {
+        // The initializer of a local static runs exactly once, even when
+        // several threads get here at the same time
+        static const bool built = BuildEntityIndex();
+        (void)built;
     }
 
     int GetEntityDescriptor(EntityDescriptor &d, const std::string &name, EntityNameDisambiguationFn disambiguator/*= nullptr*/)
     {
-        if (theADMEntityIndex.size() == 0)
-        {
-            InitializeEntityIndex();
-        }
+        InitializeEntityIndex();
 
         EntityIndex_NameIndex &index = theADMEntityIndex.get<EntityIndex_Name>();
         auto range = index.equal_range(name);
@@ -133,10 +139,7 @@ namespace DlbAdm
 
     int GetEntityDescriptor(EntityDescriptor &d, DLB_ADM_ENTITY_TYPE eType)
     {
-        if (theADMEntityIndex.size() == 0)
-        {
-            InitializeEntityIndex();
-        }
+        InitializeEntityIndex();
 
         EntityIndex_TypeIndex &index = theADMEntityIndex.get<EntityIndex_Type>();
         auto range = index.equal_range(eType);
@@ -160,10 +163,7 @@ namespace DlbAdm
 
     int GetEntityDescriptor(EntityDescriptor &d, DLB_ADM_ENTITY_TYPE eType, bool isReference)
     {
-        if (theADMEntityIndex.size() == 0)
-        {
-            InitializeEntityIndex();
-        }
+        InitializeEntityIndex();
 
         EntityIndex_TypeIndex &index = theADMEntityIndex.get<EntityIndex_Type>();
         auto range = index.equal_range(eType);
@@ -49,14 +49,19 @@ namespace DlbAdm
     {
     public:
         RelationshipData(managed_heap_memory &memory)
+            : mMemory(memory)
         {
-            mRelationshipContainer = memory.construct<RelationshipContainer>("RelationshipContainer")(RelationshipContainer::ctor_args_list(), memory.get_allocator<RelationshipRecord>());
-
+            Attach();
+        }
+        void Attach()
+        {
+            mRelationshipContainer = mMemory.find_or_construct<RelationshipContainer>("RelationshipContainer")(RelationshipContainer::ctor_args_list(), mMemory.get_allocator<RelationshipRecord>());
         }
         RelationshipContainer &Get() { return *mRelationshipContainer; }
 
     private:
         RelationshipContainer *mRelationshipContainer;
+        managed_heap_memory &mMemory;
     };
 
     RelationshipDB::RelationshipDB(managed_heap_memory &memory)
@@ -360,6 +365,16 @@ namespace DlbAdm
         return count;
     }
 
+    void RelationshipDB::Attach()
+    {
+        mRelationshipData->Attach();
+    }
+
+    bool RelationshipDB::IsEmpty() const
+    {
+        return mRelationshipData->Get().empty();
+    }
+
     void RelationshipDB::Clear()
     {
         mRelationshipData->Get().clear();
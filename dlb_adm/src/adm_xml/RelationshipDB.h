@@ -79,6 +79,10 @@ namespace DlbAdm
 
         size_t Count(dlb_adm_entity_id id, DLB_ADM_ENTITY_TYPE entityType);
 
+        void Attach();
+
+        bool IsEmpty() const;
+
         void Clear();
 
     private:
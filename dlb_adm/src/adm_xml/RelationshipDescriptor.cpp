@@ -131,30 +131,33 @@ namespace DlbAdm
 
     static RelationshipIndex theAdmRelationshipIndex;
 
-    void InitializeRelationshipIndex()
+    static bool BuildRelationshipIndex()
     {
-        if (theAdmRelationshipIndex.size() == 0)
+        for (size_t i = 0; i < RELATIONSHIP_COUNT; i++)
         {
-            for (size_t i = 0; i < RELATIONSHIP_COUNT; i++)
-            {
-                const RelationshipDescriptor *rd = &initializers[i];
-                theAdmRelationshipIndex.insert(*rd);
-
-                RelationshipDescriptor inverse;
-                inverse.fromType = rd->toType;
-                inverse.toType = rd->fromType;
-                inverse.relationship = Inverse(rd->relationship);
-                theAdmRelationshipIndex.insert(inverse);
-            }
+            const RelationshipDescriptor *rd = &initializers[i];
+            theAdmRelationshipIndex.insert(*rd);
+
+            RelationshipDescriptor inverse;
+            inverse.fromType = rd->toType;
+            inverse.toType = rd->fromType;
+            inverse.relationship = Inverse(rd->relationship);
+            theAdmRelationshipIndex.insert(inverse);
         }
+        return true;
+    }
+
+    void InitializeRelationshipIndex()
+    {
+        // The initializer of a local static runs exactly once, even when
+        // several threads get here at the same time
+        static const bool built = BuildRelationshipIndex();
+        (void)built;
     }
 
     int GetRelationshipDescriptor(RelationshipDescriptor &rd, DLB_ADM_ENTITY_TYPE f, DLB_ADM_ENTITY_TYPE t)
     {
-        if (theAdmRelationshipIndex.size() == 0)
-        {
-            InitializeRelationshipIndex();
-        }
+        InitializeRelationshipIndex();
 
         int status = DLB_ADM_STATUS_NOT_FOUND;
 
@@ -44,18 +44,12 @@
 
 #include <fstream>
 
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-#include "dlb_xml/include/dlb_xml.h"
-
-#ifdef __cplusplus
-}
-#endif
-
 #include <cstdio>
+#include <cstring>
 #include <map>
+#include <mutex>
+#include <string>
+#include <vector>
 #include <iostream>
 
 namespace DlbAdm
@@ -65,10 +59,7 @@ namespace DlbAdm
     XMLContainer::XMLContainer()
     {
         mSharedMemory = std::unique_ptr<managed_heap_memory>(new managed_heap_memory(1048500));
-        mRelationshipDB = std::unique_ptr<RelationshipDB>(new RelationshipDB(*mSharedMemory));
-        mEntityDB = std::unique_ptr<EntityDB>(new EntityDB(*mSharedMemory));
-        mSequenceMap = std::unique_ptr<AdmIdSequenceMap>(new AdmIdSequenceMap(*mSharedMemory));
-
+        AttachDatabases();
     }
 
     XMLContainer::~XMLContainer()
@@ -164,23 +155,6 @@ namespace DlbAdm
 
     /* XML Reader */
 
-    static char *LineCallback(void *p_context)
-    {
-        return reinterpret_cast<XMLReader *>(p_context)->GetLine();
-    }
-
-    static int ElementCallback(void *p_context, char *tag, char *text)
-    {
-        int status = reinterpret_cast<XMLReader *>(p_context)->Element(tag, text);
-        return status;
-    }
-
-    static int AttributeCallback(void *p_context, char *tag, char *attribute, char *value)
-    {
-        int status = reinterpret_cast<XMLReader *>(p_context)->Attribute(tag, attribute, value);
-        return status;
-    }
-
     int XMLContainer::ReadXmlBuffer(const char *xmlBuffer, size_t characterCount, dlb_adm_bool useCommonDefs)
     {
         if (xmlBuffer == nullptr)
@@ -204,7 +178,7 @@ namespace DlbAdm
         }
 
         XMLReader reader(*this, xmlBuffer, characterCount);
-        int status = ::dlb_xml_parse(&reader, &LineCallback, &ElementCallback, &AttributeCallback);
+        int status = reader.Read();
 
         return status ? DLB_ADM_STATUS_ERROR : DLB_ADM_STATUS_OK;
     }
@@ -236,7 +210,7 @@ namespace DlbAdm
         int status;
         XMLReader reader(*this, f);
 
-        status = ::dlb_xml_parse(&reader, &LineCallback, &ElementCallback, &AttributeCallback);
+        status = reader.Read();
         fclose(f);
 
         return status ? DLB_ADM_STATUS_ERROR : DLB_ADM_STATUS_OK;
@@ -320,8 +294,99 @@ namespace DlbAdm
         return AdmIdTranslator().ConstructGenericId(entityType, mSequenceMap->GetSequenceNumber(entityType));
     }
 
+    // Memory images
+    //
+    // All of the container's state lives in mSharedMemory, and boost::interprocess
+    // only stores offset pointers there, so the memory image of a container is
+    // position-independent.  We build two images once per process: an empty
+    // container, used by Reset(), and a container holding nothing but the common
+    // definitions, used by LoadCommonDefs().  Copying an image into a container
+    // replaces re-initializing or re-parsing it, and allocates nothing.
+
+    static std::mutex theImageMutex;
+    static std::vector<char> theEmptyImage;
+    static std::vector<char> theCommonDefsImage;
+    static std::string theCommonDefsImagePath;
+
+    static const char *CommonDefsSource()
+    {
+#if EXTERNAL_ADM_COMMON_DEFINITIONS
+        return dlb_adm_get_common_defs_path();
+#else
+        return "";
+#endif
+    }
+
+    static void TakeImage(std::vector<char> &image, const managed_heap_memory &memory)
+    {
+        const char *address = static_cast<const char *>(memory.get_address());
+
+        image.assign(address, address + memory.get_size());
+    }
+
+    void XMLContainer::AttachDatabases()
+    {
+        mRelationshipDB = std::unique_ptr<RelationshipDB>(new RelationshipDB(*mSharedMemory));
+        mEntityDB = std::unique_ptr<EntityDB>(new EntityDB(*mSharedMemory));
+        mSequenceMap = std::unique_ptr<AdmIdSequenceMap>(new AdmIdSequenceMap(*mSharedMemory));
+    }
+
+    bool XMLContainer::CopyImage(const std::vector<char> &image)
+    {
+        if (image.size() != mSharedMemory->get_size())
+        {
+            return false;
+        }
+
+        ::memcpy(mSharedMemory->get_address(), image.data(), image.size());
+        mRelationshipDB->Attach();
+        mEntityDB->Attach();
+        mSequenceMap->Attach(*mSharedMemory);
+
+        return true;
+    }
+
+    int XMLContainer::CopyCommonDefsImage(bool &copied)
+    {
+        std::lock_guard<std::mutex> lock(theImageMutex);
+        const char *source = CommonDefsSource();
+
+        copied = false;
+        if (theCommonDefsImage.empty() || theCommonDefsImagePath != source)
+        {
+            XMLContainer snapshot;
+            int status = snapshot.ParseCommonDefs();
+
+            if (status != DLB_ADM_STATUS_OK)
+            {
+                return status;
+            }
+            TakeImage(theCommonDefsImage, *snapshot.mSharedMemory);
+            theCommonDefsImagePath = source;
+        }
+        copied = CopyImage(theCommonDefsImage);
+
+        return DLB_ADM_STATUS_OK;
+    }
+
     int XMLContainer::LoadCommonDefs()
     {
+        if (IsEmpty())
+        {
+            bool copied;
+            int status = CopyCommonDefsImage(copied);
+
+            if (status != DLB_ADM_STATUS_OK || copied)
+            {
+                return status;
+            }
+        }
+
+        return ParseCommonDefs();
+    }
+
+    int XMLContainer::ParseCommonDefs()
+    {
 
 #if EXTERNAL_ADM_COMMON_DEFINITIONS
         const char *filePath = dlb_adm_get_common_defs_path();
@@ -334,7 +399,7 @@ namespace DlbAdm
         int status;
         XMLReader reader(*this, f, "C:\\temp\\trace_common.out", true);
 
-        status = ::dlb_xml_parse(&reader, &LineCallback, &ElementCallback, &AttributeCallback);
+        status = reader.Read();
         fclose(f); 
 #else
         int status;
@@ -344,7 +409,7 @@ namespace DlbAdm
                         , true
                         );
 
-        status = ::dlb_xml_parse(&reader, &LineCallback, &ElementCallback, &AttributeCallback);
+        status = reader.Read();
 #endif
         return status ? DLB_ADM_STATUS_ERROR : DLB_ADM_STATUS_OK;    
     }
@@ -358,4 +423,23 @@ namespace DlbAdm
         return DLB_ADM_STATUS_OK;
     }
 
+    int XMLContainer::Reset()
+    {
+        std::lock_guard<std::mutex> lock(theImageMutex);
+
+        if (theEmptyImage.empty())
+        {
+            XMLContainer empty;
+
+            TakeImage(theEmptyImage, *empty.mSharedMemory);
+        }
+
+        return CopyImage(theEmptyImage) ? DLB_ADM_STATUS_OK : Clear();
+    }
+
+    bool XMLContainer::IsEmpty() const
+    {
+        return mEntityDB->IsEmpty() && mRelationshipDB->IsEmpty() && mSequenceMap->IsEmpty();
+    }
+
 }
@@ -40,6 +40,7 @@
 #include "EntityDB.h"
 #include "RelationshipDB.h"
 #include <boost/interprocess/managed_heap_memory.hpp>
+#include <vector>
 
 namespace DlbAdm
 {
@@ -96,12 +97,24 @@ namespace DlbAdm
 
         int Clear();
 
+        int Reset();
+
+        bool IsEmpty() const;
+
         dlb_adm_entity_id GetTopLevelID();
 
         dlb_adm_entity_id GetGenericID(DLB_ADM_ENTITY_TYPE entityType);
 
     private:
 
+        int ParseCommonDefs();
+
+        int CopyCommonDefsImage(bool &copied);
+
+        bool CopyImage(const std::vector<char> &image);
+
+        void AttachDatabases();
+
         std::unique_ptr<EntityDB> mEntityDB;
         std::unique_ptr<RelationshipDB> mRelationshipDB;
         std::unique_ptr<AdmIdSequenceMap> mSequenceMap;
@@ -62,7 +62,8 @@ namespace DlbAdm
         , mStack()
         , mInputFile(f)
         , mTraceFile(nullptr)
-        , mBuffer()
+        , mInputBuffer(nullptr)
+        , mInputSize(0)
         , mXmlTagState(XML_TAG_STATE::NOT_STARTED)
         , mIsCommon(isCommon)
      {
@@ -74,7 +75,8 @@ namespace DlbAdm
          , mStack()
          , mInputFile(f)
          , mTraceFile(nullptr)
-         , mBuffer()
+         , mInputBuffer(nullptr)
+        , mInputSize(0)
          , mXmlTagState(XML_TAG_STATE::NOT_STARTED)
          , mIsCommon(isCommon)
      {
@@ -90,7 +92,8 @@ namespace DlbAdm
          , mStack()
          , mInputFile(nullptr)
          , mTraceFile(nullptr)
-         , mBuffer(stringBuffer, characterCount)
+         , mInputBuffer(stringBuffer)
+         , mInputSize(characterCount)
          , mXmlTagState(XML_TAG_STATE::NOT_STARTED)
          , mIsCommon(isCommon)
      {
@@ -102,7 +105,8 @@ namespace DlbAdm
          , mStack()
          , mInputFile(nullptr)
          , mTraceFile(nullptr)
-         , mBuffer(stringBuffer, characterCount)
+         , mInputBuffer(stringBuffer)
+         , mInputSize(characterCount)
          , mXmlTagState(XML_TAG_STATE::NOT_STARTED)
          , mIsCommon(isCommon)
      {
@@ -123,27 +127,63 @@ namespace DlbAdm
          mInputFile = nullptr;
      }
 
-     char *XMLReader::GetLine()
+     int XMLReader::Read()
      {
-         char *s = nullptr;
+         const char *buffer = mInputBuffer;
+         size_t size = mInputSize;
 
          if (mInputFile != nullptr)
          {
-             if (::feof(mInputFile))
-             {
-                 return nullptr;
-             }
-             s = ::fgets(mLineBuffer, LINE_BUFFER_SIZE, mInputFile);
+             int status = ReadInputFile();
+             CHECK_STATUS(status);
+             buffer = mFileContents.data();
+             size = mFileContents.size();
          }
-         else
+
+         return mTokenizer.Parse(*this, buffer, size);
+     }
+
+     int XMLReader::ReadInputFile()
+     {
+         size_t used = 0;
+
+         mFileContents.resize(FILE_READ_SIZE);
+         while (true)
          {
-             if (mBuffer.GetLine(mLineBuffer, LINE_BUFFER_SIZE) > 0)
+             used += ::fread(mFileContents.data() + used, 1, mFileContents.size() - used, mInputFile);
+             if (used < mFileContents.size())
              {
-                 s = mLineBuffer;
+                 break;
              }
+             mFileContents.resize(mFileContents.size() * 2);
          }
+         mFileContents.resize(used);
+
+         return ::ferror(mInputFile) ? DLB_ADM_STATUS_ERROR : DLB_ADM_STATUS_OK;
+     }
+
+     int XMLReader::OpenElement(XMLStringView tag)
+     {
+         mTag.assign(tag.data(), tag.size());
+
+         return Element(mTag.c_str(), nullptr);
+     }
+
+     int XMLReader::Attribute(XMLStringView tag, XMLStringView name, XMLStringView value)
+     {
+         mTag.assign(tag.data(), tag.size());
+         mName.assign(name.data(), name.size());
+         mValue.assign(value.data(), value.size());
+
+         return Attribute(mTag.c_str(), mName.c_str(), mValue.c_str());
+     }
+
+     int XMLReader::CloseElement(XMLStringView tag, XMLStringView text)
+     {
+         mTag.assign(tag.data(), tag.size());
+         mValue.assign(text.data(), text.size());
 
-         return s;
+         return Element(mTag.c_str(), mValue.c_str());
      }
 
      int XMLReader::Element(const char *tag, const char *text)
@@ -38,10 +38,12 @@
 #define DLB_ADM_XML_READER_H
 
 #include "dlb_adm/include/dlb_adm_api_types.h"
-#include "XMLBuffer.h"
 #include "XMLReaderStack.h"
+#include "XMLTokenizer.h"
 
 #include <cstdio>
+#include <string>
+#include <vector>
 #include <boost/noncopyable.hpp>
 
 namespace DlbAdm
@@ -50,7 +52,7 @@ namespace DlbAdm
     struct AttributeDescriptor;
     class XMLContainer;
 
-    class XMLReader : public boost::noncopyable
+    class XMLReader : public boost::noncopyable, private XMLTokenizer::Handler
     {
     public:
         XMLReader(XMLContainer &container, FILE *f, bool isCommon = false);
@@ -59,14 +61,14 @@ namespace DlbAdm
         XMLReader(XMLContainer &container, const char *stringBuffer, size_t characterCount, const char *traceFilePath, bool isCommon = false);
         ~XMLReader();
 
-        char *GetLine();
+        int Read();
 
         int Element(const char *tag, const char *text);
 
         int Attribute(const char *tag, const char *attribute, const char *value);
 
     private:
-        static const size_t LINE_BUFFER_SIZE = 4096;
+        static const size_t FILE_READ_SIZE = 65536;
 
         enum class XML_TAG_STATE
         {
@@ -77,6 +79,12 @@ namespace DlbAdm
 
         void Start();
 
+        int ReadInputFile();
+
+        virtual int OpenElement(XMLStringView tag);
+        virtual int Attribute(XMLStringView tag, XMLStringView name, XMLStringView value);
+        virtual int CloseElement(XMLStringView tag, XMLStringView text);
+
         int MakeGenericComponentId(XMLReaderStackEntry *component);
 
         int SetValue(XMLReaderStackEntry &entry, DLB_ADM_TAG attributeTag,         const std::string &valueString);
@@ -86,8 +94,13 @@ namespace DlbAdm
         XMLReaderStack       mStack;
         FILE                *mInputFile;
         FILE                *mTraceFile;
-        XMLBuffer            mBuffer;
-        char                 mLineBuffer[LINE_BUFFER_SIZE];
+        const char          *mInputBuffer;
+        size_t               mInputSize;
+        std::vector<char>    mFileContents;
+        XMLTokenizer         mTokenizer;
+        std::string          mTag;
+        std::string          mName;
+        std::string          mValue;
         XML_TAG_STATE        mXmlTagState;
         bool                 mIsCommon;
     };
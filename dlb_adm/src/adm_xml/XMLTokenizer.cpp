@@ -0,0 +1,568 @@
+/************************************************************************
+ * dlb_adm
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#include "XMLTokenizer.h"
+
+#include <cstring>
+
+namespace DlbAdm
+{
+
+    static bool IsSpace(char c)
+    {
+        return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n');
+    }
+
+    static bool IsEol(char c)
+    {
+        return (c == '\r') || (c == '\n');
+    }
+
+    static bool IsNameEnd(char c)
+    {
+        return IsSpace(c) || (c == '/') || (c == '>') || (c == '?') || (c == '=');
+    }
+
+    /* Text checks, the same as dlb_xml applies to element text and attribute values */
+
+    static bool DecodeEscape(const char *&p, const char *end, unsigned int &unicode)
+    {
+        const char *semicolon = static_cast<const char *>(::memchr(p, ';', end - p));
+
+        if (semicolon == nullptr)
+        {
+            return false;
+        }
+
+        XMLStringView name(p, semicolon - p);
+
+        p = semicolon + 1;
+        if      (name == "amp")  unicode = '&';
+        else if (name == "lt")   unicode = '<';
+        else if (name == "gt")   unicode = '>';
+        else if (name == "quot") unicode = '\"';
+        else if (name == "apos") unicode = '\'';
+        else if ((name.size() > 1) && (name[0] == '#'))
+        {
+            bool hex = (name[1] == 'x');
+            size_t i = hex ? 2 : 1;
+
+            if (i == name.size())
+            {
+                return false;
+            }
+            unicode = 0;
+            for (; i < name.size(); i++)
+            {
+                char c = name[i];
+                unsigned int digit;
+
+                if      ((c >= '0') && (c <= '9'))        digit = c - '0';
+                else if (hex && (c >= 'a') && (c <= 'f')) digit = c - 'a' + 10;
+                else if (hex && (c >= 'A') && (c <= 'F')) digit = c - 'A' + 10;
+                else return false;
+
+                unicode = unicode * (hex ? 16 : 10) + digit;
+                if (unicode > 0x10ffff)
+                {
+                    return false;
+                }
+            }
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    static bool DecodeUtf8(unsigned char c0, const char *&p, const char *end, unsigned int &unicode)
+    {
+        size_t continuation;
+
+        if      ((c0 & 0xE0) == 0xC0) { continuation = 1; unicode = c0 & 0x1F; }
+        else if ((c0 & 0xF0) == 0xE0) { continuation = 2; unicode = c0 & 0x0F; }
+        else if ((c0 & 0xF8) == 0xF0) { continuation = 3; unicode = c0 & 0x07; }
+        else return false;
+
+        if (static_cast<size_t>(end - p) < continuation)
+        {
+            return false;
+        }
+        while (continuation-- > 0)
+        {
+            unsigned char c = *p++;
+
+            if ((c & 0xC0) != 0x80)
+            {
+                return false;
+            }
+            unicode = (unicode << 6) | (c & 0x3F);
+        }
+
+        return true;
+    }
+
+    static bool CheckText(XMLStringView text)
+    {
+        const char *p = text.data();
+        const char *end = p + text.size();
+
+        while (p < end)
+        {
+            unsigned char c = *p++;
+            unsigned int unicode = c;
+
+            if (c == '&')
+            {
+                if (!DecodeEscape(p, end, unicode))
+                {
+                    return false;
+                }
+            }
+            else if (c < ' ')
+            {
+                if ((c != '\t') && (c != '\r') && (c != '\n'))
+                {
+                    return false;
+                }
+                continue;
+            }
+            else if (c > 127)
+            {
+                if (!DecodeUtf8(c, p, end, unicode))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                continue;
+            }
+
+            /* legal chars are Unicode and ISO/IEC 10646 */
+            if (!((unicode < 0xd800) ||
+                  (unicode >= 0xe000 && unicode <= 0xfffd) ||
+                  (unicode >= 0x10000 && unicode <= 0x10ffff)))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /* XMLTokenizer */
+
+    XMLTokenizer::XMLTokenizer()
+        : mBegin(nullptr)
+        , mEnd(nullptr)
+        , mCur(nullptr)
+        , mDepth(0)
+        , mRootClosed(false)
+    {
+        // Empty
+    }
+
+    XMLTokenizer::~XMLTokenizer()
+    {
+        mBegin = mEnd = mCur = nullptr;
+    }
+
+    int XMLTokenizer::Parse(Handler &handler, const char *buffer, size_t characterCount)
+    {
+        if (buffer == nullptr)
+        {
+            return DLB_ADM_STATUS_NULL_POINTER;
+        }
+
+        mBegin = mCur = buffer;
+        mEnd = buffer + characterCount;
+        mDepth = 0;
+        mRootClosed = false;
+
+        while (!mRootClosed)
+        {
+            const char *open = static_cast<const char *>(::memchr(mCur, '<', mEnd - mCur));
+            int status;
+
+            if (open == nullptr)
+            {
+                break;
+            }
+            if (mDepth > 0)
+            {
+                AppendText(mCur, open);
+            }
+            mCur = open + 1;
+            if (mCur == mEnd)
+            {
+                break;
+            }
+
+            switch (*mCur)
+            {
+            case '/':
+                ++mCur;
+                status = ParseEndTag(handler);
+                break;
+
+            case '?':
+                ++mCur;
+                status = ParseStartTag(handler, true);
+                break;
+
+            case '!':
+                ++mCur;
+                status = ParseMarkup();
+                break;
+
+            default:
+                status = ParseStartTag(handler, false);
+                break;
+            }
+
+            if (status != DLB_ADM_STATUS_OK)
+            {
+                return status;
+            }
+        }
+
+        return mRootClosed ? DLB_ADM_STATUS_OK : DLB_ADM_STATUS_ERROR;   // Unterminated element, or no element at all
+    }
+
+    int XMLTokenizer::ParseStartTag(Handler &handler, bool declaration)
+    {
+        const char *name = mCur;
+        int status;
+
+        while ((mCur < mEnd) && !IsNameEnd(*mCur))
+        {
+            ++mCur;
+        }
+        if (mCur == name)
+        {
+            return DLB_ADM_STATUS_ERROR;
+        }
+
+        XMLStringView tag(name, mCur - name);
+
+        if (!declaration)
+        {
+            status = handler.OpenElement(tag);
+            if (status != DLB_ADM_STATUS_OK)
+            {
+                return status;
+            }
+            PushLevel(tag);
+        }
+
+        while (true)
+        {
+            while ((mCur < mEnd) && IsSpace(*mCur))
+            {
+                ++mCur;
+            }
+            if (mCur == mEnd)
+            {
+                return DLB_ADM_STATUS_ERROR;
+            }
+
+            char c = *mCur;
+
+            if (c == '>')
+            {
+                ++mCur;
+                return DLB_ADM_STATUS_OK;
+            }
+
+            if (c == (declaration ? '?' : '/'))
+            {
+                if ((++mCur == mEnd) || (*mCur != '>'))
+                {
+                    return DLB_ADM_STATUS_ERROR;
+                }
+                ++mCur;
+                return declaration ? DLB_ADM_STATUS_OK : CloseLevel(handler);
+            }
+
+            const char *attributeName = mCur;
+
+            while ((mCur < mEnd) && !IsNameEnd(*mCur))
+            {
+                ++mCur;
+            }
+            if (mCur == attributeName)
+            {
+                return DLB_ADM_STATUS_ERROR;
+            }
+
+            XMLStringView attribute(attributeName, mCur - attributeName);
+
+            while ((mCur < mEnd) && IsSpace(*mCur))
+            {
+                ++mCur;
+            }
+            if (mCur == mEnd)
+            {
+                return DLB_ADM_STATUS_ERROR;
+            }
+            if (*mCur != '=')
+            {
+                continue;   // A name without a value is ignored, as dlb_xml does
+            }
+            ++mCur;
+            while ((mCur < mEnd) && IsSpace(*mCur))
+            {
+                ++mCur;
+            }
+            if (mCur == mEnd)
+            {
+                return DLB_ADM_STATUS_ERROR;
+            }
+
+            // Like dlb_xml, take whatever character follows as the quote
+            char delimiter = *mCur++;
+            const char *valueEnd = static_cast<const char *>(::memchr(mCur, delimiter, mEnd - mCur));
+
+            if (valueEnd == nullptr)
+            {
+                return DLB_ADM_STATUS_ERROR;
+            }
+
+            bool copied;
+            XMLStringView value = Normalize(mCur, valueEnd, mValueScratch, copied);
+
+            mCur = valueEnd + 1;
+            if (!CheckText(value))
+            {
+                return DLB_ADM_STATUS_ERROR;
+            }
+            status = handler.Attribute(tag, attribute, value);
+            if (status != DLB_ADM_STATUS_OK)
+            {
+                return status;
+            }
+        }
+    }
+
+    int XMLTokenizer::ParseEndTag(Handler &handler)
+    {
+        const char *name = mCur;
+
+        while ((mCur < mEnd) && !IsNameEnd(*mCur))
+        {
+            ++mCur;
+        }
+
+        XMLStringView tag(name, mCur - name);
+
+        while ((mCur < mEnd) && IsSpace(*mCur))
+        {
+            ++mCur;
+        }
+        if ((mCur == mEnd) || (*mCur != '>'))
+        {
+            return DLB_ADM_STATUS_ERROR;
+        }
+        ++mCur;
+
+        if ((mDepth == 0) || (tag != mLevels[mDepth - 1].tag))
+        {
+            return DLB_ADM_STATUS_ERROR;     // Closing tag mismatch
+        }
+
+        return CloseLevel(handler);
+    }
+
+    int XMLTokenizer::ParseMarkup()
+    {
+        XMLStringView rest(mCur, mEnd - mCur);
+
+        if (rest.starts_with("--"))
+        {
+            size_t end = rest.find("-->", 2);
+
+            if (end == XMLStringView::npos)
+            {
+                return DLB_ADM_STATUS_ERROR;
+            }
+            mCur += end + 3;
+            return DLB_ADM_STATUS_OK;
+        }
+
+        // DOCTYPE and the like: skip, including any internal subset in brackets
+        int brackets = 0;
+
+        while (mCur < mEnd)
+        {
+            char c = *mCur++;
+
+            if (c == '[')
+            {
+                ++brackets;
+            }
+            else if (c == ']')
+            {
+                --brackets;
+            }
+            else if ((c == '>') && (brackets <= 0))
+            {
+                return DLB_ADM_STATUS_OK;
+            }
+        }
+
+        return DLB_ADM_STATUS_ERROR;
+    }
+
+    int XMLTokenizer::CloseLevel(Handler &handler)
+    {
+        Level &level = mLevels[--mDepth];
+        XMLStringView text = level.spilled ? XMLStringView(level.spill) : level.text;
+
+        if (!CheckText(text))
+        {
+            return DLB_ADM_STATUS_ERROR;
+        }
+        mRootClosed = (mDepth == 0);
+
+        return handler.CloseElement(level.tag, text);
+    }
+
+    void XMLTokenizer::PushLevel(XMLStringView tag)
+    {
+        if (mDepth == mLevels.size())
+        {
+            mLevels.push_back(Level());
+        }
+
+        Level &level = mLevels[mDepth++];
+
+        level.tag = tag;
+        level.text = XMLStringView();
+        level.spill.clear();
+        level.spilled = false;
+    }
+
+    void XMLTokenizer::AppendText(const char *begin, const char *end)
+    {
+        if (begin == end)
+        {
+            return;
+        }
+
+        bool copied;
+        XMLStringView piece = Normalize(begin, end, mScratch, copied);
+
+        if (piece.empty())
+        {
+            return;
+        }
+
+        Level &level = mLevels[mDepth - 1];
+
+        if (!level.spilled && level.text.empty() && !copied)
+        {
+            level.text = piece;
+            return;
+        }
+        if (!level.spilled)
+        {
+            level.spill.assign(level.text.data(), level.text.size());
+            level.spilled = true;
+        }
+        level.spill.append(piece.data(), piece.size());
+    }
+
+    /**
+     * Line breaks are treated the way dlb_xml treats them: leading blanks of a line
+     * are dropped, and the line break itself becomes a single space, unless the line
+     * is empty or ends with '>'.  Text that does not span lines is returned as is.
+     */
+    XMLStringView XMLTokenizer::Normalize(const char *begin, const char *end, std::string &scratch, bool &copied) const
+    {
+        const char *lineStart = begin;
+        const char *eol = begin;
+
+        while ((eol < end) && !IsEol(*eol))
+        {
+            ++eol;
+        }
+        copied = (eol < end);
+        if (!copied)
+        {
+            return XMLStringView(begin, end - begin);
+        }
+
+        scratch.clear();
+        while (true)
+        {
+            scratch.append(lineStart, eol);
+            if (eol == end)
+            {
+                break;
+            }
+
+            // The first line started before begin, so it is never empty; begin is
+            // always preceded by markup, so eol[-1] is in the buffer
+            bool emptyLine = (lineStart != begin) && (eol == lineStart);
+
+            if (!emptyLine && (eol[-1] != '>'))
+            {
+                scratch.push_back(' ');
+            }
+
+            lineStart = eol + 1;
+            if ((*eol == '\r') && (lineStart < end) && (*lineStart == '\n'))
+            {
+                ++lineStart;
+            }
+            while ((lineStart < end) && ((*lineStart == ' ') || (*lineStart == '\t')))
+            {
+                ++lineStart;
+            }
+            eol = lineStart;
+            while ((eol < end) && !IsEol(*eol))
+            {
+                ++eol;
+            }
+        }
+
+        return XMLStringView(scratch);
+    }
+
+}
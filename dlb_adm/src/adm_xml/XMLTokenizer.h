@@ -0,0 +1,115 @@
+/************************************************************************
+ * dlb_adm
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#ifndef DLB_ADM_XML_TOKENIZER_H
+#define DLB_ADM_XML_TOKENIZER_H
+
+#include "dlb_adm/include/dlb_adm_api_types.h"
+
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/utility/string_view.hpp>
+
+namespace DlbAdm
+{
+
+    typedef boost::string_view XMLStringView;
+
+    /**
+     * @brief Split XML held in one contiguous character buffer into element and
+     * attribute events.  Tags, attribute names, attribute values and element text
+     * are handed out as views into the buffer, which must remain available while
+     * Parse() runs; only text that spans lines is assembled in a scratch buffer,
+     * because line breaks are normalized the same way dlb_xml_parse() does it.
+     *
+     * The events also follow dlb_xml_parse(): an element is opened before its
+     * attributes are reported, and closed with the text it encloses (excluding
+     * child elements); declarations report their attributes only; comments and
+     * DOCTYPE are skipped; entity references are checked but not expanded.
+     * Parsing stops when the root element is closed.
+     */
+    class XMLTokenizer : public boost::noncopyable
+    {
+    public:
+        class Handler
+        {
+        public:
+            virtual ~Handler() {}
+
+            virtual int OpenElement(XMLStringView tag) = 0;
+
+            virtual int Attribute(XMLStringView tag, XMLStringView name, XMLStringView value) = 0;
+
+            virtual int CloseElement(XMLStringView tag, XMLStringView text) = 0;
+        };
+
+        XMLTokenizer();
+        ~XMLTokenizer();
+
+        int Parse(Handler &handler, const char *buffer, size_t characterCount);
+
+    private:
+        struct Level
+        {
+            XMLStringView    tag;
+            XMLStringView    text;
+            std::string      spill;
+            bool             spilled;
+        };
+
+        int ParseStartTag(Handler &handler, bool declaration);
+        int ParseEndTag(Handler &handler);
+        int ParseMarkup();
+        int CloseLevel(Handler &handler);
+
+        void PushLevel(XMLStringView tag);
+        void AppendText(const char *begin, const char *end);
+        XMLStringView Normalize(const char *begin, const char *end, std::string &scratch, bool &copied) const;
+
+        const char          *mBegin;
+        const char          *mEnd;
+        const char          *mCur;
+        size_t               mDepth;
+        bool                 mRootClosed;
+        std::vector<Level>   mLevels;
+        std::string          mScratch;
+        std::string          mValueScratch;
+    };
+
+}
+
+#endif
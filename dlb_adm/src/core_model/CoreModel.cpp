@@ -36,6 +36,7 @@
 
 #include "CoreModel.h"
 
+#include "EntityPool.h"
 #include "ModelEntityContainer.h"
 #include "PresentationTable.h"
 #include "ElementTable.h"
@@ -64,23 +65,52 @@
 #include "dlb_adm/src/adm_identity/AdmIdTranslator.h"
 #include "dlb_adm/src/adm_identity/AdmIdSequenceMap.h"
 
-#include <inttypes.h>
+#include <atomic>
+#include <new>
 
 namespace DlbAdm
 {
     using namespace boost::interprocess;
+
+    typedef EntityPools<
+        Presentation,
+        ContentGroup,
+        ElementGroup,
+        AudioElement,
+        AudioObjectInteraction,
+        ComplementaryElement,
+        AlternativeValueSet,
+        AudioTrack,
+        TargetGroup,
+        Target,
+        SourceGroup,
+        Source,
+        BlockUpdate,
+        FrameFormat,
+        DolbyeInfo,
+        DolbyeProgram,
+        DolbyeEncoderParameters,
+        ProfileDescriptor
+    > ModelEntityStore;
+
+    // The entities themselves live in typed pools; only the indexes and tables
+    // live in the managed heap, which starts small and is grown when it fills up
+
     class CoreModelData
     {
     public:
-        CoreModelData(std::shared_ptr<managed_heap_memory> memory)
+        static const size_t INITIAL_HEAP_SIZE = 32768;
+
+        CoreModelData()
+            : mMemory(new managed_heap_memory(INITIAL_HEAP_SIZE))
         {
-            mMemory = memory;
-            mModelEntityContainer = mMemory->construct<ModelEntityContainer>("ModelEntityContainer")(ModelEntityContainer::ctor_args_list(), mMemory->get_allocator<ModelEntityRecord>());
-            mPresentationTable = mMemory->construct<PresentationTable>("PresentationTable")(PresentationTable::ctor_args_list(), mMemory->get_allocator<PresentationRecord>());
-            mElementTable = mMemory->construct<ElementTable>("ElementTable")(ElementTable::ctor_args_list(), mMemory->get_allocator<ElementRecord>());
-            mSourceTable = mMemory->construct<SourceTable>("SourceTable")(SourceTable::ctor_args_list(), mMemory->get_allocator<SourceRecord>());
-            mUpdateTable = mMemory->construct<UpdateTable>("UpdateTable")(UpdateTable::ctor_args_list(), mMemory->get_allocator<UpdateRecord>());
+            mMemory->construct<ModelEntityContainer>("ModelEntityContainer")(ModelEntityContainer::ctor_args_list(), mMemory->get_allocator<ModelEntityRecord>());
+            mMemory->construct<PresentationTable>("PresentationTable")(PresentationTable::ctor_args_list(), mMemory->get_allocator<PresentationRecord>());
+            mMemory->construct<ElementTable>("ElementTable")(ElementTable::ctor_args_list(), mMemory->get_allocator<ElementRecord>());
+            mMemory->construct<SourceTable>("SourceTable")(SourceTable::ctor_args_list(), mMemory->get_allocator<SourceRecord>());
+            mMemory->construct<UpdateTable>("UpdateTable")(UpdateTable::ctor_args_list(), mMemory->get_allocator<UpdateRecord>());
             mSequenceMap = std::unique_ptr<AdmIdSequenceMap>(new AdmIdSequenceMap(*mMemory));
+            Attach();
         }
 
         ~CoreModelData()
@@ -93,7 +123,36 @@ namespace DlbAdm
         ElementTable &GetElementTable() { return *mElementTable; }
         SourceTable &GetSourceTable() { return *mSourceTable; }
         UpdateTable &GetUpdateTable() { return *mUpdateTable; }
-        AdmIdSequenceMap &GetSequenceMap() { return *mSequenceMap; }
+        ModelEntityStore &GetEntities() { return mEntities; }
+
+        AdmIdSequenceNumber GetSequenceNumber(DLB_ADM_ENTITY_TYPE entityType)
+        {
+            return InHeap([&]() { return mSequenceMap->GetSequenceNumber(entityType); });
+        }
+
+        AdmIdSubcomponentNumber GetSubcomponentNumber(dlb_adm_entity_id parentID)
+        {
+            return InHeap([&]() { return mSequenceMap->GetSubcomponentNumber(parentID); });
+        }
+
+        // Run f, which may allocate in the managed heap; if the heap is full, grow it
+        // and try again.  f must reach the heap objects through the accessors above,
+        // as growing the heap moves them.
+        template <typename F>
+        auto InHeap(F f) -> decltype(f())
+        {
+            for (;;)
+            {
+                try
+                {
+                    return f();
+                }
+                catch (const boost::interprocess::bad_alloc &)
+                {
+                    Grow();
+                }
+            }
+        }
 
         void Clear();
 
@@ -101,9 +160,9 @@ namespace DlbAdm
 
     private:
 
-        void DeallocataModelEntities();
-        template <class T>
-        bool RemoveModelEntity(const DlbAdm::ModelEntity &entity);
+        void Attach();
+
+        void Grow();
 
         ModelEntityContainer *mModelEntityContainer;
         PresentationTable *mPresentationTable;
@@ -111,116 +170,48 @@ namespace DlbAdm
         SourceTable *mSourceTable;
         UpdateTable *mUpdateTable;
         std::unique_ptr<AdmIdSequenceMap> mSequenceMap;
-        std::shared_ptr<boost::interprocess::managed_heap_memory> mMemory;
+        std::unique_ptr<managed_heap_memory> mMemory;
+        ModelEntityStore mEntities;
     };
 
-    CoreModel::CoreModel()
-        :mCoreModelProfiles()
+    void CoreModelData::Attach()
     {
-        mSharedMemory = std::shared_ptr<managed_heap_memory>(new managed_heap_memory(160000));
-        mCoreModelData = std::unique_ptr<CoreModelData>(new CoreModelData(mSharedMemory));
+        mModelEntityContainer = mMemory->find<ModelEntityContainer>("ModelEntityContainer").first;
+        mPresentationTable = mMemory->find<PresentationTable>("PresentationTable").first;
+        mElementTable = mMemory->find<ElementTable>("ElementTable").first;
+        mSourceTable = mMemory->find<SourceTable>("SourceTable").first;
+        mUpdateTable = mMemory->find<UpdateTable>("UpdateTable").first;
+        mSequenceMap->Attach(*mMemory);
     }
 
-    CoreModel::~CoreModel()
+    void CoreModelData::Grow()
     {
+        // The heap is relocated as it grows; everything inside it is position
+        // independent, so we just need to find our objects again
+        if (!mMemory->grow(mMemory->get_size()))
+        {
+            throw std::bad_alloc();
+        }
+        Attach();
     }
 
-    template<class T>
-    bool CoreModelData::RemoveModelEntity(const DlbAdm::ModelEntity &entity)
+    static std::atomic<uint64_t> sGenerationCounter(0);
+
+    CoreModel::CoreModel()
+        :mCoreModelProfiles()
+        ,mGeneration(0)
     {
-        char name[32];
-        snprintf(name, 32, "%" PRIX64, entity.GetEntityID());
-        return mMemory->destroy<T>(name);
+        mCoreModelData = std::unique_ptr<CoreModelData>(new CoreModelData());
+        Touch();
     }
 
-    void CoreModelData::DeallocataModelEntities()
+    CoreModel::~CoreModel()
     {
-        ModelEntityContainer_PKIndex &index = mModelEntityContainer->get<ModelEntityContainer_PK>();
-        for (auto it = index.begin(); it != index.end();)
-        {
-            switch (it->GetReference().GetEntityType())
-            {
-            case DLB_ADM_ENTITY_TYPE_FRAME_FORMAT:
-                RemoveModelEntity<FrameFormat>(it->GetReference());
-                break;
-
-            case DLB_ADM_ENTITY_TYPE_TRANSPORT_TRACK_FORMAT:
-                RemoveModelEntity<SourceGroup>(it->GetReference());
-                break;
-
-            case DLB_ADM_ENTITY_TYPE_PROGRAMME:
-                RemoveModelEntity<Presentation>(it->GetReference());
-                break;
-
-            case DLB_ADM_ENTITY_TYPE_CONTENT:
-                RemoveModelEntity<ContentGroup>(it->GetReference());
-                break;
-
-            case DLB_ADM_ENTITY_TYPE_OBJECT:
-                if (dynamic_cast<const AudioElement*>(it->GetPointer()) != nullptr)
-                {
-                    RemoveModelEntity<AudioElement>(it->GetReference()); // For Objects
-                }
-                else
-                {
-                    RemoveModelEntity<ElementGroup>(it->GetReference()); // For Beds
-                }
-                break;
-
-            case DLB_ADM_ENTITY_TYPE_PACK_FORMAT:
-                RemoveModelEntity<TargetGroup>(it->GetReference());
-                break;
-
-            case DLB_ADM_ENTITY_TYPE_CHANNEL_FORMAT:
-                RemoveModelEntity<Target>(it->GetReference());
-                break;
-
-            case DLB_ADM_ENTITY_TYPE_BLOCK_FORMAT:
-                RemoveModelEntity<BlockUpdate>(it->GetReference());
-                break;
-
-            case DLB_ADM_ENTITY_TYPE_ALT_VALUE_SET:
-                RemoveModelEntity<AlternativeValueSet>(it->GetReference());
-                break;
-
-            case DLB_ADM_ENTITY_TYPE_TRACK_UID:
-                RemoveModelEntity<AudioTrack>(it->GetReference());
-                break;
-
-            case DLB_ADM_ENTITY_TYPE_AUDIO_TRACK:
-                RemoveModelEntity<Source>(it->GetReference());
-                break;
-
-            case DLB_ADM_ENTITY_TYPE_OBJECT_INTERACTION:
-                RemoveModelEntity<AudioObjectInteraction>(it->GetReference());
-                break;
-                
-            case DLB_ADM_ENTITY_TYPE_COMPLEMENTARY_OBJECT_REF:
-                RemoveModelEntity<ComplementaryElement>(it->GetReference());
-                break;
-
-            case DLB_ADM_ENTITY_TYPE_PROFILE_LIST_SPECIFICATION:
-                RemoveModelEntity<ProfileDescriptor>(it->GetReference());
-                break;
-
-            case DLB_ADM_ENTITY_TYPE_DOLBY_E:
-                RemoveModelEntity<DolbyeInfo>(it->GetReference());
-                break;
-
-            case DLB_ADM_ENTITY_TYPE_AC3_PROGRAM:
-                RemoveModelEntity<DolbyeProgram>(it->GetReference());
-                break;
-
-            case DLB_ADM_ENTITY_TYPE_ENCODE_PARAMETERS:
-                RemoveModelEntity<DolbyeEncoderParameters>(it->GetReference());
-                break;
+    }
 
-            default:
-                assert(0);
-                break;
-            }
-            ++it;
-        }
+    void CoreModel::Touch()
+    {
+        mGeneration = ++sGenerationCounter;
     }
 
     void CoreModelData::Clear()
@@ -230,9 +221,8 @@ namespace DlbAdm
         mPresentationTable->clear();
         mElementTable->clear();
         mSequenceMap->Clear();
-
-        DeallocataModelEntities();
         mModelEntityContainer->clear();
+        mEntities.Clear();
     }
 
     bool CoreModelData::IsEmpty() const
@@ -243,25 +233,38 @@ namespace DlbAdm
             mElementTable->empty()           &&
             mSourceTable->empty()            &&
             mUpdateTable->empty()            &&
-            mSequenceMap->IsEmpty();
+            mSequenceMap->IsEmpty()          &&
+            mEntities.IsEmpty();
     }
 
     template<class T>
     bool CoreModel::AddModelEntity(const T &entity)
     {
-        EntityName eName;
-        entity.GetName(eName, 0);
-        char name[32];
-        snprintf(name, 32, "%" PRIX64, entity.GetEntityID());
-        std::pair<T* , managed_heap_memory::size_type> ret = mSharedMemory->find<T>(name);
-        if (ret.first != nullptr)
+        EntityPool<T> &pool = mCoreModelData->GetEntities().Pool<T>();
+        const T *p = pool.Add(entity);
+        if (p == nullptr)
         {
             return 0; // Reject duplacates
         }
 
-        ConstModelEntityPtr p = mSharedMemory->construct<T>(name)(entity);
+        // If the heap cannot grow to index the entity, take it back out of the
+        // pool so the two stay consistent
         ModelEntityRecord r(p);
-        auto result = mCoreModelData->GetModelEntityContainer().insert(r);
+        std::pair<ModelEntityContainer::iterator, bool> result;
+        try
+        {
+            result = mCoreModelData->InHeap([&]() { return mCoreModelData->GetModelEntityContainer().insert(r); });
+        }
+        catch (...)
+        {
+            pool.Remove(entity.GetEntityID());
+            throw;
+        }
+        if (!result.second)
+        {
+            pool.Remove(entity.GetEntityID());
+        }
+        Touch();
         return result.second;
     }
 
@@ -357,14 +360,18 @@ namespace DlbAdm
 
 
     template <typename RecordT, typename TableT>
-    bool CoreModel::AddModelRecord(const RecordT &record, TableT &table)
+    bool CoreModel::AddModelRecord(const RecordT &record, TableT &(CoreModelData::*getTable)())
     {
         bool inserted = false;
 
         if (Validate(record))
         {
-            auto result = table.insert(record);
+            auto result = mCoreModelData->InHeap([&]() { return ((*mCoreModelData).*getTable)().insert(record); });
             inserted = result.second;
+            if (inserted)
+            {
+                Touch();
+            }
         }
 
         return inserted;
@@ -372,22 +379,22 @@ namespace DlbAdm
 
     bool CoreModel::AddRecord(const PresentationRecord &record)
     {
-        return AddModelRecord(record, mCoreModelData->GetPresentationTable());
+        return AddModelRecord(record, &CoreModelData::GetPresentationTable);
     }
 
     bool CoreModel::AddRecord(const ElementRecord &record)
     {
-        return AddModelRecord(record, mCoreModelData->GetElementTable());
+        return AddModelRecord(record, &CoreModelData::GetElementTable);
     }
 
     bool CoreModel::AddRecord(const SourceRecord &record)
     {
-        return AddModelRecord(record, mCoreModelData->GetSourceTable());
+        return AddModelRecord(record, &CoreModelData::GetSourceTable);
     }
 
     bool CoreModel::AddRecord(const UpdateRecord &record)
     {
-        return AddModelRecord(record, mCoreModelData->GetUpdateTable());
+        return AddModelRecord(record, &CoreModelData::GetUpdateTable);
     }
 
     bool CoreModel::GetEntity(dlb_adm_entity_id entityID, const ModelEntity **e) const
@@ -585,7 +592,7 @@ namespace DlbAdm
         entityID = DLB_ADM_NULL_ENTITY_ID;
         if (translator.IsGenericEntityType(entityType))
         {
-            entityID = translator.ConstructGenericId(entityType, mCoreModelData->GetSequenceMap().GetSequenceNumber(entityType));
+            entityID = translator.ConstructGenericId(entityType, mCoreModelData->GetSequenceNumber(entityType));
         }
         else
         {
@@ -594,7 +601,7 @@ namespace DlbAdm
             case DLB_ADM_ENTITY_TYPE_FRAME_FORMAT:
             {
                 char buffer[ADM_ID_MAX_LEN + 1];
-                uint32_t seq = mCoreModelData->GetSequenceMap().GetSequenceNumber(entityType);
+                uint32_t seq = mCoreModelData->GetSequenceNumber(entityType);
 
                 snprintf(buffer, sizeof(buffer), "FF_%08x", seq);
                 entityID = translator.Translate(buffer);
@@ -609,13 +616,13 @@ namespace DlbAdm
             case DLB_ADM_ENTITY_TYPE_PROGRAMME:
             case DLB_ADM_ENTITY_TYPE_CONTENT:
             case DLB_ADM_ENTITY_TYPE_OBJECT:
-                entityID = translator.ConstructUntypedId(entityType, mCoreModelData->GetSequenceMap().GetSequenceNumber(entityType));
+                entityID = translator.ConstructUntypedId(entityType, mCoreModelData->GetSequenceNumber(entityType));
                 break;
 
             case DLB_ADM_ENTITY_TYPE_PACK_FORMAT:
             case DLB_ADM_ENTITY_TYPE_STREAM_FORMAT:
             case DLB_ADM_ENTITY_TYPE_CHANNEL_FORMAT:
-                entityID = translator.ConstructTypedId(entityType, audioType, mCoreModelData->GetSequenceMap().GetSequenceNumber(entityType));
+                entityID = translator.ConstructTypedId(entityType, audioType, mCoreModelData->GetSequenceNumber(entityType));
                 break;
 
             case DLB_ADM_ENTITY_TYPE_TRACK_FORMAT:
@@ -641,7 +648,7 @@ namespace DlbAdm
         {
         case DLB_ADM_ENTITY_TYPE_CHANNEL_FORMAT:
         case DLB_ADM_ENTITY_TYPE_OBJECT:
-            entityID = translator.ConstructSubcomponentId(parentID, mCoreModelData->GetSequenceMap().GetSubcomponentNumber(parentID));
+            entityID = translator.ConstructSubcomponentId(parentID, mCoreModelData->GetSubcomponentNumber(parentID));
             break;
 
         default:
@@ -656,6 +663,7 @@ namespace DlbAdm
     {
         mCoreModelData->Clear();
         mCoreModelProfiles.clear();
+        Touch();
     }
 
     bool CoreModel::IsEmpty() const
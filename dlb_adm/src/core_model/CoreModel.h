@@ -38,7 +38,6 @@
 #define DLB_ADM_CORE_MODEL_CLASS_H
 
 #include <boost/core/noncopyable.hpp>
-#include <boost/interprocess/managed_heap_memory.hpp>
 #include <functional>
 #include <memory>
 #include <set>
@@ -196,7 +195,7 @@ namespace DlbAdm
 
         bool IsEmpty() const;
 
-        void AddProfile(DLB_ADM_PROFILE profile) { mCoreModelProfiles.insert(profile); }
+        void AddProfile(DLB_ADM_PROFILE profile) { mCoreModelProfiles.insert(profile); Touch(); }
 
         bool HasProfile(DLB_ADM_PROFILE profile) const { 
 			return mCoreModelProfiles.count(profile); 
@@ -204,12 +203,19 @@ namespace DlbAdm
 
         const std::set<DLB_ADM_PROFILE> & GetProfiles() const { return mCoreModelProfiles; };
 
+        // Change tracking: the generation is unique within the process and changes
+        // whenever the content of the model changes
+
+        uint64_t GetGeneration() const { return mGeneration; }
+
     private:
+        void Touch();
+
         template <class T>
         bool AddModelEntity(const T &entity);
 
         template <typename RecordT, typename TableT>
-        bool AddModelRecord(const RecordT &record, TableT &table);
+        bool AddModelRecord(const RecordT &record, TableT &(CoreModelData::*getTable)());
 
         template <typename IndexT, typename CallbackT>
         int ForEachRecord(IndexT &index, CallbackT callbackFn) const;
@@ -226,7 +232,7 @@ namespace DlbAdm
 
         /* From BS.2125-1 specifcation: "the flow is constrained by the most constrained parts of each profile" */
         std::set<DLB_ADM_PROFILE> mCoreModelProfiles;
-        std::shared_ptr<boost::interprocess::managed_heap_memory> mSharedMemory;
+        uint64_t mGeneration;
     };
 
 }
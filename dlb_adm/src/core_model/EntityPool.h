@@ -0,0 +1,224 @@
+/************************************************************************
+ * dlb_adm
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#ifndef DLB_ADM_ENTITY_POOL_H
+#define DLB_ADM_ENTITY_POOL_H
+
+#include "dlb_adm/include/dlb_adm_entity_id.h"
+
+#include <boost/core/noncopyable.hpp>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace DlbAdm
+{
+
+    // Storage for model entities of one class, indexed by entity ID.  Entities are
+    // constructed in chunks that are allocated on demand and kept across Clear(), so
+    // a model that is rebuilt frame after frame stops allocating once it has grown to
+    // size.  Entity addresses are stable until the entity is removed.
+
+    template <class T>
+    class EntityPool : public boost::noncopyable
+    {
+    public:
+        EntityPool()
+            : mFreeList(nullptr)
+            , mChunk(0)
+            , mChunkUsed(0)
+        {
+        }
+
+        ~EntityPool()
+        {
+            Clear();
+        }
+
+        // Returns nullptr if there is already an entity with the same ID
+        const T *Add(const T &entity)
+        {
+            dlb_adm_entity_id id = entity.GetEntityID();
+
+            if (mIndex.count(id) != 0)
+            {
+                return nullptr;
+            }
+
+            Slot *slot = Allocate();
+            T *p;
+
+            try
+            {
+                p = new (slot) T(entity);
+                mIndex.insert(std::make_pair(id, p));
+            }
+            catch (...)
+            {
+                Release(slot);
+                throw;
+            }
+
+            return p;
+        }
+
+        bool Remove(dlb_adm_entity_id id)
+        {
+            auto it = mIndex.find(id);
+
+            if (it == mIndex.end())
+            {
+                return false;
+            }
+
+            T *p = it->second;
+            mIndex.erase(it);
+            p->~T();
+            Release(reinterpret_cast<Slot *>(p));
+
+            return true;
+        }
+
+        const T *Find(dlb_adm_entity_id id) const
+        {
+            auto it = mIndex.find(id);
+            return (it == mIndex.end()) ? nullptr : it->second;
+        }
+
+        void Clear()
+        {
+            for (auto &entry : mIndex)
+            {
+                entry.second->~T();
+            }
+            mIndex.clear();
+            mFreeList = nullptr;
+            mChunk = 0;
+            mChunkUsed = 0;
+        }
+
+        size_t Size() const { return mIndex.size(); }
+
+        bool IsEmpty() const { return mIndex.empty(); }
+
+    private:
+        union Slot
+        {
+            Slot *next;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        };
+
+        Slot *Allocate()
+        {
+            Slot *slot = mFreeList;
+
+            if (slot != nullptr)
+            {
+                mFreeList = slot->next;
+                return slot;
+            }
+
+            // Move on to the next chunk, allocating it if this is the furthest we have grown
+            if (mChunk < mChunks.size() && mChunkUsed == ChunkSize(mChunk))
+            {
+                ++mChunk;
+                mChunkUsed = 0;
+            }
+            if (mChunk == mChunks.size())
+            {
+                mChunks.push_back(std::unique_ptr<Slot[]>(new Slot[ChunkSize(mChunk)]));
+            }
+
+            return &mChunks[mChunk][mChunkUsed++];
+        }
+
+        void Release(Slot *slot)
+        {
+            slot->next = mFreeList;
+            mFreeList = slot;
+        }
+
+        // Chunks double in size from 16 to 1024 entities
+        static size_t ChunkSize(size_t chunk)
+        {
+            return (chunk < 6) ? (static_cast<size_t>(16) << chunk) : 1024;
+        }
+
+        std::unordered_map<dlb_adm_entity_id, T *> mIndex;
+        std::vector<std::unique_ptr<Slot[]>> mChunks;
+        Slot *mFreeList;
+        size_t mChunk;
+        size_t mChunkUsed;
+    };
+
+    // One pool per entity class; Pool<T>() picks the right one
+
+    template <class... Ts>
+    class EntityPools;
+
+    template <>
+    class EntityPools<>
+    {
+    public:
+        void Clear() {}
+
+        bool IsEmpty() const { return true; }
+    };
+
+    template <class T, class... Ts>
+    class EntityPools<T, Ts...> : public EntityPool<T>, public EntityPools<Ts...>
+    {
+    public:
+        template <class U>
+        EntityPool<U> &Pool() { return *this; }
+
+        void Clear()
+        {
+            EntityPool<T>::Clear();
+            EntityPools<Ts...>::Clear();
+        }
+
+        bool IsEmpty() const
+        {
+            return EntityPool<T>::IsEmpty() && EntityPools<Ts...>::IsEmpty();
+        }
+    };
+
+}
+
+#endif  // DLB_ADM_ENTITY_POOL_H
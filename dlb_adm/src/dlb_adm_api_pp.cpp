@@ -755,6 +755,19 @@ dlb_adm_container_clear_all
     return unwind_protect([&] { return container->GetContainer().Clear(); });
 }
 
+int
+dlb_adm_container_reset
+    (dlb_adm_xml_container      *container
+    )
+{
+    if (container == nullptr)
+    {
+        return DLB_ADM_STATUS_NULL_POINTER;
+    }
+
+    return unwind_protect([&] { return container->GetContainer().Reset(); });
+}
+
 
 /* XML Reader */
 
@@ -3348,6 +3361,22 @@ dlb_adm_core_model_is_empty
     return status;
 }
 
+int
+dlb_adm_core_model_get_generation
+    (const dlb_adm_core_model   *model
+    ,uint64_t                   *generation
+    )
+{
+    if ((model == nullptr) || (generation == nullptr))
+    {
+        return DLB_ADM_STATUS_NULL_POINTER;
+    }
+
+    *generation = model->GetCoreModel().GetGeneration();
+
+    return DLB_ADM_STATUS_OK;
+}
+
 dlb_adm_gain_value
 dlb_adm_gain_in_decibels
     (dlb_adm_data_gain       gain
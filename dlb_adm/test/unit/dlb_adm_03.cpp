@@ -682,3 +682,169 @@ TEST_F(DlbAdm03, ReadXmlBufferSeveralTimes)
     EXPECT_TRUE(DlbAdmTest::CompareFiles(dolbyReferenceFileName, dolbyReferenceOutFileName));
 }
 
+
+TEST_F(DlbAdm03, LoadCommonDefsSnapshot)
+{
+    using namespace DlbAdm;
+
+    static const char *programmeIdStr = "APR_1001";
+    static const DLB_ADM_ENTITY_TYPE types[] =
+    {
+        DLB_ADM_ENTITY_TYPE_PACK_FORMAT,
+        DLB_ADM_ENTITY_TYPE_CHANNEL_FORMAT,
+    };
+    dlb_adm_xml_container *parsedContainer = nullptr;
+    dlb_adm_entity_id programmeId;
+    size_t snapshotCount;
+    size_t parsedCount;
+    int status;
+
+    auto countEntities = [](dlb_adm_xml_container *c, DLB_ADM_ENTITY_TYPE t)
+    {
+        size_t n = 0;
+        c->GetContainer().ForEachEntity(t, [&](const EntityRecord &) { n++; return static_cast<int>(DLB_ADM_STATUS_OK); });
+        return n;
+    };
+    auto countRelationships = [](dlb_adm_xml_container *c)
+    {
+        size_t n = 0;
+        c->GetContainer().ForEachRelationship([&](const RelationshipRecord &) { n++; return static_cast<int>(DLB_ADM_STATUS_OK); });
+        return n;
+    };
+
+    // An empty container gets the common definitions from the process-wide snapshot...
+    status = ::dlb_adm_container_open(&theContainer, &containerCounts);
+    ASSERT_EQ(DLB_ADM_STATUS_OK, status);
+    status = ::dlb_adm_container_load_common_definitions(theContainer);
+    ASSERT_EQ(DLB_ADM_STATUS_OK, status);
+    EXPECT_FALSE(theContainer->GetContainer().IsEmpty());
+
+    // ...whereas a non-empty one has to parse them
+    status = ::dlb_adm_container_open(&parsedContainer, &containerCounts);
+    ASSERT_EQ(DLB_ADM_STATUS_OK, status);
+    status = ::dlb_adm_read_entity_id(&programmeId, programmeIdStr, ::strlen(programmeIdStr) + 1);
+    ASSERT_EQ(DLB_ADM_STATUS_OK, status);
+    status = ::dlb_adm_container_add_reference(parsedContainer, programmeId);
+    ASSERT_EQ(DLB_ADM_STATUS_OK, status);
+    status = ::dlb_adm_container_load_common_definitions(parsedContainer);
+    ASSERT_EQ(DLB_ADM_STATUS_OK, status);
+
+    for (DLB_ADM_ENTITY_TYPE t : types)
+    {
+        snapshotCount = countEntities(theContainer, t);
+        parsedCount = countEntities(parsedContainer, t);
+        EXPECT_LT(0u, snapshotCount);
+        EXPECT_EQ(parsedCount, snapshotCount);
+    }
+    EXPECT_EQ(countRelationships(parsedContainer), countRelationships(theContainer));
+    EXPECT_EQ(0u, countEntities(theContainer, DLB_ADM_ENTITY_TYPE_PROGRAMME));
+
+    // The copy is an ordinary, writable container
+    status = ::dlb_adm_container_add_reference(theContainer, programmeId);
+    EXPECT_EQ(DLB_ADM_STATUS_OK, status);
+    EXPECT_EQ(1u, countEntities(theContainer, DLB_ADM_ENTITY_TYPE_PROGRAMME));
+
+    // Clearing and reloading comes back to the same state
+    status = ::dlb_adm_container_clear_all(theContainer);
+    ASSERT_EQ(DLB_ADM_STATUS_OK, status);
+    EXPECT_TRUE(theContainer->GetContainer().IsEmpty());
+    status = ::dlb_adm_container_read_xml_buffer(theContainer, dolbyReferenceXML, ::strlen(dolbyReferenceXML), DLB_ADM_TRUE);
+    EXPECT_EQ(DLB_ADM_STATUS_OK, status);
+    for (DLB_ADM_ENTITY_TYPE t : types)
+    {
+        EXPECT_LE(countEntities(parsedContainer, t), countEntities(theContainer, t));
+    }
+
+    status = ::dlb_adm_container_close(&parsedContainer);
+    EXPECT_EQ(DLB_ADM_STATUS_OK, status);
+}
+
+TEST_F(DlbAdm03, ResetContainer)
+{
+    int status;
+
+    status = ::dlb_adm_container_reset(nullptr);
+    EXPECT_EQ(DLB_ADM_STATUS_NULL_POINTER, status);
+
+    status = ::dlb_adm_container_open(&theContainer, &containerCounts);
+    ASSERT_EQ(DLB_ADM_STATUS_OK, status);
+    EXPECT_TRUE(theContainer->GetContainer().IsEmpty());
+
+    // The same container serves several reads, with or without common definitions
+    for (int i = 0; i < 3; i++)
+    {
+        dlb_adm_bool useCommonDefs = (i == 1) ? DLB_ADM_TRUE : DLB_ADM_FALSE;
+
+        status = ::dlb_adm_container_read_xml_buffer(theContainer, dolbyReferenceXML, ::strlen(dolbyReferenceXML), useCommonDefs);
+        EXPECT_EQ(DLB_ADM_STATUS_OK, status);
+        EXPECT_FALSE(theContainer->GetContainer().IsEmpty());
+
+        status = ::dlb_adm_container_reset(theContainer);
+        ASSERT_EQ(DLB_ADM_STATUS_OK, status);
+        EXPECT_TRUE(theContainer->GetContainer().IsEmpty());
+    }
+
+    status = ::dlb_adm_container_read_xml_buffer(theContainer, dolbyReferenceXML, ::strlen(dolbyReferenceXML), DLB_ADM_FALSE);
+    EXPECT_EQ(DLB_ADM_STATUS_OK, status);
+    status = ::dlb_adm_container_write_xml_file(theContainer, dolbyReferenceOutFileName);
+    EXPECT_EQ(DLB_ADM_STATUS_OK, status);
+    EXPECT_TRUE(DlbAdmTest::CompareFiles(dolbyReferenceFileName, dolbyReferenceOutFileName));
+}
+
+TEST_F(DlbAdm03, ReadXmlBufferLayout)
+{
+    std::string singleLine;
+    std::string crlf;
+    bool lineStart = false;
+    int status;
+
+    // The same document on one line, and with DOS line endings and a comment
+    for (const char *p = dolbyReferenceXML; *p != '\0'; p++)
+    {
+        if (*p == '\n')
+        {
+            crlf += "\r\n";
+            lineStart = true;
+            continue;
+        }
+        crlf += *p;
+        if (lineStart && (*p == ' ' || *p == '\t'))
+        {
+            continue;
+        }
+        singleLine += *p;
+        lineStart = false;
+    }
+    crlf.insert(crlf.find("<audioFormatExtended"), "<!-- comment with <markup> -->\r\n");
+
+    status = ::dlb_adm_container_open(&theContainer, &containerCounts);
+    ASSERT_EQ(DLB_ADM_STATUS_OK, status);
+
+    status = ::dlb_adm_container_read_xml_buffer(theContainer, singleLine.data(), singleLine.size(), DLB_ADM_FALSE);
+    EXPECT_EQ(DLB_ADM_STATUS_OK, status);
+    status = ::dlb_adm_container_write_xml_file(theContainer, dolbyReferenceOutFileName);
+    EXPECT_EQ(DLB_ADM_STATUS_OK, status);
+    EXPECT_TRUE(DlbAdmTest::CompareFiles(dolbyReferenceFileName, dolbyReferenceOutFileName));
+
+    status = ::dlb_adm_container_reset(theContainer);
+    ASSERT_EQ(DLB_ADM_STATUS_OK, status);
+    status = ::dlb_adm_container_read_xml_buffer(theContainer, crlf.data(), crlf.size(), DLB_ADM_FALSE);
+    EXPECT_EQ(DLB_ADM_STATUS_OK, status);
+    status = ::dlb_adm_container_write_xml_file(theContainer, dolbyReferenceOutFileName);
+    EXPECT_EQ(DLB_ADM_STATUS_OK, status);
+    EXPECT_TRUE(DlbAdmTest::CompareFiles(dolbyReferenceFileName, dolbyReferenceOutFileName));
+
+    // Malformed documents are rejected
+    std::string truncated = singleLine.substr(0, singleLine.size() / 2);
+    std::string mismatched = singleLine;
+
+    mismatched.replace(mismatched.rfind("</audioFormatExtended>"), 22, "</audioFormatExtendid>");
+    status = ::dlb_adm_container_reset(theContainer);
+    ASSERT_EQ(DLB_ADM_STATUS_OK, status);
+    status = ::dlb_adm_container_read_xml_buffer(theContainer, truncated.data(), truncated.size(), DLB_ADM_FALSE);
+    EXPECT_EQ(DLB_ADM_STATUS_ERROR, status);
+    status = ::dlb_adm_container_reset(theContainer);
+    ASSERT_EQ(DLB_ADM_STATUS_OK, status);
+    status = ::dlb_adm_container_read_xml_buffer(theContainer, mismatched.data(), mismatched.size(), DLB_ADM_FALSE);
+    EXPECT_EQ(DLB_ADM_STATUS_ERROR, status);
+}
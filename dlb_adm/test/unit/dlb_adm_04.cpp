@@ -51,6 +51,8 @@
 #include "ContentGroup.h"
 #include "ElementGroup.h"
 #include "PresentationRecord.h"
+#include "BlockUpdate.h"
+#include "UpdateRecord.h"
 #include "ModelEntityContainer.h"
 #include "CoreModel.h"
 
@@ -1325,4 +1327,65 @@ TEST(dlb_adm_test, CoreModel_Profiles)
     model.AddProfile(DLB_ADM_PROFILE_SADM_EMISSION_PROFILE);
     EXPECT_TRUE(model.HasProfile(DLB_ADM_PROFILE_SADM_EMISSION_PROFILE));
 
-}
\ No newline at end of file
+}
+
+static void BuildLargeObjectModel(CoreModel &model, unsigned int objectCount, unsigned int updateCount)
+{
+    AdmIdTranslator translator;
+
+    for (unsigned int i = 0; i < objectCount; i++)
+    {
+        uint32_t seq = 0x1001 + i;
+        dlb_adm_entity_id objectID = translator.ConstructUntypedId(DLB_ADM_ENTITY_TYPE_OBJECT, seq);
+        dlb_adm_entity_id packID = translator.ConstructTypedId(DLB_ADM_ENTITY_TYPE_PACK_FORMAT, DLB_ADM_AUDIO_TYPE_OBJECTS, seq);
+        dlb_adm_entity_id channelID = translator.ConstructTypedId(DLB_ADM_ENTITY_TYPE_CHANNEL_FORMAT, DLB_ADM_AUDIO_TYPE_OBJECTS, seq);
+        dlb_adm_entity_id trackID = translator.ConstructGenericId(DLB_ADM_ENTITY_TYPE_TRACK_UID, i + 1);
+
+        ASSERT_TRUE(model.AddEntity(AudioElement(objectID)));
+        ASSERT_TRUE(model.AddEntity(TargetGroup(packID, DLB_ADM_AUDIO_TYPE_OBJECTS, false)));
+        ASSERT_TRUE(model.AddEntity(Target(channelID, DLB_ADM_AUDIO_TYPE_OBJECTS, "")));
+        ASSERT_TRUE(model.AddEntity(AudioTrack(trackID)));
+        ASSERT_TRUE(model.AddRecord(ElementRecord(objectID, packID, channelID, trackID)));
+
+        for (unsigned int j = 0; j < updateCount; j++)
+        {
+            dlb_adm_entity_id updateID;
+
+            ASSERT_EQ(DLB_ADM_STATUS_OK, model.GetSubcomponentID(updateID, channelID));
+            ASSERT_TRUE(model.AddEntity(BlockUpdate(updateID, Position(0.1f * j, 0.5f, 0.0f, true), Gain())));
+            ASSERT_TRUE(model.AddRecord(UpdateRecord(updateID)));
+        }
+    }
+}
+
+TEST(dlb_adm_test, CoreModel_LargeObjectModel)
+{
+    static const unsigned int OBJECT_COUNT = 1000;
+    static const unsigned int UPDATE_COUNT = 4;
+    static const unsigned int ROUNDS = 5;
+
+    CoreModel model;
+
+    // Build the same model repeatedly, as a decoder would from frame to frame
+    for (unsigned int round = 0; round < ROUNDS; round++)
+    {
+        BuildLargeObjectModel(model, OBJECT_COUNT, UPDATE_COUNT);
+        if (HasFatalFailure())
+        {
+            return;
+        }
+
+        EXPECT_EQ(OBJECT_COUNT, model.Count(DLB_ADM_ENTITY_TYPE_OBJECT));
+        EXPECT_EQ(OBJECT_COUNT * UPDATE_COUNT, model.Count(DLB_ADM_ENTITY_TYPE_BLOCK_FORMAT));
+
+        const ModelEntity *e;
+        AdmIdTranslator translator;
+        dlb_adm_entity_id lastObjectID = translator.ConstructUntypedId(DLB_ADM_ENTITY_TYPE_OBJECT, 0x1000 + OBJECT_COUNT);
+        EXPECT_TRUE(model.GetEntity(lastObjectID, &e));
+        EXPECT_FALSE(model.AddEntity(AudioElement(lastObjectID)));
+
+        model.Clear();
+        EXPECT_TRUE(model.IsEmpty());
+        EXPECT_FALSE(model.GetEntity(lastObjectID, &e));
+    }
+}
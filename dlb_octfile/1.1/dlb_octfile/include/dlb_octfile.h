@@ -63,6 +63,7 @@ typedef struct dlb_octfile_s
     size_t           mem_alloc_size;/**< Allocated size of the memory file. */
     unsigned char    mem_fixed;     /**< Boolean flag indicating the memory file is fixed size. */
     unsigned char    mem_eof;       /**< Boolean flag indicating we have hit the end-of-file. */
+    size_t           map_ahead;     /**< End of the range of a mapped file already advised for readahead. */
     /* Pointer to file operation function table */
     const dlb_octfile_vtable *vtable;
     /*
@@ -135,6 +136,10 @@ typedef int
 (*fn_octfile_eof)
     (dlb_octfile *stream);
 
+typedef const void *
+(*fn_octfile_borrow)
+    (dlb_octfile *stream, size_t count, size_t *avail);
+
 struct dlb_octfile_vtable_s
 {
     fn_octfile_close    octfile_close;
@@ -147,6 +152,7 @@ struct dlb_octfile_vtable_s
     fn_octfile_getpos   octfile_getpos;
     fn_octfile_rewind   octfile_rewind;
     fn_octfile_eof      octfile_eof;
+    fn_octfile_borrow   octfile_borrow;
 };
 
 /* These are all exactly analogous to the standard stdio FILE function */
@@ -186,6 +192,26 @@ dlb_octfile_open_memory
     ,const char *mode 
     );
 
+/* Open a file for reading through a read-only memory mapping of its whole
+ * contents. The OS is advised that the file will be read sequentially, and
+ * is asked to read ahead of the current position as reading proceeds.
+ * Reads then copy straight out of the page cache, and dlb_octfile_borrow()
+ * can hand out views of the data without copying at all.
+ * If the platform has no mmap(), the mode is not read-only, or the file
+ * cannot be mapped (it is empty, or not a regular file), the file is opened
+ * exactly as dlb_octfile_open() would open it.
+ * The mapping follows the file on disk. If the file is truncated while it
+ * is open, reading or touching a borrowed view past its new end raises
+ * SIGBUS rather than returning an error, so do not map files that another
+ * process may truncate or rewrite.
+ */
+dlb_octfile*
+dlb_octfile_open_mapped
+    (dlb_octfile*
+    ,const char *filename
+    ,const char *mode
+    );
+
 const
 void *
 dlb_octfile_get_memory
@@ -242,4 +268,19 @@ int
 dlb_octfile_eof
     (dlb_octfile *stream);
 
+/* Borrow a read-only view of up to 'count' octets at the current position
+ * of a memory-based or memory-mapped file, and advance past them. 'avail'
+ * receives the number of octets in the view. Returns NULL, with 'avail' set
+ * to 0, if there is nothing to view: for stdio files, at the end of the
+ * file, or where CHAR_BIT != 8. The view stays valid until the file is
+ * closed or, for a growable memory file, written to.
+ */
+const
+void *
+dlb_octfile_borrow
+    (dlb_octfile *stream
+    ,size_t       count
+    ,size_t      *avail
+    );
+
 #endif
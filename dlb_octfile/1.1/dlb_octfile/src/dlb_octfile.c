@@ -100,6 +100,7 @@ open_internal(dlb_octfile* ret, const char *mode)
     ret->mem_alloc_size = 0;
     ret->mem_fixed = 0;
     ret->mem_eof = 0;
+    ret->map_ahead = 0;
 
     ret->read_buffer = 0;
     ret->read_buffer_mask = 0;
@@ -662,4 +663,19 @@ dlb_octfile_eof(dlb_octfile *stream)
     return stream->vtable->octfile_eof(stream);
 }
 
-
+const
+void *
+dlb_octfile_borrow(dlb_octfile *stream, size_t count, size_t *avail)
+{
+    *avail = 0;
+#if CHAR_BIT == 8
+    return stream->vtable->octfile_borrow(stream, count, avail);
+#else
+    /* Octets are unpacked from chars as they are read, so the stored
+     * data cannot be handed out as it is.
+     */
+    (void)stream;
+    (void)count;
+    return NULL;
+#endif
+}
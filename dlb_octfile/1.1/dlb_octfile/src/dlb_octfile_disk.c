@@ -113,6 +113,17 @@ octfile_disk_eof(dlb_octfile *stream)
     return feof(stream->file);
 }
 
+static
+const void *
+octfile_disk_borrow(dlb_octfile *stream, size_t count, size_t *avail)
+{
+    /* stdio only ever copies out of its buffer */
+    (void)stream;
+    (void)count;
+    *avail = 0;
+    return NULL;
+}
+
 const dlb_octfile_vtable dlb_octfile_disk_vtable = 
     {octfile_disk_close
     ,octfile_disk_flush
@@ -124,4 +135,5 @@ const dlb_octfile_vtable dlb_octfile_disk_vtable =
     ,octfile_disk_getpos
     ,octfile_disk_rewind
     ,octfile_disk_eof
+    ,octfile_disk_borrow
     };
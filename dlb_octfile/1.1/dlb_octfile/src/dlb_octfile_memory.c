@@ -198,6 +198,25 @@ octfile_memory_eof(dlb_octfile *stream)
     return stream->mem_eof;
 }
 
+static
+const void *
+octfile_memory_borrow(dlb_octfile *stream, size_t count, size_t *avail)
+{
+    size_t bytes_avail = stream->mem_size - stream->mem_offset;
+    const unsigned char *mem = (const unsigned char *)stream->mem_base + stream->mem_offset;
+
+    count = count > bytes_avail ? bytes_avail : count;
+    stream->mem_offset += count;
+
+    if (stream->mem_offset >= stream->mem_size)
+    {
+        stream->mem_eof = 1;
+    }
+
+    *avail = count;
+    return count ? mem : NULL;
+}
+
 const dlb_octfile_vtable dlb_octfile_memory_vtable = 
     {octfile_memory_close
     ,octfile_memory_flush
@@ -209,4 +228,5 @@ const dlb_octfile_vtable dlb_octfile_memory_vtable =
     ,octfile_memory_getpos
     ,octfile_memory_rewind
     ,octfile_memory_eof
+    ,octfile_memory_borrow
     };
@@ -0,0 +1,293 @@
+/************************************************************************
+ * dlb_octfile
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+/*
+ * Read-only memory-mapped files.
+ *
+ * A mapped file is a fixed-size memory file whose storage is the mapping,
+ * so reading is done by the memory implementation. This file adds the
+ * mapping itself, readahead advice as the read position moves through the
+ * file, stdio-like positioning, and unmapping on close.
+ */
+
+#include "dlb_octfile/include/dlb_octfile.h"
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+#if (defined(__unix__) || defined(__APPLE__)) && CHAR_BIT == 8
+#define DLB_OCTFILE_MMAP
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef DLB_OCTFILE_MMAP
+
+/* Octets requested ahead of the read position. */
+#define MMAP_READAHEAD  ((size_t)8 << 20)
+
+extern const dlb_octfile_vtable dlb_octfile_memory_vtable;
+static const dlb_octfile_vtable dlb_octfile_mmap_vtable;
+
+static
+void
+octfile_mmap_advise(dlb_octfile *stream, size_t count)
+{
+    size_t end = stream->mem_offset + (count < stream->mem_size - stream->mem_offset
+                                       ? count
+                                       : stream->mem_size - stream->mem_offset);
+
+    /* Ask for the next stretch once reading gets within half a stretch of
+     * the end of the last one, so that the OS can stay ahead of us.
+     */
+    if (end + MMAP_READAHEAD / 2 > stream->map_ahead && stream->map_ahead < stream->mem_size)
+    {
+        size_t page  = (size_t)sysconf(_SC_PAGESIZE);
+        size_t start = stream->map_ahead > stream->mem_offset ? stream->map_ahead : stream->mem_offset;
+        size_t stop  = end + MMAP_READAHEAD;
+
+        if (stop > stream->mem_size)
+        {
+            stop = stream->mem_size;
+        }
+        start -= start % page;
+        (void)madvise((unsigned char *)stream->mem_base + start, stop - start, MADV_WILLNEED);
+        stream->map_ahead = stop;
+    }
+}
+
+static
+int
+octfile_mmap_close(dlb_octfile *stream)
+{
+    int status = munmap(stream->mem_base, stream->mem_alloc_size);
+
+    stream->mem_base = NULL;
+    stream->mem_offset = 0;
+    stream->mem_size = 0;
+    stream->mem_alloc_size = 0;
+    return status;
+}
+
+static
+int
+octfile_mmap_flush(dlb_octfile *stream)
+{
+    (void)stream;
+    return 0;
+}
+
+static
+size_t
+octfile_mmap_write(const void *ptr, size_t size, size_t count, dlb_octfile *stream)
+{
+    /* The mapping is read-only */
+    (void)ptr;
+    (void)size;
+    (void)count;
+    (void)stream;
+    return 0;
+}
+
+static
+size_t
+octfile_mmap_read(void *ptr, size_t size, size_t count, dlb_octfile *stream)
+{
+    if (stream->mem_offset >= stream->mem_size)
+    {
+        stream->mem_eof = 1;
+        return 0;
+    }
+    octfile_mmap_advise(stream, count <= (size_t)-1 / size ? size * count : (size_t)-1);
+    return dlb_octfile_memory_vtable.octfile_read(ptr, size, count, stream);
+}
+
+/* Unlike a memory file, and like fseek(), a mapped file may be positioned
+ * past its end; reads from there return nothing.
+ */
+static
+int
+octfile_mmap_seek(dlb_octfile *stream, long offset, int whence)
+{
+    if (SEEK_CUR == whence)
+    {
+        offset = (long)stream->mem_offset + offset;
+    }
+    else if (SEEK_END == whence)
+    {
+        offset = (long)stream->mem_size + offset;
+    }
+
+    if (offset < 0)
+    {
+        return -1;
+    }
+    stream->mem_offset = (size_t)offset;
+    stream->mem_eof = 0;
+    return 0;
+}
+
+static
+int
+octfile_mmap_setpos(dlb_octfile *stream, const dlb_octpos *pos)
+{
+    stream->mem_offset = pos->mpos;
+    stream->mem_eof = 0;
+    return 0;
+}
+
+static
+long
+octfile_mmap_tell(dlb_octfile *stream)
+{
+    return dlb_octfile_memory_vtable.octfile_tell(stream);
+}
+
+static
+int
+octfile_mmap_getpos(dlb_octfile *stream, dlb_octpos *pos)
+{
+    return dlb_octfile_memory_vtable.octfile_getpos(stream, pos);
+}
+
+static
+void
+octfile_mmap_rewind(dlb_octfile *stream)
+{
+    octfile_mmap_seek(stream, 0L, SEEK_SET);
+}
+
+static
+int
+octfile_mmap_eof(dlb_octfile *stream)
+{
+    return dlb_octfile_memory_vtable.octfile_eof(stream);
+}
+
+static
+const void *
+octfile_mmap_borrow(dlb_octfile *stream, size_t count, size_t *avail)
+{
+    if (stream->mem_offset >= stream->mem_size)
+    {
+        stream->mem_eof = 1;
+        *avail = 0;
+        return NULL;
+    }
+    octfile_mmap_advise(stream, count);
+    return dlb_octfile_memory_vtable.octfile_borrow(stream, count, avail);
+}
+
+static const dlb_octfile_vtable dlb_octfile_mmap_vtable = 
+    {octfile_mmap_close
+    ,octfile_mmap_flush
+    ,octfile_mmap_write
+    ,octfile_mmap_read
+    ,octfile_mmap_seek
+    ,octfile_mmap_setpos
+    ,octfile_mmap_tell
+    ,octfile_mmap_getpos
+    ,octfile_mmap_rewind
+    ,octfile_mmap_eof
+    ,octfile_mmap_borrow
+    };
+
+/* Map the whole of a regular, non-empty file, or return NULL. */
+static
+void *
+map_file(const char *filename, size_t *size)
+{
+    struct stat st;
+    void *base = NULL;
+    int fd = open(filename, O_RDONLY);
+
+    if (fd < 0)
+    {
+        return NULL;
+    }
+    if  (   !fstat(fd, &st)
+        &&  S_ISREG(st.st_mode)
+        &&  st.st_size > 0
+        &&  (unsigned long long)st.st_size <= (size_t)-1
+        &&  (unsigned long long)st.st_size <= LONG_MAX
+        )
+    {
+        base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (MAP_FAILED == base)
+        {
+            base = NULL;
+        }
+        else
+        {
+            *size = (size_t)st.st_size;
+        }
+    }
+    /* The mapping holds its own reference to the file */
+    close(fd);
+    return base;
+}
+
+#endif /* DLB_OCTFILE_MMAP */
+
+dlb_octfile*
+dlb_octfile_open_mapped
+    (dlb_octfile*ret
+    ,const char *filename
+    ,const char *mode
+    )
+{
+#ifdef DLB_OCTFILE_MMAP
+    if (NULL == strchr(mode, 'w') && NULL == strchr(mode, 'a') && NULL == strchr(mode, '+'))
+    {
+        size_t size = 0;
+        void *base = map_file(filename, &size);
+
+        if (NULL != base)
+        {
+            if (NULL != dlb_octfile_open_memory_fixed(ret, size, base, mode))
+            {
+                (void)madvise(base, size, MADV_SEQUENTIAL);
+                ret->vtable = &dlb_octfile_mmap_vtable;
+                return ret;
+            }
+            munmap(base, size);
+        }
+    }
+#endif
+    return dlb_octfile_open(ret, filename, mode);
+}
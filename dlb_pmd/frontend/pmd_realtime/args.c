@@ -121,6 +121,7 @@ chkargs
     args->skip_pcm_samples = 0;
     args->vsync         = 0;
     args->sadm          = 0;
+    args->http_pipeline = 0;
 
     args->desired_input_latency = 0;
     args->desired_output_latency = 0;
@@ -396,6 +397,10 @@ chkargs
         {
             args->sadm = 1;
         }
+        else if (0 == strncmp(arg, "-http-pipeline", 15))
+        {
+            args->http_pipeline = 1;
+        }
         else
         {
             printf("Error: unrecognised arg: \"%s\"\n", *argv);
@@ -473,6 +478,9 @@ chkargs
     printf("      -loop               : in play mode, loop input file, don't terminate\n");
     printf("      -sadm               : prefer sADM metadata format in streams\n");
     printf("      -allmd              : dump metadata every frame, even if same as last frame\n");
+    printf("      -http-pipeline      : when posting metadata to an HTTP url, send frames\n");
+    printf("                            queued behind a slow server without waiting for\n");
+    printf("                            each response\n");
     printf("      -skip-pcm <count>: simulate random access into PCM stream by skipping this\n");
     printf("            many samples from start of .wav file when decoding PCM+PMD\n");
     printf("      -vsync <offset>: (PCM+PMD read only) samples from beginning of .wav file where\n");
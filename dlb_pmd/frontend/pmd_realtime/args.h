@@ -99,6 +99,7 @@ typedef struct
     dlb_pmd_bool loop_playback;    /**< loop playback file indefinitely */
     dlb_pmd_bool filter_md;        /**< only dump metadata files if change */
     dlb_pmd_bool sadm;           /**< prefer sADM metadata format? */
+    dlb_pmd_bool http_pipeline;  /**< pipeline queued HTTP metadata posts? */
 
     int desired_input_latency;  /**< desired portaudio input latency */
     int desired_output_latency; /**< desired portaudio output latency */
@@ -42,7 +42,7 @@
 #include "dlb_http_server.h"
 #include "pmd_os.h"
 #include "dlb_pmd_xml.h"
-#include "model_queue.h"
+#include "model_exchange.h"
 #include <stdarg.h>
 
 #if defined(_MSC_VER) && !defined(snprintf)
@@ -57,6 +57,13 @@
 #  define MHL_TRACE(x)
 #endif
 
+/**
+ * @def MHL_MAX_CONNECTIONS (16)
+ * @brief most senders the listener serves at once
+ */
+#define MHL_MAX_CONNECTIONS (16)
+
+
 /* uncomment following to dump received XML */
 //#define MHL_DUMP
 
@@ -126,7 +133,7 @@ typedef struct
 {
     const char *servicename;          /**< name of service */
     uint16_t port;                    /**< requested localhost port to listen to */
-    model_queue *pending;             /**< model queue to populate with incoming XML */
+    model_exchange *pending;          /**< model exchange to populate with incoming XML */
     dlb_http_request *request;        /**< current request */
     dlb_http_server http_server;      /**< http server abstraction */
     pmd_thread thread;                /**< thread handle for server */
@@ -329,10 +336,9 @@ process_http_request
     
     MHL_DUMP_OPEN(&mhl->dumper, request);
 
-    model = model_queue_back(mhl->pending);
+    model = model_rewrite(model_exchange_back(mhl->pending));
     if (model)
     {
-        dlb_pmd_reset(model);
         if (dlb_xmlpmd_parse(mhl_line_callback, mhl_error_callback, mhl, model,
                              !DLB_PMD_XML_STRICT))
         {
@@ -346,7 +352,7 @@ process_http_request
         {
             /* todo: check to see if there is more data */
             request->return_code = "200 OK";
-            model_queue_push(mhl->pending);
+            model_exchange_publish(mhl->pending);
         }
     }
     
@@ -367,7 +373,8 @@ listener_thread
     md_http_listener *mhl = (md_http_listener *)arg;
     int err;
 
-    (void)dlb_http_server_run(&mhl->http_server, mhl->port, process_http_request, mhl, &err);
+    (void)dlb_http_server_run2(&mhl->http_server, mhl->port, MHL_MAX_CONNECTIONS,
+                               process_http_request, mhl, &err);
     return NULL;
 }
 
@@ -381,7 +388,7 @@ static inline
 dlb_pmd_success
 md_http_listener_init
     (Args *args                    /**< [in] command-line arguments */
-    ,model_queue *pending          /**< [in] model queue to populate */
+    ,model_exchange *pending       /**< [in] model exchange to populate */
     ,md_http_listener **mhlptr     /**< [out] metadata listener */
     )
 {
@@ -37,6 +37,10 @@
 /**
  * @file md_http_send.h
  * @brief abstraction of code to send metadata to a destination HTTP address via HTTP POST
+ *
+ * The connection is kept alive between posts, and re-established when the
+ * server closes it.  A batch of models can also be pipelined: all of them
+ * are posted back to back before any of the responses are read.
  */
 
 #include "dlb_http_client.h"
@@ -53,6 +57,8 @@ typedef struct
     dlb_http_client http_client;
     const char *url;
     dlb_pmd_model *model;
+    dlb_pmd_bool opened;      /**< has http_client been set up for the url? */
+    dlb_pmd_bool pipeline;    /**< pipeline batches of posts? */
     char line[4096];
     int length;
     int indent;
@@ -92,7 +98,9 @@ md_http_sender_init
     ,Args *args                /**< [in] command-line arguments */
     )
 {
+    memset(mhs, '\0', sizeof(*mhs));
     mhs->url = args->md_file_out;
+    mhs->pipeline = args->http_pipeline;
     return PMD_SUCCESS;
 }
 
@@ -106,8 +114,12 @@ md_http_sender_finish
     (md_http_sender *mhs       /**< [in] metadata sender to finish */
     )
 {
-    printf("closing HTTP socket\n");
-    dlb_http_client_close(&mhs->http_client);
+    if (mhs->opened)
+    {
+        printf("closing HTTP socket after %u connection(s)\n", mhs->http_client.connections);
+        dlb_http_client_close(&mhs->http_client);
+        mhs->opened = 0;
+    }
 }
 
 
@@ -136,7 +148,12 @@ get_buffer
             return 0;
         }
 
-        if (DLB_SOCKET_OK != dlb_http_client_send(&mhs->http_client, mhs->line, len, &err))
+        if (!mhs->http_client.connected)
+        {
+            /* the request has already failed, and the writer carries on
+             * regardless: just recycle the buffer until it is done */
+        }
+        else if (DLB_SOCKET_OK != dlb_http_client_send(&mhs->http_client, mhs->line, len, &err))
         {
             printf("Failed to send data down socket: %d\n", err);
             return 0;
@@ -153,11 +170,39 @@ get_buffer
 
 
 /**
- * @brief send model XML format down socket
+ * @brief set up the HTTP client for the destination url, the first time
+ *
+ * Failing to connect is not an error here: the client connects again
+ * when the request is sent.
  */
 static inline
 dlb_pmd_success
-md_http_sender_post
+mhs_open
+    (md_http_sender *mhs       /**< [in] metadata sender */
+    )
+{
+    int err;
+
+    if (!mhs->opened)
+    {
+        if (DLB_SOCKET_INVALID_ARG == dlb_http_client_open2(&mhs->http_client, mhs->url, 1, &err))
+        {
+            printf("Bad HTTP url %s\n", mhs->url);
+            return PMD_FAIL;
+        }
+        mhs->opened = 1;
+    }
+    return PMD_SUCCESS;
+}
+
+
+/**
+ * @brief send one model's XML as an HTTP POST request, without waiting for
+ * the response
+ */
+static inline
+dlb_pmd_success
+mhs_send
     (md_http_sender *mhs       /**< [in] metadata sender */
     ,dlb_pmd_model *model      /**< [in] model to send */
     )
@@ -165,19 +210,114 @@ md_http_sender_post
     int err;
 
     mhs->model = model;
-
     MHS_DUMP(model);
-    if (!dlb_http_client_open(&mhs->http_client, mhs->url, &err) &&
-        !dlb_http_client_post(&mhs->http_client, "application/xml; charset=utf-8", 0, &err) &&
-        !dlb_xmlpmd_write(get_buffer, 0, mhs, model) &&
-        !dlb_http_client_read(&mhs->http_client, NULL, NULL)
-       )
+    if (   !dlb_http_client_post(&mhs->http_client, "application/xml; charset=utf-8", 0, &err)
+        && !dlb_xmlpmd_write(get_buffer, 0, mhs, model)
+        && !dlb_http_client_end_request(&mhs->http_client, &err))
     {
-        dlb_http_client_close(&mhs->http_client);
         return PMD_SUCCESS;
     }
+    /* never leave half a request on the connection */
     dlb_http_client_close(&mhs->http_client);
     return PMD_FAIL;
 }
 
 
+/**
+ * @brief send a batch of models' XML down the socket
+ *
+ * With pipelining, all the models are posted before any response is
+ * read.  If the connection drops part way, the models whose responses
+ * were lost are sent again on a new connection, and if a pipelined
+ * round makes no progress at all, the rest are sent one at a time.
+ * Without pipelining each model waits for its response before the next
+ * is sent.  A request that fails on a reused connection is retried once
+ * on a new one, since the server may have closed it while idle.
+ */
+static inline
+dlb_pmd_success                /** @return PMD_SUCCESS if every model was accepted */
+md_http_sender_post_batch
+    (md_http_sender *mhs       /**< [in] metadata sender */
+    ,dlb_pmd_model **models    /**< [in] models to send, in order */
+    ,unsigned int num_models   /**< [in] number of models to send */
+    )
+{
+    dlb_http_client *client = &mhs->http_client;
+    dlb_pmd_success res = PMD_SUCCESS;
+    unsigned int depth = mhs->pipeline ? num_models : 1;
+    unsigned int done = 0;
+    unsigned int retried = 0;
+
+    if (mhs_open(mhs))
+    {
+        return PMD_FAIL;
+    }
+
+    while (done < num_models)
+    {
+        unsigned int connections = client->connections;
+        unsigned int first = client->responses;
+        unsigned int answered;
+        unsigned int sent = 0;
+
+        while (sent < depth && done + sent < num_models
+               && !mhs_send(mhs, models[done + sent]))
+        {
+            ++sent;
+        }
+        while (client->connected && client->responses - first < sent)
+        {
+            unsigned int before = client->responses;
+            if (dlb_http_client_read(client, NULL, NULL) && client->responses != before)
+            {
+                /* the server answered, but rejected the model */
+                res = PMD_FAIL;
+            }
+        }
+        answered = client->responses - first;
+        done += answered;
+
+        if (answered < sent || 0 == sent)
+        {
+            /* the connection failed or was closed with requests still
+             * unanswered; they go again on a new connection */
+            dlb_http_client_close(client);
+            if (answered)
+            {
+                retried = 0;
+            }
+            else if (depth > 1)
+            {
+                depth = 1;
+            }
+            else if (!retried && connections == client->connections)
+            {
+                /* the request went down a connection opened before it,
+                 * which the server may have dropped: try a fresh one */
+                retried = 1;
+            }
+            else
+            {
+                printf("Error: could not send %u model(s) to %s\n", num_models - done, mhs->url);
+                return PMD_FAIL;
+            }
+        }
+    }
+    return res;
+}
+
+
+/**
+ * @brief send model XML format down socket
+ */
+static inline
+dlb_pmd_success
+md_http_sender_post
+    (md_http_sender *mhs       /**< [in] metadata sender */
+    ,dlb_pmd_model *model      /**< [in] model to send */
+    )
+{
+    return md_http_sender_post_batch(mhs, &model, 1);
+}
+
+
@@ -37,13 +37,20 @@
 /**
  * @file md_reader.h
  * @brief abstraction of code to extract metadata out of audio stream and save it
+ *
+ * Extraction runs on the audio thread, but writing the metadata out,
+ * whether to file or by HTTP POST, can stall for much longer than an
+ * audio block.  So the new-frame callback only queues a snapshot of the
+ * model, and an egress worker thread serializes and sends it.
  */
 
 
 #include "dlb_pmd_pcm.h"
 #include "model.h"
+#include "snapshot_queue.h"
 #include "md_http_sender.h"
 #include "dlb_pmd_sadm_file.h"
+#include "pmd_os.h"
 
 #ifdef _MSC_VER
 #  define snprintf _snprintf
@@ -61,10 +68,16 @@ typedef struct
     md_http_sender http;          /**< [in] http send stuff */
     dlb_pcmpmd_extractor *ext;    /**< [in] PMD extractor */
     void *mem;                    /**< [in] memory for PMD extractor */
-    model current;                /**< [in] current PMD model */
+    model current;                /**< [in] last PMD model written, owned by egress worker */
     model next;                   /**< [in] newly extracted PMD model */
     unsigned int frame_count;     /**< [in] number of frames read */
     unsigned int error_count;     /**< [in] number of errors discovered */
+
+    snapshot_queue *queue;        /**< [in] models waiting to be written */
+    pmd_semaphore doorbell;       /**< [in] wakes the egress worker */
+    pmd_atomic running;           /**< [in] cleared to stop the egress worker */
+    pmd_thread worker;            /**< [in] egress worker thread */
+    dlb_pmd_bool worker_running;  /**< [in] has the egress worker been started? */
 } md_reader;
     
 
@@ -139,6 +152,157 @@ file_writer_init
 }
 
 
+/**
+ * @brief write out or send extracted models, oldest first
+ *
+ * This runs on the egress worker thread.
+ */
+static inline
+void
+md_reader_egress
+    (md_reader *mdr               /**< [in] metadata reader */
+    ,snapshot_slot **slots        /**< [in] claimed snapshots */
+    ,unsigned int num_slots       /**< [in] number of snapshots */
+    )
+{
+    dlb_pmd_model *models[SNAPSHOT_QUEUE_DEPTH];
+    unsigned int num_models = 0;
+    char filename[256];
+    unsigned int i;
+
+    for (i = 0; i != num_slots; ++i)
+    {
+        dlb_pmd_model *model = slots[i]->snapshot.model;
+
+        if (mdr->filter_md && !dlb_pmd_equal(mdr->current.model, model, 0, 0))
+        {
+            continue;
+        }
+
+        if (mdr->send_socket)
+        {
+            /* posted below, as one batch */
+            models[num_models++] = model;
+        }
+        else
+        {
+            snprintf(filename, sizeof(filename), "%s_%u.xml", mdr->md_file_name, slots[i]->frame);
+            if (mdr->sadm ? dlb_pmd_sadm_file_write(filename, model)
+                          : dlb_xmlpmd_file_write(filename, model))
+            {
+                printf("Error: could not write %s\n", filename);
+            }
+        }
+        dlb_pmd_copy(mdr->current.model, model);
+    }
+
+    if (num_models && md_http_sender_post_batch(&mdr->http, models, num_models))
+    {
+        printf("Error: could not send to socket %s\n", mdr->md_file_name);
+    }
+}
+
+
+/**
+ * @brief egress worker: drain the snapshot queue whenever woken
+ *
+ * Once asked to stop, the worker still writes everything already queued.
+ * When HTTP requests are pipelined, everything queued is sent as one
+ * batch, leaving a slot for the producer to coalesce into meanwhile.
+ */
+static
+void *
+md_reader_worker
+    (void *arg                    /**< [in] metadata reader */
+    )
+{
+    md_reader *mdr = (md_reader*)arg;
+    snapshot_slot *slots[SNAPSHOT_QUEUE_DEPTH];
+    unsigned int batch = 1;
+    dlb_pmd_bool stopping;
+    unsigned int n;
+    unsigned int i;
+
+    if (mdr->send_socket && mdr->http.pipeline)
+    {
+        batch = SNAPSHOT_QUEUE_DEPTH - 1;
+    }
+
+    for (;;)
+    {
+        /* sample the flag before draining, so that nothing queued before
+         * the stop request can be left behind */
+        stopping = !pmd_atomic_load(&mdr->running);
+        while (0 != (n = snapshot_queue_claim_batch(mdr->queue, slots, batch)))
+        {
+            md_reader_egress(mdr, slots, n);
+            for (i = 0; i != n; ++i)
+            {
+                snapshot_queue_release(mdr->queue, slots[i]);
+            }
+        }
+        if (stopping || pmd_semaphore_wait(&mdr->doorbell))
+        {
+            break;
+        }
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief set up the egress worker and its queue
+ */
+static inline
+dlb_pmd_success
+md_reader_worker_init
+    (md_reader *mdr            /**< [in] metadata reader */
+    )
+{
+    if (snapshot_queue_init(&mdr->queue)) goto error0;
+    if (pmd_semaphore_init(&mdr->doorbell, "mdegress", 0)) goto error1;
+    pmd_atomic_init(&mdr->running, 1);
+    if (pmd_thread_init(&mdr->worker, md_reader_worker, mdr, PMD_THREAD_PRIORITY_NORMAL, 0, 0))
+    {
+        printf("Failed to create metadata egress thread\n");
+        goto error2;
+    }
+    (void)pmd_thread_set_name(&mdr->worker, "mdegress");
+    (void)pmd_thread_start(&mdr->worker);
+    mdr->worker_running = PMD_TRUE;
+    return PMD_SUCCESS;
+
+  error2: pmd_semaphore_finish(&mdr->doorbell);
+  error1: snapshot_queue_finish(mdr->queue);
+          mdr->queue = NULL;
+  error0: return PMD_FAIL;
+}
+
+
+/**
+ * @brief stop the egress worker once it has written everything queued
+ */
+static inline
+void
+md_reader_worker_finish
+    (md_reader *mdr            /**< [in] metadata reader */
+    )
+{
+    if (mdr->worker_running)
+    {
+        void *ignore;
+
+        pmd_atomic_store(&mdr->running, 0);
+        (void)pmd_semaphore_signal(&mdr->doorbell);
+        (void)pmd_thread_join(&mdr->worker, &ignore);
+        pmd_thread_finish(&mdr->worker);
+        pmd_semaphore_finish(&mdr->doorbell);
+        mdr->worker_running = PMD_FALSE;
+        (void)ignore;
+    }
+}
+
+
 /**
  * @brief initialize a metadata reader 
  */
@@ -174,8 +338,10 @@ md_reader_init
     if (model_init(&mdr->current)) goto error1;
     if (model_init(&mdr->next)) goto error2;
     if (extractor_init(mdr, args, ic)) goto error3;
+    if (args->md_file_out && md_reader_worker_init(mdr)) goto error4;
     return PMD_SUCCESS;
 
+  error4: extractor_finish(mdr);
   error3: model_finish(&mdr->next);
   error2: model_finish(&mdr->current);
   error1: free(mdr->md_file_name);
@@ -193,12 +359,21 @@ md_reader_finish
     (md_reader *mdr                       /**< [in] metadata reader to finish */
     )
 {
+    md_reader_worker_finish(mdr);
     extractor_finish(mdr);
     model_finish(&mdr->next);
     model_finish(&mdr->current);
     md_http_sender_finish(&mdr->http);
     free(mdr->md_file_name);
     printf("frame count:%u\n", mdr->frame_count);
+    if (mdr->queue)
+    {
+        printf("egress: %lu frames coalesced, %lu dropped\n",
+               snapshot_queue_coalesced(mdr->queue),
+               snapshot_queue_dropped(mdr->queue));
+        snapshot_queue_finish(mdr->queue);
+        mdr->queue = NULL;
+    }
 }
 
 
@@ -206,7 +381,8 @@ md_reader_finish
  * @brief metadata reader 'new frame' callback
  *
  * Every time the metadata extractor detects a new frame, this callback
- * will be invoked
+ * will be invoked.  It runs on the audio thread, so it only queues a
+ * copy of the model for the egress worker; it never waits for it.
  */
 static
 void
@@ -215,31 +391,11 @@ md_reader_callback
     )
 {
     md_reader *mdr = (md_reader*)arg;
-    char filename[256];
-    
-    if (!mdr->filter_md || dlb_pmd_equal(mdr->current.model, mdr->next.model, 0, 0))
-    {
-        snprintf(filename, sizeof(filename), "%s_%u.xml", mdr->md_file_name, mdr->frame_count);
 
-        if (mdr->send_socket)
-        {
-            if (md_http_sender_post(&mdr->http, mdr->next.model))
-            {
-                printf("Error: could not send to socket %s\n", mdr->md_file_name);
-            }
-        }
-        else if (mdr->sadm)
-        {
-            if (dlb_pmd_sadm_file_write(filename, mdr->next.model))
-            {
-                printf("Error: could not write %s\n", filename);
-            }
-        }
-        else if (dlb_xmlpmd_file_write(filename, mdr->next.model))
-        {
-            printf("Error: could not write %s\n", filename);
-        }
-        dlb_pmd_copy(mdr->current.model, mdr->next.model);
+    /* no queue (or egress worker) without an output file */
+    if (mdr->queue != NULL && !snapshot_queue_push(mdr->queue, mdr->next.model, mdr->frame_count))
+    {
+        (void)pmd_semaphore_signal(&mdr->doorbell);
     }
     mdr->frame_count += 1;
 }
@@ -47,14 +47,6 @@
 #include <stdlib.h>
 
 
-/**
- * @def MODEL_QUEUE_SIZE (2)
- * @brief size of pending model queue
- *
- */
-#define MODEL_QUEUE_SIZE (2)
-
-
 /**
  * @brief type of the metadata writer
  */
@@ -69,8 +61,8 @@ typedef struct
     md_http_listener *mhl;        /**< optional HTTP listener */
     dlb_pcmpmd_augmentor *aug;    /**< PCM augmentor */
     void *mem;                    /**< memory for the augmentor */
-    model current;                /**< currently poplulated model for writing */
-    model_queue *pending;         /**< queue of pending models */
+    model *current;               /**< model being written, owned by the audio thread */
+    model_exchange *pending;      /**< models shared with the HTTP listener */
 } md_writer;
 
 
@@ -98,7 +90,7 @@ augmentor_init
     }
     
     dlb_pcmpmd_augmentor_init2(&mdw->aug,
-                               mdw->current.model,
+                               mdw->current->combo,
                                mdw->mem,
                                args->rate,
                                args->ul,
@@ -142,16 +134,15 @@ md_writer_init
     ,unsigned int nc           /**< [in] number of channels */
     )
 {
-    if (model_init(&mdw->current)) goto error1;
-    if (model_queue_init(&mdw->pending, MODEL_QUEUE_SIZE)) goto error2;
-    if (model_populate(&mdw->current, args->md_file_in)) goto error3;
-    if (augmentor_init(mdw, args, nc)) goto error3;
-    if (md_http_listener_init(args, mdw->pending, &mdw->mhl)) goto error4;
+    if (model_exchange_init(&mdw->pending)) goto error1;
+    mdw->current = model_exchange_front(mdw->pending);
+    if (model_populate(mdw->current, args->md_file_in)) goto error2;
+    if (augmentor_init(mdw, args, nc)) goto error2;
+    if (md_http_listener_init(args, mdw->pending, &mdw->mhl)) goto error3;
     return PMD_SUCCESS;
 
-  error4: augmentor_finish(mdw);
-  error3: model_queue_finish(mdw->pending);
-  error2: model_finish(&mdw->current);
+  error3: augmentor_finish(mdw);
+  error2: model_exchange_finish(mdw->pending);
   error1: return PMD_FAIL;
 }
 
@@ -167,8 +158,8 @@ md_writer_finish
 {
     md_http_listener_finish(mdw->mhl);
     augmentor_finish(mdw);
-    model_queue_finish(mdw->pending);
-    model_finish(&mdw->current);
+    model_exchange_finish(mdw->pending);
+    mdw->current = NULL;
 }
 
 
@@ -176,7 +167,9 @@ md_writer_finish
  * @brief client callback invoked whenever PCM augmentor is about to begin
  * a new frame
  *
- * We use this time to update models, if we have a new one pending.
+ * We use this time to switch to the latest model published by the HTTP
+ * listener, if there is one.  This runs on the audio thread, so it only
+ * swaps pointers: it neither locks nor copies the model.
  */
 static
 void
@@ -185,11 +178,11 @@ new_frame_callback
     )
 {
     md_writer *mdw = (md_writer*)arg;
-    dlb_pmd_model *model = model_queue_front(mdw->pending);
-    if (model)
+    model *m = model_exchange_update(mdw->pending);
+    if (m)
     {
-        dlb_pmd_copy(mdw->current.model, model);
-        model_queue_pop(mdw->pending);
+        mdw->current = m;
+        dlb_pcmpmd_augmentor_set_model(mdw->aug, m->combo);
     }
 }
 
@@ -43,6 +43,7 @@
 #define __MODEL_H__
 
 #include "dlb_pmd_api.h"
+#include "dlb_pmd_model_combo.h"
 #include "dlb_pmd_xml_file.h"
 #include "dlb_pmd_sadm_file.h"
 #include <stdlib.h>
@@ -56,6 +57,7 @@ typedef struct
     size_t size;
     void *mem;
     dlb_pmd_model *model;
+    dlb_pmd_model_combo *combo;
 } model;
     
 
@@ -91,6 +93,15 @@ model_init
         return PMD_FAIL;
     }
     dlb_pmd_init(&m->model, m->mem);
+    if (dlb_pmd_model_combo_init(&m->combo, m->model, NULL, PMD_FALSE, NULL))
+    {
+        printf("could not allocate model combo\n");
+        dlb_pmd_finish(m->model);
+        free(m->mem);
+        m->model = NULL;
+        m->mem = NULL;
+        return PMD_FAIL;
+    }
     return PMD_SUCCESS;
 }
 
@@ -106,6 +117,7 @@ model_finish
 {
     if (m->model)
     {
+        (void)dlb_pmd_model_combo_destroy(&m->combo);
         dlb_pmd_finish(m->model);
         free(m->mem);
         m->model = NULL;
@@ -114,6 +126,26 @@ model_finish
 }
 
 
+/**
+ * @brief clear a model, ready to be given new PMD content
+ */
+static inline
+dlb_pmd_model *          /** @return PMD model to write, or NULL on failure */
+model_rewrite
+    (model *m
+    )
+{
+    dlb_pmd_model *pmd_model;
+
+    if (   dlb_pmd_model_combo_clear(m->combo)
+        || dlb_pmd_model_combo_get_writable_pmd_model(m->combo, &pmd_model, PMD_TRUE))
+    {
+        return NULL;
+    }
+    return pmd_model;
+}
+
+
 /**
  * @brief populate a model from an XML file
  */
@@ -129,7 +161,10 @@ model_populate
     {
         if (dlb_xmlpmd_file_is_pmd(filename))
         {
-            if (dlb_xmlpmd_file_read(filename, m->model, !DLB_PMD_XML_STRICT, error_callback, NULL))
+            dlb_pmd_model *pmd_model = model_rewrite(m);
+
+            if (   NULL == pmd_model
+                || dlb_xmlpmd_file_read(filename, pmd_model, !DLB_PMD_XML_STRICT, error_callback, NULL))
             {
                 printf("XML read file failed: %s\n", dlb_pmd_error(m->model));
                 return PMD_FAIL;
@@ -137,7 +172,8 @@ model_populate
         }
         else if (dlb_xmlpmd_file_is_sadm(filename))
         {
-            if (dlb_pmd_sadm_file_read(filename, m->model, error_callback, NULL))
+            if (   dlb_pmd_model_combo_clear(m->combo)
+                || dlb_pmd_sadm_file_read(filename, m->combo, PMD_FALSE, error_callback, NULL))
             {
                 printf("XML read sADM file failed\n");
                 return PMD_FAIL;
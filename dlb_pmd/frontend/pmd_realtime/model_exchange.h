@@ -0,0 +1,216 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+/**
+ * @file model_exchange.h
+ * @brief wait-free hand-off of models from one producer thread to one
+ * consumer thread
+ *
+ * This is a triple buffer: the producer owns one model (the back), the
+ * consumer owns another (the front), and the third is shared.  Publishing
+ * a model swaps the back with the shared slot, and taking an update swaps
+ * the shared slot with the front, each with a single atomic exchange, so
+ * neither side ever waits for or copies a model.  If the producer publishes
+ * twice before the consumer looks, the consumer only sees the latest model.
+ */
+
+#ifndef __MODEL_EXCHANGE_H__
+#define __MODEL_EXCHANGE_H__
+
+#include "model.h"
+#include "pmd_os.h"
+#include <string.h>
+
+/**
+ * @def MODEL_EXCHANGE_SLOTS (3)
+ * @brief number of models in the exchange
+ */
+#define MODEL_EXCHANGE_SLOTS (3)
+
+/**
+ * @def MODEL_EXCHANGE_FRESH (4)
+ * @brief flag added to the shared slot index when it holds a model the
+ * consumer has not taken yet
+ */
+#define MODEL_EXCHANGE_FRESH (4)
+
+/**
+ * @def MODEL_EXCHANGE_INDEX_MASK (3)
+ * @brief mask to extract a slot index
+ */
+#define MODEL_EXCHANGE_INDEX_MASK (3)
+
+
+/**
+ * @brief encapsulates the models shared by a producer and a consumer
+ */
+typedef struct
+{
+    model slots[MODEL_EXCHANGE_SLOTS]; /**< the models */
+    pmd_atomic shared;                 /**< index of shared slot, plus #MODEL_EXCHANGE_FRESH */
+    unsigned int back;                 /**< index of producer's slot */
+    unsigned int front;                /**< index of consumer's slot */
+} model_exchange;
+
+
+/**
+ * @brief create a model exchange
+ */
+static inline
+dlb_pmd_success             /** @return PMD_SUCCESS if ok, PMD_FAIL otherwise */
+model_exchange_init
+    (model_exchange **mxptr /**< [out] model exchange handle to set */
+    )
+{
+    model_exchange *mx = (model_exchange*)malloc(sizeof(model_exchange));
+    unsigned int i;
+
+    if (!mx)
+    {
+        return PMD_FAIL;
+    }
+    memset(mx, '\0', sizeof(model_exchange));
+
+    for (i = 0; i != MODEL_EXCHANGE_SLOTS; ++i)
+    {
+        if (model_init(&mx->slots[i]))
+        {
+            while (i--)
+            {
+                model_finish(&mx->slots[i]);
+            }
+            free(mx);
+            return PMD_FAIL;
+        }
+    }
+    mx->front = 0;
+    mx->back = 1;
+    pmd_atomic_init(&mx->shared, 2);
+    *mxptr = mx;
+    return PMD_SUCCESS;
+}
+
+
+/**
+ * @brief destroy model exchange and free resources
+ */
+static inline
+void
+model_exchange_finish
+    (model_exchange *mx     /**< [in] model exchange to finish */
+    )
+{
+    if (mx)
+    {
+        unsigned int i;
+        for (i = 0; i != MODEL_EXCHANGE_SLOTS; ++i)
+        {
+            model_finish(&mx->slots[i]);
+        }
+        free(mx);
+    }
+}
+
+
+/**
+ * @brief consumer: the model currently owned by the consumer
+ */
+static inline
+model *                     /** @return consumer's model */
+model_exchange_front
+    (model_exchange *mx     /**< [in] model exchange to query */
+    )
+{
+    return &mx->slots[mx->front];
+}
+
+
+/**
+ * @brief consumer: take the most recently published model, if there is one
+ *
+ * The previous front model goes back to the producer, so the consumer must
+ * have stopped using it.  This never blocks.
+ */
+static inline
+model *                     /** @return new front model, or NULL if nothing new was published */
+model_exchange_update
+    (model_exchange *mx     /**< [in] model exchange to query */
+    )
+{
+    long shared;
+
+    if (!(pmd_atomic_load(&mx->shared) & MODEL_EXCHANGE_FRESH))
+    {
+        return NULL;
+    }
+    shared = pmd_atomic_exchange(&mx->shared, (long)mx->front);
+    mx->front = (unsigned int)(shared & MODEL_EXCHANGE_INDEX_MASK);
+    return &mx->slots[mx->front];
+}
+
+
+/**
+ * @brief producer: the model to populate before publishing it
+ */
+static inline
+model *                     /** @return producer's model */
+model_exchange_back
+    (model_exchange *mx     /**< [in] model exchange to query */
+    )
+{
+    return &mx->slots[mx->back];
+}
+
+
+/**
+ * @brief producer: hand the back model over to the consumer
+ *
+ * The producer gets a new back model, which is either the previously
+ * published one (if the consumer never took it), or one the consumer has
+ * finished with.  This never blocks.
+ */
+static inline
+void
+model_exchange_publish
+    (model_exchange *mx     /**< [in] model exchange to update */
+    )
+{
+    long shared = pmd_atomic_exchange(&mx->shared, (long)mx->back | MODEL_EXCHANGE_FRESH);
+    mx->back = (unsigned int)(shared & MODEL_EXCHANGE_INDEX_MASK);
+}
+
+
+#endif /* __MODEL_EXCHANGE_H__ */
@@ -0,0 +1,330 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+/**
+ * @file snapshot_queue.h
+ * @brief bounded wait-free queue of model snapshots from one producer
+ * thread to one consumer thread
+ *
+ * The producer copies a model into the next free slot and marks it
+ * ready; the consumer claims the oldest ready slot, uses it, and frees
+ * it.  Neither side ever waits for the other.  If the consumer falls so
+ * far behind that the queue is full, the producer overwrites the newest
+ * queued snapshot instead (latest wins).  A snapshot is only dropped if
+ * it cannot be copied, or if the consumer has already claimed the newest
+ * slot, which needs a queue of depth 1.  Both outcomes are counted.
+ */
+
+#ifndef __SNAPSHOT_QUEUE_H__
+#define __SNAPSHOT_QUEUE_H__
+
+#include "model.h"
+#include "pmd_os.h"
+#include <string.h>
+
+/**
+ * @def SNAPSHOT_QUEUE_DEPTH (4)
+ * @brief number of snapshots the queue can hold; must be a power of 2
+ */
+#define SNAPSHOT_QUEUE_DEPTH (4)
+
+
+/**
+ * @brief state of a queue slot
+ */
+typedef enum
+{
+    SNAPSHOT_SLOT_FREE,           /**< available to the producer */
+    SNAPSHOT_SLOT_WRITING,        /**< producer is copying a model into it */
+    SNAPSHOT_SLOT_READY,          /**< holds a snapshot the consumer has not claimed */
+    SNAPSHOT_SLOT_CLAIMED         /**< consumer is using it */
+} snapshot_slot_state;
+
+
+/**
+ * @brief one queued model snapshot
+ */
+typedef struct
+{
+    model snapshot;               /**< copy of the producer's model */
+    unsigned int frame;           /**< producer's frame number for the snapshot */
+    pmd_atomic state;             /**< #snapshot_slot_state */
+} snapshot_slot;
+
+
+/**
+ * @brief encapsulates the snapshots in flight between a producer and a consumer
+ */
+typedef struct
+{
+    snapshot_slot slots[SNAPSHOT_QUEUE_DEPTH]; /**< the snapshots */
+    unsigned int head;            /**< producer's next slot */
+    unsigned int tail;            /**< consumer's next slot */
+    pmd_atomic coalesced;         /**< snapshots that replaced an unclaimed one */
+    pmd_atomic dropped;           /**< snapshots that could not be queued */
+} snapshot_queue;
+
+
+/**
+ * @brief create a snapshot queue
+ */
+static inline
+dlb_pmd_success             /** @return PMD_SUCCESS if ok, PMD_FAIL otherwise */
+snapshot_queue_init
+    (snapshot_queue **sqptr /**< [out] snapshot queue handle to set */
+    )
+{
+    snapshot_queue *sq = (snapshot_queue*)malloc(sizeof(snapshot_queue));
+    unsigned int i;
+
+    if (!sq)
+    {
+        return PMD_FAIL;
+    }
+    memset(sq, '\0', sizeof(snapshot_queue));
+
+    for (i = 0; i != SNAPSHOT_QUEUE_DEPTH; ++i)
+    {
+        if (model_init(&sq->slots[i].snapshot))
+        {
+            while (i--)
+            {
+                model_finish(&sq->slots[i].snapshot);
+            }
+            free(sq);
+            return PMD_FAIL;
+        }
+        pmd_atomic_init(&sq->slots[i].state, SNAPSHOT_SLOT_FREE);
+    }
+    pmd_atomic_init(&sq->coalesced, 0);
+    pmd_atomic_init(&sq->dropped, 0);
+    *sqptr = sq;
+    return PMD_SUCCESS;
+}
+
+
+/**
+ * @brief destroy snapshot queue and free resources
+ */
+static inline
+void
+snapshot_queue_finish
+    (snapshot_queue *sq     /**< [in] snapshot queue to finish */
+    )
+{
+    if (sq)
+    {
+        unsigned int i;
+        for (i = 0; i != SNAPSHOT_QUEUE_DEPTH; ++i)
+        {
+            model_finish(&sq->slots[i].snapshot);
+        }
+        free(sq);
+    }
+}
+
+
+/**
+ * @brief helper: copy a model into a slot the producer has claimed
+ */
+static inline
+dlb_pmd_success             /** @return PMD_SUCCESS if ok, PMD_FAIL otherwise */
+snapshot_slot_fill
+    (snapshot_slot *slot    /**< [in] slot in #SNAPSHOT_SLOT_WRITING state */
+    ,dlb_pmd_model *src     /**< [in] model to copy */
+    ,unsigned int frame     /**< [in] frame number of the model */
+    )
+{
+    dlb_pmd_success res = dlb_pmd_copy(slot->snapshot.model, src);
+
+    slot->frame = frame;
+    pmd_atomic_store(&slot->state, res ? SNAPSHOT_SLOT_FREE : SNAPSHOT_SLOT_READY);
+    return res;
+}
+
+
+/**
+ * @brief producer: queue a copy of a model
+ *
+ * This never blocks.  When the queue is full, the newest queued snapshot
+ * is overwritten.
+ */
+static inline
+dlb_pmd_success             /** @return PMD_SUCCESS if the model was queued or coalesced,
+                              *  PMD_FAIL if it was dropped or could not be copied */
+snapshot_queue_push
+    (snapshot_queue *sq     /**< [in] snapshot queue */
+    ,dlb_pmd_model *src     /**< [in] model to copy */
+    ,unsigned int frame     /**< [in] frame number of the model */
+    )
+{
+    snapshot_slot *slot = &sq->slots[sq->head & (SNAPSHOT_QUEUE_DEPTH-1)];
+    long expected = SNAPSHOT_SLOT_FREE;
+
+    if (pmd_atomic_compare_exchange(&slot->state, &expected, SNAPSHOT_SLOT_WRITING))
+    {
+        if (snapshot_slot_fill(slot, src, frame))
+        {
+            pmd_atomic_fetch_add(&sq->dropped, 1);
+            return PMD_FAIL;
+        }
+        sq->head += 1;
+        return PMD_SUCCESS;
+    }
+
+    slot = &sq->slots[(sq->head - 1) & (SNAPSHOT_QUEUE_DEPTH-1)];
+    expected = SNAPSHOT_SLOT_READY;
+    if (pmd_atomic_compare_exchange(&slot->state, &expected, SNAPSHOT_SLOT_WRITING))
+    {
+        /* a failed copy frees the slot, which the consumer then treats
+         * as the end of the queue, so keep the producer in step */
+        if (snapshot_slot_fill(slot, src, frame))
+        {
+            sq->head -= 1;
+            pmd_atomic_fetch_add(&sq->dropped, 1);
+            return PMD_FAIL;
+        }
+        pmd_atomic_fetch_add(&sq->coalesced, 1);
+        return PMD_SUCCESS;
+    }
+    pmd_atomic_fetch_add(&sq->dropped, 1);
+    return PMD_FAIL;
+}
+
+
+/**
+ * @brief consumer: claim the oldest queued snapshot, if there is one
+ *
+ * The snapshot belongs to the consumer until it calls
+ * #snapshot_queue_release.  This never blocks.
+ */
+static inline
+snapshot_slot *             /** @return claimed slot, or NULL if nothing is ready */
+snapshot_queue_claim
+    (snapshot_queue *sq     /**< [in] snapshot queue */
+    )
+{
+    snapshot_slot *slot = &sq->slots[sq->tail & (SNAPSHOT_QUEUE_DEPTH-1)];
+    long expected = SNAPSHOT_SLOT_READY;
+
+    if (pmd_atomic_compare_exchange(&slot->state, &expected, SNAPSHOT_SLOT_CLAIMED))
+    {
+        return slot;
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief consumer: claim up to @p max of the oldest queued snapshots at once
+ *
+ * Slots are returned oldest first, and must be released in that order.
+ * While the newest queued snapshot is claimed the producer cannot
+ * coalesce into it, so leave room by asking for fewer than
+ * #SNAPSHOT_QUEUE_DEPTH.  This never blocks.
+ */
+static inline
+unsigned int                /** @return number of slots claimed */
+snapshot_queue_claim_batch
+    (snapshot_queue *sq     /**< [in] snapshot queue */
+    ,snapshot_slot **slots  /**< [out] claimed slots */
+    ,unsigned int max       /**< [in] capacity of @p slots */
+    )
+{
+    unsigned int n;
+
+    if (max > SNAPSHOT_QUEUE_DEPTH)
+    {
+        max = SNAPSHOT_QUEUE_DEPTH;
+    }
+    for (n = 0; n != max; ++n)
+    {
+        snapshot_slot *slot = &sq->slots[(sq->tail + n) & (SNAPSHOT_QUEUE_DEPTH-1)];
+        long expected = SNAPSHOT_SLOT_READY;
+
+        if (!pmd_atomic_compare_exchange(&slot->state, &expected, SNAPSHOT_SLOT_CLAIMED))
+        {
+            break;
+        }
+        slots[n] = slot;
+    }
+    return n;
+}
+
+
+/**
+ * @brief consumer: hand a claimed slot back to the producer
+ */
+static inline
+void
+snapshot_queue_release
+    (snapshot_queue *sq     /**< [in] snapshot queue */
+    ,snapshot_slot *slot    /**< [in] slot returned by #snapshot_queue_claim or
+                              *  #snapshot_queue_claim_batch */
+    )
+{
+    sq->tail += 1;
+    pmd_atomic_store(&slot->state, SNAPSHOT_SLOT_FREE);
+}
+
+
+/**
+ * @brief number of snapshots that replaced one the consumer had not yet claimed
+ */
+static inline
+unsigned long
+snapshot_queue_coalesced
+    (snapshot_queue *sq     /**< [in] snapshot queue */
+    )
+{
+    return (unsigned long)pmd_atomic_load(&sq->coalesced);
+}
+
+
+/**
+ * @brief number of snapshots that could not be queued
+ */
+static inline
+unsigned long
+snapshot_queue_dropped
+    (snapshot_queue *sq     /**< [in] snapshot queue */
+    )
+{
+    return (unsigned long)pmd_atomic_load(&sq->dropped);
+}
+
+
+#endif /* __SNAPSHOT_QUEUE_H__ */
@@ -0,0 +1,160 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2019-2020, Dolby Laboratories Inc.
+ * Copyright (c) 2019-2020, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#ifndef _MIX_ENGINE_H_
+#define _MIX_ENGINE_H_
+
+#include <stdint.h>
+#include "mix_matrix.h"
+
+/* Frames mixed per pass; longer callbacks are processed in several passes */
+#define PMD_STUDIO_MIX_BLOCK_FRAMES (256)
+
+/* Planar float scratch used by the audio callback.  Each output is
+ * accumulated over a contiguous run of frames, one input channel at a
+ * time, so that the compiler can turn the multiply-accumulate and the
+ * conversions into vector instructions.
+ */
+struct pmd_studio_mix_engine
+{
+    float in[MAX_INPUT_CHANNELS][PMD_STUDIO_MIX_BLOCK_FRAMES];
+    float acc[PMD_STUDIO_MIX_BLOCK_FRAMES];
+};
+
+/* Largest float below 2^31; anything above would overflow the conversion */
+#define PMD_STUDIO_MIX_FULL_SCALE (2147483520.0f)
+
+inline
+void
+pmd_studio_mix_engine_block
+    (struct pmd_studio_mix_engine *engine
+    ,const struct pmd_studio_comp_mix_matrix *cm
+    ,const int32_t *input
+    ,unsigned int input_stride
+    ,int32_t *output
+    ,unsigned int output_channels
+    ,unsigned int frames
+    )
+{
+    unsigned int num_outputs = cm->size ? cm->num_outputs : 0;
+    unsigned int c,n,k;
+
+    /* de-interleave only the inputs that feed at least one output */
+    for (c = 0 ; c < (cm->size ? cm->num_inputs_used : 0) ; c++)
+    {
+        unsigned int ch = cm->inputs_used[c];
+        float *dst = engine->in[ch];
+        const int32_t *src = input + ch;
+
+        for (k = 0 ; k < frames ; k++)
+        {
+            dst[k] = (float)src[k * input_stride];
+        }
+    }
+
+    for (c = 0 ; c < output_channels ; c++)
+    {
+        float *acc = engine->acc;
+        const float *x;
+        float g;
+        unsigned int begin = c < num_outputs ? cm->output_start[c] : 0;
+        unsigned int end = c < num_outputs ? cm->output_start[c + 1] : 0;
+
+        if (begin == end)
+        {
+            for (k = 0 ; k < frames ; k++)
+            {
+                output[k * output_channels + c] = 0;
+            }
+            continue;
+        }
+
+        x = engine->in[cm->input[begin]];
+        g = cm->coef[begin];
+        for (k = 0 ; k < frames ; k++)
+        {
+            acc[k] = g * x[k];
+        }
+        for (n = begin + 1 ; n < end ; n++)
+        {
+            x = engine->in[cm->input[n]];
+            g = cm->coef[n];
+            for (k = 0 ; k < frames ; k++)
+            {
+                acc[k] += g * x[k];
+            }
+        }
+
+        /* saturate and re-interleave */
+        for (k = 0 ; k < frames ; k++)
+        {
+            float v = acc[k];
+            v = v > PMD_STUDIO_MIX_FULL_SCALE ? PMD_STUDIO_MIX_FULL_SCALE : v;
+            v = v < -PMD_STUDIO_MIX_FULL_SCALE ? -PMD_STUDIO_MIX_FULL_SCALE : v;
+            output[k * output_channels + c] = (int32_t)v;
+        }
+    }
+}
+
+/**
+ * Apply a compressed mix matrix to a buffer of interleaved 32-bit PCM
+ *
+ * Output channels that no coefficient feeds are written as silence.
+ */
+inline
+void
+pmd_studio_mix_engine_run
+    (struct pmd_studio_mix_engine *engine
+    ,const struct pmd_studio_comp_mix_matrix *cm
+    ,const int32_t *input
+    ,unsigned int input_channels
+    ,int32_t *output
+    ,unsigned int output_channels
+    ,unsigned long frames
+    )
+{
+    while (frames > 0)
+    {
+        unsigned int block = frames > PMD_STUDIO_MIX_BLOCK_FRAMES ? PMD_STUDIO_MIX_BLOCK_FRAMES : (unsigned int)frames;
+
+        pmd_studio_mix_engine_block(engine, cm, input, input_channels, output, output_channels, block);
+        input += block * input_channels;
+        output += block * output_channels;
+        frames -= block;
+    }
+}
+
+#endif // _MIX_ENGINE_H_
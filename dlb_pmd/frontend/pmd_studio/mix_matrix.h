@@ -44,12 +44,19 @@
 typedef float pmd_studio_mix_matrix[][MAX_OUTPUT_CHANNELS];
 typedef float pmd_studio_mix_matrix_array[MAX_INPUT_CHANNELS][MAX_OUTPUT_CHANNELS];
 
+/* Non-zero coefficients are stored output-major: the coefficients feeding
+ * output o are entries output_start[o] .. output_start[o+1]-1.
+ */
 struct pmd_studio_comp_mix_matrix
 {
     unsigned int size;
     unsigned int input[MAX_COMP_MIX_MATRIX_SIZE];
     unsigned int output[MAX_COMP_MIX_MATRIX_SIZE];
     float coef[MAX_COMP_MIX_MATRIX_SIZE];
+    unsigned int num_outputs;
+    unsigned int output_start[MAX_OUTPUT_CHANNELS + 1];
+    unsigned int num_inputs_used;
+    unsigned int inputs_used[MAX_INPUT_CHANNELS];
 };
 
 inline
@@ -123,9 +130,12 @@ inline
 void
 compress_mix_matrix(pmd_studio_mix_matrix_array mix_matrix, struct pmd_studio_comp_mix_matrix *comp_mix_matrix, unsigned int input_channels, unsigned int output_channels)
 {
+    bool used[MAX_INPUT_CHANNELS] = { false };
     unsigned int i,j;
 
     comp_mix_matrix->size = 0;
+    comp_mix_matrix->num_outputs = 0;
+    comp_mix_matrix->num_inputs_used = 0;
 
     if ((input_channels > MAX_INPUT_CHANNELS) ||
         (input_channels == 0) ||
@@ -133,30 +143,31 @@ compress_mix_matrix(pmd_studio_mix_matrix_array mix_matrix, struct pmd_studio_co
         (output_channels == 0))
     {
         pmd_studio_error(PMD_STUDIO_ERR_ASSERT, "pmd_studio_device compress_mix_matrix - Invalid number of channels");
+        return;
     }
 
-    for (i = 0 ; i < input_channels ; i++)
+    for (j = 0 ; j < output_channels ; j++)
     {
-        for (j = 0 ; j < output_channels ; j++)
+        comp_mix_matrix->output_start[j] = comp_mix_matrix->size;
+        for (i = 0 ; i < input_channels ; i++)
         {
             if (mix_matrix[i][j] != 0.0)
             {
                 comp_mix_matrix->input[comp_mix_matrix->size] = i;
                 comp_mix_matrix->output[comp_mix_matrix->size] = j;
                 comp_mix_matrix->coef[comp_mix_matrix->size++] = mix_matrix[i][j];
-                if (comp_mix_matrix->size == MAX_COMP_MIX_MATRIX_SIZE)
-                {
-                    break;
-                }
-            }
-            if (comp_mix_matrix->size == MAX_COMP_MIX_MATRIX_SIZE)
-            {
-                break;
+                used[i] = true;
             }
         }
-        if (comp_mix_matrix->size == MAX_COMP_MIX_MATRIX_SIZE)
+    }
+    comp_mix_matrix->output_start[output_channels] = comp_mix_matrix->size;
+    comp_mix_matrix->num_outputs = output_channels;
+
+    for (i = 0 ; i < input_channels ; i++)
+    {
+        if (used[i])
         {
-            break;
+            comp_mix_matrix->inputs_used[comp_mix_matrix->num_inputs_used++] = i;
         }
     }
 }
@@ -987,11 +987,9 @@ disable_audio_output(
 
 static
 dlb_pmd_success
-get_sadm_payload(dlb_pmd_model_combo *model, void *payload, unsigned int &max_payload_size)
+get_sadm_payload(sadm_bitstream_encoder *enc, dlb_pmd_model_combo *model, void *payload, unsigned int &max_payload_size)
 {
-    sadm_bitstream_encoder *enc;
     int sadm_payload_bytes;
-    size_t sadm_end_mem_size;
 
     const dlb_adm_core_model *core_model = NULL;
 
@@ -1001,17 +999,6 @@ get_sadm_payload(dlb_pmd_model_combo *model, void *payload, unsigned int &max_pa
         return (PMD_FAIL);
     }
 
-    sadm_end_mem_size = sadm_bitstream_encoder_query_mem();
-    void *mem = malloc(sadm_end_mem_size);
-
-    if(mem == nullptr)
-    {
-        pmd_studio_error(PMD_STUDIO_ERR_MEMORY, "Could not allocate memory for S-ADM/PMD encoder");
-        return(PMD_FAIL);
-    }
-
-    sadm_bitstream_encoder_init(mem, &enc);
-
     if (!dlb_pmd_model_combo_ensure_readable_core_model(model, &core_model))
     {
         sadm_payload_bytes = sadm_bitstream_encoder_payload(enc, core_model, (uint8_t *)payload);
@@ -1033,6 +1020,276 @@ get_sadm_payload(dlb_pmd_model_combo *model, void *payload, unsigned int &max_pa
     return (PMD_SUCCESS);
 }
 
+/**
+ * Returns PMD_TRUE if two metadata outputs carry identical buffers
+ */
+static
+dlb_pmd_bool
+metadata_outputs_match
+    (const pmd_studio_metadata_output *a
+    ,const pmd_studio_metadata_output *b
+    )
+{
+    return (a->format == b->format &&
+            a->smpte337_wrapped == b->smpte337_wrapped &&
+            a->subframemode == b->subframemode &&
+            a->frame_rate == b->frame_rate) ? PMD_TRUE : PMD_FALSE;
+}
+
+static
+dlb_pmd_bool
+metadata_encoder_matches
+    (const pmd_studio_metadata_encoder *enc
+    ,const pmd_studio_metadata_output *mout
+    )
+{
+    return (enc->in_use &&
+            enc->format == mout->format &&
+            enc->smpte337_wrapped == mout->smpte337_wrapped &&
+            enc->wrap_depth == METADATA_WRAP_DEPTH &&
+            enc->subframemode == mout->subframemode &&
+            enc->frame_rate == mout->frame_rate) ? PMD_TRUE : PMD_FALSE;
+}
+
+static
+void
+release_metadata_encoder
+    (pmd_studio_metadata_encoder *enc
+    )
+{
+    if (enc->aug != nullptr)
+    {
+        dlb_pcmpmd_augmentor_finish(enc->aug);
+    }
+    free(enc->mem);
+    enc->in_use = PMD_FALSE;
+    enc->aug = nullptr;
+    enc->senc = nullptr;
+    enc->mem = nullptr;
+}
+
+/**
+ * Find the encoder for an output's configuration, creating it if this is
+ * the first output to use it.  Encoders no enabled output uses any more
+ * make way for new ones.
+ */
+static
+pmd_studio_metadata_encoder *
+get_metadata_encoder
+    (pmd_studio_metadata_output *mout
+    ,dlb_pmd_model_combo *model
+    )
+{
+    pmd_studio_outputs *outs = mout->outputs;
+    pmd_studio_metadata_encoder *enc = nullptr;
+    unsigned int i;
+    unsigned int j;
+
+    for (i = 0; i < MAX_METADATA_OUTPUTS; i++)
+    {
+        if (metadata_encoder_matches(&outs->metadata_encoders[i], mout))
+        {
+            enc = &outs->metadata_encoders[i];
+            if (enc->model != model)
+            {
+                if (enc->aug != nullptr)
+                {
+                    dlb_pcmpmd_augmentor_set_model(enc->aug, model);
+                }
+                else
+                {
+                    // Drops the payload cached for the old model
+                    sadm_bitstream_encoder_track_changes(enc->senc, PMD_TRUE);
+                }
+                enc->model = model;
+            }
+            return enc;
+        }
+    }
+
+    for (i = 0; i < MAX_METADATA_OUTPUTS; i++)
+    {
+        pmd_studio_metadata_encoder *e = &outs->metadata_encoders[i];
+        dlb_pmd_bool used = PMD_FALSE;
+
+        for (j = 0; e->in_use && j < outs->metadata_output_count; j++)
+        {
+            if (outs->metadata_outputs[j].enabled && metadata_encoder_matches(e, &outs->metadata_outputs[j]))
+            {
+                used = PMD_TRUE;
+            }
+        }
+        if (!used)
+        {
+            release_metadata_encoder(e);
+            if (enc == nullptr)
+            {
+                enc = e;
+            }
+        }
+    }
+    if (enc == nullptr)
+    {
+        pmd_studio_error(PMD_STUDIO_ERR_ASSERT, "No free S-ADM/PMD encoder");
+        return nullptr;
+    }
+
+    dlb_pmd_bool sadm = (mout->format == SADM_OUTPUT_MODE)? PMD_TRUE : PMD_FALSE;
+    enc->mem = malloc(mout->smpte337_wrapped ? dlb_pcmpmd_augmentor_query_mem(sadm) : sadm_bitstream_encoder_query_mem());
+    if (enc->mem == nullptr)
+    {
+        pmd_studio_error(PMD_STUDIO_ERR_MEMORY, "Could not allocate memory for S-ADM/PMD encoder");
+        return nullptr;
+    }
+
+    if (mout->smpte337_wrapped)
+    {
+        dlb_pmd_bool pair;
+        unsigned int num_channels;
+        if(mout->subframemode)
+        {
+            pair = PMD_FALSE;
+            num_channels = 1;
+        }
+        else
+        {
+            pair = PMD_TRUE;
+            num_channels = 2;
+        }
+        dlb_pcmpmd_augmentor_init3(&enc->aug, model, enc->mem, METADATA_WRAP_DEPTH, METADATA_DLB_PMD_FRAME_RATE, DLB_PMD_KLV_UL_ST2109, PMD_FALSE, num_channels, num_channels, pair, 0, sadm);
+    }
+    else
+    {
+        sadm_bitstream_encoder_init(enc->mem, &enc->senc);
+        sadm_bitstream_encoder_track_changes(enc->senc, PMD_TRUE);
+    }
+
+    enc->in_use = PMD_TRUE;
+    enc->format = mout->format;
+    enc->smpte337_wrapped = mout->smpte337_wrapped;
+    enc->wrap_depth = METADATA_WRAP_DEPTH;
+    enc->subframemode = mout->subframemode;
+    enc->frame_rate = mout->frame_rate;
+    enc->model = model;
+    return enc;
+}
+
+static
+void
+commit_metadata_buffer
+    (PMDStudioRingBufferList *ring_buffer_list
+    ,pmd_studio_metadata_output *mout
+    ,unsigned int size_bytes
+    )
+{
+    if (mout->smpte337_wrapped)
+    {
+        // Queue new buffer for update
+        ring_buffer_list->CommitUpdate(mout->channel);
+    }
+    else
+    {
+        // Commit with a fit to the data i.e. no padding
+        ring_buffer_list->CommitUpdate(mout->channel, size_bytes);
+    }
+}
+
+/**
+ * Encode the model into the buffer for a metadata output, then copy it to
+ * every other enabled output with the same configuration that has not yet
+ * been updated.  Updated outputs are marked in the updated array, if given.
+ */
+static
+dlb_pmd_success
+update_metadata_output_group
+    (pmd_studio_metadata_output *mout
+    ,dlb_pmd_bool *updated
+    )
+{
+    pmd_studio_outputs *outs = mout->outputs;
+    PMDStudioRingBufferList *ring_buffer_list = pmd_studio_device_get_ring_buffer_list(outs->studio);
+    dlb_pmd_model_combo *combo_model = pmd_studio_get_model(outs->studio);
+    pmd_studio_metadata_encoder *enc;
+    unsigned int newbuf_size_bytes = 0;
+    unsigned int commit_size_bytes;
+    void *newbuf;
+
+    if (!mout->smpte337_wrapped && mout->format != SADM_OUTPUT_MODE)
+    {
+        pmd_studio_error(PMD_STUDIO_ERR_UI, "PMD over SMPTE ST 2110-41 is not supported");
+        return(PMD_FAIL);
+    }
+
+    enc = get_metadata_encoder(mout, combo_model);
+    if (enc == nullptr)
+    {
+        return(PMD_FAIL);
+    }
+
+    newbuf = ring_buffer_list->GetBufferForUpdate(mout->channel, newbuf_size_bytes);
+    commit_size_bytes = newbuf_size_bytes;
+
+    if (!mout->smpte337_wrapped)
+    {
+        // No SMPTE wrapping so just get payload
+        if (get_sadm_payload(enc->senc, combo_model, newbuf, commit_size_bytes) == PMD_FAIL)
+        {
+            return(PMD_FAIL);
+        }
+    }
+    else
+    {
+        // Reset augmentor error flag and callback arg
+        mout->augmentor_error = PMD_FALSE;
+#if LATER
+        model->error_cbarg = (void *) mout;
+#endif
+        // Start wrapping from the beginning of the buffer, as a new augmentor would
+        dlb_pcmpmd_augmentor_restart(enc->aug);
+
+        if(mout->augmentor_error == PMD_FALSE)
+        {
+            unsigned int num_channels = mout->subframemode ? 1 : 2;
+            unsigned int num_frames = newbuf_size_bytes / (sizeof(uint32_t) * num_channels);
+            dlb_pcmpmd_augment(enc->aug, (uint32_t *)newbuf, num_frames , 0);
+        }
+        else
+        {
+            // Force disable metadata output
+            uiCheckboxSetChecked(mout->enable, 0);
+            onEnableMetadataOutput(mout->enable, mout);
+            return PMD_FAIL;
+        }
+    }
+
+    for (unsigned int i = 0; updated != nullptr && i < outs->metadata_output_count; i++)
+    {
+        pmd_studio_metadata_output *other = &outs->metadata_outputs[i];
+        unsigned int other_size_bytes;
+        void *otherbuf;
+
+        if (other == mout)
+        {
+            updated[i] = PMD_TRUE;
+        }
+        else if (other->enabled && !updated[i] && metadata_outputs_match(other, mout))
+        {
+            otherbuf = ring_buffer_list->GetBufferForUpdate(other->channel, other_size_bytes);
+            // Buffers are sized by configuration, so this only guards against a
+            // mismatch; such an output is left to be encoded on its own
+            if (other_size_bytes == newbuf_size_bytes)
+            {
+                memcpy(otherbuf, newbuf, commit_size_bytes);
+                commit_metadata_buffer(ring_buffer_list, other, commit_size_bytes);
+                updated[i] = PMD_TRUE;
+            }
+        }
+    }
+
+    commit_metadata_buffer(ring_buffer_list, mout, commit_size_bytes);
+    return PMD_SUCCESS;
+}
+
 
 /* Public Functions */
 
@@ -1063,6 +1320,11 @@ pmd_studio_outputs_init
     (*outs)->metadata_output_count = 0;
     (*outs)->num_presentations = 0;
 
+    for (i = 0 ; i < MAX_METADATA_OUTPUTS ; i++)
+    {
+        memset(&(*outs)->metadata_encoders[i], 0, sizeof(pmd_studio_metadata_encoder));
+    }
+
    /* Do channels init here to avoid having yet another function */
     for (i = 0 ; i < MAX_OUTPUT_CHANNELS ; i++)
     {
@@ -1464,6 +1726,11 @@ pmd_studio_outputs_reset
         uiControlDestroy(uiControl(ao1->metadata_outputs[i].chan));
     }
 
+    for (i = 0 ; i < MAX_METADATA_OUTPUTS ; i++)
+    {
+        release_metadata_encoder(&ao1->metadata_encoders[i]);
+    }
+
     ao1->audio_output_count = 0;
     ao1->metadata_output_count = 0;
     ao1->num_presentations = 0;
@@ -1478,6 +1745,10 @@ pmd_studio_outputs_finish
 {
 	if (ao1)
 	{
+        for (unsigned int i = 0 ; i < MAX_METADATA_OUTPUTS ; i++)
+        {
+            release_metadata_encoder(&ao1->metadata_encoders[i]);
+        }
     	free(ao1);
     }
     return(PMD_SUCCESS);
@@ -1488,81 +1759,9 @@ pmd_studio_audio_outputs_update_metadata_output
     (pmd_studio_metadata_output *mout
     )
 {
-    void *newbuf;
-    unsigned int newbuf_size_bytes = 0;
-    PMDStudioRingBufferList *ring_buffer_list = pmd_studio_device_get_ring_buffer_list(mout->outputs->studio);
-
     if(mout != nullptr)
     {
-        dlb_pmd_model_combo *combo_model = pmd_studio_get_model(mout->outputs->studio);
-
-        newbuf = ring_buffer_list->GetBufferForUpdate(mout->channel, newbuf_size_bytes);
-
-        if (!mout->smpte337_wrapped)
-        {
-            if (mout->format == SADM_OUTPUT_MODE)
-            {
-                // No SMPTE wrapping so just get payload
-                get_sadm_payload(combo_model, newbuf, newbuf_size_bytes);
-                // Commit with a fit to the data i.e. no padding
-                ring_buffer_list->CommitUpdate(mout->channel, newbuf_size_bytes);
-            }
-            else
-            {
-                pmd_studio_error(PMD_STUDIO_ERR_UI, "PMD over SMPTE ST 2110-41 is not supported");
-                return(PMD_FAIL);
-            }
-        }
-        else
-        {
-            // Reset augmentor error flag and callback arg
-            mout->augmentor_error = PMD_FALSE;
-    #if LATER
-            model->error_cbarg = (void *) mout;
-    #endif
-
-            dlb_pmd_bool sadm = (mout->format == SADM_OUTPUT_MODE)? PMD_TRUE : PMD_FALSE;
-            void *mem = malloc(dlb_pcmpmd_augmentor_query_mem(sadm));
-            if(mem == nullptr){
-                pmd_studio_error(PMD_STUDIO_ERR_MEMORY, "Could not allocate memory for S-ADM/PMD encoder");
-                return(PMD_FAIL);
-            }
-            dlb_pmd_bool pair;
-            unsigned int num_channels;
-            if(mout->subframemode)
-            {
-                pair = PMD_FALSE;
-                num_channels = 1;
-            }
-            else
-            {
-                pair = PMD_TRUE;
-                num_channels = 2;
-            }
-            dlb_pcmpmd_augmentor *aug;
-            unsigned int wrap_depth = 0;    // TODO: add a SMPTE 337m wrapping bit depth UI element and use the value here
-            dlb_pcmpmd_augmentor_init3(&aug, combo_model, mem, wrap_depth, METADATA_DLB_PMD_FRAME_RATE, DLB_PMD_KLV_UL_ST2109, PMD_FALSE, num_channels, num_channels, pair, 0, sadm);
-
-            if(mout->augmentor_error == PMD_FALSE)
-            {
-                unsigned int num_frames = newbuf_size_bytes / (sizeof(uint32_t) * num_channels);
-                dlb_pcmpmd_augment(aug, (uint32_t *)newbuf, num_frames , 0);
-                dlb_pcmpmd_augmentor_finish(aug);
-
-                free(mem);
-                // Queue new buffer for update
-                ring_buffer_list->CommitUpdate(mout->channel);
-            }
-            else
-            {
-                free(mem);
-                // Force disable metadata output
-                uiCheckboxSetChecked(mout->enable, 0);
-                onEnableMetadataOutput(mout->enable, mout);
-                return PMD_FAIL;
-            }
-        }
-        return PMD_SUCCESS;
+        return update_metadata_output_group(mout, nullptr);
     }
     return PMD_FAIL;
 }
@@ -1572,12 +1771,15 @@ pmd_studio_audio_outputs_update_metadata_outputs(
     pmd_studio* s
     )
 {
+    dlb_pmd_bool updated[MAX_METADATA_OUTPUTS] = { PMD_FALSE };
+
+    // Outputs sharing a configuration are encoded once and copied
     for(unsigned int i = 0; i<s->outputs->metadata_output_count; i++)
     {
         pmd_studio_metadata_output *mout = &s->outputs->metadata_outputs[i];
-        if(mout->enabled)
+        if(mout->enabled && !updated[i])
         {
-            pmd_studio_audio_outputs_update_metadata_output(mout);
+            update_metadata_output_group(mout, updated);
         }
     }
 };
@@ -58,6 +58,8 @@ static const dlb_pmd_speaker_config pmd_studio_output_config[PMD_STUDIO_OUTPUT_N
 #define METADATA_MAX_CHANNELS (2)
 #define METADATA_MAX_BYTES_PER_SAMPLE (4)
 #define MAX_PCM_BUF_SIZE (METADATA_SAMPLES_PER_FRAME * METADATA_MAX_CHANNELS * METADATA_MAX_BYTES_PER_SAMPLE)
+// TODO: add a SMPTE 337m wrapping bit depth UI element and use the value here
+#define METADATA_WRAP_DEPTH (0)
 
 
 typedef struct
@@ -98,12 +100,30 @@ struct pmd_studio_metadata_output
     dlb_pmd_bool augmentor_error;
 };
 
+// Long-lived encoder shared by all enabled metadata outputs with the same
+// format, wrapping, wrap depth, channel mode and frame rate, as they all
+// carry an identical buffer: the model is serialized once for all of them
+typedef struct
+{
+    dlb_pmd_bool in_use;
+    pmd_studio_metadata_format format;
+    dlb_pmd_bool smpte337_wrapped;
+    unsigned int wrap_depth;
+    dlb_pmd_bool subframemode;
+    pmd_studio_video_frame_rate frame_rate;
+    dlb_pmd_model_combo *model;     // model being encoded
+    dlb_pcmpmd_augmentor *aug;      // for SMPTE 337m wrapped outputs
+    sadm_bitstream_encoder *senc;   // for S-ADM payload-only outputs
+    void *mem;
+} pmd_studio_metadata_encoder;
+
 struct pmd_studio_outputs
 {
     pmd_studio *studio;
     uiWindow *window;
     pmd_studio_audio_output audio_outputs[MAX_AUDIO_OUTPUTS];
     pmd_studio_metadata_output metadata_outputs[MAX_METADATA_OUTPUTS];
+    pmd_studio_metadata_encoder metadata_encoders[MAX_METADATA_OUTPUTS];
 
     /* add in a count field to the struct for how many of the allocated outputs are intialized */
     unsigned int audio_output_count;
@@ -42,7 +42,7 @@
 #include <iostream>
 #include <string.h>
 #include "pmd_studio_device_pvt.h"
-#include "mix_matrix.h"
+#include "mix_engine.h"
 
 #if defined(_WIN32) || defined(_WIN64)
 
@@ -196,9 +196,6 @@ recordCallback( const void *inputBuffer, void *outputBuffer,
                            void *userData
                )
 {
-    int *readPtr = (int *)inputBuffer;
-    int *writePtr = (int *)outputBuffer;
-    unsigned int i,j;
     pmd_studio_device *device = (pmd_studio_device *)userData;
     struct pmd_studio_comp_mix_matrix *cm = device->active_comp_mix_matrix;
 
@@ -208,19 +205,10 @@ recordCallback( const void *inputBuffer, void *outputBuffer,
     if( inputBuffer != NULL )
     {
         // First run mixing matrix in compressed form
-        for( i = 0; i < framesPerBuffer ; i++ )
-        {
-            for (j = 0 ; j < (unsigned int)device->outputParameters.channelCount ; j++)
-            {
-                writePtr[j] = 0;
-            }
-            for (j = 0 ; j < cm->size ; j++)
-            {
-                writePtr[cm->output[j]] += readPtr[cm->input[j]] * cm->coef[j]; /* TODO: clarify mixed-types arithmetic -- where do we truncate? */
-            }
-            writePtr += device->outputParameters.channelCount;
-            readPtr += device->inputParameters.channelCount;
-        }
+        pmd_studio_mix_engine_run(&device->mix_engine, cm,
+                                  (const int32_t *)inputBuffer, device->inputParameters.channelCount,
+                                  (int32_t *)outputBuffer, device->outputParameters.channelCount,
+                                  framesPerBuffer);
         // Now add ring buffers
         device->ring_buffer_list->WriteRingBuffers((int32_t *)outputBuffer, device->outputParameters.channelCount, framesPerBuffer);
     }
@@ -42,6 +42,7 @@
 #include "am824_framer.h"
 #include "portaudio.h"
 #include "ring_buffer.h"
+#include "mix_engine.h"
 #include <mutex>
 extern "C"{
 #include "ui.h"
@@ -73,6 +74,7 @@ struct pmd_studio_device
     struct pmd_studio_comp_mix_matrix comp_mix_matrix1;
     struct pmd_studio_comp_mix_matrix comp_mix_matrix2;
     struct pmd_studio_comp_mix_matrix *active_comp_mix_matrix;    
+    struct pmd_studio_mix_engine    mix_engine;
     PMDStudioRingBufferList         *ring_buffer_list;
     dlb_pmd_bool                    am824_mode;
     char                            input_device_names[MAX_DEVICES][MAX_DEVICE_NAME_LENGTH];
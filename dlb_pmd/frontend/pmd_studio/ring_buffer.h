@@ -37,7 +37,10 @@
 #ifndef __RING_BUFFER_H__
 #define __RING_BUFFER_H__
 
+#include <atomic>
+#include <cmath>
 #include <mutex>
+#include <thread>
 #include <vector>
 #include <memory>
 #include <cstring>
@@ -53,48 +56,109 @@ static const unsigned int numBuffers = 3; // Active, queued and editable
 
 class PMDStudioRingBufferList
 {
+    // Triple buffer shared between editors (UI and metadata threads) and
+    // a reader (the audio or stream callback).  The reader owns the
+    // active buffer and editors own the edit buffer; the third buffer is
+    // handed between them with a single atomic exchange, flagged when it
+    // holds a commit the reader has not yet picked up.  The reader never
+    // takes a lock, allocates or throws.
+    //
+    // Reconfiguration (Enable/Disable) clears 'enabled' and waits for any
+    // reader already inside to leave; readers arriving meanwhile see the
+    // ring as disabled and skip it.
     class PMDStudioRingBuffer
     {
+        static const unsigned int bufferIndexMask = 0x3;
+        static const unsigned int queuedFlag = 0x4;
 
-        bool enabled;
+        std::atomic<bool> enabled;
+        std::atomic<bool> reading;
         uint32_t *buffers[numBuffers]; 
-        std::mutex ringBufferMutex;
+        unsigned int bufferSizeBytes[numBuffers];
+        std::mutex editMutex;
 
         unsigned int startChannel;
         unsigned int numChannels;
-        unsigned int nextSampleIndex;
         unsigned int maxPcmBufSamples;
+        std::atomic<pmd_studio_video_frame_rate> frameRate;
+
+        // Editor state, guarded by editMutex
+        unsigned int bufSizeBytes;
+        unsigned int commitBufSizeBytes;
+        unsigned int edited;
+        bool editing;
+
+        // Buffer in hand-over, possibly with queuedFlag set
+        std::atomic<unsigned int> queued;
+
+        // Reader state
+        unsigned int active;
+        bool haveActive;
+        unsigned int nextSampleIndex;
         unsigned int frameRateCadenceIndex;
-        pmd_studio_video_frame_rate frameRate;
         unsigned int numSamples;
-        unsigned int bufSizeBytes;
-        unsigned int activeBufSizeBytes;        
-        // Three references
-        int active;
-        int queued;
-        int edited;
+
+        // Wait until no reader is using the buffers; 'enabled' must already be false
+        void WaitForReader(void)
+        {
+            while (reading.load())
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        void ResetIndices(void)
+        {
+            active = 0;
+            haveActive = false;
+            queued.store(1);
+            edited = 2;
+            editing = false;
+        }
+
+        // Reader: pick up the most recent commit, if there is one
+        void TakeQueued(void)
+        {
+            if (queued.load(std::memory_order_relaxed) & queuedFlag)
+            {
+                active = queued.exchange(active, std::memory_order_acq_rel) & bufferIndexMask;
+                haveActive = true;
+            }
+        }
+
+        // Editor: publish the edit buffer and take the previous hand-over buffer in its place
+        void Publish(void)
+        {
+            bufferSizeBytes[edited] = commitBufSizeBytes;
+            edited = queued.exchange(edited | queuedFlag, std::memory_order_acq_rel) & bufferIndexMask;
+            editing = false;
+        }
 
     public:
 
         PMDStudioRingBuffer(
             unsigned int newstartChannel): // Number of SMPTE frames (samples / channels)
             enabled(false),
+            reading(false),
             startChannel(newstartChannel),
             numChannels(0),
-            nextSampleIndex(0),
             maxPcmBufSamples(0),
-            frameRateCadenceIndex(0),
             frameRate(INVALID_FRAME_RATE),
-            numSamples(0),
             bufSizeBytes(0),
-            activeBufSizeBytes(0),
-            active(-1),
-            queued(-1),
-            edited(-1)
+            commitBufSizeBytes(0),
+            edited(2),
+            editing(false),
+            queued(1),
+            active(0),
+            haveActive(false),
+            nextSampleIndex(0),
+            frameRateCadenceIndex(0),
+            numSamples(0)
         {
             for (unsigned int i = 0 ; i < numBuffers ; i++)
             {
                 buffers[i] = nullptr;
+                bufferSizeBytes[i] = 0;
             }
         }
 
@@ -110,28 +174,31 @@ class PMDStudioRingBufferList
                      pmd_studio_video_frame_rate newFrameRate)
         {
             unsigned int maxNumSamples;
+            unsigned int newNumSamples;
+
+            if ((newNumChannels == 0) ||
+                (newNumChannels == 0))
+            {
+                throw std::runtime_error("number of ring buffer channels or frames can't be zero");
+            }
 
             // frameRate = INVALID signals data mode and not wrapping
             // frame rate timing will be handled by the stream
             if (newFrameRate == INVALID_FRAME_RATE)
             {
                 maxNumSamples = MAX_DATA_BYTES / sizeof(uint32_t);
-                numSamples = maxNumSamples;
+                newNumSamples = maxNumSamples;
             }
             else
             {
                 maxNumSamples = newNumChannels * pmd_studio_video_frame_rate_max_frames[newFrameRate];
-                numSamples = pmd_studio_video_frame_rate_cadence[newFrameRate][frameRateCadenceIndex++] * newNumChannels;
-           }
-
-            if ((newNumChannels == 0) ||
-                (newNumChannels == 0))
-            {
-                throw std::runtime_error("number of ring buffer channels or frames can't be zero");
+                newNumSamples = pmd_studio_video_frame_rate_cadence[newFrameRate][0] * newNumChannels;
             }
-            ringBufferMutex.lock();
+
+            std::lock_guard<std::mutex> lock(editMutex);
+            enabled.store(false);
+            WaitForReader();
             // Rescale buffers if required
-            ;
             if (maxNumSamples > maxPcmBufSamples)
             {
                 for (unsigned int i = 0 ; i < numBuffers ; i++)
@@ -145,27 +212,27 @@ class PMDStudioRingBufferList
                 maxPcmBufSamples = maxNumSamples;
             }
             numChannels = newNumChannels;
+            numSamples = newNumSamples;
             bufSizeBytes = numSamples * sizeof(uint32_t);
-            activeBufSizeBytes = bufSizeBytes;
+            commitBufSizeBytes = bufSizeBytes;
             nextSampleIndex = 0;
-            frameRateCadenceIndex = 0;
-            frameRate = newFrameRate;
-            enabled = true;
-            active = queued = edited = -1;
-            ringBufferMutex.unlock();
+            frameRateCadenceIndex = (newFrameRate == INVALID_FRAME_RATE) ? 0 : 1;
+            frameRate.store(newFrameRate);
+            ResetIndices();
+            enabled.store(true);
         }
 
         bool isEnabled()
         {
-            return(enabled);
+            return(enabled.load());
         }
 
         void Disable(void)
         {
-            ringBufferMutex.lock();
-            active = queued = edited = -1;
-            enabled = false;
-            ringBufferMutex.unlock();
+            std::lock_guard<std::mutex> lock(editMutex);
+            enabled.store(false);
+            WaitForReader();
+            ResetIndices();
         }
 
 
@@ -191,31 +258,18 @@ class PMDStudioRingBufferList
 
         pmd_studio_video_frame_rate GetFrameRate(void)
         {
-            return frameRate;
+            return frameRate.load(std::memory_order_relaxed);
         }
 
         void *GetBufferForUpdate(unsigned int &retBufSizeBytes)
         {
-            ringBufferMutex.lock();
-            if (!enabled)
+            std::lock_guard<std::mutex> lock(editMutex);
+            if (!enabled.load())
             {
-                ringBufferMutex.unlock();
                 throw std::runtime_error("Tried to get buffer from disabled ring buffer");
             }
-            // Create new buffer 
-            int newForEdited = 0;
-            while (((newForEdited == active) || (newForEdited == queued)) && (newForEdited < (int)numBuffers))
-            {
-                newForEdited++;
-            }
-            if (newForEdited == numBuffers)
-            {
-                ringBufferMutex.unlock();                
-                throw std::runtime_error("Can't find free buffer");
-            }
-            edited = newForEdited;
-            ringBufferMutex.unlock();
-            retBufSizeBytes = bufSizeBytes;             
+            editing = true;
+            retBufSizeBytes = bufSizeBytes;
             return (buffers[edited]);
         }
 
@@ -223,15 +277,12 @@ class PMDStudioRingBufferList
         // The buffer is queued for update at the end of the next frame
         void CommitUpdate(void)
         {
-            ringBufferMutex.lock();
-            if (edited < 0)
+            std::lock_guard<std::mutex> lock(editMutex);
+            if (!editing)
             {
-                ringBufferMutex.unlock();        
                 return;
             }
-            queued = edited;
-            edited = -1;
-            ringBufferMutex.unlock();        
+            Publish();
         }
 
         // This commits the edits that have taken place
@@ -240,84 +291,81 @@ class PMDStudioRingBufferList
         // the data so eliminating the padding normally associated with the ring buffer
         void CommitUpdate(unsigned int newBufSizeBytes)
         {
-            ringBufferMutex.lock();
-            if (edited < 0)
+            std::lock_guard<std::mutex> lock(editMutex);
+            if (!editing)
             {
-                ringBufferMutex.unlock();        
                 return;
             }
-            queued = edited;
-            edited = -1;
             unsigned int newPcmBufSamples = ceil(newBufSizeBytes / (float)sizeof(int32_t));
-            activeBufSizeBytes = newBufSizeBytes; // avoids round up to sample
             // Check that requested size is not more than allocated size
             if (newPcmBufSamples > maxPcmBufSamples)
             {
+                editing = false;
                 throw std::runtime_error("Trying to commit larger buffer than exists");
-
             }
-            else if (newPcmBufSamples < maxPcmBufSamples)
+            commitBufSizeBytes = newBufSizeBytes; // avoids round up to sample
+            if (newPcmBufSamples < maxPcmBufSamples)
             {
-                numSamples = newPcmBufSamples;
-                bufSizeBytes = numSamples * sizeof(int32_t);
+                bufSizeBytes = newPcmBufSamples * sizeof(int32_t);
             }
-            ringBufferMutex.unlock();        
+            Publish();
         }
 
 
-        // lock
-        void Lock()
+        // Reader: claim the buffers for the duration of a callback.
+        // Returns false, without waiting, if the ring is disabled,
+        // being reconfigured or already claimed by another reader
+        bool TryBeginRead()
         {
-            ringBufferMutex.lock();
+            if (reading.exchange(true))
+            {
+                return(false);
+            }
+            if (!enabled.load())
+            {
+                reading.store(false);
+                return(false);
+            }
+            return(true);
         }
 
-        void Unlock()
+        void EndRead()
         {
-            ringBufferMutex.unlock();
-            // Now see if there are any queued updates
+            reading.store(false, std::memory_order_release);
         }
 
-        // Get exact bytes in the buffer with no sample padding
-        unsigned int GetEntireActiveBufferBytes(uint32_t*& ptr)
+        // Copy out the most recently committed buffer with no sample padding
+        unsigned int CopyEntireActiveBufferBytes(uint32_t *destPtr)
         {
-            if (active < 0)
+            unsigned int numBytes = 0;
+
+            if (!TryBeginRead())
             {
-                if (queued >= 0)
-                {
-                    active = queued;
-                    queued = -1;                
-                }
-                else
-                {
-                    ptr = NULL;
-                    return(0);
-                }
+                return(0);
             }
-            ptr = &buffers[active][0];
-
-            if (queued >= 0)
+            TakeQueued();
+            if (haveActive)
             {
-                active = queued;
-                queued = -1;
+                numBytes = bufferSizeBytes[active];
+                memcpy(destPtr, buffers[active], numBytes);
             }
-
-            return(activeBufSizeBytes);
+            EndRead();
+            return(numBytes);
         }
 
+        // Must be called between TryBeginRead() and EndRead()
         uint32_t GetNextWord()
         {
-            if (frameRate == INVALID_FRAME_RATE)
+            pmd_studio_video_frame_rate rate = frameRate.load(std::memory_order_relaxed);
+
+            if (rate == INVALID_FRAME_RATE)
             {
-                throw std::runtime_error("INVALID_FRAME_RATE");
+                return(0);
             }
-            if (active < 0)
+            if (!haveActive)
             {
-                if (queued >= 0)
-                {
-                    active = queued;
-                    queued = -1;                
-                }
-                else
+                TakeQueued();
+                if (!haveActive)
                 {
                     return(0);
                 }
@@ -326,23 +374,19 @@ class PMDStudioRingBufferList
             if (nextSampleIndex >= numSamples)
             {
                 nextSampleIndex = 0;
-                numSamples = pmd_studio_video_frame_rate_cadence[frameRate][frameRateCadenceIndex++] * numChannels;
+                numSamples = pmd_studio_video_frame_rate_cadence[rate][frameRateCadenceIndex++] * numChannels;
                 if (frameRateCadenceIndex >= NUM_VIDEO_FRAME_RATE_CADENCE)
                 {
                     frameRateCadenceIndex = 0;
                 }
-                if (queued >= 0)
-                {
-                    active = queued;
-                    queued = -1;
-                }
+                TakeQueued();
             }
             return(nextWord);
         }
 
         uint32_t PeekNextWord()
         {
-            if (active < 0)
+            if (!haveActive)
             {
                 return(0);
             }
@@ -351,18 +395,19 @@ class PMDStudioRingBufferList
 
         void PrintDebug(void)
         {
-            ringBufferMutex.lock();
             printf("\tStart Channel: %u\n", GetStartChannel());
             printf("\tNumber of Channel: %u\n", GetNumChannels());
-            printf("\tFrame Rate: %ffps\n", pmd_studio_video_frame_rate_floats[frameRate]);
+            printf("\tFrame Rate: %ffps\n", pmd_studio_video_frame_rate_floats[GetFrameRate()]);
             printf("\tFrame Rate Cadence Index: %u\n", frameRateCadenceIndex);
-            printf("\tCurrent buffer wrap point: %u\n", pmd_studio_video_frame_rate_cadence[frameRate][frameRateCadenceIndex]);
+            printf("\tCurrent buffer wrap point: %u\n", pmd_studio_video_frame_rate_cadence[GetFrameRate()][frameRateCadenceIndex]);
             printf("\tindex: %u\n", GetWordIndex());
             printf("\tBuffer Size in Frames: %u\n", GetBufferFrames());
-            ringBufferMutex.unlock();
         }
     };
 
+    // The vector is filled once at construction and never resized, so
+    // readers can walk it without locking; listMutex only serialises
+    // reconfiguration
     std::vector<std::shared_ptr<PMDStudioRingBuffer>> bufferVector;
     std::mutex listMutex;
 
@@ -388,17 +433,15 @@ public:
         unsigned int numChannels,
         pmd_studio_video_frame_rate frameRate)
     {
-        listMutex.lock();
+        std::lock_guard<std::mutex> lock(listMutex);
         bufferVector[startChannel]->Enable(numChannels, frameRate);
-        listMutex.unlock();
     }
 
 
     void DeleteRingBuffer(unsigned int startChannel)
     {
-        listMutex.lock();
+        std::lock_guard<std::mutex> lock(listMutex);
         bufferVector[startChannel]->Disable();
-        listMutex.unlock();
     }
 
     void CommitUpdate(unsigned int startChannel)
@@ -416,15 +459,18 @@ public:
         return(bufferVector[startChannel]->GetBufferForUpdate(bufSizeBytes));
     }
 
+    // Called from the real-time callback: never blocks
     void WriteRingBuffers(int32_t *outputBuffer, unsigned int outBufChannelCount, unsigned int framesToWrite)
     {
-        // This lock is required to protect iterator from list deletion
-        listMutex.lock();
         for (std::vector<std::shared_ptr<PMDStudioRingBuffer>>::iterator i = bufferVector.begin() ; i < bufferVector.end() ; i++)
         {   
-            (*i)->Lock();
-            // If frame rate is invalid then this is a -41 stream and shoud not be included in the outgoing multiplex
-            if ((*i)->isEnabled() && ((*i)->GetFrameRate() != INVALID_FRAME_RATE))
+            // If frame rate is invalid then this is a -41 stream and shoud not be included in the outgoing multiplex.
+            // Check before claiming so that the stream's own reader is not turned away
+            if (((*i)->GetFrameRate() == INVALID_FRAME_RATE) || !(*i)->TryBeginRead())
+            {
+                continue;
+            }
+            if ((*i)->GetFrameRate() != INVALID_FRAME_RATE)
             {
                 int32_t *writePtr = (int32_t *) outputBuffer;
                 writePtr += (*i)->GetStartChannel();
@@ -438,22 +484,19 @@ public:
                     writePtr += outBufChannelCount - numRingBufferChannels;
                 }
             }
-            (*i)->Unlock();
+            (*i)->EndRead();
         }
-        listMutex.unlock();
     }
 
     unsigned int CopyEntireActiveBufferBytes(unsigned int startChannel, uint32_t *destPtr)
     {
-        uint32_t *srcPtr;
-        unsigned int numBytes = bufferVector[startChannel]->GetEntireActiveBufferBytes(srcPtr);
-        memcpy(destPtr, srcPtr, numBytes);
-        return(numBytes);
+        return(bufferVector[startChannel]->CopyEntireActiveBufferBytes(destPtr));
     }
 
 
     void Reset(void)
     {
+        std::lock_guard<std::mutex> lock(listMutex);
         for (std::vector<std::shared_ptr<PMDStudioRingBuffer>>::iterator i = bufferVector.begin() ; i < bufferVector.end() ; i++)
         {
             (*i)->Disable();
@@ -462,7 +505,7 @@ public:
 
     void PrintDebug(void)
     {
-        listMutex.lock();
+        std::lock_guard<std::mutex> lock(listMutex);
         printf("Number of ring buffers: %lu\n", bufferVector.size());
         unsigned int j = 1;
         for (std::vector<std::shared_ptr<PMDStudioRingBuffer>>::iterator i = bufferVector.begin() ; i < bufferVector.end() ; i++)
@@ -470,11 +513,9 @@ public:
             printf("Ring Buffer#%u\n---- --------\n", j++);
             (*i)->PrintDebug();
         }
-        listMutex.unlock();
     }
 
 
 };
 
 #endif // __RING_BUFFER_H__
-
@@ -56,7 +56,7 @@ extern "C"{
 #include "dlb_st2110_logging.h"
 #include "dlb_st2110_api.h"
 #include "mclock.h"
-#include "mix_matrix.h"
+#include "mix_engine.h"
 
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -100,9 +100,6 @@ bool RxTxCallback(void *data,
                   unsigned int outputBytes
                   )
 {
-    int32_t *readPtr = (int32_t *)inputAudio;
-    int32_t *writePtr = (int32_t *)outputAudio;
-    unsigned int i,j;
     pmd_studio_device *device = (pmd_studio_device *)data;
     struct pmd_studio_comp_mix_matrix *cm = device->active_comp_mix_matrix;
     // frames per buffer is same for input and output buffer channels may not be
@@ -112,20 +109,10 @@ bool RxTxCallback(void *data,
     if( framesPerBuffer > 0 )
     {
         // First run mixing matrix in compressed form
-        for( i = 0; i < framesPerBuffer ; i++ )
-        {
-            // Replace this loop with memset outside all loops for speed
-            for (j = 0 ; j < device->input_stream_info.audio.numChannels ; j++)
-            {
-                writePtr[j] = 0;
-            }
-            for (j = 0 ; j < cm->size ; j++)
-            {
-                writePtr[cm->output[j]] += readPtr[cm->input[j]] * cm->coef[j]; /* TODO: clarify mixed-types arithmetic -- where do we truncate? */
-            }
-            writePtr += device->input_stream_info.audio.numChannels;
-            readPtr += device->input_stream_info.audio.numChannels;
-        }
+        pmd_studio_mix_engine_run(&device->mix_engine, cm,
+                                  (const int32_t *)inputAudio, device->input_stream_info.audio.numChannels,
+                                  (int32_t *)outputAudio, device->input_stream_info.audio.numChannels,
+                                  framesPerBuffer);
 	    // Now add ring buffers
         device->ring_buffer_list->WriteRingBuffers((int32_t *) outputAudio, device->input_stream_info.audio.numChannels, framesPerBuffer);
     }
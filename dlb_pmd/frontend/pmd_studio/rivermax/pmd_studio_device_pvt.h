@@ -46,6 +46,7 @@
 #include "dlb_st2110_api.h"
 #include "pmd_studio_device_settings.h"
 #include "ring_buffer.h"
+#include "mix_engine.h"
 
 #define MAX_NUM_INTERFACES (16)
 #define MAX_NUM_INPUT_STREAMS (128) // Max number to choose from. There is one received stream
@@ -78,6 +79,7 @@ struct pmd_studio_device
     struct pmd_studio_comp_mix_matrix comp_mix_matrix1;
     struct pmd_studio_comp_mix_matrix comp_mix_matrix2;
     struct pmd_studio_comp_mix_matrix *active_comp_mix_matrix;    
+    struct pmd_studio_mix_engine    mix_engine;
     unsigned int                    num_ring_buffers;
     PMDStudioRingBufferList         *ring_buffer_list;
     StreamInfo                      input_stream_info;
@@ -50,6 +50,7 @@
 
 #include "dlb_pmd_api.h"
 #include "dlb_pmd_pcm.h"
+#include "pmd_os.h"
 #include "pcm_vsync_timer.h"
 #include "pcm.h"
 
@@ -69,48 +70,200 @@
 #endif
 
 
-#define MAX_CHANNELS (256)
-#define BLOCK_SIZE (256)
 #define OUTPUT_PCM_BIT_DEPTH (24)
 
-static uint32_t channeldata[MAX_CHANNELS * BLOCK_SIZE];
-static uint32_t *ppdata[MAX_CHANNELS];
+
+/**
+ * @def PIPELINE_BLOCKS
+ * @brief number of PCM blocks in flight between the stages of a pipelined conversion
+ */
+#define PIPELINE_BLOCKS (16)
+
+
+/**
+ * @brief stages of a PCM conversion, in the order a block passes through them
+ */
+typedef enum
+{
+    PCM_STAGE_READ,         /**< decode a block from the input file */
+    PCM_STAGE_PROCESS,      /**< augment the block with, or extract, PMD */
+    PCM_STAGE_WRITE,        /**< encode the block to the output file */
+    PCM_NUM_STAGES
+} pcm_stage_id;
+
+
+/**
+ * @brief one block of interleaved PCM, handed from stage to stage
+ */
+typedef struct
+{
+    uint32_t     *data;     /**< block_size sample sets of nchans samples each */
+    size_t        count;    /**< number of sample sets read into the block */
+    dlb_pmd_bool  last;     /**< no blocks follow this one */
+} pcm_block;
+
+
+/**
+ * @brief progress of one stage of a pipelined conversion
+ *
+ * Each stage works through the blocks in order, so the queue between
+ * a stage and the one feeding it is just the difference of their
+ * #done counts; the blocks themselves live in a ring of
+ * #PIPELINE_BLOCKS.  Only the stage itself writes its count, so the
+ * queues need no locks.  The doorbell merely lets a stage sleep while
+ * its queue is empty: the stage feeding it rings it after every
+ * block, and a stage only waits on it once it has seen the queue
+ * empty, so a wake-up can never be lost.
+ */
+typedef struct
+{
+    pmd_atomic     done;        /**< number of blocks this stage has finished with */
+    pmd_semaphore  doorbell;    /**< rung whenever the stage feeding this one finishes a block */
+} pcm_stage;
+
+
+/**
+ * @brief state of a single PCM conversion
+ */
+typedef struct
+{
+    dlb_wave_file  source;                  /**< input file */
+    dlb_wave_file  sink;                    /**< output file, if #has_sink */
+    dlb_pmd_bool   has_sink;                /**< is there an output file? */
+    unsigned int   nchans;                  /**< number of channels in both files */
+    size_t         block_size;              /**< maximum number of sample sets per block */
+
+    dlb_buffer     inbuf;                   /**< reader's view of the current block */
+    dlb_buffer     outbuf;                  /**< writer's view of the current block */
+    void         **ppdata;                  /**< channel pointers of #inbuf and #outbuf */
+    int            write_status;            /**< first failure writing the output file */
+    uint64_t       processed;               /**< number of sample sets processed */
+
+    unsigned int   nblocks;                 /**< 1 for a serial conversion, #PIPELINE_BLOCKS otherwise */
+    pcm_block     *blocks;                  /**< ring of blocks */
+    uint32_t      *samples;                 /**< sample memory of all blocks */
+
+    unsigned int   nstages;                 /**< number of stages taking part */
+    pcm_stage      stages[PCM_NUM_STAGES];  /**< per-stage progress of a pipelined conversion */
+    pmd_atomic     failed;                  /**< set when the writer fails, to stop the reader */
+} pcm_stream;
+
+
+/**
+ * @brief callback performing the processing stage on a block
+ */
+typedef void (*pcm_process_fn)(void *arg, pcm_block *block);
 
 
 static inline
 void
 buffer_init
     (dlb_buffer *buf
+    ,void      **ppdata
     ,unsigned    nchannel
     )
 {
-    unsigned int i;
-
     buf->nchannel  = nchannel;
     buf->nstride   = nchannel;
     buf->data_type = DLB_BUFFER_INT_LEFT;
-    buf->ppdata    = (void**)ppdata;
+    buf->ppdata    = ppdata;
+}
+
+
+static inline
+void
+buffer_point
+    (dlb_buffer *buf
+    ,uint32_t   *data
+    )
+{
+    unsigned int i;
 
-    for (i = 0; i != nchannel; ++i)
+    for (i = 0; i != buf->nchannel; ++i)
     {
-        ppdata[i] = &channeldata[i];
+        buf->ppdata[i] = &data[i];
     }
 }
 
 
+/**
+ * @brief limit the block size so that no block spans more than one video sync
+ *
+ * The augmentor and extractor take at most one video sync position
+ * per block, and the vsync timer only reports a sync that falls
+ * strictly inside a block, so a block must be shorter than the
+ * shortest frame of the frame rate.
+ */
+static
+size_t
+limit_block_size
+    (dlb_pmd_frame_rate  rate
+    ,size_t              block_size
+    )
+{
+    size_t i;
+
+    if (0 == block_size)
+    {
+        block_size = PCM_DEFAULT_BLOCK_SIZE;
+    }
+    for (i = 0; i != VF_CYCLE; ++i)
+    {
+        if (block_size >= VF_SPACING[rate][i])
+        {
+            block_size = VF_SPACING[rate][i] - 1;
+        }
+    }
+    return block_size;
+}
+
+
+/**
+ * @brief get memory for an augmentor or extractor
+ *
+ * Without a workspace the memory is allocated for this conversion
+ * alone; otherwise the workspace's memory is grown if need be, and
+ * kept for the next conversion.
+ */
+static
+void *                          /** @return memory, or NULL if allocation failed */
+workspace_get
+    (pcm_workspace *ws          /**< [in] workspace, or NULL */
+    ,size_t         size        /**< [in] number of bytes required */
+    )
+{
+    if (NULL == ws)
+    {
+        return malloc(size);
+    }
+    if (ws->size < size)
+    {
+        free(ws->mem);
+        ws->mem  = malloc(size);
+        ws->size = (NULL == ws->mem) ? 0 : size;
+    }
+    return ws->mem;
+}
+
+
+/**
+ * @brief give back memory obtained by #workspace_get
+ */
 static inline
 void
-buffer_shift
-    (dlb_buffer *buf
-    ,size_t      skip
-    ,size_t      amount
+workspace_put
+    (pcm_workspace *ws
+    ,void          *mem
     )
 {
-    size_t sample_set_size = sizeof(uint32_t) * buf->nstride;
-    memmove(channeldata, (channeldata + (skip * sample_set_size)), (sample_set_size * amount));
+    if (NULL == ws)
+    {
+        free(mem);
+    }
 }
 
 
+
 static inline
 int
 open_files
@@ -284,6 +437,429 @@ payload_set_status_callback
     return 0;   /* This callback just prints debug info and should never signal failure */
 }
 
+
+
+/**
+ * @brief open the files of a conversion and allocate its blocks
+ */
+static
+int                                     /** @return 0 on success, 1 on failure */
+pcm_stream_open
+    (pcm_stream          *s             /**< [in] conversion to set up */
+    ,const char          *infile        /**< [in] name of PCM file to read */
+    ,const char          *outfile       /**< [in] name of PCM file to write, or NULL */
+    ,dlb_pmd_frame_rate   rate          /**< [in] video frame rate */
+    ,size_t               block_size    /**< [in] requested block size, 0 for the default */
+    ,dlb_pmd_bool         pipeline      /**< [in] run the stages concurrently? */
+    )
+{
+    size_t block_samples;
+    unsigned int i;
+
+    memset(s, 0, sizeof(*s));
+
+    s->has_sink = (NULL != outfile);
+    if (open_files(infile, outfile, &s->source, s->has_sink ? &s->sink : NULL, &s->nchans))
+    {
+        return 1;
+    }
+
+    s->block_size = limit_block_size(rate, block_size);
+    s->nblocks    = pipeline ? PIPELINE_BLOCKS : 1;
+    s->nstages    = s->has_sink ? PCM_NUM_STAGES : PCM_STAGE_WRITE;
+
+    block_samples = s->block_size * s->nchans;
+    s->ppdata  = (void **)malloc(sizeof(void *) * 2 * s->nchans);
+    s->blocks  = (pcm_block *)malloc(sizeof(pcm_block) * s->nblocks);
+    s->samples = (uint32_t *)malloc(sizeof(uint32_t) * block_samples * s->nblocks);
+    if (NULL == s->ppdata || NULL == s->blocks || NULL == s->samples)
+    {
+        printf("ERROR: could not allocate memory\n");
+        goto error;
+    }
+
+    for (i = 0; i != s->nblocks; ++i)
+    {
+        s->blocks[i].data  = &s->samples[i * block_samples];
+        s->blocks[i].count = 0;
+        s->blocks[i].last  = PMD_FALSE;
+    }
+    buffer_init(&s->inbuf, s->ppdata, s->nchans);
+    buffer_init(&s->outbuf, s->ppdata + s->nchans, s->nchans);
+
+    if (pipeline)
+    {
+        for (i = 0; i != s->nstages; ++i)
+        {
+            pmd_atomic_init(&s->stages[i].done, 0);
+            if (pmd_semaphore_init(&s->stages[i].doorbell, "pcmstage", 0))
+            {
+                while (i--)
+                {
+                    pmd_semaphore_finish(&s->stages[i].doorbell);
+                }
+                s->nblocks = 1;
+                goto error;
+            }
+        }
+        pmd_atomic_init(&s->failed, 0);
+    }
+    return 0;
+
+  error:
+    free(s->samples);
+    free(s->blocks);
+    free(s->ppdata);
+    if (s->has_sink)
+    {
+        dlb_wave_close(&s->sink);
+    }
+    dlb_wave_close(&s->source);
+    return 1;
+}
+
+
+/**
+ * @brief close the files of a conversion and release its memory
+ */
+static
+void
+pcm_stream_close
+    (pcm_stream *s              /**< [in] conversion to finish */
+    )
+{
+    unsigned int i;
+
+    if (s->nblocks > 1)
+    {
+        for (i = 0; i != s->nstages; ++i)
+        {
+            pmd_semaphore_finish(&s->stages[i].doorbell);
+        }
+    }
+    if (s->has_sink)
+    {
+        dlb_wave_end_data(&s->sink);
+        dlb_wave_close(&s->sink);
+    }
+    dlb_wave_close(&s->source);
+    free(s->samples);
+    free(s->blocks);
+    free(s->ppdata);
+}
+
+
+/**
+ * @brief read the next block of the input file
+ */
+static inline
+void
+pcm_stream_read
+    (pcm_stream *s
+    ,pcm_block  *block
+    )
+{
+    int res;
+
+    buffer_point(&s->inbuf, block->data);
+    res = dlb_wave_int_read(&s->source, &s->inbuf, s->block_size, &block->count);
+    block->last = (0 != res);
+}
+
+
+/**
+ * @brief write a block to the output file, unless writing has already failed
+ */
+static inline
+void
+pcm_stream_write
+    (pcm_stream *s
+    ,pcm_block  *block
+    )
+{
+    int res;
+
+    if (0 == s->write_status && 0 < block->count)
+    {
+        buffer_point(&s->outbuf, block->data);
+        res = dlb_wave_int_write(&s->sink, &s->outbuf, block->count);
+        if (res)
+        {
+            printf("ERROR: could not write: %d\n", res);
+            s->write_status = res;
+        }
+    }
+}
+
+
+/**
+ * @brief wait until the given block has reached the given stage
+ */
+static
+pcm_block *                     /** @return block to work on */
+pcm_stream_acquire
+    (pcm_stream   *s
+    ,pcm_stage_id  stage
+    ,long          index        /**< [in] number of blocks the stage has finished so far */
+    )
+{
+    pcm_stage *self = &s->stages[stage];
+
+    if (PCM_STAGE_READ == stage)
+    {
+        /* the reader recycles blocks the final stage is done with */
+        pmd_atomic *drained = &s->stages[s->nstages - 1].done;
+
+        while (index - pmd_atomic_load(drained) >= (long)s->nblocks)
+        {
+            (void)pmd_semaphore_wait(&self->doorbell);
+        }
+    }
+    else
+    {
+        pmd_atomic *filled = &s->stages[stage - 1].done;
+
+        while (pmd_atomic_load(filled) <= index)
+        {
+            (void)pmd_semaphore_wait(&self->doorbell);
+        }
+    }
+    return &s->blocks[index % s->nblocks];
+}
+
+
+/**
+ * @brief hand the given block on to the next stage
+ */
+static
+void
+pcm_stream_release
+    (pcm_stream   *s
+    ,pcm_stage_id  stage
+    ,long          index
+    )
+{
+    pmd_atomic_store(&s->stages[stage].done, index + 1);
+    (void)pmd_semaphore_signal(&s->stages[(stage + 1) % s->nstages].doorbell);
+}
+
+
+static
+void *
+pcm_reader_thread
+    (void *arg
+    )
+{
+    pcm_stream *s = (pcm_stream *)arg;
+    pcm_block *block;
+    dlb_pmd_bool last;
+    long i;
+
+    for (i = 0, last = PMD_FALSE; !last; ++i)
+    {
+        block = pcm_stream_acquire(s, PCM_STAGE_READ, i);
+        if (pmd_atomic_load(&s->failed))
+        {
+            block->count = 0;
+            block->last  = PMD_TRUE;
+        }
+        else
+        {
+            pcm_stream_read(s, block);
+        }
+        last = block->last;
+        pcm_stream_release(s, PCM_STAGE_READ, i);
+    }
+    return NULL;
+}
+
+
+static
+void *
+pcm_writer_thread
+    (void *arg
+    )
+{
+    pcm_stream *s = (pcm_stream *)arg;
+    pcm_block *block;
+    dlb_pmd_bool last;
+    long i;
+
+    for (i = 0, last = PMD_FALSE; !last; ++i)
+    {
+        block = pcm_stream_acquire(s, PCM_STAGE_WRITE, i);
+        pcm_stream_write(s, block);
+        if (s->write_status)
+        {
+            /* keep draining, so that the reader is never left waiting */
+            pmd_atomic_store(&s->failed, 1);
+        }
+        last = block->last;
+        pcm_stream_release(s, PCM_STAGE_WRITE, i);
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief run a conversion: read, process and (optionally) write every block
+ *
+ * A serial conversion runs the stages one after the other on each
+ * block.  A pipelined one decodes the input on a reader thread and
+ * encodes the output on a writer thread, so that file I/O overlaps
+ * with the processing done on the calling thread.  Both see exactly
+ * the same sequence of blocks.
+ */
+static
+int                             /** @return 0 on success, 1 if the conversion failed */
+pcm_stream_run
+    (pcm_stream     *s          /**< [in] conversion to run */
+    ,pcm_process_fn  process    /**< [in] processing stage */
+    ,void           *arg        /**< [in] argument of processing stage */
+    )
+{
+    pmd_thread reader;
+    pmd_thread writer;
+    pcm_block *block;
+    dlb_pmd_bool last;
+    long i;
+
+    if (1 == s->nblocks)
+    {
+        block = &s->blocks[0];
+        do
+        {
+            pcm_stream_read(s, block);
+            if (0 < block->count)
+            {
+                s->processed += block->count;
+                process(arg, block);
+                if (s->has_sink)
+                {
+                    pcm_stream_write(s, block);
+                }
+            }
+        } while (!block->last && 0 == s->write_status);
+        return (0 != s->write_status);
+    }
+
+    if (pmd_thread_init(&reader, pcm_reader_thread, s, PMD_THREAD_PRIORITY_NORMAL, 0, 0))
+    {
+        printf("ERROR: could not create reader thread\n");
+        return 1;
+    }
+    if (s->has_sink
+        && pmd_thread_init(&writer, pcm_writer_thread, s, PMD_THREAD_PRIORITY_NORMAL, 0, 0))
+    {
+        printf("ERROR: could not create writer thread\n");
+        /* the reader stops straight away, without waiting for a writer */
+        pmd_atomic_store(&s->failed, 1);
+        (void)pmd_thread_join(&reader, NULL);
+        pmd_thread_finish(&reader);
+        return 1;
+    }
+
+    (void)pmd_thread_set_name(&reader, "pcm_reader");
+    (void)pmd_thread_start(&reader);
+    if (s->has_sink)
+    {
+        (void)pmd_thread_set_name(&writer, "pcm_writer");
+        (void)pmd_thread_start(&writer);
+    }
+
+    for (i = 0, last = PMD_FALSE; !last; ++i)
+    {
+        block = pcm_stream_acquire(s, PCM_STAGE_PROCESS, i);
+        if (0 < block->count && !pmd_atomic_load(&s->failed))
+        {
+            s->processed += block->count;
+            process(arg, block);
+        }
+        last = block->last;
+        pcm_stream_release(s, PCM_STAGE_PROCESS, i);
+    }
+
+    (void)pmd_thread_join(&reader, NULL);
+    pmd_thread_finish(&reader);
+    if (s->has_sink)
+    {
+        (void)pmd_thread_join(&writer, NULL);
+        pmd_thread_finish(&writer);
+    }
+    return (0 != s->write_status);
+}
+
+
+
+/**
+ * @brief state of the processing stage of #pcm_read
+ */
+typedef struct
+{
+    dlb_pcmpmd_extractor *ext;          /**< PMD extractor */
+    unsigned int          nchans;       /**< number of channels in a sample set */
+    vsync_timer           vt;           /**< video sync position */
+    size_t                skip;         /**< samples left to skip */
+    unsigned int          block_count;  /**< blocks seen in the current frame */
+    unsigned int          frame_count;  /**< frames seen */
+    unsigned int          error_count;  /**< blocks that failed to decode */
+} pcm_extraction;
+
+
+static
+void
+extract_block
+    (void      *arg
+    ,pcm_block *block
+    )
+{
+    pcm_extraction *x = (pcm_extraction *)arg;
+    uint32_t *pcm = block->data;
+    size_t read = block->count;
+    size_t video_sync;
+
+    if (x->skip)
+    {
+        if (x->skip > read)
+        {
+            (void)vsync_timer_add_samples(&x->vt, read);
+            x->skip -= read;
+            return;
+        }
+        (void)vsync_timer_add_samples(&x->vt, x->skip);
+        read -= x->skip;
+        pcm  += x->skip * x->nchans;
+        x->skip = 0;
+    }
+
+    video_sync = vsync_timer_add_samples(&x->vt, read);
+    if (video_sync != DLB_PMD_VSYNC_NONE) { TRACE(("video sync in %u\n", video_sync)); }
+    if (dlb_pcmpmd_extract(x->ext, pcm, read, video_sync))
+    {
+        const char *msg = dlb_pcmpmd_extractor_error_msg(x->ext);
+
+        if (msg[0] == '\0')
+        {
+            msg = "error";
+        }
+        printf("%s", msg);
+        printf("    at block %u of frame %u\n", x->block_count, x->frame_count);
+        x->error_count += 1;
+    }
+    else if (x->block_count == 0)
+    {
+        /* we got a good first frame */
+        x->error_count = 0;
+    }
+    x->block_count += 1;
+    if (video_sync)
+    {
+        x->block_count = 0;
+        x->frame_count += 1;
+    }
+}
+
+
 int
 pcm_read
     (const char             *infile
@@ -293,21 +869,16 @@ pcm_read
     ,dlb_pmd_bool            is_pair
     ,size_t                  vsync
     ,size_t                  skip
+    ,size_t                  block_size
+    ,dlb_pmd_bool            pipeline
+    ,pcm_workspace          *ws
     ,dlb_pmd_model_combo    *model
     )
 {
-    dlb_pcmpmd_extractor    *ext;
-    dlb_wave_file            source;
-    dlb_buffer               buffer;
-    unsigned int             nchans;
-    unsigned int             block_count;
-    unsigned int             frame_count;
-    unsigned int             error_count;
-    size_t                   read;
+    pcm_extraction           x;
+    pcm_stream               s;
     size_t                   sz;
     void                    *mem;
-    vsync_timer              vt;
-    size_t                   video_sync;
     FILE                    *filelog = NULL;
     dlb_pmd_bool             close_log_file = PMD_FALSE;
     dlb_pmd_success          success;
@@ -320,15 +891,16 @@ pcm_read
     memset(&payload_set_status, 0, sizeof(payload_set_status));
 
     sz  = dlb_pcmpmd_extractor_query_mem(PMD_TRUE);
-    mem = malloc(sz);
+    mem = workspace_get(ws, sz);
     if (NULL == mem)
     {
         printf("ERROR: could not allocate memory\n");
         return 1;
     }
 
-    if (open_files(infile, NULL, &source, NULL, &nchans))
+    if (pcm_stream_open(&s, infile, NULL, rate, block_size, pipeline))
     {
+        workspace_put(ws, mem);
         return 1;
     }
 
@@ -341,12 +913,14 @@ pcm_read
         else if (strcmp(logfile, "stderr") == 0)
         {
             filelog = stderr;
-        } 
+        }
         else
         {
             filelog = fopen(logfile, "w");
             if (filelog == NULL)
             {
+                pcm_stream_close(&s);
+                workspace_put(ws, mem);
                 return 1;
             }
             close_log_file = PMD_TRUE;
@@ -357,81 +931,71 @@ pcm_read
     {
         success = dlb_pmd_initialize_payload_set_status_with_callback(&payload_set_status, update_array, DLB_PMD_MAX_UPDATES, (void *)filelog, payload_set_status_callback);
         payload_set_status.count_frames = PMD_TRUE;
-    } 
+    }
     else
     {
         success = dlb_pmd_initialize_payload_set_status(&payload_set_status, update_array, DLB_PMD_MAX_UPDATES);
     }
     if (success != PMD_SUCCESS)
     {
+        if (close_log_file)
+        {
+            fclose(filelog);
+        }
+        pcm_stream_close(&s);
+        workspace_put(ws, mem);
         return 1;
     }
 
-    dlb_pcmpmd_extractor_init2(&ext, mem, rate, chan, nchans, is_pair, model, &payload_set_status, 1);
-
-    buffer_init(&buffer, nchans);
-    vsync_timer_init(&vt, rate, vsync);
+    dlb_pcmpmd_extractor_init2(&x.ext, mem, rate, chan, s.nchans, is_pair, model, &payload_set_status, 1);
 
-    frame_count = 0;
-    block_count = 0;
-    error_count = 0;
+    vsync_timer_init(&x.vt, rate, vsync);
+    x.nchans      = s.nchans;
+    x.skip        = skip;
+    x.frame_count = 0;
+    x.block_count = 0;
+    x.error_count = 0;
 
-    res = 0;
-    while (0 == res)
+    res = pcm_stream_run(&s, extract_block, &x);
+    if (NULL != ws)
     {
-        res = dlb_wave_int_read(&source, &buffer, BLOCK_SIZE, &read);
-        if (0 < read)
-        {
-            if (skip)
-            {
-                if (skip > read)
-                {
-                    (void)vsync_timer_add_samples(&vt, read);
-                    skip -= read;
-                    continue;
-                }
-                (void)vsync_timer_add_samples(&vt, skip);
-                read -= skip;
-                buffer_shift(&buffer, skip, read);
-                skip = 0;
-            }
-
-            video_sync = vsync_timer_add_samples(&vt, read);
-            if (video_sync != DLB_PMD_VSYNC_NONE) { TRACE(("video sync in %u\n", video_sync)); }
-            if (dlb_pcmpmd_extract(ext, channeldata, read, video_sync))
-            {
-                const char *msg = dlb_pcmpmd_extractor_error_msg(ext);
-
-                if (msg[0] == '\0')
-                {
-                    msg = "error";
-                }
-                printf("%s", msg);
-                printf("    at block %u of frame %u\n", block_count, frame_count);
-                error_count += 1;
-            }
-            else if (block_count == 0)
-            {
-                /* we got a good first frame */
-                error_count = 0;
-            }
-            block_count += 1;
-            if (video_sync)
-            {
-                block_count = 0;
-                frame_count += 1;
-            }
-        }
+        ws->samples = s.processed;
     }
 
-    dlb_pcmpmd_extractor_finish(ext);
-    dlb_wave_close(&source);
+    dlb_pcmpmd_extractor_finish(x.ext);
+    pcm_stream_close(&s);
     if (close_log_file)
     {
         fclose(filelog);
     }
-    free(mem);
-    return (error_count != 0);
+    workspace_put(ws, mem);
+    return res || (x.error_count != 0);
+}
+
+
+/**
+ * @brief state of the processing stage of #pcm_write
+ */
+typedef struct
+{
+    dlb_pcmpmd_augmentor *aug;          /**< PMD augmentor */
+    vsync_timer           vt;           /**< video sync position */
+    size_t                video_sync;   /**< video sync position in the previous block */
+} pcm_augmentation;
+
+
+static
+void
+augment_block
+    (void      *arg
+    ,pcm_block *block
+    )
+{
+    pcm_augmentation *a = (pcm_augmentation *)arg;
+
+    if (a->video_sync != DLB_PMD_VSYNC_NONE) { TRACE(("video sync in %u\n", a->video_sync)); }
+    a->video_sync = vsync_timer_add_samples(&a->vt, block->count);
+    dlb_pcmpmd_augment(a->aug, block->data, block->count, a->video_sync);
 }
 
 
@@ -445,67 +1009,68 @@ pcm_write
     ,dlb_klvpmd_universal_label  ul
     ,dlb_pmd_bool                mark_empty_blocks
     ,dlb_pmd_bool                sadm
+    ,size_t                      block_size
+    ,dlb_pmd_bool                pipeline
+    ,pcm_workspace              *ws
     ,dlb_pmd_model_combo        *model
     )
 {
-    dlb_pcmpmd_augmentor      *aug;
-    dlb_wave_file              source;
-    dlb_wave_file              sink;
-    dlb_buffer                 buffer;
-    unsigned int               nchans;
-    size_t                     read;
+    pcm_augmentation           a;
+    pcm_stream                 s;
     size_t                     sz;
     void                      *mem;
-    vsync_timer                vt;
-    size_t                     video_sync;
     int                        res;
 
     sz  = dlb_pcmpmd_augmentor_query_mem(sadm);
-    mem = malloc(sz);
+    mem = workspace_get(ws, sz);
     if (NULL == mem)
     {
         printf("ERROR: could not allocate memory\n");
         return 1;
     }
 
-    if (open_files(infile, outfile, &source, &sink, &nchans))
+    if (pcm_stream_open(&s, infile, outfile, rate, block_size, pipeline))
     {
-        free(mem);
+        workspace_put(ws, mem);
         return 1;
     }
 
-    dlb_pcmpmd_augmentor_init2(&aug, model, mem, rate, ul, mark_empty_blocks,
-                               nchans, nchans, is_pair, chan, sadm);
+    dlb_pcmpmd_augmentor_init2(&a.aug, model, mem, rate, ul, mark_empty_blocks,
+                               s.nchans, s.nchans, is_pair, chan, sadm);
 
-    buffer_init(&buffer, nchans);
-    vsync_timer_init(&vt, rate, 0);
+    vsync_timer_init(&a.vt, rate, 0);
+    a.video_sync = 0;
 
-    res = 0;
-    video_sync = 0;
-    while (0 == res)
+    res = pcm_stream_run(&s, augment_block, &a);
+    if (NULL != ws)
     {
-        res = dlb_wave_int_read(&source, &buffer, BLOCK_SIZE, &read);
-        if (0 < read)
-        {
-            if (video_sync != DLB_PMD_VSYNC_NONE) { TRACE(("video sync in %u\n", video_sync)); }
-            video_sync = vsync_timer_add_samples(&vt, read);
-            dlb_pcmpmd_augment(aug, channeldata, read, video_sync);
-            res = dlb_wave_int_write(&sink, &buffer, read);
-            if (res)
-            {
-                printf("ERROR: could not write: %d\n", res);
-                break;
-            }
-        }
+        ws->samples = s.processed;
     }
 
-    dlb_pcmpmd_augmentor_finish(aug);
+    dlb_pcmpmd_augmentor_finish(a.aug);
+    pcm_stream_close(&s);
+    workspace_put(ws, mem);
+
+    return res;
+}
+
 
-    dlb_wave_end_data(&sink);
-    dlb_wave_close(&sink);
-    dlb_wave_close(&source);
+void
+pcm_workspace_init
+    (pcm_workspace *ws
+    )
+{
+    ws->mem     = NULL;
+    ws->size    = 0;
+    ws->samples = 0;
+}
 
-    free(mem);
 
-    return 0;
+void
+pcm_workspace_finish
+    (pcm_workspace *ws
+    )
+{
+    free(ws->mem);
+    pcm_workspace_init(ws);
 }
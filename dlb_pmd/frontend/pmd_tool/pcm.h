@@ -49,6 +49,46 @@
 #define MAX_FILENAME_LEN (256)
 
 
+/**
+ * @def PCM_DEFAULT_BLOCK_SIZE
+ * @brief default number of sample sets processed at a time
+ */
+#define PCM_DEFAULT_BLOCK_SIZE (256)
+
+
+/**
+ * @brief memory kept from one conversion to the next
+ *
+ * A thread converting many files can pass the same workspace to
+ * every call, so that the augmentor/extractor memory is allocated
+ * only once.  A workspace must not be shared between threads.
+ */
+typedef struct
+{
+    void     *mem;      /**< augmentor or extractor memory */
+    size_t    size;     /**< size of #mem, in bytes */
+    uint64_t  samples;  /**< number of sample sets processed by the last conversion */
+} pcm_workspace;
+
+
+/**
+ * @brief set up an empty workspace
+ */
+void
+pcm_workspace_init
+    (pcm_workspace *ws      /**< [in] workspace to initialize */
+    );
+
+
+/**
+ * @brief release the memory of a workspace
+ */
+void
+pcm_workspace_finish
+    (pcm_workspace *ws      /**< [in] workspace to finish */
+    );
+
+
 /**
  * @brief extract SMPTE 337m-wrapped KLV from input PCM wave file
  */
@@ -61,6 +101,9 @@ pcm_read
     ,dlb_pmd_bool            is_pair    /**< [in]  1: decode pair, 0: decode single channel */
     ,size_t                  vsync      /**< [in]  number of samples until vsync */
     ,size_t                  skip       /**< [in]  number of samples to skip (to simulate random access) */
+    ,size_t                  block_size /**< [in]  sample sets per block (0: default), shorter than a video frame */
+    ,dlb_pmd_bool            pipeline   /**< [in]  decode the file on a separate thread? */
+    ,pcm_workspace          *ws         /**< [in]  workspace to reuse, or NULL */
     ,dlb_pmd_model_combo    *model      /**< [out] destination struct for model */
     );
 
@@ -79,5 +122,8 @@ pcm_write
     ,dlb_pmd_bool                mark_empty_blocks  /**< [in] mark empty PMD blocks with SMPTE 337m NULL data bursts
                                                       *       (default is to leave them silent) */
     ,dlb_pmd_bool                sadm               /**< [in] generate sADM instead of PMD? */
+    ,size_t                      block_size         /**< [in] sample sets per block (0: default), shorter than a video frame */
+    ,dlb_pmd_bool                pipeline           /**< [in] decode and encode the files on separate threads? */
+    ,pcm_workspace              *ws                 /**< [in] workspace to reuse, or NULL */
     ,dlb_pmd_model_combo        *model              /**< [in] PMD model to write */
     );
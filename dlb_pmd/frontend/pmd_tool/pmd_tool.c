@@ -45,6 +45,12 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <limits.h>
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <dirent.h>
+#  include <time.h>
+#endif
 
 #include "pmd_tool.h"
 
@@ -54,6 +60,7 @@
 #include "xml.h"
 #include "pmd_tool_klv.h"
 #include "pcm.h"
+#include "pmd_os.h"
 
 #include "pmd_tool_build_version.h"
 
@@ -65,6 +72,27 @@ static const char *FRAME_RATE_NAMES[] =
 #define NUM_FRAME_RATE_NAMES ((sizeof FRAME_RATE_NAMES)/(sizeof FRAME_RATE_NAMES[0]))
 
 
+/**
+ * @def DEFAULT_BATCH_JOBS
+ * @brief default number of worker threads in batch mode
+ */
+#define DEFAULT_BATCH_JOBS (4)
+
+
+/**
+ * @def MAX_BATCH_JOBS
+ * @brief maximum number of worker threads in batch mode
+ */
+#define MAX_BATCH_JOBS (64)
+
+
+/**
+ * @def PCM_SAMPLE_RATE
+ * @brief sample rate of all PCM the tool accepts
+ */
+#define PCM_SAMPLE_RATE (48000.0)
+
+
 /**
  * @brief encapsulate model and its creation
  */
@@ -128,6 +156,19 @@ void dlb_pmd_tool_usage
     printf("                          this many samples from the start of the .wav file\n");
     printf("        -vsync <offset> - (PCM+PMD read) number of samples from the beginning of the .wav file\n");
     printf("                          where the first video frame boundary occurs\n");
+    printf("        -block-size <count> - (PCM) number of samples processed at a time [1-4096],\n");
+    printf("                          limited to less than a video frame (default: %u)\n",
+           PCM_DEFAULT_BLOCK_SIZE);
+    printf("        -pipeline       - (PCM) read and write .wav files on separate threads, concurrently\n");
+    printf("                          with the metadata processing\n");
+    printf("        -batch <path>   - convert many files on a pool of threads; <path> is either\n");
+    printf("                          a manifest with an \"<input> <output>\" pair per line, or\n");
+    printf("                          a directory of .xml, .klv and .wav files, in which case -o\n");
+    printf("                          names a different output directory\n");
+    printf("        -batch-out <sfx> - (batch directory) suffix of the output files: xml or klv\n");
+    printf("                          (default: xml)\n");
+    printf("        -jobs <count>   - (batch) number of worker threads [1-%u] (default: %u)\n",
+           MAX_BATCH_JOBS, DEFAULT_BATCH_JOBS);
     printf("        -Dolby          - use Dolby Private Universal Label instead of SMPTE 2109\n");
     printf("        -mark-pcm-blocks - insert SMPTE 337m NULL-frames at PCM block boundaries\n");
     printf("                          even when there is no data for that PCM block\n");
@@ -451,6 +492,11 @@ dlb_pmd_tool_parse_cmdline_args
     args->mark_pcm_blocks        = 0;
     args->skip_pcm_samples       = 0;
     args->vsync                  = 0;
+    args->pcm_block_size         = PCM_DEFAULT_BLOCK_SIZE;
+    args->pcm_pipeline           = 0;
+    args->batch                  = NULL;
+    args->batch_out              = "xml";
+    args->jobs                   = DEFAULT_BATCH_JOBS;
     args->ul                     = DLB_PMD_KLV_UL_ST2109;
     args->try_frame              = 0;
     args->strict_xml             = 1;
@@ -605,6 +651,50 @@ dlb_pmd_tool_parse_cmdline_args
                 goto error;
             }
         }
+        else if (0 == strncmp(opt, "-block-size", 12))
+        {
+            --argc;
+            ++argv;
+            if (!parse_uint_arg(argc, argv, opt, 1, 4096, &args->pcm_block_size))
+            {
+                goto error;
+            }
+        }
+        else if (0 == strncmp(opt, "-pipeline", 10))
+        {
+            args->pcm_pipeline = 1;
+        }
+        else if (0 == strncmp(opt, "-batch", 7))
+        {
+            --argc;
+            ++argv;
+            if (!argc)
+            {
+                fprintf(stderr, "ERROR: option -batch expects a manifest or directory parameter\n");
+                goto error;
+            }
+            args->batch = *argv;
+        }
+        else if (0 == strncmp(opt, "-batch-out", 11))
+        {
+            --argc;
+            ++argv;
+            if (!argc || (strcmp(*argv, "xml") && strcmp(*argv, "klv")))
+            {
+                fprintf(stderr, "ERROR: option -batch-out expects xml or klv\n");
+                goto error;
+            }
+            args->batch_out = *argv;
+        }
+        else if (0 == strncmp(opt, "-jobs", 6))
+        {
+            --argc;
+            ++argv;
+            if (!parse_uint_arg(argc, argv, opt, 1, MAX_BATCH_JOBS, &args->jobs))
+            {
+                goto error;
+            }
+        }
         else if (0 == strncmp(opt, "-rand", 6))
         {
             args->inmode = MODE_PRNG;
@@ -721,6 +811,17 @@ dlb_pmd_tool_parse_cmdline_args
         ++argv;
     }
 
+    if (NULL != args->batch)
+    {
+        /* inputs and outputs come from the batch; see batch_process() */
+        if (stat(args->batch, &info))
+        {
+            fprintf(stderr, "ERROR: batch input is not accessible '%s'\n", args->batch);
+            return PMD_FALSE;
+        }
+        return PMD_TRUE;
+    }
+
     if ((NULL == args->in && MODE_PRNG != args->inmode) || NULL == args->out)
     {
         fprintf(stderr, "ERROR: not enough arguments\n");
@@ -797,6 +898,7 @@ int                           /** @return 0 on success, 1 on failure */
 read_input
     (const Args             *args   /**< [in]  control arguments */
     ,dlb_pmd_model_combo    *model  /**< [out] PMD model to read */
+    ,pcm_workspace          *ws     /**< [in]  PCM workspace, or NULL */
     )
 
 {
@@ -820,7 +922,8 @@ read_input
         result = klv_read(in, model);
         break;
     case MODE_WAV:
-        result = pcm_read(in, args->logname, rate, chan, ispair, vsync, skip, model);
+        result = pcm_read(in, args->logname, rate, chan, ispair, vsync, skip,
+                          args->pcm_block_size, args->pcm_pipeline, ws, model);
         break;
     case MODE_PRNG:
         result = prng_read((Args *)args, model);    /* TODO: it would be nice to keep args const... */
@@ -914,6 +1017,7 @@ int                           /** @return 0 on success, 1 on failure */
 write_output
     (const Args             *args   /**< [in]  control arguments */
     ,dlb_pmd_model_combo    *model  /**< [out] PMD model to write */
+    ,pcm_workspace          *ws     /**< [in]  PCM workspace, or NULL */
     )
 {
           char                         pcm_out[256];
@@ -931,13 +1035,516 @@ write_output
     {
     case MODE_XML:   return xml_write(out, model, sadm);
     case MODE_KLV:   return klv_write(out, model, ul);
-    case MODE_WAV:   return pcm_write(out, pcm_out, rate, chan, ispair, ul, mark, sadm, model);
+    case MODE_WAV:   return pcm_write(out, pcm_out, rate, chan, ispair, ul, mark, sadm,
+                                       args->pcm_block_size, args->pcm_pipeline, ws, model);
     case MODE_PRNG:  abort();  /* not possible */
     default:         return 1;
     }
 }
 
 
+/* ------------------------------ batch mode ------------------------------ */
+
+
+/**
+ * @brief one conversion of a batch
+ */
+typedef struct
+{
+    char in[MAX_FILENAME_LEN];      /**< input filename */
+    char out[MAX_FILENAME_LEN];     /**< output filename */
+} batch_entry;
+
+
+/**
+ * @brief state shared by the workers of a batch
+ */
+typedef struct
+{
+    const Args   *args;             /**< options common to all conversions */
+    batch_entry  *entries;          /**< conversions to do */
+    size_t        count;            /**< number of #entries */
+    size_t        capacity;         /**< allocated size of #entries */
+    pmd_atomic    next;             /**< index of the next entry to hand out */
+    pmd_mutex     lock;             /**< guards the fields below, and stdout */
+    size_t        failures;         /**< number of failed conversions */
+    uint64_t      samples;          /**< number of PCM sample sets processed */
+} batch;
+
+
+/**
+ * @brief a batch worker thread, and the instances it reuses for every file
+ */
+typedef struct
+{
+    batch         *b;               /**< batch being worked on */
+    pmd_thread     thread;          /**< the worker thread */
+    model          m;               /**< model, cleared before each file */
+    pcm_workspace  ws;              /**< augmentor/extractor memory */
+} batch_worker;
+
+
+/**
+ * @brief read a monotonic clock
+ */
+static
+double                              /** @return time in seconds from an arbitrary point */
+batch_clock
+    (void
+    )
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER now;
+
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+#endif
+}
+
+
+/**
+ * @brief append a conversion to the batch
+ */
+static
+int                                 /** @return 0 on success, 1 on failure */
+batch_add
+    (batch      *b
+    ,const char *in
+    ,const char *out
+    )
+{
+    if (strlen(in) >= MAX_FILENAME_LEN || strlen(out) >= MAX_FILENAME_LEN)
+    {
+        fprintf(stderr, "ERROR: filename too long: \"%s\"\n",
+                strlen(in) >= MAX_FILENAME_LEN ? in : out);
+        return 1;
+    }
+
+    if (b->count == b->capacity)
+    {
+        size_t capacity = b->capacity ? 2 * b->capacity : 64;
+        batch_entry *entries = (batch_entry *)realloc(b->entries, capacity * sizeof(batch_entry));
+
+        if (NULL == entries)
+        {
+            fprintf(stderr, "ERROR: could not allocate memory\n");
+            return 1;
+        }
+        b->entries  = entries;
+        b->capacity = capacity;
+    }
+
+    strcpy(b->entries[b->count].in, in);
+    strcpy(b->entries[b->count].out, out);
+    b->count += 1;
+    return 0;
+}
+
+
+/**
+ * @brief read a batch manifest
+ *
+ * Each line of the manifest holds an input and an output filename,
+ * separated by white space, exactly as they would be given to -i and
+ * -o.  Blank lines and lines starting with '#' are ignored.
+ */
+static
+int                                 /** @return 0 on success, 1 on failure */
+batch_read_manifest
+    (batch      *b
+    ,const char *filename
+    )
+{
+    char line[3 * MAX_FILENAME_LEN];
+    char in[MAX_FILENAME_LEN];
+    char out[MAX_FILENAME_LEN];
+    unsigned int lineno = 0;
+    int res = 0;
+    FILE *f;
+
+    f = fopen(filename, "r");
+    if (NULL == f)
+    {
+        fprintf(stderr, "ERROR: could not open batch manifest \"%s\"\n", filename);
+        return 1;
+    }
+
+    while (0 == res && NULL != fgets(line, sizeof(line), f))
+    {
+        char first = '#';
+
+        ++lineno;
+        (void)sscanf(line, " %c", &first);
+        if ('#' == first)
+        {
+            continue;
+        }
+        /* field widths are MAX_FILENAME_LEN - 1 */
+        if (2 != sscanf(line, "%255s %255s", in, out))
+        {
+            fprintf(stderr, "ERROR: %s:%u: expected <input> <output>\n", filename, lineno);
+            res = 1;
+        }
+        else
+        {
+            res = batch_add(b, in, out);
+        }
+    }
+
+    fclose(f);
+    return res;
+}
+
+
+/**
+ * @brief add the batch conversion of one file found in a directory
+ *
+ * Files with a .xml, .klv or .wav suffix become <outdir>/<name>.<suffix>;
+ * anything else is skipped.
+ */
+static
+int                                 /** @return 0 on success, 1 on failure */
+batch_add_directory_file
+    (batch      *b
+    ,const char *dir                /**< [in] input directory */
+    ,const char *name               /**< [in] name of file in input directory */
+    ,const char *outdir             /**< [in] output directory */
+    ,const char *suffix             /**< [in] suffix of output files */
+    )
+{
+    char in[MAX_FILENAME_LEN];
+    char out[MAX_FILENAME_LEN];
+    const char *dot = strrchr(name, '.');
+
+    if (   NULL == dot
+        || (strcmp(dot, ".xml") && strcmp(dot, ".klv") && strcmp(dot, ".wav")))
+    {
+        return 0;
+    }
+
+    if (   snprintf(in, sizeof(in), "%s/%s", dir, name) >= (int)sizeof(in)
+        || snprintf(out, sizeof(out), "%s/%.*s.%s", outdir, (int)(dot - name), name, suffix) >= (int)sizeof(out))
+    {
+        fprintf(stderr, "ERROR: filename too long: \"%s/%s\"\n", dir, name);
+        return 1;
+    }
+    return batch_add(b, in, out);
+}
+
+
+static
+int
+compare_batch_entries
+    (const void *a
+    ,const void *b
+    )
+{
+    return strcmp(((const batch_entry *)a)->in, ((const batch_entry *)b)->in);
+}
+
+
+/**
+ * @brief decide whether two paths name the same directory
+ */
+static
+int                                 /** @return 1 if they do, 0 if not (or either is missing) */
+batch_same_directory
+    (const char *a
+    ,const char *b
+    )
+{
+#ifdef _WIN32
+    char full_a[MAX_PATH];
+    char full_b[MAX_PATH];
+
+    if (   0 == GetFullPathNameA(a, sizeof(full_a), full_a, NULL)
+        || 0 == GetFullPathNameA(b, sizeof(full_b), full_b, NULL))
+    {
+        return 0;
+    }
+    return 0 == _stricmp(full_a, full_b);
+#else
+    struct stat info_a;
+    struct stat info_b;
+
+    if (stat(a, &info_a) || stat(b, &info_b))
+    {
+        return 0;
+    }
+    return info_a.st_dev == info_b.st_dev && info_a.st_ino == info_b.st_ino;
+#endif
+}
+
+
+/**
+ * @brief add a conversion for every metadata or PCM file in a directory
+ */
+static
+int                                 /** @return 0 on success, 1 on failure */
+batch_scan_directory
+    (batch      *b
+    ,const char *dir                /**< [in] input directory */
+    ,const char *outdir             /**< [in] output directory */
+    ,const char *suffix             /**< [in] suffix of output files */
+    )
+{
+    int res = 0;
+#ifdef _WIN32
+    char pattern[MAX_FILENAME_LEN];
+    WIN32_FIND_DATAA found;
+    HANDLE h;
+
+    snprintf(pattern, sizeof(pattern), "%s\\*", dir);
+    h = FindFirstFileA(pattern, &found);
+    if (INVALID_HANDLE_VALUE == h)
+    {
+        fprintf(stderr, "ERROR: could not read directory \"%s\"\n", dir);
+        return 1;
+    }
+    do
+    {
+        if (!(found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+        {
+            res = batch_add_directory_file(b, dir, found.cFileName, outdir, suffix);
+        }
+    } while (0 == res && FindNextFileA(h, &found));
+    FindClose(h);
+#else
+    struct dirent *de;
+    DIR *d;
+
+    d = opendir(dir);
+    if (NULL == d)
+    {
+        fprintf(stderr, "ERROR: could not read directory \"%s\"\n", dir);
+        return 1;
+    }
+    while (0 == res && NULL != (de = readdir(d)))
+    {
+        res = batch_add_directory_file(b, dir, de->d_name, outdir, suffix);
+    }
+    closedir(d);
+#endif
+
+    /* directory order is arbitrary; keep runs reproducible */
+    if (b->count > 1)
+    {
+        qsort(b->entries, b->count, sizeof(batch_entry), compare_batch_entries);
+    }
+    return res;
+}
+
+
+/**
+ * @brief run one conversion of a batch, and print its summary line
+ */
+static
+void
+batch_convert
+    (batch_worker      *w
+    ,const batch_entry *e
+    )
+{
+    batch    *b = w->b;
+    Args      args = *b->args;
+    uint64_t  samples = 0;
+    double    start = batch_clock();
+    double    seconds;
+    int       res = 1;
+
+    args.in      = e->in;
+    args.out     = e->out;
+    args.inmode  = MODE_UNKNOWN;
+    args.outmode = MODE_UNKNOWN;
+
+    if (check_modes(&args) && PMD_SUCCESS == dlb_pmd_model_combo_clear(w->m.model))
+    {
+        w->ws.samples = 0;
+        res = read_input(&args, w->m.model, &w->ws);
+        samples = w->ws.samples;
+        if (0 == res)
+        {
+            w->ws.samples = 0;
+            res = write_output(&args, w->m.model, &w->ws);
+            if (w->ws.samples > samples)
+            {
+                samples = w->ws.samples;
+            }
+        }
+    }
+    seconds = batch_clock() - start;
+
+    pmd_mutex_lock(&b->lock);
+    printf("%s %s -> %s: %.3f s", res ? "FAIL" : "OK  ", e->in, e->out, seconds);
+    if (samples)
+    {
+        printf(", %.2f s of audio", (double)samples / PCM_SAMPLE_RATE);
+    }
+    printf("\n");
+    fflush(stdout);
+    b->failures += (0 != res);
+    b->samples  += samples;
+    pmd_mutex_unlock(&b->lock);
+}
+
+
+static
+void *
+batch_worker_thread
+    (void *arg
+    )
+{
+    batch_worker *w = (batch_worker *)arg;
+    batch *b = w->b;
+    long i;
+
+    while ((i = pmd_atomic_fetch_add(&b->next, 1)) < (long)b->count)
+    {
+        batch_convert(w, &b->entries[i]);
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief process every file of a batch manifest or directory
+ *
+ * The conversions are shared out between a pool of worker threads.
+ * Each worker keeps its own model and PCM workspace for all of the
+ * files it converts, so per-file setup is just a model clear.
+ */
+static
+int                                 /** @return 0 if every conversion succeeded, 1 otherwise */
+batch_process
+    (const Args *args
+    )
+{
+    batch_worker *workers;
+    struct stat   info;
+    unsigned int  njobs;
+    unsigned int  n;
+    unsigned int  i;
+    double        start;
+    double        seconds;
+    batch         b;
+    int           res;
+
+    memset(&b, 0, sizeof(b));
+    b.args = args;
+
+    if (stat(args->batch, &info))
+    {
+        fprintf(stderr, "ERROR: batch input is not accessible '%s'\n", args->batch);
+        return 1;
+    }
+    if ((info.st_mode & S_IFMT) == S_IFDIR)
+    {
+        if (NULL == args->out)
+        {
+            fprintf(stderr, "ERROR: batch directory mode needs an output directory (-o)\n");
+            return 1;
+        }
+        if (batch_same_directory(args->batch, args->out))
+        {
+            /* workers would overwrite files that other workers are still reading */
+            fprintf(stderr, "ERROR: batch output directory must differ from the input directory\n");
+            return 1;
+        }
+        res = batch_scan_directory(&b, args->batch, args->out, args->batch_out);
+    }
+    else
+    {
+        res = batch_read_manifest(&b, args->batch);
+    }
+    if (res || 0 == b.count)
+    {
+        if (0 == res)
+        {
+            fprintf(stderr, "ERROR: nothing to do in batch '%s'\n", args->batch);
+        }
+        free(b.entries);
+        return 1;
+    }
+
+    njobs = args->jobs;
+    if (njobs > b.count)
+    {
+        njobs = (unsigned int)b.count;
+    }
+    workers = (batch_worker *)calloc(njobs, sizeof(batch_worker));
+    if (NULL == workers)
+    {
+        fprintf(stderr, "ERROR: could not allocate memory\n");
+        free(b.entries);
+        return 1;
+    }
+
+    pmd_atomic_init(&b.next, 0);
+    pmd_mutex_init(&b.lock);
+
+    start = batch_clock();
+    for (n = 0; n != njobs; ++n)
+    {
+        batch_worker *w = &workers[n];
+
+        w->b = &b;
+        pcm_workspace_init(&w->ws);
+        if (!model_init(&w->m, args))
+        {
+            break;
+        }
+        if (pmd_thread_init(&w->thread, batch_worker_thread, w, PMD_THREAD_PRIORITY_NORMAL, 0, 0))
+        {
+            model_finish(&w->m);
+            break;
+        }
+        (void)pmd_thread_start(&w->thread);
+    }
+    if (n != njobs)
+    {
+        fprintf(stderr, "ERROR: could only start %u of %u batch workers\n", n, njobs);
+    }
+
+    for (i = 0; i != n; ++i)
+    {
+        (void)pmd_thread_join(&workers[i].thread, NULL);
+        pmd_thread_finish(&workers[i].thread);
+        model_finish(&workers[i].m);
+        pcm_workspace_finish(&workers[i].ws);
+    }
+    seconds = batch_clock() - start;
+
+    /* with no workers at all, nothing was converted */
+    if (0 == n)
+    {
+        b.failures = b.count;
+    }
+
+    printf("%u files, %u failed, in %.3f s on %u thread%s: %.2f files/s",
+           (unsigned int)b.count, (unsigned int)b.failures, seconds, n, n == 1 ? "" : "s",
+           seconds > 0.0 ? (double)b.count / seconds : 0.0);
+    if (b.samples)
+    {
+        double hours = (double)b.samples / PCM_SAMPLE_RATE / 3600.0;
+
+        printf(", %.3f audio-hours (%.3f audio-hours/s)", hours, seconds > 0.0 ? hours / seconds : 0.0);
+    }
+    printf("\n");
+
+    pmd_mutex_finish(&b.lock);
+    free(workers);
+    free(b.entries);
+    return (0 != b.failures);
+}
+
+
 /**
  * @brief process files according to the arguments
  */
@@ -949,10 +1556,15 @@ dlb_pmd_tool_process
     int res = 0;
     model m;
 
+    if (NULL != args->batch)
+    {
+        return batch_process(args);
+    }
+
     if (model_init(&m, args))
     {
-        res = read_input(args, m.model)
-           || write_output(args, m.model);
+        res = read_input(args, m.model, NULL)
+           || write_output(args, m.model, NULL);
         model_finish(&m);
     }
 
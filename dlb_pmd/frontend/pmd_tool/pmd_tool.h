@@ -88,6 +88,11 @@ typedef struct
     dlb_pmd_bool                mark_pcm_blocks;
     unsigned int                skip_pcm_samples;
     unsigned int                vsync;
+    unsigned int                pcm_block_size;
+    dlb_pmd_bool                pcm_pipeline;
+    const char                 *batch;
+    const char                 *batch_out;
+    unsigned int                jobs;
     mode                        inmode;
     mode                        outmode;
     mode                        mdmode;
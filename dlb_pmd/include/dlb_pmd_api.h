@@ -167,6 +167,21 @@ dlb_pmd_query_mem_constrained
     );
 
 
+/**
+ * @brief establish how much memory the client needs to allocate, given
+ * some maximum entity counts and a choice of id map.  Use the same
+ * arguments when allocating the model using #dlb_pmd_init_constrained2
+ *
+ * Same as #dlb_pmd_query_mem_constrained, which uses dense id maps.
+ */
+DLB_PMD_DLL_ENTRY
+size_t                                  /** @return size of memory to allocate in bytes */
+dlb_pmd_query_mem_constrained2
+    (const dlb_pmd_model_constraints *c /**< [in] model size constraints */
+    ,dlb_pmd_bool      compact_id_maps  /**< [in] use compact id maps? */
+    );
+
+
 /**
  * @brief establish how much memory the client needs to allocate, given
  * a required maximum profile and level.  Use the same profile and memory
@@ -226,6 +241,28 @@ dlb_pmd_init_constrained
     );
 
 
+/**
+ * @brief initialize a region of memory to be a dlb_pmd model with the given
+ * maximum entity limits, and a choice of id map
+ *
+ * Same as #dlb_pmd_init_constrained, except that the memory must be at
+ * least of the size established by #dlb_pmd_query_mem_constrained2.
+ *
+ * The model maps entity ids to entities.  By default each map is a
+ * dense 4096-entry table, giving O(1) lookups.  If #compact_id_maps is
+ * set, each map is instead a sorted array sized by the limits, which
+ * is much smaller for small limits, at the cost of O(log n) lookups.
+ */
+DLB_PMD_DLL_ENTRY
+void
+dlb_pmd_init_constrained2
+    (      dlb_pmd_model **model        /**< [out] newly created model structure */
+    ,const dlb_pmd_model_constraints *c /**< [in] model size constraints */
+    ,      dlb_pmd_bool compact_id_maps /**< [in] use compact id maps? */
+    ,      void *mem                    /**< [in] memory for the model */
+    );
+
+
 /**
  * @brief initialize a region of memory to be a dlb_pmd model with the given
  * maximum entity limits
@@ -302,6 +339,10 @@ dlb_pmd_finish
 /**
  * @brief overwrite one model with the content of another
  *
+ * Only the entities actually present in the source are copied, so the
+ * cost follows the size of the source's content rather than the
+ * capacity of either model.  The destination keeps its own limits.
+ *
  * Invalid parameters cause undefined behaviour.
  */
 DLB_PMD_DLL_ENTRY
@@ -117,6 +117,28 @@ dlb_pmd_frame_captor_capture
     );
 
 
+/**
+ * @brief Capture metadata from consecutive blobs of one continuous stream.  The first
+ * call behaves like #dlb_pmd_frame_captor_capture and locks on to the metadata channel,
+ * frame phase and frame rate it finds.  Subsequent blobs of the same format are fed
+ * straight to the captor's extractor, and the metadata set is refreshed as soon as a
+ * frame has been completely decoded, so it always describes the latest whole frame.  The
+ * search is only repeated if the stream is lost (no frame starts within two frame
+ * periods, or a block fails to decode) or the blob format changes.  Blobs must be passed
+ * in stream order with no gaps; calling #dlb_pmd_frame_captor_capture drops the lock.
+ * The metadata set remains valid until the next call to capture or stream, or until the
+ * frame captor is closed.
+ */
+DLB_PMD_DLL_ENTRY
+int                                                 /** @return Status code. */
+dlb_pmd_frame_captor_stream
+    (dlb_pmd_metadata_set           **metadata_set  /**< [out] Metadata set pointer for result. */
+    ,dlb_pmd_frame_captor            *captor        /**< [in]  Frame captor instance. */
+    ,const dlb_pmd_blob_descriptor   *descriptor    /**< [in]  Data blob descriptor. */
+    ,const void                      *data_blob     /**< [in]  Data blob. */
+    );
+
+
 /**
  * @brief Close a frame captor instance, freeing any internally-allocated resources.  Sets the
  * instance pointer to NULL.
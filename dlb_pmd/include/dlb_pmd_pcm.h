@@ -105,6 +105,27 @@ typedef enum
 dlb_pcmsadm_status;
 
 
+/**
+ * @def DLB_PCMPMD_SADM_COMPRESSION_DEFAULT
+ * @brief default zlib compression level for serial ADM payloads
+ */
+#define DLB_PCMPMD_SADM_COMPRESSION_DEFAULT (9)
+
+
+/**
+ * @brief zlib compression strategy for serial ADM payloads
+ */
+typedef enum
+{
+    DLB_PCMPMD_SADM_STRATEGY_DEFAULT = 0,   /**< zlib Z_DEFAULT_STRATEGY */
+    DLB_PCMPMD_SADM_STRATEGY_FILTERED,      /**< zlib Z_FILTERED */
+    DLB_PCMPMD_SADM_STRATEGY_HUFFMAN_ONLY,  /**< zlib Z_HUFFMAN_ONLY */
+    DLB_PCMPMD_SADM_STRATEGY_RLE,           /**< zlib Z_RLE */
+    DLB_PCMPMD_SADM_STRATEGY_FIXED          /**< zlib Z_FIXED */
+}
+dlb_pcmpmd_sadm_strategy;
+
+
 /**
  * @brief type of a callback used when #dlb_pcmpmd_extract2 discovers
  * a new frame or when #dlb_pcmpmd_augment2 is about to write a new
@@ -150,6 +171,68 @@ dlb_pcmpmd_augmentor_query_mem
     );
 
 
+/**
+ * @brief initialize PCM augmentor, with serial ADM compression settings and
+ * optional preset dictionary
+ *
+ * As #dlb_pcmpmd_augmentor_init4, but when both #sadm and #sadm_dictionary
+ * are true, the payload is compressed as a zlib stream primed with the
+ * built-in ADM dictionary and signalled with format_type 2 in the sADM
+ * format_info word.  This makes payloads smaller, but only extractors that
+ * know the dictionary can decode them.  Ignored for PMD.
+ */
+DLB_PMD_DLL_ENTRY
+void
+dlb_pcmpmd_augmentor_init5
+    (dlb_pcmpmd_augmentor          **augptr             /**< [in] PCM augmentor to initialize */
+    ,dlb_pmd_model_combo            *model              /**< [in] PMD model */
+    ,void                           *mem                /**< [in] memory for PCM augmentor */
+    ,unsigned int                    wrap_depth         /**< [in] s337m wrapping bit depth (16, 20 or 24) */
+    ,dlb_pmd_frame_rate              rate               /**< [in] video frame rate */
+    ,dlb_klvpmd_universal_label      ul                 /**< [in] universal label */
+    ,dlb_pmd_bool                    mark_empty_blocks  /**< [in] mark empty PMD blocks with SMPTE 337m NULL data bursts */
+    ,unsigned int                    numchannels        /**< [in] number of channels of PCM */
+    ,unsigned int                    stride             /**< [in] channel stride */
+    ,dlb_pmd_bool                    is_pair            /**< [in] 1 = pair of channels, 0 = single channel */
+    ,unsigned int                    start              /**< [in] 1st pair or channel to write, (see #pmd_pair) */
+    ,dlb_pmd_bool                    sadm               /**< [in] generate sADM instead of PMD */
+    ,int                             sadm_level         /**< [in] sADM zlib compression level */
+    ,dlb_pcmpmd_sadm_strategy        sadm_strategy      /**< [in] sADM zlib compression strategy */
+    ,dlb_pmd_bool                    sadm_dictionary    /**< [in] compress sADM with the preset ADM dictionary */
+    );
+
+
+/**
+ * @brief initialize PCM augmentor, with serial ADM compression settings
+ *
+ * As #dlb_pcmpmd_augmentor_init3, but when #sadm is true, the payload is
+ * compressed with the given zlib level (0..9, where 0 is stored and 9 is
+ * smallest, #DLB_PCMPMD_SADM_COMPRESSION_DEFAULT otherwise) and strategy,
+ * so that payload size can be traded for CPU time.  Both are ignored for PMD.
+ *
+ * This function calls #dlb_pcmpmd_augmentor_init5 without the preset
+ * dictionary.
+ */
+DLB_PMD_DLL_ENTRY
+void
+dlb_pcmpmd_augmentor_init4
+    (dlb_pcmpmd_augmentor          **augptr             /**< [in] PCM augmentor to initialize */
+    ,dlb_pmd_model_combo            *model              /**< [in] PMD model */
+    ,void                           *mem                /**< [in] memory for PCM augmentor */
+    ,unsigned int                    wrap_depth         /**< [in] s337m wrapping bit depth (16, 20 or 24) */
+    ,dlb_pmd_frame_rate              rate               /**< [in] video frame rate */
+    ,dlb_klvpmd_universal_label      ul                 /**< [in] universal label */
+    ,dlb_pmd_bool                    mark_empty_blocks  /**< [in] mark empty PMD blocks with SMPTE 337m NULL data bursts */
+    ,unsigned int                    numchannels        /**< [in] number of channels of PCM */
+    ,unsigned int                    stride             /**< [in] channel stride */
+    ,dlb_pmd_bool                    is_pair            /**< [in] 1 = pair of channels, 0 = single channel */
+    ,unsigned int                    start              /**< [in] 1st pair or channel to write, (see #pmd_pair) */
+    ,dlb_pmd_bool                    sadm               /**< [in] generate sADM instead of PMD */
+    ,int                             sadm_level         /**< [in] sADM zlib compression level */
+    ,dlb_pcmpmd_sadm_strategy        sadm_strategy      /**< [in] sADM zlib compression strategy */
+    );
+
+
 /**
  * @brief initialize PCM augmentor
  *
@@ -165,6 +248,9 @@ dlb_pcmpmd_augmentor_query_mem
  *
  * If #sadm is true, the size for #mem must have been calculated by
  * calling #dlb_pcmpmd_augmentor_query_mem with #sadm true.
+ *
+ * This function calls #dlb_pcmpmd_augmentor_init4 with the default
+ * sADM compression settings.
  */
 DLB_PMD_DLL_ENTRY
 void
@@ -254,6 +340,22 @@ dlb_pcmpmd_augmentor_init
     );
 
 
+/**
+ * @brief start an augmentor over, as if it had just been initialized
+ *
+ * The next block of PCM is wrapped from the beginning of a frame, with
+ * the same settings as before.  Unlike initializing the augmentor again,
+ * this keeps any state the serial ADM encoder has built up, such as the
+ * payload of an unchanged model, so a long-lived augmentor can cheaply
+ * regenerate a buffer of whole frames whenever its model changes.
+ */
+DLB_PMD_DLL_ENTRY
+void
+dlb_pcmpmd_augmentor_restart
+    (dlb_pcmpmd_augmentor *aug          /**< [in] PCM augmentor */
+    );
+
+
 /**
  * @brief finalize PCM augmentor
  */
@@ -396,6 +498,24 @@ dlb_pcmpmd_augment2
     );
 
 
+/**
+ * @brief switch the model an augmentor writes
+ *
+ * The augmentor does not copy the model, it only starts reading the new one.
+ * Call this from the #dlb_pcmpmd_new_frame callback of #dlb_pcmpmd_augment2
+ * (or before any PCM has been augmented), so that the new model begins on a
+ * frame boundary; it is cheap enough to call on a real-time audio thread.
+ * The model must remain valid, and must not be modified, until the augmentor
+ * has been switched to another model or finished.
+ */
+DLB_PMD_DLL_ENTRY
+void
+dlb_pcmpmd_augmentor_set_model
+    (dlb_pcmpmd_augmentor *aug          /**< [in] PCM augmentor */
+    ,dlb_pmd_model_combo  *model        /**< [in] PMD model to write from now on */
+    );
+
+
 /**
  * @brief abstract type of structure used to remove KLV metadata
  * from final two channels in PCM.
@@ -443,6 +563,11 @@ dlb_pcmpmd_extractor_init3
  * If #sadm is true, the size for #mem must have been calculated by
  * calling #dlb_pcmpmd_extractor_query_mem with #sadm true.
  *
+ * A serial ADM extractor allocates its XML container on first use, so
+ * every initialization must be paired with #dlb_pcmpmd_extractor_finish
+ * before #mem is freed or initialized again; otherwise the container
+ * leaks.
+ *
  * If #sadm is not true, and the extractor encounters serial ADM
  * content, that content will be ignored.
  *
@@ -488,6 +613,9 @@ dlb_pcmpmd_extractor_init
 
 /**
  * @brief clean up resources
+ *
+ * Required after every extractor initialization, before its memory is
+ * freed or initialized again.
  */
 DLB_PMD_DLL_ENTRY
 void
@@ -561,7 +689,7 @@ dlb_pcmpmd_extract3
     ,size_t                num_samples      /**< [in]  number of PCM sample sets */
     ,dlb_pcmpmd_new_frame  callback         /**< [in]  callback to invoke when new frame is found */
     ,dlb_pcmpmd_new_sadm   sadm_callback    /**< [in]  callback to invoke when new sadm packet is processed */
-    ,char                 *sadm_xml_buf     /**< [in]  buffer to store sadm xml */
+    ,char                 *sadm_xml_buf     /**< [in]  buffer to store sadm xml, or NULL if not needed */
     ,void                 *cbarg            /**< [in]  user argument to callback */
     ,size_t               *video_sync       /**< [out] video frame sync occurs at given line,
                                              **<       or #DLB_PMD_VSYNC_NONE if no frame sync. */
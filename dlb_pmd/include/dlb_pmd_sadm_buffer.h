@@ -69,6 +69,19 @@ dlb_pmd_sadm_buffer_reader_init
     ,void                        *mem     /**< [in] memory to use */
     );
 
+/**
+ * @brief Release the resources held by the reader
+ *
+ * The reader keeps state between calls to #dlb_pmd_sadm_buffer_read, so that
+ * reading a stream of buffers does not rebuild it every time.  Call this once
+ * the reader is no longer needed, before freeing its memory.
+ */
+DLB_PMD_DLL_ENTRY
+void
+dlb_pmd_sadm_buffer_reader_finish
+    (dlb_pmd_sadm_buffer_reader  *reader  /**< [in] reader structure to finish */
+    );
+
 /**
  * @brief helper routine to actually read and parse S-ADM from buffer
  *
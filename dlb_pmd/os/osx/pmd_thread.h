@@ -124,7 +124,7 @@ pmd_thread_wrapper
      * thread must be shutting us down via join.  In that
      * case, we don't need to clean up.
      */
-    if (0 == pmd_mutex_try_lock(&thread->mutex))
+    if (pmd_mutex_try_lock(&thread->mutex))
     {
         if (!thread->joined)
         {
@@ -164,6 +164,89 @@ pmd_mutex_unlock
 
 
 
+/* -------------------------- ATOMICS ------------------------------- */
+
+
+/**
+ * @brief abstract type of an integer shared between threads without a lock
+ *
+ * Loads have acquire semantics, stores have release semantics and the
+ * read-modify-write operations have both, so that whatever a thread wrote
+ * before storing a value is visible to the thread that loads it.
+ *
+ * Note that the actual structure will be defined by one of the #include
+ * files below.
+ */
+typedef struct pmd_atomic pmd_atomic;
+
+
+/**
+ * @brief initialise the atomic, before it is shared with other threads
+ */
+static inline
+void
+pmd_atomic_init
+    (pmd_atomic *atomic     /**< [in] atomic to initialize */
+    ,long value             /**< [in] initial value */
+    );
+
+
+/**
+ * @brief read the atomic's value
+ */
+static inline
+long                        /** @return current value */
+pmd_atomic_load
+    (pmd_atomic *atomic     /**< [in] atomic to read */
+    );
+
+
+/**
+ * @brief set the atomic's value
+ */
+static inline
+void
+pmd_atomic_store
+    (pmd_atomic *atomic     /**< [in] atomic to write */
+    ,long value             /**< [in] new value */
+    );
+
+
+/**
+ * @brief set the atomic's value, and return the value it replaced
+ */
+static inline
+long                        /** @return previous value */
+pmd_atomic_exchange
+    (pmd_atomic *atomic     /**< [in] atomic to write */
+    ,long value             /**< [in] new value */
+    );
+
+
+/**
+ * @brief set the atomic's value only if it still holds the expected value
+ */
+static inline
+dlb_pmd_bool                /** @return 1 if the value was set, 0 otherwise */
+pmd_atomic_compare_exchange
+    (pmd_atomic *atomic     /**< [in] atomic to write */
+    ,long *expected         /**< [in/out] expected value; updated to the current value on failure */
+    ,long desired           /**< [in] new value */
+    );
+
+
+/**
+ * @brief add to the atomic's value, and return the value before the addition
+ */
+static inline
+long                        /** @return previous value */
+pmd_atomic_fetch_add
+    (pmd_atomic *atomic     /**< [in] atomic to modify */
+    ,long delta             /**< [in] amount to add */
+    );
+
+
+
 /* -------------------------- THREADING ------------------------------- */
 
 
@@ -289,14 +372,17 @@ pmd_ctrlc_handle
  * The following #includes provide definitions
  */
 #if defined (_MSC_VER)
+#  include "windows/pmd_atomic.h"
 #  include "windows/pmd_mutex.h"
 #  include "windows/pmd_semaphore.h"
 #  include "windows/pmd_thread.h"
 #elif defined (__linux__)
+#  include "linux/pmd_atomic.h"
 #  include "linux/pmd_mutex.h"
 #  include "linux/pmd_semaphore.h"
 #  include "linux/pmd_thread.h"
 #elif defined (__APPLE__)
+#  include "osx/pmd_atomic.h"
 #  include "osx/pmd_mutex.h"
 #  include "osx/pmd_semaphore.h"
 #  include "osx/pmd_thread.h"
@@ -0,0 +1,126 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#ifndef PMD_ATOMIC_INC_
+#define PMD_ATOMIC_INC_
+
+#include <windows.h>
+
+#if _MSC_VER < 1900 && !defined(inline)
+#  define inline __inline
+#endif
+
+
+struct pmd_atomic
+{
+    volatile LONG value;
+};
+
+
+static inline
+void
+pmd_atomic_init
+    (pmd_atomic *atomic
+    ,long value
+    )
+{
+    atomic->value = value;
+}
+
+
+static inline
+long
+pmd_atomic_load
+    (pmd_atomic *atomic
+    )
+{
+    return InterlockedCompareExchange(&atomic->value, 0, 0);
+}
+
+
+static inline
+void
+pmd_atomic_store
+    (pmd_atomic *atomic
+    ,long value
+    )
+{
+    (void)InterlockedExchange(&atomic->value, value);
+}
+
+
+static inline
+long
+pmd_atomic_exchange
+    (pmd_atomic *atomic
+    ,long value
+    )
+{
+    return InterlockedExchange(&atomic->value, value);
+}
+
+
+static inline
+dlb_pmd_bool
+pmd_atomic_compare_exchange
+    (pmd_atomic *atomic
+    ,long *expected
+    ,long desired
+    )
+{
+    LONG previous = InterlockedCompareExchange(&atomic->value, desired, *expected);
+
+    if (previous == *expected)
+    {
+        return PMD_TRUE;
+    }
+    *expected = previous;
+    return PMD_FALSE;
+}
+
+
+static inline
+long
+pmd_atomic_fetch_add
+    (pmd_atomic *atomic
+    ,long delta
+    )
+{
+    return InterlockedExchangeAdd(&atomic->value, delta);
+}
+
+
+#endif /* PMD_ATOMIC_INC_ */
@@ -124,11 +124,22 @@ size_t
 dlb_pmd_query_mem_constrained
     (const dlb_pmd_model_constraints *constraints
     )
+{
+    return dlb_pmd_query_mem_constrained2(constraints, PMD_FALSE);
+}
+
+
+size_t
+dlb_pmd_query_mem_constrained2
+    (const dlb_pmd_model_constraints *constraints
+    ,dlb_pmd_bool compact_id_maps
+    )
 {
     if (check_constraints(constraints))
     {
         const dlb_pmd_metadata_count *max = &constraints->max;
         unsigned int max_elements = constraints->max_elements;
+        pmd_bool compact = !!compact_id_maps;
         if (!max_elements)
         {
             max_elements = max->num_beds + max->num_objects;
@@ -145,6 +156,11 @@ dlb_pmd_query_mem_constrained
             +  ALIGN_TO_MPTR(max->num_ed2_turnarounds * sizeof(pmd_etd))
             +  ALIGN_TO_MPTR(max->num_headphone_desc * sizeof(pmd_hed))
             +  ALIGN_TO_MPTR(constraints->max_presentation_names * sizeof(pmd_apn))
+            +  ALIGN_TO_MPTR(pmd_idmap_query_mem(compact, max_elements))
+            +  ALIGN_TO_MPTR(pmd_idmap_query_mem(compact, max->num_presentations))
+            +  ALIGN_TO_MPTR(pmd_idmap_query_mem(compact, max->num_eac3))
+            +  ALIGN_TO_MPTR(pmd_idmap_query_mem(compact, max->num_ed2_turnarounds))
+            +  ALIGN_TO_MPTR(pmd_idmap_query_mem(compact, max_elements))
             ;
     }
     return 0;
@@ -160,6 +176,13 @@ dlb_pmd_query_mem_constrained
             mem += ALIGN_TO_MPTR((count) * sizeof(type));               \
         }                                                               \
     }
+
+
+#define ATTACH_IDMAP_AND_INC(map, compact, count)                       \
+    {                                                                   \
+        pmd_idmap_attach(&map, mem, compact, count);                    \
+        mem += ALIGN_TO_MPTR(pmd_idmap_query_mem(compact, count));      \
+    }
     
 
 void
@@ -168,6 +191,18 @@ dlb_pmd_init_constrained
     ,const dlb_pmd_model_constraints *constraints
     ,      void *memvoid
     )
+{
+    dlb_pmd_init_constrained2(modelptr, constraints, PMD_FALSE, memvoid);
+}
+
+
+void
+dlb_pmd_init_constrained2
+    (      dlb_pmd_model **modelptr
+    ,const dlb_pmd_model_constraints *constraints
+    ,      dlb_pmd_bool compact_id_maps
+    ,      void *memvoid
+    )
 {
     pmd_bool mallocated = PMD_FALSE;
 
@@ -178,7 +213,7 @@ dlb_pmd_init_constrained
 
     if (memvoid == NULL)
     {
-        size_t sz = dlb_pmd_query_mem_constrained(constraints);
+        size_t sz = dlb_pmd_query_mem_constrained2(constraints, compact_id_maps);
 
         memvoid = malloc(sz);
         if (memvoid != NULL)
@@ -194,6 +229,7 @@ dlb_pmd_init_constrained
         uint8_t *mem = (uint8_t*)memvoid;
         dlb_pmd_model *model;
         unsigned int max_elements = constraints->max_elements;
+        pmd_bool compact = !!compact_id_maps;
 
         if (!max_elements)
         {
@@ -212,6 +248,11 @@ dlb_pmd_init_constrained
         ASSIGN_AND_INC(model->etd_list,      pmd_etd,     max->num_ed2_turnarounds);
         ASSIGN_AND_INC(model->hed_list,      pmd_hed,     max->num_headphone_desc);
         ASSIGN_AND_INC(model->apn_list.pool, pmd_apn,     constraints->max_presentation_names);
+        ATTACH_IDMAP_AND_INC(model->element_ids, compact, max_elements);
+        ATTACH_IDMAP_AND_INC(model->apd_ids,     compact, max->num_presentations);
+        ATTACH_IDMAP_AND_INC(model->eep_ids,     compact, max->num_eac3);
+        ATTACH_IDMAP_AND_INC(model->etd_ids,     compact, max->num_ed2_turnarounds);
+        ATTACH_IDMAP_AND_INC(model->aen_ids,     compact, max_elements);
         
         model->limits = *constraints;
 
@@ -373,11 +414,10 @@ constraints_larger
 
 
 /**
- * @def COPY_ONEOF(tmp, dest, src, field, type)
+ * @def COPY_ONEOF(dest, src, field, type)
  * @brief helper macro to define copying optional single entity, IAT or ESD
  */
-#define COPY_ONEOF(tmp, dest, src, field, type)                  \
-    tmp.field = dest->field;                                     \
+#define COPY_ONEOF(dest, src, field, type)                       \
     if (dest->field)                                             \
     {                                                            \
         if (src->field)                                          \
@@ -394,11 +434,46 @@ constraints_larger
 /**
  * @def COPY_ENTITY
  * @brief helper macro to define copying a list of elements
+ *
+ * Only the populated prefix of the source list is copied; whatever
+ * the destination held beyond it is reset to the unused pattern that
+ * #pmd_model_new_frame leaves in empty slots.
  */
-#define COPY_ENTITY(tmp, dest, src, field, count)                       \
-    tmp.field = dest->field;                                            \
-    memmove(dest->field, src->field, sizeof(src->field[0]) * count);    \
+#define COPY_ENTITY(dest, src, field, count, old_count)                         \
+    memmove(dest->field, src->field, sizeof(src->field[0]) * (count));          \
+    if ((old_count) > (count))                                                  \
+    {                                                                           \
+        memset(&dest->field[count], '\xff',                                     \
+               sizeof(dest->field[0]) * ((old_count) - (count)));               \
+    }                                                                           \
+
 
+/**
+ * @brief entity storage and limits that belong to a model rather than its content
+ */
+typedef struct
+{
+    dlb_pmd_model_constraints limits;
+    pmd_element *element_list;
+    pmd_apd *apd_list;
+    pmd_pld *pld_list;
+    pmd_iat *iat;
+    pmd_xyz *xyz_list;
+    pmd_apn *apn_pool;
+    pmd_aen *aen_list;
+    pmd_eep *eep_list;
+    pmd_etd *etd_list;
+    pmd_esd *esd;
+    pmd_hed *hed_list;
+    uint16_t num_elements;
+    uint16_t num_apd;
+    uint16_t num_pld;
+    uint16_t num_xyz;
+    uint16_t num_eep;
+    uint16_t num_etd;
+    uint16_t num_aen;
+    uint16_t num_hed;
+} model_storage;
 
 
 dlb_pmd_success
@@ -407,11 +482,11 @@ dlb_pmd_copy
     ,const dlb_pmd_model *src
     )
 {
-    unsigned int offset = offsetof(dlb_pmd_model, title);
+    size_t head_start = offsetof(dlb_pmd_model, title);
+    size_t head_end = offsetof(dlb_pmd_model, element_ids);
+    size_t tail_start = offsetof(dlb_pmd_model, write_state);
     dlb_pmd_model_constraints scon;
-    dlb_pmd_model tmp;
-    uint8_t *d; 
-    uint8_t *s; 
+    model_storage ms;
     
     FUNCTION_PROLOGUE(dest);
     FUNCTION_PROLOGUE(src);
@@ -422,41 +497,78 @@ dlb_pmd_copy
     }
     
     scon.max_elements = scon.max.num_objects + scon.max.num_beds;
-    scon.max_presentation_names = src->apn_list.num;
+    scon.max_presentation_names = src->apn_list.max;
     if (!constraints_larger(dest, &dest->limits, &scon))
     {
         return PMD_FAIL;
     }
-    scon.use_adm_common_defs = src->limits.use_adm_common_defs;
 
-    /* tmp will be a clone of dest until we fix it up */
-    memmove(&tmp, dest, sizeof(tmp));
-    d = (uint8_t*)&tmp + offset;
-    s = (uint8_t*)src + offset;
-    memmove(d, s, sizeof(tmp) - offset);
-    
-    /* tmp will now point to entity arrays in src; one-by-one
-     * fixup these pointers to point to the destination model's
-     * arrays, and copy their contents
+    /* remember what belongs to the destination itself */
+    ms.limits       = dest->limits;
+    ms.element_list = dest->element_list;
+    ms.apd_list     = dest->apd_list;
+    ms.pld_list     = dest->pld_list;
+    ms.iat          = dest->iat;
+    ms.xyz_list     = dest->xyz_list;
+    ms.apn_pool     = dest->apn_list.pool;
+    ms.aen_list     = dest->aen_list;
+    ms.eep_list     = dest->eep_list;
+    ms.etd_list     = dest->etd_list;
+    ms.esd          = dest->esd;
+    ms.hed_list     = dest->hed_list;
+    ms.num_elements = dest->num_elements;
+    ms.num_apd      = dest->num_apd;
+    ms.num_pld      = dest->num_pld;
+    ms.num_xyz      = dest->num_xyz;
+    ms.num_eep      = dest->num_eep;
+    ms.num_etd      = dest->num_etd;
+    ms.num_aen      = dest->num_aen;
+    ms.num_hed      = dest->num_hed;
+
+    /* the name list goes first, while the destination's own list is intact */
+    pmd_apn_list_copy(&dest->apn_list, &src->apn_list);
+
+    /* copy the scalar state either side of the id maps, which are
+     * large and mostly unused, then point the destination back at its
+     * own arrays
      */
-    COPY_ENTITY(tmp, dest, src, element_list, tmp.limits.max_elements);
-    COPY_ENTITY(tmp, dest, src, apd_list,     tmp.limits.max.num_presentations);
-    COPY_ENTITY(tmp, dest, src, pld_list,     tmp.limits.max.num_loudness);
-    COPY_ENTITY(tmp, dest, src, xyz_list,     tmp.limits.max.num_updates);
-    COPY_ENTITY(tmp, dest, src, aen_list,     tmp.limits.max_elements);
-    COPY_ENTITY(tmp, dest, src, eep_list,     tmp.limits.max.num_eac3);
-    COPY_ENTITY(tmp, dest, src, etd_list,     tmp.limits.max.num_ed2_turnarounds);
-    COPY_ENTITY(tmp, dest, src, hed_list,     tmp.limits.max.num_headphone_desc);
-
-    COPY_ONEOF(tmp, dest, src, iat, pmd_iat);
-    COPY_ONEOF(tmp, dest, src, esd, pmd_esd);
-
-    /* APN needs to be copied separately */
-    tmp.apn_list.pool = dest->apn_list.pool;
-    memmove(tmp.apn_list.pool, src->apn_list.pool, sizeof(pmd_apn) * src->apn_list.max);
-
-    /* finally, copy everything back to the destination */
-    memmove(dest, &tmp, sizeof(tmp));
+    memmove((uint8_t*)dest + head_start, (const uint8_t*)src + head_start, head_end - head_start);
+    memmove((uint8_t*)dest + tail_start, (const uint8_t*)src + tail_start, sizeof(*dest) - tail_start);
+
+    dest->limits        = ms.limits;
+    dest->element_list  = ms.element_list;
+    dest->apd_list      = ms.apd_list;
+    dest->pld_list      = ms.pld_list;
+    dest->iat           = ms.iat;
+    dest->xyz_list      = ms.xyz_list;
+    dest->apn_list.pool = ms.apn_pool;
+    dest->aen_list      = ms.aen_list;
+    dest->eep_list      = ms.eep_list;
+    dest->etd_list      = ms.etd_list;
+    dest->esd           = ms.esd;
+    dest->hed_list      = ms.hed_list;
+    if (dest->write_state.apni.nl == &src->apn_list)
+    {
+        dest->write_state.apni.nl = &dest->apn_list;
+    }
+
+    COPY_ENTITY(dest, src, element_list, src->num_elements, ms.num_elements);
+    COPY_ENTITY(dest, src, apd_list,     src->num_apd,      ms.num_apd);
+    COPY_ENTITY(dest, src, pld_list,     src->num_pld,      ms.num_pld);
+    COPY_ENTITY(dest, src, xyz_list,     src->num_xyz,      ms.num_xyz);
+    COPY_ENTITY(dest, src, aen_list,     src->num_aen,      ms.num_aen);
+    COPY_ENTITY(dest, src, eep_list,     src->num_eep,      ms.num_eep);
+    COPY_ENTITY(dest, src, etd_list,     src->num_etd,      ms.num_etd);
+    COPY_ENTITY(dest, src, hed_list,     src->num_hed,      ms.num_hed);
+
+    COPY_ONEOF(dest, src, iat, pmd_iat);
+    COPY_ONEOF(dest, src, esd, pmd_esd);
+
+    pmd_idmap_copy(&dest->element_ids, &src->element_ids);
+    pmd_idmap_copy(&dest->apd_ids,     &src->apd_ids);
+    pmd_idmap_copy(&dest->eep_ids,     &src->eep_ids);
+    pmd_idmap_copy(&dest->etd_ids,     &src->etd_ids);
+    pmd_idmap_copy(&dest->aen_ids,     &src->aen_ids);
     return PMD_SUCCESS;
 }
 
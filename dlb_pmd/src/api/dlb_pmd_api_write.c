@@ -434,14 +434,17 @@ add_element_name
     }       
 
     idx = model->num_aen;
+    if (!pmd_idmap_insert(&model->aen_ids, id, idx))
+    {
+        error(model, "no room for the name of element %u", id);
+        return PMD_FAIL;
+    }
     aen = &model->aen_list[idx];
     model->num_aen += 1;
     aen->id = id;
 
     /* snprintf will convert C escape codes */
     snprintf((char*)aen->name, sizeof(aen->name), "%s", name);
-
-    pmd_idmap_insert(&model->aen_ids, id, idx);
     return PMD_SUCCESS;
 }
 
@@ -577,7 +580,11 @@ dlb_pmd_add_bed
         ++first_signal;
     }
     pmd_bed_set_normal_form(cmd);
-    pmd_idmap_insert(&model->element_ids, e->id, model->num_elements);
+    if (!pmd_idmap_insert(&model->element_ids, e->id, model->num_elements))
+    {
+        error(model, "no room for element id %u", e->id);
+        return PMD_FAIL;
+    }
     model->num_elements += 1;
     model->num_abd += 1;
 
@@ -631,7 +638,11 @@ dlb_pmd_set_bed
     {
         /* this is a new object */
         e = &model->element_list[model->num_elements];
-        pmd_idmap_insert(&model->element_ids, bed->id, model->num_elements);
+        if (!pmd_idmap_insert(&model->element_ids, bed->id, model->num_elements))
+        {
+            error(model, "no room for element id %u", bed->id);
+            return PMD_FAIL;
+        }
         added = 1;        
     }
 
@@ -742,7 +753,11 @@ dlb_pmd_add_object
     omd->size_vertical   = size_vertical;
     omd->dynamic_updates = dynamic_update;
     omd->diverge         = diverge;
-    pmd_idmap_insert(&model->element_ids, e->id, model->num_elements);
+    if (!pmd_idmap_insert(&model->element_ids, e->id, model->num_elements))
+    {
+        error(model, "no room for element id %u", e->id);
+        return PMD_FAIL;
+    }
     model->num_elements += 1;
 
     if (name && name[0])
@@ -790,7 +805,11 @@ dlb_pmd_set_object
     {
         /* this is a new object */
         e = &model->element_list[model->num_elements];
-        pmd_idmap_insert(&model->element_ids, object->id, model->num_elements);
+        if (!pmd_idmap_insert(&model->element_ids, object->id, model->num_elements))
+        {
+            error(model, "no room for element id %u", object->id);
+            return PMD_FAIL;
+        }
         added = 1;
     }
     
@@ -881,7 +900,11 @@ dlb_pmd_add_presentation
         pres->num_elements += 1;
     }
     
-    pmd_idmap_insert(&model->apd_ids, pres->id, model->num_apd);
+    if (!pmd_idmap_insert(&model->apd_ids, pres->id, model->num_apd))
+    {
+        error(model, "no room for presentation id %u", pres->id);
+        return PMD_FAIL;
+    }
     model->num_apd += 1;
 
     return dlb_pmd_add_presentation_name(model, pres->id, namelang, name);
@@ -919,7 +942,11 @@ dlb_pmd_set_presentation
     else
     {
         pres = &model->apd_list[model->num_apd];
-        pmd_idmap_insert(&model->apd_ids, p->id, model->num_apd);
+        if (!pmd_idmap_insert(&model->apd_ids, p->id, model->num_apd))
+        {
+            error(model, "no room for presentation id %u", p->id);
+            return PMD_FAIL;
+        }
         idx = model->num_apd;
         added = 1;
     }
@@ -1150,7 +1177,11 @@ dlb_pmd_add_eac3_encoding_parameters
     eep->options  = 0;
     eep->num_presentations = 0;
     
-    pmd_idmap_insert(&model->eep_ids, eep->id, model->num_eep);
+    if (!pmd_idmap_insert(&model->eep_ids, eep->id, model->num_eep))
+    {
+        error(model, "no room for EAC3 encoding parameters id %u", id);
+        return PMD_FAIL;
+    }
     model->num_eep += 1;
     return PMD_SUCCESS;
 }
@@ -1330,7 +1361,11 @@ dlb_pmd_set_eac3
     else
     {
         eep = &model->eep_list[model->num_eep];
-        pmd_idmap_insert(&model->eep_ids, (uint16_t)eac3->id, model->num_eep);
+        if (!pmd_idmap_insert(&model->eep_ids, (uint16_t)eac3->id, model->num_eep))
+        {
+            error(model, "no room for EAC3 encoding parameters id %u", eac3->id);
+            return PMD_FAIL;
+        }
         added = 1;
     }
 
@@ -1423,7 +1458,11 @@ dlb_pmd_add_etd
     etd->ed2_presentations = 0;
     etd->de_presentations = 0;
 
-    pmd_idmap_insert(&model->etd_ids, etd->id, model->num_etd);
+    if (!pmd_idmap_insert(&model->etd_ids, etd->id, model->num_etd))
+    {
+        error(model, "no room for ED2 turnaround id %u", id);
+        return PMD_FAIL;
+    }
     model->num_etd += 1;
     return PMD_SUCCESS;
 }
@@ -1611,7 +1650,11 @@ dlb_pmd_set_ed2_turnaround
     else
     {
         e = &model->etd_list[model->num_etd];        
-        pmd_idmap_insert(&model->etd_ids, (uint16_t)etd->id, model->num_etd);
+        if (!pmd_idmap_insert(&model->etd_ids, (uint16_t)etd->id, model->num_etd))
+        {
+            error(model, "no room for ED2 turnaround id %u", etd->id);
+            return PMD_FAIL;
+        }
         added = 1;
     }
 
@@ -121,6 +121,8 @@ typedef struct
     uint16_t     free;                          /**< list of unused slots in pool */
     uint16_t     max_readcount;                 /**< largest number of times a name has
                                                   * been read in */
+    uint16_t     top;                           /**< one more than the highest slot ever
+                                                  * taken from the free list */
 } pmd_apn_list;
     
 
@@ -165,6 +167,25 @@ TRACE_LIST
 #endif
 
 
+/**
+ * @brief put a pool slot into the state a freshly initialized list leaves it in
+ */
+static inline
+void
+pmd_apn_slot_init
+    (pmd_apn *pool     /**< [in] name pool */
+    ,uint16_t i        /**< [in] index of slot to initialize */
+    ,uint16_t max      /**< [in] number of slots in use by the list */
+    )
+{
+    pmd_apn *name = &pool[i];
+
+    memset(name, '\0', sizeof(*name));
+    name->idx = i;
+    name->next = (i+1 == max) ? (unsigned short)PMD_APN_LIST_END : i+1;
+}
+
+
 /**
  * @brief initialize the model's presentation name list
  */
@@ -175,23 +196,63 @@ pmd_apn_list_init
     ,unsigned int maxm /**< [in] max number allowed */
     )
 {
-    pmd_apn *name;
     uint16_t max = maxm > 65535 ? 65535 : (uint16_t)maxm;
     uint16_t i;
 
-    name = nl->pool;
     for (i = 0; i != max; ++i)
     {
-        memset(name, '\0', sizeof(*name));
-        name->idx = i;
-        name->next = (i+1 == max) ? (unsigned short)PMD_APN_LIST_END : i+1;
-        ++name;
+        pmd_apn_slot_init(nl->pool, i, max);
     }
     nl->free = 0;
     nl->list = PMD_APN_LIST_END;
     nl->num = 0;
     nl->max = max;
     nl->max_readcount = 0;
+    nl->top = 0;
+}
+
+
+/**
+ * @brief overwrite one name list with another
+ *
+ * The free list hands out slots in index order until names are
+ * removed, so slots from #top upwards are exactly as
+ * #pmd_apn_list_init left them.  Only the slots below the source's
+ * top need copying; the destination's slots between the two tops are
+ * returned to their initial state, as are the slots whose 'next' link
+ * depends on the list's maximum.
+ *
+ * The destination pool must have room for the source's #max slots.
+ */
+static inline
+void
+pmd_apn_list_copy
+    (pmd_apn_list *dest         /**< [in] name list to overwrite */
+    ,const pmd_apn_list *src    /**< [in] name list to copy */
+    )
+{
+    pmd_apn *pool = dest->pool;
+    uint16_t max = (uint16_t)src->max;
+    uint16_t i;
+
+    memmove(pool, src->pool, sizeof(pmd_apn) * src->top);
+    for (i = src->top; i < dest->top && i < max; ++i)
+    {
+        pmd_apn_slot_init(pool, i, max);
+    }
+    if (dest->max != src->max)
+    {
+        if (dest->max > src->top && dest->max <= max)
+        {
+            pmd_apn_slot_init(pool, (uint16_t)(dest->max - 1), max);
+        }
+        if (max > src->top)
+        {
+            pmd_apn_slot_init(pool, (uint16_t)(max - 1), max);
+        }
+    }
+    *dest = *src;
+    dest->pool = pool;
 }
 
 
@@ -217,6 +278,10 @@ pmd_apn_list_add
     nl->list = name->idx;
     nl->num += 1;
     name->readcount = nl->max_readcount - 1;
+    if (name->idx >= nl->top)
+    {
+        nl->top = name->idx + 1;
+    }
 
     TRACE_LIST(nl, "add %u", name->idx);
     return name;
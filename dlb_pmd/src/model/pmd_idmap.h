@@ -43,7 +43,12 @@
  * id attributes into corresponding array entries, so that we can perform
  * lookups in O(1) time.
  *
- * We implement a simple mapping function using hash tables.
+ * A map is either dense or compact.  A dense map is a table indexed
+ * directly by id, giving O(1) lookups at a cost of 8 KB per map.  A
+ * compact map keeps only the mapped ids, sorted, in an array sized by
+ * the number of entities the model can hold; lookups are binary
+ * searches and iteration visits only the mapped ids.  Models choose
+ * between the two at init time, see #dlb_pmd_init_constrained2.
  */
 
 #ifndef PARSER_IDMAP_INC_
@@ -54,34 +59,165 @@
 
 #define MAP_SIZE (4096)
 
+
+/**
+ * @brief one mapping of a compact map
+ */
+typedef struct
+{
+    uint16_t id;            /**< PMD id value */
+    uint16_t index;         /**< data structure array index */
+} pmd_idmap_entry;
+
+
 typedef struct
 {
-    uint16_t map[MAP_SIZE];
+    uint16_t        *map;       /**< dense table of #MAP_SIZE indices, or NULL if compact */
+    pmd_idmap_entry *entries;   /**< compact map: mapped ids, in ascending order */
+    unsigned int     num;       /**< compact map: number of mapped ids */
+    unsigned int     max;       /**< compact map: capacity of #entries */
+    unsigned int     top;       /**< one more than the highest id ever mapped */
 } pmd_idmap;
 
 
+/**
+ * @brief memory required for the storage of a map
+ */
+static inline
+size_t                      /** @return size in bytes */
+pmd_idmap_query_mem
+    (pmd_bool compact       /**< [in] compact map? */
+    ,unsigned int capacity  /**< [in] maximum number of ids a compact map holds */
+    )
+{
+    return compact
+        ? capacity * sizeof(pmd_idmap_entry)
+        : MAP_SIZE * sizeof(uint16_t);
+}
+
+
+/**
+ * @brief give a map its storage, as sized by #pmd_idmap_query_mem
+ */
+static inline
+void
+pmd_idmap_attach
+    (pmd_idmap *map         /**< [in] map */
+    ,void *mem              /**< [in] storage for the map */
+    ,pmd_bool compact       /**< [in] compact map? */
+    ,unsigned int capacity  /**< [in] maximum number of ids a compact map holds */
+    )
+{
+    map->map = NULL;
+    map->entries = NULL;
+    map->max = 0;
+    if (compact)
+    {
+        map->entries = (pmd_idmap_entry *)mem;
+        map->max = capacity;
+    }
+    else
+    {
+        map->map = (uint16_t *)mem;
+    }
+    /* nothing is known about the storage yet, so the first init clears it all */
+    map->top = compact ? 0 : MAP_SIZE;
+}
+
+
+/**
+ * @brief remove all mappings
+ *
+ * Dense entries at or above #top are never written, so only those
+ * below it need clearing.
+ */
 static inline
 void
 pmd_idmap_init
    (pmd_idmap *map
    )
 {
-    memset(map, '\xff', sizeof(*map));
+    if (map->map)
+    {
+        memset(map->map, '\xff', sizeof(map->map[0]) * map->top);
+    }
+    map->num = 0;
+    map->top = 0;
+}
+
+
+/**
+ * @brief find the position of the first compact entry whose id is not below the given one
+ */
+static inline
+unsigned int                /** @return position in #entries, #num if there is none */
+pmd_idmap_lower_bound
+    (const pmd_idmap *map   /**< [in] compact map */
+    ,unsigned int id        /**< [in] id value */
+    )
+{
+    unsigned int lo = 0;
+    unsigned int hi = map->num;
+
+    while (lo != hi)
+    {
+        unsigned int mid = (lo + hi) / 2;
+        if (map->entries[mid].id < id)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
 }
 
 
 /**
  * @brief establish a mapping from a PMD id to an array index
+ *
+ * A compact map that is already full refuses new ids; its capacity is
+ * the number of entities the model can hold, so this only happens when
+ * the caller would overflow the entity array anyway.
  */
 static inline
-void
+pmd_bool                    /** @return 1 on success, 0 if the map is full */
 pmd_idmap_insert
     (pmd_idmap *map         /**< [in] map */
     ,uint16_t id            /**< [in] PMD id value */
     ,uint16_t array_index   /**< [in] data structure array index */
     )
 {
-    map->map[id] = array_index;	
+    if (map->map)
+    {
+        map->map[id] = array_index;	
+    }
+    else
+    {
+        unsigned int pos = pmd_idmap_lower_bound(map, id);
+
+        if (pos < map->num && map->entries[pos].id == id)
+        {
+            map->entries[pos].index = array_index;
+            return 1;
+        }
+        if (map->num == map->max)
+        {
+            return 0;
+        }
+        memmove(&map->entries[pos+1], &map->entries[pos],
+                sizeof(map->entries[0]) * (map->num - pos));
+        map->entries[pos].id = id;
+        map->entries[pos].index = array_index;
+        map->num += 1;
+    }
+    if (id >= map->top)
+    {
+        map->top = id + 1;
+    }
+    return 1;
 }
 
 
@@ -96,7 +232,20 @@ pmd_idmap_lookup
     ,uint16_t *index        /**< [out] internal array index, if found */
     )
 {
-    *index = map->map[id];
+    if (map->map)
+    {
+        *index = map->map[id];
+    }
+    else
+    {
+        unsigned int pos = pmd_idmap_lower_bound(map, id);
+
+        *index = 0xffff;
+        if (pos < map->num && map->entries[pos].id == id)
+        {
+            *index = map->entries[pos].index;
+        }
+    }
     return (*index != 0xffff);
 }
 
@@ -115,19 +264,84 @@ pmd_idmap_iterate_next
 {
     unsigned int it = *count;
     assert(limit < MAP_SIZE);
-    while (it <= limit)
+    if (map->map)
     {
-        *value = map->map[it];
-        if (0xffff != *value)
+        while (it <= limit)
         {
-            *count = it + 1;
-            return 1;
+            *value = map->map[it];
+            if (0xffff != *value)
+            {
+                *count = it + 1;
+                return 1;
+            }
+            ++it;
+        }
+    }
+    else
+    {
+        unsigned int pos = pmd_idmap_lower_bound(map, it);
+
+        for (; pos < map->num && map->entries[pos].id <= limit; ++pos)
+        {
+            *value = map->entries[pos].index;
+            if (0xffff != *value)
+            {
+                *count = map->entries[pos].id + 1u;
+                return 1;
+            }
+        }
+        if (it <= limit)
+        {
+            it = limit + 1;
         }
-        ++it;
     }
     *count = it + 1;
     return 0;
 }
 
 
+/**
+ * @brief overwrite one map with another
+ *
+ * Two dense maps can only differ below the higher of their #top
+ * values, so that is all we need to look at.  Otherwise the
+ * destination is rebuilt from the source's mappings.
+ */
+static inline
+void
+pmd_idmap_copy
+    (pmd_idmap *dest        /**< [in] map to overwrite */
+    ,const pmd_idmap *src   /**< [in] map to copy */
+    )
+{
+    if (dest->map && src->map)
+    {
+        memmove(dest->map, src->map, sizeof(src->map[0]) * src->top);
+        if (dest->top > src->top)
+        {
+            memset(&dest->map[src->top], '\xff', sizeof(dest->map[0]) * (dest->top - src->top));
+        }
+        dest->top = src->top;
+    }
+    else if (!dest->map && !src->map && src->num <= dest->max)
+    {
+        memmove(dest->entries, src->entries, sizeof(src->entries[0]) * src->num);
+        dest->num = src->num;
+        dest->top = src->top;
+    }
+    else
+    {
+        unsigned int it = 0;
+        uint16_t value;
+
+        pmd_idmap_init(dest);
+        /* the caller has checked that dest can hold every entity of src */
+        while (src->top && pmd_idmap_iterate_next(src, src->top - 1, &it, &value))
+        {
+            (void)pmd_idmap_insert(dest, (uint16_t)(it - 1), value);
+        }
+    }
+}
+
+
 #endif /* PMD_IDMAP_H_ */
@@ -42,6 +42,7 @@
 #include "dlb_pmd/include/dlb_pmd_capture.h"
 #include "dlb_pmd/include/dlb_pmd_pcm.h"
 #include "pmd_profile.h"
+#include "pmd_s337m_scan.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -63,6 +64,8 @@ static int retstat(int s)
 #define PMD_PA_BLOCK_SPACING        (160)
 #define PMD_GUARD_BAND_SIZE         (32)
 #define PMD_2ND_BLOCK_SPACING       (PMD_PA_BLOCK_SPACING - PMD_GUARD_BAND_SIZE)
+#define PMD_FRAME_DONE_SAMPLES      (3 * PMD_PA_BLOCK_SPACING)
+#define NO_CHANNEL_RANK             ((size_t)~0)
 
 
 #ifdef __GNUC__
@@ -97,6 +100,7 @@ typedef enum
     CAPTOR_STATE_CLEAR,
     CAPTOR_STATE_CAPTURING,
     CAPTOR_STATE_GOOD,
+    CAPTOR_STATE_LOCKED,
     CAPTOR_STATE_DESTROYED
 } CAPTOR_STATE;
 
@@ -129,6 +133,14 @@ struct dlb_pmd_frame_captor
     feature_location_type            frame_end;
     dlb_pmd_frame_rate               frame_rate;
 
+    dlb_pmd_blob_descriptor          stream_descriptor;     /* format of the locked stream */
+    size_t                           stream_frame_count;    /* frames started in the current blob */
+    size_t                           stream_sync_samples;   /* samples since the last frame start */
+    dlb_pmd_payload_set_status       stream_payload_status; /* reports each decoded PMD block */
+    dlb_pmd_bool                     stream_pending;        /* decoded metadata not yet in the metadata set */
+    size_t                           stream_quiet_samples;  /* samples since the last decoded block */
+    int                              stream_set_status;     /* result of rebuilding the set from a callback */
+
     dlb_pmd_bool                     mallocated;
     CAPTOR_STATE                     captor_state;
 };
@@ -260,6 +272,14 @@ frame_captor_clear
         captor->frame_end = NO_METADATA;
         captor->frame_rate = NO_METADATA;
 
+        memset(&captor->stream_descriptor, 0, sizeof(captor->stream_descriptor));
+        captor->stream_frame_count = 0;
+        captor->stream_sync_samples = 0;
+        memset(&captor->stream_payload_status, 0, sizeof(captor->stream_payload_status));
+        captor->stream_pending = PMD_FALSE;
+        captor->stream_quiet_samples = 0;
+        captor->stream_set_status = DLB_PMD_FRAME_CAPTOR_STATUS_OK;
+
         captor->captor_state = CAPTOR_STATE_CLEAR;
     }
 }
@@ -487,6 +507,7 @@ int
 convert_channels
     (dlb_pmd_frame_captor   *captor
     ,size_t                  first_channel_index
+    ,size_t                  first_sample
     )
 {
     uint8_t *src_start;
@@ -516,12 +537,17 @@ convert_channels
     }
 
     blob_count = captor->blob_descriptor->number_of_samples;
+    if (first_sample > blob_count)
+    {
+        return DLB_PMD_FRAME_CAPTOR_STATUS_ERROR;
+    }
+    blob_count -= first_sample;
     data_buffer_count = (sizeof(captor->data_buffer) / sizeof(captor->data_buffer[0])) / channel_count;
     sample_count = ((blob_count < data_buffer_count) ? blob_count : data_buffer_count);
     src_sample_sz = captor->blob_descriptor->bit_depth / CHAR_BIT;
     src_stride = captor->blob_descriptor->number_of_channels * src_sample_sz;
     dest_start = captor->data_buffer;
-    src_start = (uint8_t *)captor->blob + first_channel_index * src_sample_sz;
+    src_start = (uint8_t *)captor->blob + first_sample * src_stride + first_channel_index * src_sample_sz;
     for (channel = 0; channel < channel_count; channel++)
     {
         buffer_data_type *dest = dest_start + channel;
@@ -550,6 +576,7 @@ scan_for_pa
     size_t current_sample;
     size_t last_sample;
     buffer_data_type *p;
+    buffer_data_type *end;
 
     if (captor == NULL)
     {
@@ -564,12 +591,14 @@ scan_for_pa
     p = captor->data_buffer;
     stride = captor->channel_count;
     last_sample = captor->sample_count - 2;
-    for (current_sample = 0; current_sample < last_sample; current_sample++)
+    end = p + last_sample * stride;
+    while ((p = (buffer_data_type *)pmd_s337m_find_pa(p, end, stride, stride)) < end)
     {
         buffer_data_type v0 = p[0];
         buffer_data_type v1 = p[1];
         buffer_data_type v2 = p[stride];
 
+        current_sample = (p - captor->data_buffer) / stride;
         if ((v0 == PA_16 && v1 == PB_16) ||
             (v0 == PA_20 && v1 == PB_20) ||
             (v0 == PA_24 && v1 == PB_24))
@@ -590,6 +619,87 @@ scan_for_pa
     return DLB_PMD_FRAME_CAPTOR_STATUS_OK;
 }
 
+/**
+ * @brief the order in which find_metadata_channel() tries a channel
+ *
+ * Even channels before the last are tried as the first of a pair, in
+ * order; the last channel is tried on its own, after all of them.
+ * Other channels are never the first one tried.
+ */
+static
+size_t                          /** @return rank, or NO_CHANNEL_RANK */
+channel_rank
+    (size_t channel
+    ,size_t channel_count
+    )
+{
+    size_t last_channel = channel_count - 1;
+
+    if (channel == last_channel)
+    {
+        return channel_count;
+    }
+    if (channel & 1)
+    {
+        return NO_CHANNEL_RANK;
+    }
+    return channel;
+}
+
+/**
+ * @brief find the first channel, in find_metadata_channel() order, whose
+ * samples contain a Pa sync word anywhere in the blob
+ *
+ * This looks at all channels of the raw blob at once, so that only the
+ * pairs that actually contain a Pa have to be converted and scanned.
+ */
+static
+int
+next_pa_channel
+    (dlb_pmd_frame_captor   *captor
+    ,size_t                  first_rank     /**< [in]  lowest rank to consider */
+    ,size_t                 *rank           /**< [out] rank of the channel found, or NO_CHANNEL_RANK */
+    )
+{
+    const dlb_pmd_blob_descriptor *descriptor = captor->blob_descriptor;
+    const uint8_t *blob = (const uint8_t *)captor->blob;
+    size_t channel_count = descriptor->number_of_channels;
+    size_t sample_sz = descriptor->bit_depth / CHAR_BIT;
+    size_t msb_offset = descriptor->big_endian ? sample_sz - 3 : sample_sz - 1;
+    size_t size = (size_t)descriptor->number_of_samples * channel_count * sample_sz;
+    size_t best = NO_CHANNEL_RANK;
+    size_t start = 0;
+
+    while (start < size && best != first_rank)
+    {
+        size_t pos = start + pmd_s337m_scan_msb(blob + start, size - start, sample_sz, msb_offset);
+        size_t sample_index = pos / sample_sz;
+        size_t r;
+
+        if (pos >= size)
+        {
+            break;
+        }
+
+        r = channel_rank(sample_index % channel_count, channel_count);
+        if (r != NO_CHANNEL_RANK && r >= first_rank && r < best)
+        {
+            buffer_data_type v;
+            int status = convert_sample(captor, &v, (void *)(blob + sample_index * sample_sz));
+
+            CHECK_STATUS(status);
+            if (v == PA_16 || v == PA_20 || v == PA_24)
+            {
+                best = r;
+            }
+        }
+        start = (sample_index + 1) * sample_sz;
+    }
+
+    *rank = best;
+    return DLB_PMD_FRAME_CAPTOR_STATUS_OK;
+}
+
 static
 int
 find_metadata_channel
@@ -598,18 +708,36 @@ find_metadata_channel
 {
     size_t last_channel;
     size_t channel;
+    size_t rank;
     int status;
 
-    if (captor == NULL || captor->blob_descriptor == NULL)
+    if (captor == NULL || captor->blob == NULL || captor->blob_descriptor == NULL)
     {
         return DLB_PMD_FRAME_CAPTOR_STATUS_NULL_POINTER;
     }
 
-    captor->channel_count = 2;
     last_channel = captor->blob_descriptor->number_of_channels - 1;
-    for (channel = 0; channel < last_channel; channel += 2)
+    rank = 0;
+    for (;;)
     {
-        status = convert_channels(captor, channel);
+        status = next_pa_channel(captor, rank, &rank);
+        CHECK_STATUS(status);
+        if (rank == NO_CHANNEL_RANK)
+        {
+            break;
+        }
+
+        if (rank < last_channel)
+        {
+            captor->channel_count = 2;
+            channel = rank;
+        }
+        else
+        {
+            captor->channel_count = 1;
+            channel = last_channel;
+        }
+        status = convert_channels(captor, channel, 0);
         CHECK_STATUS(status);
         status = scan_for_pa(captor);
         CHECK_STATUS(status);
@@ -617,17 +745,11 @@ find_metadata_channel
         {
             goto found;
         }
-    }
-
-    captor->channel_count = 1;
-    channel = last_channel;
-    status = convert_channels(captor, channel);
-    CHECK_STATUS(status);
-    status = scan_for_pa(captor);
-    CHECK_STATUS(status);
-    if (captor->pa_count > 0)
-    {
-        goto found;
+        if (captor->channel_count == 1)
+        {
+            break;
+        }
+        rank += 2;
     }
 
     return DLB_PMD_FRAME_CAPTOR_STATUS_NOT_FOUND;
@@ -794,6 +916,26 @@ find_frame
     return status;
 }
 
+/**
+ * @brief payload set callback: a PMD block has been decoded into the model
+ *
+ * The frame it belongs to may have more blocks to come, so the metadata set
+ * is not rebuilt yet.
+ */
+static
+int
+stream_block_decoded
+    (dlb_pmd_payload_set_status *payload_set_status
+    )
+{
+    dlb_pmd_frame_captor *captor = (dlb_pmd_frame_captor *)payload_set_status->callback_arg;
+
+    captor->stream_pending = PMD_TRUE;
+    captor->stream_quiet_samples = 0;
+
+    return 0;
+}
+
 static
 int
 extract_model
@@ -807,6 +949,12 @@ extract_model
         return DLB_PMD_FRAME_CAPTOR_STATUS_NULL_POINTER;
     }
 
+    if (dlb_pmd_initialize_payload_set_status_with_callback(&captor->stream_payload_status, NULL, 0,
+                                                            captor, stream_block_decoded))
+    {
+        return DLB_PMD_FRAME_CAPTOR_STATUS_ERROR;
+    }
+
     dlb_pcmpmd_extractor_init2
     (
         &captor->extractor,
@@ -816,7 +964,7 @@ extract_model
         (unsigned int)captor->channel_count,
         captor->is_pair,
         captor->model,
-        NULL,
+        &captor->stream_payload_status,
         PMD_TRUE
     );
 
@@ -873,7 +1021,7 @@ dlb_pmd_frame_captor_capture
     }
 
     if (captor->captor_state         <  CAPTOR_STATE_CLEAR  ||
-        captor->captor_state         >  CAPTOR_STATE_GOOD   ||
+        captor->captor_state         >  CAPTOR_STATE_LOCKED ||
         check_descriptor(descriptor) != PMD_SUCCESS)
     {
         return DLB_PMD_FRAME_CAPTOR_STATUS_ERROR;
@@ -898,6 +1046,213 @@ dlb_pmd_frame_captor_capture
     return status;
 }
 
+/**
+ * @brief extractor callback: a new frame has started
+ *
+ * The new frame's first block has not been decoded yet, so the model still
+ * holds the whole of the previous frame.  If that has not reached the
+ * metadata set, this is the last chance to put it there.
+ */
+static
+void
+stream_new_frame
+    (void *arg
+    )
+{
+    dlb_pmd_frame_captor *captor = (dlb_pmd_frame_captor *)arg;
+
+    captor->stream_frame_count++;
+    if (captor->stream_pending)
+    {
+        captor->stream_pending = PMD_FALSE;
+        captor->stream_set_status = create_metadata_set(captor);
+    }
+}
+
+/**
+ * @brief extractor callback: an sADM burst has been decoded
+ *
+ * A frame's sADM arrives in a single burst, so the frame is complete.
+ */
+static
+void
+stream_sadm_decoded
+    (void               *arg
+    ,void               *buff
+    ,size_t              size
+    ,dlb_pcmsadm_status  result
+    )
+{
+    dlb_pmd_frame_captor *captor = (dlb_pmd_frame_captor *)arg;
+
+    (void)buff;
+    (void)size;
+    if (result == DLB_PCMSADM_OK)
+    {
+        captor->stream_pending = PMD_TRUE;
+        captor->stream_quiet_samples = PMD_FRAME_DONE_SAMPLES;
+    }
+}
+
+/**
+ * @brief rebuild the metadata set once the frame being decoded is complete
+ *
+ * A frame's PMD blocks start every PMD_PA_BLOCK_SPACING samples, so no two
+ * are ever decoded more than two block spacings apart.  Samples are fed at
+ * most one block spacing at a time, so once PMD_FRAME_DONE_SAMPLES have been
+ * counted since the last decoded block, there are no more blocks to come.
+ */
+static
+int
+stream_refresh
+    (dlb_pmd_frame_captor *captor
+    ,size_t                sample_count     /**< [in] samples just fed to the extractor */
+    )
+{
+    int status = captor->stream_set_status;
+
+    captor->stream_set_status = DLB_PMD_FRAME_CAPTOR_STATUS_OK;
+    CHECK_STATUS(status);
+    if (captor->stream_pending)
+    {
+        captor->stream_quiet_samples += sample_count;
+        if (captor->stream_quiet_samples >= PMD_FRAME_DONE_SAMPLES)
+        {
+            captor->stream_pending = PMD_FALSE;
+            status = create_metadata_set(captor);
+        }
+    }
+
+    return status;
+}
+
+static
+dlb_pmd_bool
+same_stream_format
+    (const dlb_pmd_blob_descriptor *a
+    ,const dlb_pmd_blob_descriptor *b
+    )
+{
+    return a->number_of_channels == b->number_of_channels &&
+           a->bit_depth          == b->bit_depth          &&
+           !a->big_endian        == !b->big_endian;
+}
+
+static
+int
+stream_extract
+    (dlb_pmd_frame_captor *captor
+    ,size_t                first_sample
+    )
+{
+    size_t blob_count = captor->blob_descriptor->number_of_samples;
+    size_t offset;
+    size_t count;
+    int status;
+
+    /* Only the locked channel(s) are converted, and the extractor keeps its
+     * frame and block position from the previous blob, so there is no
+     * discovery to do: just hand the samples over, a block spacing at a
+     * time so that stream_refresh() can tell when a frame is complete.
+     */
+    captor->stream_frame_count = 0;
+    while (first_sample < blob_count)
+    {
+        status = convert_channels(captor, captor->metadata_channel_index, first_sample);
+        CHECK_STATUS(status);
+        for (offset = 0; offset < captor->sample_count; offset += count)
+        {
+            count = captor->sample_count - offset;
+            if (count > PMD_PA_BLOCK_SPACING)
+            {
+                count = PMD_PA_BLOCK_SPACING;
+            }
+            if (dlb_pcmpmd_extract3(captor->extractor, captor->data_buffer + offset * captor->channel_count, count,
+                                    stream_new_frame, stream_sadm_decoded, NULL, captor, NULL))
+            {
+                return DLB_PMD_FRAME_CAPTOR_STATUS_ERROR;
+            }
+            status = stream_refresh(captor, count);
+            CHECK_STATUS(status);
+        }
+        first_sample += captor->sample_count;
+    }
+
+    if (captor->stream_frame_count > 0)
+    {
+        captor->stream_sync_samples = 0;
+    }
+    else
+    {
+        /* no frame started in this blob; allow for frame size jitter
+         * (e.g., 29.97 fps) before declaring the stream lost */
+        captor->stream_sync_samples += blob_count;
+        if (captor->stream_sync_samples > 2 * (size_t)dlb_pcmpmd_min_frame_size(captor->frame_rate))
+        {
+            return DLB_PMD_FRAME_CAPTOR_STATUS_NOT_FOUND;
+        }
+    }
+
+    return DLB_PMD_FRAME_CAPTOR_STATUS_OK;
+}
+
+int
+dlb_pmd_frame_captor_stream
+    (dlb_pmd_metadata_set           **metadata_set
+    ,dlb_pmd_frame_captor            *captor
+    ,const dlb_pmd_blob_descriptor   *descriptor
+    ,const void                      *data_blob
+    )
+{
+    int status = DLB_PMD_FRAME_CAPTOR_STATUS_ERROR;
+
+    if (metadata_set == NULL ||
+        captor       == NULL ||
+        data_blob    == NULL)
+    {
+        return DLB_PMD_FRAME_CAPTOR_STATUS_NULL_POINTER;
+    }
+
+    if (captor->captor_state <  CAPTOR_STATE_CLEAR  ||
+        captor->captor_state >  CAPTOR_STATE_LOCKED ||
+        descriptor           == NULL)
+    {
+        return DLB_PMD_FRAME_CAPTOR_STATUS_ERROR;
+    }
+
+    /* once locked, a blob of any length continues the stream; the full
+     * search below checks the descriptor as capture does */
+    if (captor->captor_state == CAPTOR_STATE_LOCKED &&
+        descriptor->number_of_samples > 0 &&
+        same_stream_format(&captor->stream_descriptor, descriptor))
+    {
+        captor->blob_descriptor = descriptor;
+        captor->blob = data_blob;
+        status = stream_extract(captor, 0);
+        if (status == DLB_PMD_FRAME_CAPTOR_STATUS_OK)
+        {
+            *metadata_set = captor->metadata_set;
+            return status;
+        }
+        /* lost sync: fall back to a full search of this blob */
+    }
+
+    status = dlb_pmd_frame_captor_capture(metadata_set, captor, descriptor, data_blob);
+    CHECK_STATUS(status);
+
+    /* lock on, and carry the extractor on from the end of the captured frame;
+     * if that fails we still have this frame, and search again next time */
+    captor->stream_descriptor = *descriptor;
+    captor->stream_sync_samples = 0;
+    captor->stream_pending = PMD_FALSE;
+    if (stream_extract(captor, captor->frame_end) == DLB_PMD_FRAME_CAPTOR_STATUS_OK)
+    {
+        captor->captor_state = CAPTOR_STATE_LOCKED;
+    }
+
+    return status;
+}
+
 int
 dlb_pmd_frame_captor_close
     (dlb_pmd_frame_captor   **captor
@@ -913,7 +1268,7 @@ dlb_pmd_frame_captor_close
     fc = *captor;
 
     state = fc->captor_state;
-    if (state < CAPTOR_STATE_CLEAR || state > CAPTOR_STATE_GOOD)
+    if (state < CAPTOR_STATE_CLEAR || state > CAPTOR_STATE_LOCKED)
     {
         return DLB_PMD_FRAME_CAPTOR_STATUS_ERROR;
     }
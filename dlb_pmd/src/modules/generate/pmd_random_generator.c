@@ -80,6 +80,14 @@ __pragma(warning(disable:4244))
 #define MIN(a,b) (((a) < (b)) ? (a) : (b))
 
 
+/**
+ * @def MAX_UPDATE_POPULATION
+ * @brief upper limit on the (dynamic object, update time) pairs we choose
+ * updates from, so that they fit in one random population
+ */
+#define MAX_UPDATE_POPULATION (MAX_BITSET_WORD32 * WORD32_BITS - 1)
+
+
 /**
  * @brief table of speaker counts for PMD speaker configs
  */
@@ -913,7 +921,7 @@ generate_objs
             obj.diverge         = generate_bool(g);
 
             /* has this already been tagged as a dynamic object? */
-            while (*dynobjs && *dynobjs > obj.id)
+            while (*dynobjs && *dynobjs < obj.id)
             {
                 ++dynobjs;
             }
@@ -1331,7 +1339,7 @@ generate_xyz
         /* we want to randomly distribute the updates across two dimensions:
          * the set of objects, and the set of times, 0 - 63 (times 32)
          */
-        population_max = g->num_dynamic_objects * 64;
+        population_max = MIN(g->num_dynamic_objects * 64, MAX_UPDATE_POPULATION);
         generate_random_population(g, population_max, count);
         
         for (i = 0; i != count; ++i)
@@ -1567,6 +1575,7 @@ dlb_pmd_generate_random
     if (sadm)
     {
         /* restrict random counts to beds, objects, presentations only */
+        counts.num_updates = 0;
         counts.num_loudness = 0;
         counts.num_iat = 0;
         counts.num_eac3 = 0;
@@ -1603,7 +1612,8 @@ dlb_pmd_generate_random
     generate_signal_ids(g, counts.num_signals);
     generate_element_ids(g, counts.num_beds, counts.num_objects);
 
-    entity_limit = MIN(g->num_dynamic_objects * 64, limits->num_updates);
+    entity_limit = MIN(g->num_dynamic_objects * 64, MAX_UPDATE_POPULATION);
+    entity_limit = MIN(entity_limit, limits->num_updates);
     check_count(&g->kiss, &counts.num_updates,         0, entity_limit);
     check_count(&g->kiss, &counts.num_presentations,   1, limits->num_presentations);
 
@@ -164,8 +164,14 @@ klv_aen_read
         {
             /* allow as yet unknown names */            
             idx = r->model->num_aen;
+            if (!pmd_idmap_insert(r->aen_ids, eid, idx))
+            {
+                klv_reader_error_at(r, DLB_PMD_PAYLOAD_STATUS_OUT_OF_MEMORY, read_status,
+                                    "No space for name of audio element %u in model\n",
+                                    (unsigned int)eid);
+                return 1;
+            }
             r->model->num_aen += 1;
-            pmd_idmap_insert(r->aen_ids, eid, idx);
         }
 
         e = &r->model->aen_list[idx];
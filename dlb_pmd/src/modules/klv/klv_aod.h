@@ -175,7 +175,12 @@ klv_aod_read
             }            
 
             idx = (uint16_t)model->num_elements;
-            pmd_idmap_insert(r->element_ids, id, idx);
+            if (!pmd_idmap_insert(r->element_ids, id, idx))
+            {
+                klv_reader_error_at(r, DLB_PMD_PAYLOAD_STATUS_OUT_OF_MEMORY, read_status,
+                                    "No space for AOD element id %u in model\n", (unsigned int)id);
+                return 1;
+            }
             model->num_elements += 1;
         }
 
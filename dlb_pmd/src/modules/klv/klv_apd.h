@@ -185,7 +185,12 @@ klv_apd_read
             }            
 
             idx = (uint16_t)model->num_apd;
-            pmd_idmap_insert(r->apd_ids, id, idx);
+            if (!pmd_idmap_insert(r->apd_ids, id, idx))
+            {
+                klv_reader_error_at(r, DLB_PMD_PAYLOAD_STATUS_OUT_OF_MEMORY, read_status,
+                                    "No space for APD presentation id %u in model\n", (unsigned int)id);
+                return 1;
+            }
             model->num_apd += 1;
         }
       
@@ -330,7 +330,12 @@ klv_eep_read
             }            
 
             idx = (uint16_t)model->num_eep;
-            pmd_idmap_insert(r->eep_ids, id, idx);
+            if (!pmd_idmap_insert(r->eep_ids, id, idx))
+            {
+                klv_reader_error_at(r, DLB_PMD_PAYLOAD_STATUS_OUT_OF_MEMORY, read_status,
+                                    "No space for EEP payload id %u in model\n", (unsigned int)id);
+                return 1;
+            }
             model->num_eep += 1;
         }
         TRACE(("        %u\n", id));
@@ -297,7 +297,12 @@ klv_etd_read
                 return 1;
             }
             idx = model->num_etd;
-            pmd_idmap_insert(r->etd_ids, id, idx);
+            if (!pmd_idmap_insert(r->etd_ids, id, idx))
+            {
+                klv_reader_error_at(r, DLB_PMD_PAYLOAD_STATUS_OUT_OF_MEMORY, read_status,
+                                    "No space for ETD payload id %u in model\n", (unsigned int)id);
+                return 1;
+            }
             model->num_etd += 1;
         }
         TRACE(("        %u\n", id));
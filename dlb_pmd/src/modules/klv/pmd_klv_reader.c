@@ -340,7 +340,7 @@ klv_read_local_keys
 
             case KLV_PMD_LOCAL_TAG_DYNAMIC_UPDATES:
                 TRACE(("    read dynamic update...\n"));
-                if (read_status && read_status->xyz_payload_count <= read_status->xyz_payload_count_max)
+                if (read_status && read_status->xyz_payload_count < read_status->xyz_payload_count_max)
                 {
                     current_status_record = &read_status->xyz_payload_status[read_status->xyz_payload_count++];
                 }
@@ -87,6 +87,7 @@ struct dlb_pcmpmd_augmentor
     uint8_t                     *klvp;                      /**< current read pointer of klvbuf */
     size_t                       klvsize;                   /**< bytes remaining in block */
     pmd_s337m                    s337m;                     /**< SMPTE 337m wrapping state */
+    unsigned int                 wrap_depth;                /**< requested SMPTE 337m wrapping bit depth */
     unsigned int                 samples;                   /**< samples remaining to write in current block */
     dlb_pmd_frame_rate           rate;                      /**< video frame rate */
     unsigned int                 numchannels;               /**< number of channels of PCM */
@@ -196,7 +197,7 @@ dlb_pcmpmd_augmentor_query_mem
 
 
 void
-dlb_pcmpmd_augmentor_init3
+dlb_pcmpmd_augmentor_init5
     (dlb_pcmpmd_augmentor **augptr
     ,dlb_pmd_model_combo            *model
     ,void *mem
@@ -209,6 +210,9 @@ dlb_pcmpmd_augmentor_init3
     ,dlb_pmd_bool                    is_pair
     ,unsigned int start
     ,dlb_pmd_bool sadm
+    ,int sadm_level
+    ,dlb_pcmpmd_sadm_strategy sadm_strategy
+    ,dlb_pmd_bool sadm_dictionary
     )
 {
     dlb_pcmpmd_augmentor *aug = (dlb_pcmpmd_augmentor *)mem;
@@ -264,8 +268,83 @@ dlb_pcmpmd_augmentor_init3
         char *p = (char *)aug;
         p += sizeof(*aug);
         sadm_bitstream_encoder_init((void *)p, &aug->senc);
+        sadm_bitstream_encoder_track_changes(aug->senc, PMD_TRUE);
+        if ((sadm_level < 0) || (sadm_level > DLB_PCMPMD_SADM_COMPRESSION_DEFAULT))
+        {
+            sadm_level = DLB_PCMPMD_SADM_COMPRESSION_DEFAULT;
+        }
+        if (sadm_bitstream_encoder_set_compression(aug->senc, sadm_level, (int)sadm_strategy))
+        {
+            (void)sadm_bitstream_encoder_set_compression(aug->senc, sadm_level, (int)DLB_PCMPMD_SADM_STRATEGY_DEFAULT);
+        }
+        sadm_bitstream_encoder_use_dictionary(aug->senc, sadm_dictionary);
     }
+    aug->wrap_depth = wd;
     pmd_s337m_init(&aug->s337m, wd, stride, pcm_next_block, aug, is_pair, start, mark_empty_blocks, sadm);
+    aug->s337m.sadm_dict = sadm && sadm_dictionary;
+}
+
+
+void
+dlb_pcmpmd_augmentor_restart
+    (dlb_pcmpmd_augmentor *aug
+    )
+{
+    pmd_s337m *s337m = &aug->s337m;
+    unsigned int stride = s337m->stride;
+    dlb_pmd_bool pair = s337m->pair;
+    dlb_pmd_bool mark_empty = s337m->mark_empty;
+    dlb_pmd_bool sadm_dict = s337m->sadm_dict;
+
+    aug->block = ~0u;
+    pmd_s337m_init(s337m, aug->wrap_depth, stride, pcm_next_block, aug, pair, aug->klvchan, mark_empty, aug->sadm);
+    s337m->sadm_dict = sadm_dict;
+}
+
+
+void
+dlb_pcmpmd_augmentor_init4
+    (dlb_pcmpmd_augmentor **augptr
+    ,dlb_pmd_model_combo            *model
+    ,void *mem
+    ,unsigned int wrap_depth
+    ,dlb_pmd_frame_rate rate
+    ,dlb_klvpmd_universal_label ul
+    ,dlb_pmd_bool mark_empty_blocks
+    ,unsigned int numchannels
+    ,unsigned int stride
+    ,dlb_pmd_bool                    is_pair
+    ,unsigned int start
+    ,dlb_pmd_bool sadm
+    ,int sadm_level
+    ,dlb_pcmpmd_sadm_strategy sadm_strategy
+    )
+{
+    dlb_pcmpmd_augmentor_init5(augptr, model, mem, wrap_depth, rate, ul, mark_empty_blocks,
+                               numchannels, stride, is_pair, start, sadm,
+                               sadm_level, sadm_strategy, PMD_FALSE);
+}
+
+
+void
+dlb_pcmpmd_augmentor_init3
+    (dlb_pcmpmd_augmentor **augptr
+    ,dlb_pmd_model_combo            *model
+    ,void *mem
+    ,unsigned int wrap_depth
+    ,dlb_pmd_frame_rate rate
+    ,dlb_klvpmd_universal_label ul
+    ,dlb_pmd_bool mark_empty_blocks
+    ,unsigned int numchannels
+    ,unsigned int stride
+    ,dlb_pmd_bool                    is_pair
+    ,unsigned int start
+    ,dlb_pmd_bool sadm
+    )
+{
+    dlb_pcmpmd_augmentor_init4(augptr, model, mem, wrap_depth, rate, ul, mark_empty_blocks,
+                               numchannels, stride, is_pair, start, sadm,
+                               DLB_PCMPMD_SADM_COMPRESSION_DEFAULT, DLB_PCMPMD_SADM_STRATEGY_DEFAULT);
 }
 
 
@@ -550,6 +629,21 @@ dlb_pcmpmd_augment2
 }
 
 
+void
+dlb_pcmpmd_augmentor_set_model
+    (dlb_pcmpmd_augmentor *aug
+    ,dlb_pmd_model_combo  *model
+    )
+{
+    aug->model = model;
+    if (aug->sadm)
+    {
+        /* the payload cache is keyed on the generation of the old model */
+        aug->senc->cache_valid = PMD_FALSE;
+    }
+}
+
+
 void
 dlb_pcmpmd_augment
     (dlb_pcmpmd_augmentor *aug
@@ -185,7 +185,7 @@ sadm_dec_callback
 
     if (ext->sadm_callback)
     {
-        if (state != SADM_DECOMPRESS_ERR)
+        if (state != SADM_DECOMPRESS_ERR && ext->sadm_xml_buf != NULL)
         {
             memcpy(ext->sadm_xml_buf, ext->sdec->xmlbuf, ext->sdec->size);
         }
@@ -411,7 +411,10 @@ dlb_pcmpmd_extractor_finish
     (dlb_pcmpmd_extractor *ext
     )
 {
-    (void)ext;
+    if (ext != NULL)
+    {
+        sadm_bitstream_decoder_finish(ext->sdec);
+    }
 }
 
 
@@ -0,0 +1,287 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+/**
+ * @file pmd_s337m_scan.c
+ * @brief vectorised search for SMPTE 337m Pa sync words
+ */
+
+#include "pmd_s337m_scan.h"
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#  define S337M_SCAN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define S337M_SCAN_SSE2
+#endif
+
+#ifdef _MSC_VER
+#  include <intrin.h>
+#  define inline __inline
+#endif
+
+
+/**
+ * @brief SMPTE 337m Pa sync words, and their most significant bytes
+ */
+#define PA_16      (0xf8720000u)
+#define PA_20      (0x6f872000u)
+#define PA_24      (0x96f87200u)
+
+#define PA_16_MSB  ((uint8_t)(PA_16 >> 24))
+#define PA_20_MSB  ((uint8_t)(PA_20 >> 24))
+#define PA_24_MSB  ((uint8_t)(PA_24 >> 24))
+
+
+static inline
+dlb_pmd_bool
+is_pa
+    (uint32_t word
+    )
+{
+    return word == PA_16 || word == PA_20 || word == PA_24;
+}
+
+
+static inline
+dlb_pmd_bool
+is_pa_msb
+    (uint8_t byte
+    )
+{
+    return byte == PA_16_MSB || byte == PA_20_MSB || byte == PA_24_MSB;
+}
+
+
+#if defined(S337M_SCAN_AVX2) || defined(S337M_SCAN_SSE2)
+static inline
+unsigned int                /** @return index of the lowest set bit of a non-zero mask */
+lowest_bit
+    (uint32_t mask
+    )
+{
+#if defined(_MSC_VER)
+    unsigned long i;
+
+    _BitScanForward(&i, mask);
+    return (unsigned int)i;
+#else
+    return (unsigned int)__builtin_ctz(mask);
+#endif
+}
+#endif
+
+
+/**
+ * @brief find the first Pa in a run of contiguous words
+ */
+static inline
+const uint32_t *            /** @return first Pa word, or #end */
+find_pa_contiguous
+    (const uint32_t *pcm
+    ,const uint32_t *end
+    )
+{
+#if defined(S337M_SCAN_AVX2)
+    const __m256i pa16 = _mm256_set1_epi32((int)PA_16);
+    const __m256i pa20 = _mm256_set1_epi32((int)PA_20);
+    const __m256i pa24 = _mm256_set1_epi32((int)PA_24);
+
+    while (end - pcm >= 8)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)pcm);
+        __m256i m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi32(v, pa16),
+                                                     _mm256_cmpeq_epi32(v, pa20)),
+                                    _mm256_cmpeq_epi32(v, pa24));
+        uint32_t bits = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(m));
+
+        if (bits)
+        {
+            return pcm + lowest_bit(bits);
+        }
+        pcm += 8;
+    }
+#elif defined(S337M_SCAN_SSE2)
+    const __m128i pa16 = _mm_set1_epi32((int)PA_16);
+    const __m128i pa20 = _mm_set1_epi32((int)PA_20);
+    const __m128i pa24 = _mm_set1_epi32((int)PA_24);
+
+    while (end - pcm >= 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)pcm);
+        __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi32(v, pa16),
+                                              _mm_cmpeq_epi32(v, pa20)),
+                                 _mm_cmpeq_epi32(v, pa24));
+        uint32_t bits = (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(m));
+
+        if (bits)
+        {
+            return pcm + lowest_bit(bits);
+        }
+        pcm += 4;
+    }
+#endif
+
+    while (pcm < end && !is_pa(*pcm))
+    {
+        ++pcm;
+    }
+    return pcm;
+}
+
+
+const uint32_t *
+pmd_s337m_find_pa
+    (const uint32_t *pcm
+    ,const uint32_t *end
+    ,size_t stride
+    ,size_t width
+    )
+{
+    if (pcm >= end)
+    {
+        return pcm;
+    }
+
+    if (stride == width)
+    {
+        /* the channel (or pair) is the whole buffer: scan it as one run */
+        size_t words = (size_t)(find_pa_contiguous(pcm, end) - pcm);
+        size_t samples = (words < (size_t)(end - pcm)) ? words / width : (words + width - 1) / width;
+
+        return pcm + samples * stride;
+    }
+
+    if (width > 1)
+    {
+        while (pcm < end && !is_pa(pcm[0]) && !is_pa(pcm[1]))
+        {
+            pcm += stride;
+        }
+    }
+    else
+    {
+        while (pcm < end && !is_pa(pcm[0]))
+        {
+            pcm += stride;
+        }
+    }
+    return pcm;
+}
+
+
+size_t
+pmd_s337m_scan_msb
+    (const uint8_t *buf
+    ,size_t size
+    ,size_t sample_size
+    ,size_t msb_offset
+    )
+{
+    size_t pos = 0;
+
+    if (sample_size == 0 || sample_size > 16 || msb_offset >= sample_size)
+    {
+        return size;
+    }
+
+#if defined(S337M_SCAN_AVX2) || defined(S337M_SCAN_SSE2)
+    {
+#if defined(S337M_SCAN_AVX2)
+        const size_t block = 32;
+        const __m256i msb16 = _mm256_set1_epi8((char)PA_16_MSB);
+        const __m256i msb20 = _mm256_set1_epi8((char)PA_20_MSB);
+        const __m256i msb24 = _mm256_set1_epi8((char)PA_24_MSB);
+#else
+        const size_t block = 16;
+        const __m128i msb16 = _mm_set1_epi8((char)PA_16_MSB);
+        const __m128i msb20 = _mm_set1_epi8((char)PA_20_MSB);
+        const __m128i msb24 = _mm_set1_epi8((char)PA_24_MSB);
+#endif
+        uint32_t masks[16];     /* MSB lanes of a block, by the block's phase within a sample */
+        size_t phase;
+        size_t i;
+
+        for (phase = 0; phase < sample_size; ++phase)
+        {
+            masks[phase] = 0;
+            for (i = 0; i < block; ++i)
+            {
+                if ((phase + i) % sample_size == msb_offset)
+                {
+                    masks[phase] |= 1u << i;
+                }
+            }
+        }
+
+        phase = 0;
+        while (size - pos >= block)
+        {
+#if defined(S337M_SCAN_AVX2)
+            __m256i v = _mm256_loadu_si256((const __m256i *)(buf + pos));
+            __m256i m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, msb16),
+                                                         _mm256_cmpeq_epi8(v, msb20)),
+                                        _mm256_cmpeq_epi8(v, msb24));
+            uint32_t bits = (uint32_t)_mm256_movemask_epi8(m) & masks[phase];
+#else
+            __m128i v = _mm_loadu_si128((const __m128i *)(buf + pos));
+            __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, msb16),
+                                                  _mm_cmpeq_epi8(v, msb20)),
+                                     _mm_cmpeq_epi8(v, msb24));
+            uint32_t bits = (uint32_t)_mm_movemask_epi8(m) & masks[phase];
+#endif
+            if (bits)
+            {
+                return pos + lowest_bit(bits);
+            }
+            pos += block;
+            phase = (phase + block) % sample_size;
+        }
+    }
+#endif
+
+    /* first MSB position at or after pos */
+    pos += (msb_offset + sample_size - pos % sample_size) % sample_size;
+    for (; pos < size; pos += sample_size)
+    {
+        if (is_pa_msb(buf[pos]))
+        {
+            return pos;
+        }
+    }
+    return size;
+}
@@ -0,0 +1,97 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#ifndef PMD_S337M_SCAN_H_
+#define PMD_S337M_SCAN_H_
+
+/**
+ * @file pmd_s337m_scan.h
+ * @brief vectorised search for SMPTE 337m Pa sync words
+ *
+ * Finding the start of a data burst means looking at every sample of
+ * every candidate channel, although metadata appears on at most one
+ * pair.  These helpers do the looking many words at a time (AVX2 when
+ * the compiler targets it, otherwise SSE2 on x86, otherwise plain C) and
+ * report candidates only; the callers' state machines still verify them.
+ */
+
+#include "dlb_pmd_types.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief find the first sample set that contains a Pa sync word
+ *
+ * Examines the first #width words (1 for a single channel, 2 for a pair)
+ * of each sample set from #pcm up to #end, #stride words apart, and
+ * matches the 16-, 20- and 24-bit Pa values exactly.
+ */
+const uint32_t *                  /** @return first matching sample set, or the first one at or after #end */
+pmd_s337m_find_pa
+    (const uint32_t *pcm          /**< [in] first word of the first sample set to examine */
+    ,const uint32_t *end          /**< [in] 1st word after the PCM block */
+    ,size_t stride                /**< [in] PCM channel stride */
+    ,size_t width                 /**< [in] words to examine per sample set, 1 or 2 */
+    );
+
+
+/**
+ * @brief find the next sample whose most significant byte could begin a Pa
+ *
+ * Works on raw interleaved PCM bytes of any channel count and byte order,
+ * examining a whole vector of channels per instruction.  A hit only means
+ * that the most significant byte of the sample matches that of one of the
+ * Pa sync words; callers must convert the sample and compare it in full.
+ */
+size_t                            /** @return byte offset of the first candidate's MSB, or #size if none */
+pmd_s337m_scan_msb
+    (const uint8_t *buf           /**< [in] interleaved PCM bytes */
+    ,size_t size                  /**< [in] number of bytes to examine */
+    ,size_t sample_size           /**< [in] bytes per sample, 1 to 16 */
+    ,size_t msb_offset            /**< [in] offset of the most significant byte within each sample */
+    );
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* PMD_S337M_SCAN_H_ */
@@ -51,6 +51,7 @@ __pragma(warning(disable:4204))
 #include <stdlib.h>
 
 #include "pmd_smpte_337m.h"
+#include "pmd_s337m_scan.h"
 #include "dlb_pmd_pcm.h"
 
 
@@ -135,7 +136,12 @@ enum serial_adm_defs
     SADM_FORMAT_TYPE      = 1,  /* gzip, as specified in RFC-1952) */
     SADM_FORMAT_INFO_16   = (SADM_FORMAT_TYPE) << 16,
     SADM_FORMAT_INFO_20   = (SADM_FORMAT_TYPE << 4) << 12,
-    SADM_FORMAT_INFO_24   = (SADM_FORMAT_TYPE << 8) << 8
+    SADM_FORMAT_INFO_24   = (SADM_FORMAT_TYPE << 8) << 8,
+
+    SADM_FORMAT_TYPE_DICT      = 2,  /* zlib (RFC-1950) with the built-in ADM preset dictionary */
+    SADM_FORMAT_INFO_DICT_16   = (SADM_FORMAT_TYPE_DICT) << 16,
+    SADM_FORMAT_INFO_DICT_20   = (SADM_FORMAT_TYPE_DICT << 4) << 12,
+    SADM_FORMAT_INFO_DICT_24   = (SADM_FORMAT_TYPE_DICT << 8) << 8
 };
 
 
@@ -175,43 +181,84 @@ enum s337m_values
 };
 
 
+/**
+ * @brief the bit-depth dependent words of a SMPTE 337m data burst
+ *
+ * The wrapper looks these up once per bit depth rather than once per
+ * preamble word.
+ */
+struct s337m_words
+{
+    uint32_t pa;                /**< preamble a */
+    uint32_t pb;                /**< preamble b */
+    uint32_t pc_pmd;            /**< PMD preamble c data mode & data type */
+    uint32_t pc_sadm;           /**< sADM preamble c */
+    uint32_t pe_sadm;           /**< sADM preamble e */
+    uint32_t format_info;       /**< sADM format_info, gzip */
+    uint32_t format_info_dict;  /**< sADM format_info, zlib with preset dictionary */
+    uint32_t assemble_info;     /**< sADM assemble_info */
+};
+
+
+static const struct s337m_words S337M_WORDS_16 =
+{
+    (uint32_t)PA_16, (uint32_t)PB_16, (uint32_t)PMD_PC_16, (uint32_t)PC_SADM_16, (uint32_t)PE_SADM_16,
+    (uint32_t)SADM_FORMAT_INFO_16, (uint32_t)SADM_FORMAT_INFO_DICT_16, (uint32_t)SADM_ASSEMBLE_INFO_16
+};
+
+
+static const struct s337m_words S337M_WORDS_20 =
+{
+    (uint32_t)PA_20, (uint32_t)PB_20, (uint32_t)PMD_PC_20, (uint32_t)PC_SADM_20, (uint32_t)PE_SADM_20,
+    (uint32_t)SADM_FORMAT_INFO_20, (uint32_t)SADM_FORMAT_INFO_DICT_20, (uint32_t)SADM_ASSEMBLE_INFO_20
+};
+
+
+static const struct s337m_words S337M_WORDS_24 =
+{
+    (uint32_t)PA_24, (uint32_t)PB_24, (uint32_t)PMD_PC_24, (uint32_t)PC_SADM_24, (uint32_t)PE_SADM_24,
+    (uint32_t)SADM_FORMAT_INFO_24, (uint32_t)SADM_FORMAT_INFO_DICT_24, (uint32_t)SADM_ASSEMBLE_INFO_24
+};
+
+
+/**
+ * @brief all-zero words for unsupported bit depths
+ */
+static const struct s337m_words S337M_WORDS_NONE = { 0 };
+
+
 static inline
-uint32_t                      /** @return correct value for bit depth */
-select_s337m_value
+void
+select_s337m_words
     (pmd_s337m *s337m         /**< [in] PCM smpte state */
-    ,int32_t v16              /**< [in] bit depth 16 value */
-    ,int32_t v20              /**< [in] bit depth 20 value */
-    ,int32_t v24              /**< [in] bit depth 24 value */
     )
 {
-    int32_t v = 0;
-
     switch (s337m->bit_depth)
     {
     case 16:
-        v = v16;
+        s337m->words = &S337M_WORDS_16;
         break;
     case 20:
-        v = v20;
+        s337m->words = &S337M_WORDS_20;
         break;
     case 24:
-        v = v24;
+        s337m->words = &S337M_WORDS_24;
         break;
     default:
+        s337m->words = &S337M_WORDS_NONE;
         break;
     }
-
-    return (uint32_t)v;
 }
 
 
-#define PA_VALUE(S) select_s337m_value(S, PA_16, PA_20, PA_24)
-#define PB_VALUE(S) select_s337m_value(S, PB_16, PB_20, PB_24)
-#define PC_PMD_VALUE(S) select_s337m_value(S, PMD_PC_16, PMD_PC_20, PMD_PC_24)
-#define PC_SADM_VALUE(S) select_s337m_value(S, PC_SADM_16, PC_SADM_20, PC_SADM_24)
-#define PE_SADM_VALUE(S) select_s337m_value(S, PE_SADM_16, PE_SADM_20, PE_SADM_24)
-#define SADM_FORMAT_INFO_VALUE(S) select_s337m_value(S, SADM_FORMAT_INFO_16, SADM_FORMAT_INFO_20, SADM_FORMAT_INFO_24)
-#define SADM_ASSEMBLE_INFO_VALUE(S) select_s337m_value(S, SADM_ASSEMBLE_INFO_16, SADM_ASSEMBLE_INFO_20, SADM_ASSEMBLE_INFO_24)
+#define PA_VALUE(S) ((S)->words->pa)
+#define PB_VALUE(S) ((S)->words->pb)
+#define PC_PMD_VALUE(S) ((S)->words->pc_pmd)
+#define PC_SADM_VALUE(S) ((S)->words->pc_sadm)
+#define PE_SADM_VALUE(S) ((S)->words->pe_sadm)
+#define SADM_FORMAT_INFO_VALUE(S) ((S)->words->format_info)
+#define SADM_FORMAT_INFO_DICT_VALUE(S) ((S)->words->format_info_dict)
+#define SADM_ASSEMBLE_INFO_VALUE(S) ((S)->words->assemble_info)
 
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
@@ -281,6 +328,59 @@ write_word
 }
 
 
+/**
+ * @brief how many samples (or sample pairs) are there from #pcm to #end?
+ */
+static inline
+size_t                        /** @return number of whole or partial samples remaining */
+samples_remaining
+    (pmd_s337m *s337m         /**< [in] PCM smpte state */
+    ,uint32_t *pcm            /**< [in] current PCM position */
+    ,uint32_t *end            /**< [in] 1st sample after end of block */
+    )
+{
+    if (pcm >= end)
+    {
+        return 0;
+    }
+    return ((size_t)(end - pcm) + s337m->stride - 1) / s337m->stride;
+}
+
+
+/**
+ * @brief fill a contiguous run of PCM words
+ */
+static inline
+void
+fill_words
+    (uint32_t *pcm            /**< [out] PCM words to fill */
+    ,size_t count             /**< [in] number of words */
+    ,uint32_t word            /**< [in] value to write */
+    )
+{
+    size_t i;
+
+    if (!word)
+    {
+        memset(pcm, '\0', count * sizeof(*pcm));
+    }
+    else
+    {
+        for (i = 0; i != count; ++i)
+        {
+            pcm[i] = word;
+        }
+    }
+}
+
+
+/**
+ * @brief write a run of identical samples (padding, guardband or silence)
+ *
+ * This writes all the samples in one go, rather than a word at a time, and
+ * updates the pairity and vsync offset once at the end.  When the SMPTE 337m
+ * channel (or pair) is the only one in the buffer, the run is contiguous.
+ */
 static inline
 uint32_t *                    /** @return next PCM sample to write */
 write_repeated
@@ -291,31 +391,57 @@ write_repeated
     ,uint32_t word            /**< [in] Word value to repeat */
     )
 {
+    size_t stride = s337m->stride;
+    size_t n;
+    size_t i;
+
     assert(counter != &s337m->vsync_offset);    /* no help in release builds... */
 
-    if (s337m->pair)    /* frame mode */
+    if (s337m->pair && s337m->pairity)      /* even out the second channel */
+    {
+        pcm = write_word(s337m, pcm, end, word, PMD_FALSE);
+    }
+
+    n = samples_remaining(s337m, pcm, end);
+    if (n > *counter)
+    {
+        n = *counter;
+    }
+
+    if (s337m->pair)    /* frame mode: write the word for both channels */
     {
-        if (s337m->pairity)                 /* even out the second channel */
+        if (stride == 2)
         {
-            pcm = write_word(s337m, pcm, end, word, PMD_FALSE);
+            fill_words(pcm, 2 * n, word);
         }
-        while (*counter && pcm < end) /* write the word for both channels */
+        else
         {
-            pcm = write_word(s337m, pcm, end, word, PMD_FALSE);
-            assert(pcm < end);
-            pcm = write_word(s337m, pcm, end, word, PMD_FALSE);
-            *counter -= 1;
+            for (i = 0; i != n; ++i)
+            {
+                pcm[i * stride]     = word;
+                pcm[i * stride + 1] = word;
+            }
         }
     }
     else                /* subframe mode */
     {
-        while (*counter && pcm < end) /* write the word */
+        if (stride == 1)
         {
-            pcm = write_word(s337m, pcm, end, word, PMD_FALSE);
-            *counter -= 1;
+            fill_words(pcm, n, word);
+        }
+        else
+        {
+            for (i = 0; i != n; ++i)
+            {
+                pcm[i * stride] = word;
+            }
         }
     }
 
+    pcm += n * stride;
+    s337m->vsync_offset -= n;
+    *counter -= n;
+
     return pcm;
 }
 
@@ -396,7 +522,9 @@ phase_write_sadm_ff
     assert(s337m->sadm);
     assert(s337m->sadm_ff);
 
-    pcm = write_word(s337m, pcm, end, SADM_FORMAT_INFO_VALUE(s337m), PMD_TRUE);
+    pcm = write_word(s337m, pcm, end,
+                     s337m->sadm_dict ? SADM_FORMAT_INFO_DICT_VALUE(s337m) : SADM_FORMAT_INFO_VALUE(s337m),
+                     PMD_TRUE);
     s337m->phase = S337M_PHASE_DATA;
 
     return pcm;
@@ -608,119 +736,138 @@ phase_write_preamble_pa
 }
 
 
+/**
+ * @brief unpack the next data burst word from the payload bytes
+ *
+ * 24-bit words take three bytes each; 20-bit words come in pairs that
+ * share the middle byte of five.
+ */
 static inline
-uint32_t *
-phase_write_data_burst_20
-    (pmd_s337m *s337m       /**< [in] PCM smpte state */
-    ,uint32_t *pcm          /**< [in/out] PCM channel buffer to modify */
-    ,uint32_t *end          /**< [in] 1st sample after end of block */
+uint32_t                      /** @return left-justified data word */
+unpack_data_word
+    (uint8_t **data           /**< [in/out] payload read position */
+    ,dlb_pmd_bool *isodd      /**< [in/out] current word is at odd index of encoded pair */
+    ,unsigned int bit_depth   /**< [in] word size, 20 or 24 */
     )
 {
-    size_t databits = s337m->databits;
-    uint32_t tmp;
-    uint8_t *p;
-    dlb_pmd_bool isodd = s337m->isodd;
-    
-#ifndef NDEBUG
-    assert(databits % WORD_20_BITS == 0);
-    if (s337m->pair)
-        assert(s337m->vsync_offset >= databits / PAIR_20_BITS + s337m->padding);
-    else
-        assert(s337m->vsync_offset >= databits / WORD_20_BITS + s337m->padding);
-#endif
+    uint8_t *p = *data;
+    uint32_t word;
 
-    p = s337m->data;
-    while (databits >= WORD_20_BITS && pcm < end)
+    if (bit_depth == WORD_24_BITS)
     {
-        switch (isodd)
-        {
-        case 0:
-            tmp = *p++;
-            tmp = (tmp << 8) | *p++;
-            tmp = (tmp << 8) | (*p & 0xf0);
-            pcm = write_word(s337m, pcm, end, tmp << 8, PMD_TRUE);
-            break;
-        case 1:
-            tmp = (*p++ & 0x0f);
-            tmp = (tmp << 8) | *p++;
-            tmp = (tmp << 8) | *p++;
-            pcm = write_word(s337m, pcm, end, tmp << 12, PMD_TRUE);
-            break;
-        default:
-            abort();
-        }
-        
-        databits -= WORD_20_BITS;
-        isodd = 1 - isodd;
+        word = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8);
+        p += 3;
+    }
+    else if (!*isodd)
+    {
+        word = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)(p[2] & 0xf0) << 8);
+        p += 2;
     }
-
-    assert(databits == s337m->databits);
-    s337m->data = p;
-    s337m->databits = databits;
-    s337m->isodd = isodd;
-
-#ifndef NDEBUG
-    if (s337m->pair)
-        assert(s337m->vsync_offset >= databits / PAIR_20_BITS + s337m->padding);
     else
-        assert(s337m->vsync_offset >= databits / WORD_20_BITS + s337m->padding);
-#endif
-
-    if (!databits)
     {
-        s337m->phase = S337M_PHASE_PADDING;
-        s337m->isodd = 0;
+        word = ((uint32_t)(p[0] & 0x0f) << 28) | ((uint32_t)p[1] << 20) | ((uint32_t)p[2] << 12);
+        p += 3;
     }
 
-    return pcm;
+    *data = p;
+    *isodd = 1 - *isodd;
+    return word;
 }
 
 
+/**
+ * @brief write as much of the data burst as fits before #end
+ *
+ * The bit depth is a compile-time constant at each call site, so that the
+ * unpacking specialises; the pair and subframe layouts each have their own
+ * loop, so neither the pairity nor the vsync offset is touched per word.
+ */
 static inline
 uint32_t *
-phase_write_data_burst_24
+write_data_run
     (pmd_s337m *s337m       /**< [in] PCM smpte state */
     ,uint32_t *pcm          /**< [in/out] PCM channel buffer to modify */
     ,uint32_t *end          /**< [in] 1st sample after end of block */
+    ,unsigned int bit_depth /**< [in] word size, 20 or 24 */
     )
 {
-    size_t databits = s337m->databits;
+    size_t stride = s337m->stride;
+    size_t words = s337m->databits / bit_depth;
+    size_t remaining = words;
     dlb_pmd_bool isodd = s337m->isodd;
-    uint32_t sample;
-    uint8_t *p;
+    uint8_t *p = s337m->data;
+    size_t n;
+    size_t i;
 
 #ifndef NDEBUG
-    assert(databits % WORD_24_BITS == 0);
+    assert(s337m->databits % bit_depth == 0);
     if (s337m->pair)
-        assert(s337m->vsync_offset >= databits / PAIR_24_BITS + s337m->padding);
+        assert(s337m->vsync_offset >= s337m->databits / (2 * bit_depth) + s337m->padding);
     else
-        assert(s337m->vsync_offset >= databits / WORD_24_BITS + s337m->padding);
+        assert(s337m->vsync_offset >= s337m->databits / bit_depth + s337m->padding);
 #endif
 
-    p = s337m->data;
-    while (databits >= WORD_24_BITS && pcm != end)
+    if (s337m->pair)
     {
-        sample = *p++;
-        sample = (sample << 8) | *p++;
-        sample = (sample << 8) | *p++;
-        pcm = write_word(s337m, pcm, end, sample << 8, PMD_TRUE);
-        databits -= WORD_24_BITS;
-        isodd = 1 - isodd;
+        if (s337m->pairity && remaining)    /* finish the current pair */
+        {
+            *pcm = unpack_data_word(&p, &isodd, bit_depth);
+            pcm += stride - 1;
+            s337m->pairity = 0;
+            --remaining;
+        }
+
+        n = samples_remaining(s337m, pcm, end);
+        if (n > remaining / 2)
+        {
+            n = remaining / 2;
+        }
+        for (i = 0; i != n; ++i)
+        {
+            pcm[0] = unpack_data_word(&p, &isodd, bit_depth);
+            pcm[1] = unpack_data_word(&p, &isodd, bit_depth);
+            pcm += stride;
+        }
+        s337m->vsync_offset -= n;
+        remaining -= 2 * n;
+
+        if (remaining && pcm < end)         /* odd word count: start a pair */
+        {
+            *pcm = unpack_data_word(&p, &isodd, bit_depth);
+            ++pcm;
+            s337m->pairity = 1;
+            --s337m->vsync_offset;
+            --remaining;
+        }
+    }
+    else
+    {
+        n = samples_remaining(s337m, pcm, end);
+        if (n > remaining)
+        {
+            n = remaining;
+        }
+        for (i = 0; i != n; ++i)
+        {
+            *pcm = unpack_data_word(&p, &isodd, bit_depth);
+            pcm += stride;
+        }
+        s337m->vsync_offset -= n;
+        remaining -= n;
     }
 
-    assert(databits == s337m->databits);
     s337m->data = p;
-    s337m->databits = databits;
+    s337m->databits -= (words - remaining) * bit_depth;
     s337m->isodd = isodd;
 
 #ifndef NDEBUG
     if (s337m->pair)
-        assert(s337m->vsync_offset >= databits / PAIR_24_BITS + s337m->padding);
+        assert(s337m->vsync_offset >= s337m->databits / (2 * bit_depth) + s337m->padding);
     else
-        assert(s337m->vsync_offset >= databits / WORD_24_BITS + s337m->padding);
+        assert(s337m->vsync_offset >= s337m->databits / bit_depth + s337m->padding);
 #endif
 
-    if (!databits)
+    if (!s337m->databits)
     {
         s337m->phase = S337M_PHASE_PADDING;
         s337m->isodd = 0;
@@ -741,10 +888,10 @@ phase_write_data_burst
     switch (s337m->bit_depth)
     {
     case 20:
-        pcm = phase_write_data_burst_20(s337m, pcm, end);
+        pcm = write_data_run(s337m, pcm, end, WORD_20_BITS);
         break;
     case 24:
-        pcm = phase_write_data_burst_24(s337m, pcm, end);
+        pcm = write_data_run(s337m, pcm, end, WORD_24_BITS);
         break;
     default:
         while (s337m->databits && pcm != end)   /* This will probably only be correct for bit depth 16 */
@@ -781,6 +928,12 @@ read_word
 }
 
 
+/**
+ * @brief skip a run of samples whose values are not needed
+ *
+ * Nothing is read: the run is skipped in one step, as write_repeated()
+ * writes it.
+ */
 static inline
 uint32_t *                    /** @return next PCM sample to read */
 read_repeated
@@ -791,31 +944,23 @@ read_repeated
     )
 {
     uint32_t word;
+    size_t n;
 
     assert(counter != &s337m->vsync_offset);    /* no help in release builds... */
 
-    if (s337m->pair)    /* frame mode */
+    if (s337m->pair && s337m->pairity)      /* even up the second channel */
     {
-        if (s337m->pairity)                 /* even up the second channel */
-        {
-            pcm = read_word(s337m, pcm, end, &word, PMD_FALSE);
-        }
-        while (*counter && pcm < end)       /* read the word for both channels */
-        {
-            pcm = read_word(s337m, pcm, end, &word, PMD_FALSE);
-            assert(pcm < end);
-            pcm = read_word(s337m, pcm, end, &word, PMD_FALSE);
-            *counter -= 1;
-        }
+        pcm = read_word(s337m, pcm, end, &word, PMD_FALSE);
     }
-    else                /* subframe mode */
+
+    n = samples_remaining(s337m, pcm, end);
+    if (n > *counter)
     {
-        while (*counter && pcm < end)       /* read the word */
-        {
-            pcm = read_word(s337m, pcm, end, &word, PMD_FALSE);
-            *counter -= 1;
-        }
+        n = *counter;
     }
+    pcm += n * s337m->stride;
+    s337m->vsync_offset -= n;
+    *counter -= n;
 
     return pcm;
 }
@@ -965,16 +1110,18 @@ phase_read_sadm_ff
     )
 {
     uint32_t got_ff;
-    uint32_t expected_ff = SADM_FORMAT_INFO_VALUE(s337m);
     dlb_pmd_bool ff_is_gzip;
+    dlb_pmd_bool ff_is_dict;
 
     pcm = read_word(s337m, pcm, end, &got_ff, PMD_TRUE);
 
-    /* check for frame format == gzip */
-    ff_is_gzip = (got_ff == expected_ff);
+    /* check for frame format == gzip or zlib with preset dictionary */
+    ff_is_gzip = (got_ff == SADM_FORMAT_INFO_VALUE(s337m));
+    ff_is_dict = (got_ff == SADM_FORMAT_INFO_DICT_VALUE(s337m));
 
-    if (ff_is_gzip)
+    if (ff_is_gzip || ff_is_dict)
     {
+        s337m->sadm_dict = ff_is_dict;
         s337m->phase = S337M_PHASE_DATA;
     }
     else
@@ -1222,6 +1369,35 @@ phase_read_preamble_pb
 }
 
 
+/**
+ * @brief skip sample sets that cannot contain a Pa
+ *
+ * While hunting for Pa, the state machine would read every word of the
+ * channel (or pair) only to discard it; this hands the search to the
+ * vectorised scanner and resumes the state machine at the first sample
+ * set holding a candidate.
+ */
+static inline
+uint32_t *                    /** @return first sample set to read word by word */
+skip_to_preamble_pa
+    (pmd_s337m *s337m       /**< [in] PCM smpte state */
+    ,uint32_t *pcm          /**< [in] PCM channel buffer to read */
+    ,uint32_t *end          /**< [in] 1st sample after end of block */
+    )
+{
+    uint32_t *next;
+
+    if (s337m->pair && s337m->pairity)
+    {
+        return pcm;
+    }
+
+    next = (uint32_t *)pmd_s337m_find_pa(pcm, end, s337m->stride, s337m->pair ? 2 : 1);
+    s337m->vsync_offset -= (size_t)(next - pcm) / s337m->stride;
+    return next;
+}
+
+
 static inline
 uint32_t *
 phase_read_preamble_pa
@@ -1257,6 +1433,7 @@ phase_read_preamble_pa
     
     if (pa_present)
     {
+        select_s337m_words(s337m);
         s337m->phase = S337M_PHASE_PREAMBLEB;
     }
 
@@ -1283,6 +1460,7 @@ pmd_s337m_init
 
     s337m->wrap_depth = (wrap_depth == 24) ? 24 : 20;
     s337m->bit_depth  = (wrap_depth == 16) ? 16 : s337m->wrap_depth;
+    select_s337m_words(s337m);
     s337m->pair = pair;
     s337m->pairity = 0;
     s337m->start = pair ? 2*start : start;
@@ -1412,7 +1590,11 @@ pmd_s337m_wrap
     ,uint32_t *end
     )
 {
-    s337m->bit_depth = s337m->wrap_depth;
+    if (s337m->bit_depth != s337m->wrap_depth)
+    {
+        s337m->bit_depth = s337m->wrap_depth;
+        select_s337m_words(s337m);
+    }
 
     while (pcm < end)
     {
@@ -1496,7 +1678,11 @@ pmd_s337m_unwrap
             
         case S337M_PHASE_PREAMBLEA:
         case S337M_PHASE_GUARDBAND:
-            pcm = phase_read_preamble_pa(s337m, pcm, end);
+            pcm = skip_to_preamble_pa(s337m, pcm, end);
+            if (pcm < end)
+            {
+                pcm = phase_read_preamble_pa(s337m, pcm, end);
+            }
             break;
             
         case S337M_PHASE_PREAMBLEB:
@@ -91,6 +91,12 @@ extern "C" {
 typedef struct pmd_s337m pmd_s337m;
 
 
+/**
+ * @brief bit-depth dependent preamble and sADM header words
+ */
+struct s337m_words;
+
+
 /**
  * @brief processing phase
  */
@@ -148,10 +154,12 @@ struct pmd_s337m
     dlb_pmd_bool sadm;         /**< generate/detect serial ADM instead of PMD? */
     dlb_pmd_bool sadm_ai;      /**< write/detect sADM assemble_info  */
     dlb_pmd_bool sadm_ff;      /**< write/detect sADM format_info */
+    dlb_pmd_bool sadm_dict;    /**< sADM payload uses the preset dictionary (format_type 2)? */
     unsigned int start;        /**< start channel index */
     size_t       pa_found;     /**< sample within block in which Pa was found, or NO_PA_FOUND */
     unsigned int bit_depth;    /**< Bit depth */
     unsigned int wrap_depth;   /**< Bit depth for wrapping */
+    const struct s337m_words *words; /**< preamble words for #bit_depth */
 
     uint8_t *data;             /**< data to write/buffer to write to */
     size_t databits;           /**< size of data to write/capacity of buffer to write */
@@ -83,6 +83,17 @@ dlb_pmd_sadm_buffer_reader_init
     return success;
 }
 
+void
+dlb_pmd_sadm_buffer_reader_finish
+    (dlb_pmd_sadm_buffer_reader  *reader
+    )
+{
+    if (reader != NULL)
+    {
+        sadm_bitstream_decoder_finish(reader->dec);
+    }
+}
+
 dlb_pmd_success
 dlb_pmd_sadm_buffer_read
    (dlb_pmd_sadm_buffer_reader  *reader
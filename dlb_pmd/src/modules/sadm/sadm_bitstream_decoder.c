@@ -35,6 +35,7 @@
  **********************************************************************/
 
 #include "sadm_bitstream_decoder.h"
+#include "sadm_dictionary.h"
 #include "dlb_adm/include/dlb_adm_api.h"
 #include "zlib.h"
 
@@ -75,6 +76,21 @@ is_buffer_compressed
         status = PMD_TRUE;
     }
 
+    /* A zlib stream (RFC 1950) is used with the preset dictionary:
+     *
+         +---+---+=====================+
+         |CMF|FLG|...4 bytes  DICTID...|
+         +---+---+=====================+
+     * Check for deflate in CMF, FDICT in FLG and a valid header check value
+     */
+    else if ((datasize >= 6)                    &&
+             ((buf[0] & 0x0f) == Z_DEFLATED)    &&
+             (buf[1] & 0x20)                    &&
+             ((((unsigned int)buf[0] << 8) | buf[1]) % 31 == 0))
+    {
+        status = PMD_TRUE;
+    }
+
     return status;
 }
 
@@ -87,7 +103,7 @@ sadm_bitstream_decoder_query_mem
     (void
     )
 {
-    return sizeof(sadm_bitstream_decoder);
+    return sizeof(sadm_bitstream_decoder) + SADM_INFLATE_MEMORY_SIZE;
 }
 
 
@@ -100,12 +116,72 @@ sadm_bitstream_decoder_init
     sadm_bitstream_decoder *d = (sadm_bitstream_decoder*)mem;
 
     memset(d, 0, sizeof(*d));
+    sadm_zlib_memory_init(&d->zmem, d + 1, SADM_INFLATE_MEMORY_SIZE);
     *dec = d;
 
     return PMD_SUCCESS;
 }
 
 
+void
+sadm_bitstream_decoder_finish
+    (sadm_bitstream_decoder     *dec
+    )
+{
+    if (dec != NULL && dec->container != NULL)
+    {
+        (void)dlb_adm_container_close(&dec->container);
+        dec->container = NULL;
+    }
+}
+
+
+/**
+ * @brief get the decoder's inflate stream, ready to decompress a new payload
+ *
+ * The stream is set up on first use and then only reset, so its state is
+ * allocated (from memory following the decoder) once, not on every frame.
+ */
+static
+z_stream *                          /** @return stream, or NULL on error */
+get_inflate_stream
+    (sadm_bitstream_decoder *dec
+    )
+{
+    z_stream *s = (z_stream *)dec->zstream;
+
+    if (s != NULL)
+    {
+        if (inflateReset(s) == Z_OK)
+        {
+            return s;
+        }
+        (void)inflateEnd(s);
+        dec->zstream = NULL;
+    }
+
+    sadm_zlib_memory_reset(&dec->zmem);
+    s = (z_stream *)sadm_zlib_alloc(&dec->zmem, 1, sizeof(*s));
+    if (s == NULL)
+    {
+        return NULL;
+    }
+
+    memset(s, 0, sizeof(*s));
+    s->zalloc = sadm_zlib_alloc;
+    s->zfree = sadm_zlib_free;
+    s->opaque = &dec->zmem;
+
+    if (inflateInit2(s, MAX_WBITS + 32)) // 32 - autodetect header type
+    {
+        return NULL;
+    }
+
+    dec->zstream = s;
+    return s;
+}
+
+
 int
 decompress_sadm_xml
    (sadm_bitstream_decoder  *dec
@@ -113,30 +189,30 @@ decompress_sadm_xml
    ,size_t                   datasize
    )
 {
-    z_stream s;
+    z_stream *s = get_inflate_stream(dec);
     int res;
     unsigned int done = 0;
 
-    memset(&s, 0, sizeof(s));
-    s.zalloc = 0;
-    s.zfree = 0;
-    s.next_in = buf;
-    s.total_out = 0;
-    s.avail_in = (uInt)datasize;
-    s.next_out = (uint8_t*)dec->xmlbuf;
-    s.avail_out = sizeof(dec->xmlbuf);
-
-    if (inflateInit2(&s, MAX_WBITS + 32)) // 32 - autodetect header type
+    if (s == NULL)
     {
         return 0;
     }
 
+    s->next_in = (uint8_t *)buf;
+    s->avail_in = (uInt)datasize;
+
     while(!done)
     {
-        s.next_out = (uint8_t*) (dec->xmlbuf + s.total_out);
-        s.avail_out -= s.total_out;
+        s->next_out = (uint8_t*) (dec->xmlbuf + s->total_out);
+        s->avail_out = (uInt)(sizeof(dec->xmlbuf) - s->total_out);
+
+        res = inflate(s, Z_NO_FLUSH);
+        if (res == Z_NEED_DICT)
+        {
+            /* fails with Z_DATA_ERROR unless the stream asks for our dictionary */
+            res = inflateSetDictionary(s, (const Bytef *)sadm_dictionary, (uInt)sadm_dictionary_size);
+        }
 
-        res = inflate(&s, Z_NO_FLUSH);
         if (res == Z_STREAM_END)
         {
             done = 1;
@@ -145,15 +221,14 @@ decompress_sadm_xml
         else if (Z_OK != res)
         {
 #ifndef NDEBUG
-            printf("zlib error: %s\n", s.msg);
+            printf("zlib error: %s\n", s->msg);
 #endif
-            s.total_out = 0;
+            s->total_out = 0;
             break;
         }
     }
 
-    inflateEnd(&s);
-    return s.total_out;
+    return s->total_out;
 }
 
 
@@ -168,11 +243,9 @@ sadm_bitstream_decoder_decode
     ,void                           *cbarg
     )
 {
-    dlb_adm_container_counts     counts;
-    dlb_adm_xml_container       *container = NULL;
     dlb_pmd_success              result = PMD_SUCCESS;
+    int                          status;
 
-    memset(&counts, 0, sizeof(counts));
     dec->model = model;
     if (is_buffer_compressed(bitstream, datasize))
     {
@@ -200,10 +273,24 @@ sadm_bitstream_decoder_decode
         memcpy(dec->xmlbuf, bitstream, dec->size);
     }
 
-    if (dlb_adm_container_open(&container, &counts)                                           ||
-        dlb_adm_container_read_xml_buffer(container, dec->xmlbuf, dec->size, use_common_defs) ||
-        dlb_adm_core_model_clear(model)                                                       ||
-        dlb_adm_core_model_ingest_xml_container(model, container)
+    /* The container lives as long as the decoder, so that steady-state
+     * decoding only resets it instead of building a new one every frame */
+    if (dec->container == NULL)
+    {
+        dlb_adm_container_counts counts;
+
+        memset(&counts, 0, sizeof(counts));
+        status = dlb_adm_container_open(&dec->container, &counts);
+    }
+    else
+    {
+        status = dlb_adm_container_reset(dec->container);
+    }
+
+    if (status                                                                                     ||
+        dlb_adm_container_read_xml_buffer(dec->container, dec->xmlbuf, dec->size, use_common_defs) ||
+        dlb_adm_core_model_clear(model)                                                            ||
+        dlb_adm_core_model_ingest_xml_container(model, dec->container)
        )
     {
         result = PMD_FAIL;
@@ -214,10 +301,5 @@ sadm_bitstream_decoder_decode
         callback(cbarg, (result == PMD_SUCCESS) ? SADM_OK : SADM_PARSE_ERR);
     }
 
-    if (container != NULL)
-    {
-        (void)dlb_adm_container_close(&container);
-    }
-
     return result;
 }
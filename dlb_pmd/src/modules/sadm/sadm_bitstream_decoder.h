@@ -46,6 +46,7 @@
 
 //#include "pmd_smpte_337m.h"
 #include "pmd_error_helper.h"
+#include "sadm_zlib_memory.h"
 #include "dlb_pmd_sadm.h"
 #include "dlb_adm/include/dlb_adm_fwd_type.h"
 #include "dlb_adm/include/dlb_adm_api_types.h"
@@ -87,8 +88,11 @@ void
 typedef struct
 {
     dlb_adm_core_model  *model;
+    dlb_adm_xml_container *container;                       /**< XML container, opened on first use and reset per frame */
     char                 xmlbuf[DLB_PMD_SADM_MAX_XML_SIZE]; /**< S-ADM decompression buffer */
     size_t               size;
+    void                *zstream;                           /**< persistent inflate stream, NULL until first use */
+    sadm_zlib_memory     zmem;                              /**< memory for #zstream, follows the decoder struct */
 } sadm_bitstream_decoder;
 
 
@@ -104,6 +108,10 @@ sadm_bitstream_decoder_query_mem
 
 /**
  * @brief initialize the S-ADM bitstream decoder
+ *
+ * #mem is not assumed to hold a decoder already, so initializing a
+ * decoder that has decoded a frame, without calling
+ * #sadm_bitstream_decoder_finish first, leaks its XML container.
  */
 TEST_DLL_ENTRY
 dlb_pmd_success
@@ -113,6 +121,19 @@ sadm_bitstream_decoder_init
     );
 
 
+/**
+ * @brief release the resources held by the S-ADM bitstream decoder
+ *
+ * The decoder keeps its XML container between frames; this closes it.  The
+ * decoder may be used again afterwards.
+ */
+TEST_DLL_ENTRY
+void
+sadm_bitstream_decoder_finish
+    (sadm_bitstream_decoder     *dec
+    );
+
+
 /**
  * @brief helper function to decompress the input buffer to the decoder's
  * XML buffer.
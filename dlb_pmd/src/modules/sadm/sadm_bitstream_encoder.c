@@ -41,6 +41,7 @@
  */
 
 #include "sadm_bitstream_encoder.h"
+#include "sadm_dictionary.h"
 #include "dlb_adm/include/dlb_adm_api.h"
 #include "zlib.h"
 
@@ -92,7 +93,7 @@ sadm_bitstream_encoder_query_mem
     (void
     )
 {
-    return sizeof(sadm_bitstream_encoder);
+    return sizeof(sadm_bitstream_encoder) + SADM_DEFLATE_MEMORY_SIZE;
 }
 
 
@@ -110,80 +111,201 @@ sadm_bitstream_encoder_init
     }
 
     memset(e, 0, sizeof(*e));
+    e->level = Z_BEST_COMPRESSION;
+    e->strategy = Z_DEFAULT_STRATEGY;
+    sadm_zlib_memory_init(&e->zmem, e + 1, SADM_DEFLATE_MEMORY_SIZE);
     *enc = e;
 
     return PMD_SUCCESS;
 }
 
 
-int 
-compress_sadm_xml
-   (sadm_bitstream_encoder  *enc
-   ,uint8_t                 *buf
-   ,size_t                   buf_size
-   )
+void
+sadm_bitstream_encoder_track_changes
+    (sadm_bitstream_encoder     *enc
+    ,dlb_pmd_bool                track_changes
+    )
 {
-    z_stream s;
-    int bytecount;
+    enc->track_changes = track_changes;
+    enc->cache_valid = PMD_FALSE;
+}
+
+
+dlb_pmd_success
+sadm_bitstream_encoder_set_compression
+    (sadm_bitstream_encoder     *enc
+    ,int                         level
+    ,int                         strategy
+    )
+{
+    if ((level < Z_DEFAULT_COMPRESSION) || (level > Z_BEST_COMPRESSION) ||
+        (strategy < Z_DEFAULT_STRATEGY) || (strategy > Z_FIXED))
+    {
+        return PMD_FAIL;
+    }
+
+    enc->level = level;
+    enc->strategy = strategy;
+    enc->cache_valid = PMD_FALSE;
+
+    return PMD_SUCCESS;
+}
+
+
+void
+sadm_bitstream_encoder_use_dictionary
+    (sadm_bitstream_encoder     *enc
+    ,dlb_pmd_bool                dictionary
+    )
+{
+    enc->dictionary = dictionary;
+    enc->cache_valid = PMD_FALSE;
+}
+
+
+/**
+ * @brief get the encoder's deflate stream, ready to compress a new payload
+ *
+ * The stream is set up on first use and then only reset, so its state is
+ * allocated (from memory following the encoder) once, not on every frame.
+ */
+static
+z_stream *                          /** @return stream, or NULL on error */
+get_deflate_stream
+    (sadm_bitstream_encoder *enc
+    )
+{
+    z_stream *s = (z_stream *)enc->zstream;
     int res;
 
-    memset(&s, 0, sizeof(s));
-    s.zalloc = 0;
-    s.zfree = 0;
-    s.next_in = (uint8_t*)enc->xmlbuf;
-    s.avail_in = (uInt)enc->size;
-    s.next_out = buf;
-    s.avail_out = buf_size;
+    if (s != NULL)
+    {
+        if ((enc->zstream_level == enc->level) &&
+            (enc->zstream_strategy == enc->strategy) &&
+            (enc->zstream_dictionary == enc->dictionary) &&
+            (deflateReset(s) == Z_OK))
+        {
+            /* a reset forgets the dictionary, so set it again */
+            if (!enc->dictionary ||
+                (deflateSetDictionary(s, (const Bytef *)sadm_dictionary, (uInt)sadm_dictionary_size) == Z_OK))
+            {
+                return s;
+            }
+        }
+        (void)deflateEnd(s);
+        enc->zstream = NULL;
+    }
+
+    sadm_zlib_memory_reset(&enc->zmem);
+    s = (z_stream *)sadm_zlib_alloc(&enc->zmem, 1, sizeof(*s));
+    if (s == NULL)
+    {
+        return NULL;
+    }
+
+    memset(s, 0, sizeof(*s));
+    s->zalloc = sadm_zlib_alloc;
+    s->zfree = sadm_zlib_free;
+    s->opaque = &enc->zmem;
 
     res = deflateInit2
     (
-        &s,
-        Z_BEST_COMPRESSION,
+        s,
+        enc->level,
         Z_DEFLATED,
-        MAX_WBITS + 16,     /* + 16 is "write a simple gzip header" */
+        enc->dictionary
+            ? MAX_WBITS         /* zlib header, which carries the dictionary id */
+            : MAX_WBITS + 16,   /* + 16 is "write a simple gzip header" */
         8,                  /* memory level (default) */
-        Z_DEFAULT_STRATEGY
+        enc->strategy
     );
+    if (res == Z_OK && enc->dictionary)
+    {
+        res = deflateSetDictionary(s, (const Bytef *)sadm_dictionary, (uInt)sadm_dictionary_size);
+    }
     if (res != Z_OK)
+    {
+        return NULL;
+    }
+
+    enc->zstream = s;
+    enc->zstream_level = enc->level;
+    enc->zstream_strategy = enc->strategy;
+    enc->zstream_dictionary = enc->dictionary;
+    return s;
+}
+
+
+int 
+compress_sadm_xml
+   (sadm_bitstream_encoder  *enc
+   ,uint8_t                 *buf
+   ,size_t                   buf_size
+   )
+{
+    z_stream *s = get_deflate_stream(enc);
+    int res;
+
+    if (s == NULL)
     {
         return buf_size + 1;
     }
 
-    res = deflate(&s, Z_NO_FLUSH);
+    s->next_in = (uint8_t*)enc->xmlbuf;
+    s->avail_in = (uInt)enc->size;
+    s->next_out = buf;
+    s->avail_out = buf_size;
+
+    res = deflate(s, Z_NO_FLUSH);
     if (res != Z_OK)
     {
         return buf_size + 1;
     }
 
-    if (s.avail_in || !s.avail_out)
+    if (s->avail_in || !s->avail_out)
     {
         /* not enough space in output buffer */
         return 0;
     }
     
-    res = deflate(&s, Z_FINISH);
+    res = deflate(s, Z_FINISH);
     if (res != Z_STREAM_END)
     {
         return buf_size + 1;
     }
 
-    bytecount = buf_size - s.avail_out;
-    deflateEnd(&s);
-    return bytecount;
+    return buf_size - s->avail_out;
 }
 
 
-int
-sadm_bitstream_encoder_payload
+/**
+ * @brief generate the compressed sADM payload for a model, re-using the
+ * previous payload when change tracking is enabled and the model is unchanged
+ */
+static
+int                                 /** @return bytes used, 0 if none, > MAX_DATA_BYTES on compression error */
+generate_compressed_payload
     (sadm_bitstream_encoder     *enc
     ,const dlb_adm_core_model   *model
     ,uint8_t                    *outbuf
     )
 {
     dlb_adm_xml_container   *container = NULL;
+    dlb_pmd_bool             tracked = PMD_FALSE;
+    uint64_t                 generation = 0;
     int                      byte_size = 0;
     int                      status;
 
+    if (enc->track_changes)
+    {
+        tracked = (dlb_adm_core_model_get_generation(model, &generation) == DLB_ADM_STATUS_OK);
+        if (tracked && enc->cache_valid && enc->cache_generation == generation)
+        {
+            memcpy(outbuf, enc->cache, enc->cache_size);
+            return enc->cache_size;
+        }
+    }
+
     enc->size = sizeof(enc->xmlbuf);
     status = dlb_adm_container_open_from_core_model(&container, model);
     if (status != DLB_ADM_STATUS_OK) goto finish;
@@ -191,6 +313,18 @@ sadm_bitstream_encoder_payload
     if (status != DLB_ADM_STATUS_OK) goto finish;
     byte_size = compress_sadm_xml(enc, outbuf, MAX_DATA_BYTES);
 
+    if (tracked)
+    {
+        /* a payload that did not fit (0) is remembered too, compression errors are not */
+        enc->cache_valid = (byte_size <= MAX_DATA_BYTES);
+        if (enc->cache_valid)
+        {
+            enc->cache_generation = generation;
+            enc->cache_size = byte_size;
+            memcpy(enc->cache, outbuf, byte_size);
+        }
+    }
+
 finish:
     if (container != NULL)
     {
@@ -201,6 +335,17 @@ finish:
 }
 
 
+int
+sadm_bitstream_encoder_payload
+    (sadm_bitstream_encoder     *enc
+    ,const dlb_adm_core_model   *model
+    ,uint8_t                    *outbuf
+    )
+{
+    return generate_compressed_payload(enc, model, outbuf);
+}
+
+
 int
 sadm_bitstream_encoder_payload_ext
     (sadm_bitstream_encoder     *enc
@@ -248,31 +393,17 @@ sadm_bitstream_encoder_encode
     ,uint8_t                    *outbuf
     )
 {
-    dlb_adm_xml_container   *container = NULL;
     size_t                   min_frame_size = pmd_s337m_min_frame_size(rate);
     int                      frame_byte_count = (int)pmd_s337m_sadm_data_bytes(s337m, rate);
-    int                      byte_size = 0;
-    int                      status;
+    int                      byte_size;
 
-    enc->size = sizeof(enc->xmlbuf);
     s337m->framelen = min_frame_size - 2 * GUARDBAND;   /* Note: this could be short by a sample - TODO: can that be a problem? */
 
-    status = dlb_adm_container_open_from_core_model(&container, model);
-    if (status != DLB_ADM_STATUS_OK) goto finish;
-    status = dlb_adm_container_write_xml_buffer(container, pcm_sadm_get_buffer, enc);
-    if (status != DLB_ADM_STATUS_OK) goto finish;
-
-    byte_size = compress_sadm_xml(enc, outbuf, MAX_DATA_BYTES);
+    byte_size = generate_compressed_payload(enc, model, outbuf);
     if (byte_size > frame_byte_count)
     {
         byte_size = 0;
     }
 
-finish:
-    if (container != NULL)
-    {
-        (void)dlb_adm_container_close(&container);
-    }
-
     return byte_size;
 }
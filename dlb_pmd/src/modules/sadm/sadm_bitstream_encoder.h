@@ -46,6 +46,7 @@
 
 
 #include "pmd_smpte_337m.h"
+#include "sadm_zlib_memory.h"
 #include "dlb_pmd_sadm.h"
 
 #include "dlb_pmd/include/dlb_pmd_lib_dll.h"
@@ -65,6 +66,21 @@ typedef struct
 {
     char                         xmlbuf[DLB_PMD_SADM_MAX_XML_SIZE]; /**< S-ADM precompression buffer */
     size_t                       size;
+
+    dlb_pmd_bool                 track_changes;                     /**< re-emit previous payload while model unchanged? */
+    dlb_pmd_bool                 cache_valid;                       /**< does the payload cache hold a payload? */
+    uint64_t                     cache_generation;                  /**< core model generation of cached payload */
+    int                          cache_size;                        /**< size of cached payload in bytes */
+    uint8_t                      cache[MAX_DATA_BYTES];             /**< last compressed payload */
+
+    int                          level;                             /**< zlib compression level */
+    int                          strategy;                          /**< zlib compression strategy */
+    dlb_pmd_bool                 dictionary;                        /**< prime zlib with the built-in ADM dictionary? */
+    void                        *zstream;                           /**< persistent deflate stream, NULL until first use */
+    int                          zstream_level;                     /**< compression level #zstream was set up with */
+    int                          zstream_strategy;                  /**< compression strategy #zstream was set up with */
+    dlb_pmd_bool                 zstream_dictionary;                /**< dictionary mode #zstream was set up with */
+    sadm_zlib_memory             zmem;                              /**< memory for #zstream, follows the encoder struct */
 } sadm_bitstream_encoder;
 
 
@@ -89,6 +105,54 @@ sadm_bitstream_encoder_init
     );
 
 
+/**
+ * @brief enable or disable change tracking
+ *
+ * When change tracking is enabled, the encoder remembers the last compressed
+ * payload together with the generation of the core model it was made from,
+ * and re-emits it byte-for-byte, without regenerating or recompressing the
+ * XML, until the core model changes.  Change tracking is disabled by default.
+ */
+TEST_DLL_ENTRY
+void
+sadm_bitstream_encoder_track_changes
+    (sadm_bitstream_encoder     *enc            /**< [in] bitstream encoder */
+    ,dlb_pmd_bool                track_changes  /**< [in] 1 to enable change tracking, 0 to disable */
+    );
+
+
+/**
+ * @brief set the zlib compression level and strategy
+ *
+ * The defaults are Z_BEST_COMPRESSION and Z_DEFAULT_STRATEGY.  Lower levels
+ * trade payload size for CPU time.
+ */
+TEST_DLL_ENTRY
+dlb_pmd_success
+sadm_bitstream_encoder_set_compression
+    (sadm_bitstream_encoder     *enc            /**< [in] bitstream encoder */
+    ,int                         level          /**< [in] zlib compression level, Z_DEFAULT_COMPRESSION or 0..9 */
+    ,int                         strategy       /**< [in] zlib compression strategy */
+    );
+
+
+/**
+ * @brief enable or disable the built-in ADM preset dictionary
+ *
+ * With the dictionary, payloads are zlib (RFC 1950) streams primed with the
+ * ADM tag and attribute vocabulary (see sadm_dictionary.h) instead of gzip
+ * (RFC 1952) streams, which makes them smaller and quicker to compress.  Only
+ * decoders that know the dictionary can read them; the SMPTE 337m wrapper
+ * signals the mode in the sADM format_info word.  Disabled by default.
+ */
+TEST_DLL_ENTRY
+void
+sadm_bitstream_encoder_use_dictionary
+    (sadm_bitstream_encoder     *enc            /**< [in] bitstream encoder */
+    ,dlb_pmd_bool                dictionary     /**< [in] 1 to use the preset dictionary, 0 for plain gzip */
+    );
+
+
 /**
  * @brief helper function to compress the encoder's XML buffer to the
  * given byte buffer
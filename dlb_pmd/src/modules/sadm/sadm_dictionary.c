@@ -0,0 +1,111 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+/**
+ * @file sadm_dictionary.c
+ * @brief built-in zlib preset dictionary for S-ADM payloads
+ *
+ * zlib finds matches in the dictionary most cheaply near its end, so the
+ * rarer vocabulary comes first and the per-channel/per-track boilerplate last.
+ */
+
+#include "sadm_dictionary.h"
+
+const char sadm_dictionary[] =
+    "<dolbyE><programConfig><encodeParameters langCod bsMod acMod cMixLev surMixLev "
+    "dSurMod dialNorm copyRightB origBs lfeOn hpFOn bwLpFOn lfeLpFOn surAttOn rfPremphOn "
+    "</audioFormatCustom><audioFormatCustomSet audioFormatCustomSetID=\"AFC_"
+    "<alternativeValueSet alternativeValueSetID=\"AVS_</alternativeValueSetIDRef>"
+    "<audioComplementaryObjectIDRef></audioComplementaryObjectIDRef>"
+    "<audioComplementaryObjectGroupLabel language=\""
+    "<audioObjectInteraction onOffInteract=\"1\" gainInteract=\"1\" positionInteract=\"0\">"
+    "<gainInteractionRange bound=\"min\"></gainInteractionRange><gainInteractionRange bound=\"max\">"
+    "<positionInteractionRange coordinate=\"X\" bound=\"min\"></positionInteractionRange>"
+    "</audioObjectInteraction><audioObjectLabel language=\"</audioObjectLabel>"
+    "<gain gainUnit=\"dB\"></gain><objectDivergence><screenEdgeLock>"
+    "<profileList><profile profileVersion=\"1\" profileLevel=\"1\" profileName=\"AdvSS Emission S-ADM Profile\">"
+    "ITU-R BS.[ADM-NGA-Emission]-0</profile></profileList>"
+    "<dialogueLoudness><loudnessMetadata loudnessMethod=\"ITU-R BS.1770\">"
+    "<integratedLoudness></integratedLoudness></loudnessMetadata>"
+    "<dialogue nonDialogueContentKind=\"</dialogue><dialogue dialogueContentKind=\""
+    "<dialogue mixedContentKind=\"</dialogue>"
+    "<audioProgrammeLabel language=\"</audioProgrammeLabel>"
+    "<audioContentLabel language=\"</audioContentLabel>"
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<frame version=\"ITU-R_BS.2125-1\">\n"
+    "  <frameHeader>\n"
+    "    <frameFormat frameFormatID=\"FF_00000001\" type=\"full\" start=\"00:00:00.00000\" "
+    "duration=\"00:00:00.00000\" timeReference=\"local\" flowID=\"\">\n"
+    "    </frameFormat>\n"
+    "    <transportTrackFormat transportID=\"TP_0001\" transportName=\"\" numIDs=\"\" numTracks=\"\">\n"
+    "  </frameHeader>\n"
+    "  <audioFormatExtended version=\"ITU-R_BS.2076-3\">\n"
+    "    <audioProgramme audioProgrammeID=\"APR_100\" audioProgrammeName=\"\" audioProgrammeLanguage=\"eng\">\n"
+    "      <audioContentIDRef>ACO_100</audioContentIDRef>\n"
+    "    </audioProgramme>\n"
+    "    <audioContent audioContentID=\"ACO_100\" audioContentName=\"\" audioContentLanguage=\"eng\">\n"
+    "      <audioObjectIDRef>AO_100</audioObjectIDRef>\n"
+    "    </audioContent>\n"
+    "    <audioObject audioObjectID=\"AO_100\" audioObjectName=\"\" interact=\"0\">\n"
+    "    </audioObject>\n"
+    "    <audioPackFormat audioPackFormatID=\"AP_00011001\" audioPackFormatName=\"RoomCentric_\" "
+    "typeLabel=\"0003\" typeDefinition=\"Objects\">\n"
+    "    </audioPackFormat>\n"
+    "    <audioChannelFormat audioChannelFormatID=\"AC_00031001\" audioChannelFormatName=\"\" "
+    "typeLabel=\"0001\" typeDefinition=\"DirectSpeakers\">\n"
+    "      <audioBlockFormat audioBlockFormatID=\"AB_00011001_00000001\" "
+    "lstart=\"00:00:00.00000\" lduration=\"00:00:00.00000\">\n"
+    "        <speakerLabel>RC_</speakerLabel>\n"
+    "        <cartesian>1</cartesian>\n"
+    "        <position coordinate=\"X\">0.00</position>\n"
+    "        <position coordinate=\"Y\">1.00</position>\n"
+    "        <position coordinate=\"Z\">0.00</position>\n"
+    "      </audioBlockFormat>\n"
+    "    </audioChannelFormat>\n"
+    "    <audioTrackUID UID=\"ATU_00000001\">\n"
+    "      <audioPackFormatIDRef>AP_00011001</audioPackFormatIDRef>\n"
+    "      <audioChannelFormatIDRef>AC_00011001</audioChannelFormatIDRef>\n"
+    "    </audioTrackUID>\n"
+    "  </audioFormatExtended>\n"
+    "</frame>\n"
+    "      <audioTrack trackID=\"1\" formatLabel=\"0001\" formatDefinition=\"PCM\">\n"
+    "        <audioTrackUIDRef>ATU_00000001</audioTrackUIDRef>\n"
+    "      </audioTrack>\n"
+    "      <audioPackFormatIDRef>AP_00011001</audioPackFormatIDRef>\n"
+    "      <audioTrackUIDRef>ATU_00000001</audioTrackUIDRef>\n"
+    "      <audioChannelFormatIDRef>AC_00011001</audioChannelFormatIDRef>\n";
+
+const size_t sadm_dictionary_size = sizeof(sadm_dictionary) - 1;     /* without the terminating NUL */
@@ -0,0 +1,108 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+/**
+ * @file sadm_zlib_memory.c
+ * @brief client-memory allocator for the persistent zlib streams of the
+ * S-ADM bitstream encoder and decoder
+ */
+
+#include "sadm_zlib_memory.h"
+
+/**
+ * @def SADM_ZLIB_ALIGN
+ * @brief alignment of each allocation
+ */
+#define SADM_ZLIB_ALIGN (16)
+
+
+void
+sadm_zlib_memory_init
+    (sadm_zlib_memory   *zmem
+    ,void               *base
+    ,size_t              capacity
+    )
+{
+    uintptr_t p = (uintptr_t)base;
+    uintptr_t aligned = (p + SADM_ZLIB_ALIGN - 1) & ~(uintptr_t)(SADM_ZLIB_ALIGN - 1);
+
+    zmem->base = (uint8_t *)aligned;
+    zmem->capacity = (capacity > aligned - p) ? capacity - (aligned - p) : 0;
+    zmem->used = 0;
+}
+
+
+void
+sadm_zlib_memory_reset
+    (sadm_zlib_memory   *zmem
+    )
+{
+    zmem->used = 0;
+}
+
+
+void *
+sadm_zlib_alloc
+    (void               *opaque
+    ,unsigned int        items
+    ,unsigned int        size
+    )
+{
+    sadm_zlib_memory *zmem = (sadm_zlib_memory *)opaque;
+    size_t bytes = (size_t)items * size;
+    void *p;
+
+    bytes = (bytes + SADM_ZLIB_ALIGN - 1) & ~(size_t)(SADM_ZLIB_ALIGN - 1);
+    if (bytes > zmem->capacity - zmem->used)
+    {
+        return NULL;
+    }
+
+    p = zmem->base + zmem->used;
+    zmem->used += bytes;
+    return p;
+}
+
+
+void
+sadm_zlib_free
+    (void               *opaque
+    ,void               *address
+    )
+{
+    (void)opaque;
+    (void)address;
+}
@@ -0,0 +1,129 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#ifndef SADM_ZLIB_MEMORY_H_
+#define SADM_ZLIB_MEMORY_H_
+
+/**
+ * @file sadm_zlib_memory.h
+ * @brief client-memory allocator for the persistent zlib streams of the
+ * S-ADM bitstream encoder and decoder
+ *
+ * zlib allocates its stream state when a stream is initialized and keeps it
+ * across deflateReset()/inflateReset(), so a simple bump allocator over
+ * memory provided at init time is enough, and keeps the per-frame path free
+ * of heap allocations.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def SADM_DEFLATE_MEMORY_SIZE
+ * @brief memory needed for a deflate stream with windowBits 15 and memLevel 8:
+ * (1 << (windowBits + 2)) + (1 << (memLevel + 9)), plus the stream and its state
+ */
+#define SADM_DEFLATE_MEMORY_SIZE ((1 << 17) + (1 << 17) + (1 << 14))
+
+/**
+ * @def SADM_INFLATE_MEMORY_SIZE
+ * @brief memory needed for an inflate stream with windowBits 15:
+ * (1 << windowBits), plus the stream and its state
+ */
+#define SADM_INFLATE_MEMORY_SIZE ((1 << 15) + (1 << 14))
+
+
+/**
+ * @brief bump allocator state
+ */
+typedef struct
+{
+    uint8_t     *base;          /**< start of the memory */
+    size_t       capacity;      /**< size of the memory in bytes */
+    size_t       used;          /**< bytes handed out so far */
+} sadm_zlib_memory;
+
+
+/**
+ * @brief set up the allocator over the given memory
+ */
+void
+sadm_zlib_memory_init
+    (sadm_zlib_memory   *zmem       /**< [in] allocator to initialize */
+    ,void               *base       /**< [in] memory to allocate from */
+    ,size_t              capacity   /**< [in] size of the memory in bytes */
+    );
+
+
+/**
+ * @brief release everything handed out so far
+ */
+void
+sadm_zlib_memory_reset
+    (sadm_zlib_memory   *zmem       /**< [in] allocator to reset */
+    );
+
+
+/**
+ * @brief zlib alloc_func; #opaque is the #sadm_zlib_memory
+ */
+void *                              /** @return allocated memory, or NULL if exhausted */
+sadm_zlib_alloc
+    (void               *opaque     /**< [in] allocator */
+    ,unsigned int        items      /**< [in] number of items */
+    ,unsigned int        size       /**< [in] size of each item */
+    );
+
+
+/**
+ * @brief zlib free_func; memory is only reclaimed by #sadm_zlib_memory_reset
+ */
+void
+sadm_zlib_free
+    (void               *opaque     /**< [in] allocator */
+    ,void               *address    /**< [in] memory to free */
+    );
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SADM_ZLIB_MEMORY_H_ */
@@ -0,0 +1,323 @@
+#!/bin/bash
+#
+# simple script to create the perfect hash table of PMD XML tag and
+# attribute names used by the XML reader.
+#
+# Each name gets an enumerator XML_NAME_<name> (with '-' replaced by '_').
+# Names are matched case-insensitively, so names differing only in case
+# share one entry, spelled as the first one listed.  The script searches
+# for a hash multiplier that maps every name to a different slot, so a
+# lookup costs one hash and one string comparison.
+#
+# The hash must match xml_name_lookup() in the generated file:
+#
+#     h = 0; for each char c: h = h * multiplier + (c | 0x20)  (mod 2^32)
+#     slot = h % table size
+#
+# usage: ./mknames.sh <outputfilename>
+
+OUTPUT=$1
+if [ "$#" -eq "0" ]
+then
+    echo "Error - expected output filename"
+    exit
+fi
+
+# element tags, then attributes
+cat > tmp <<EOF
+ATSC3
+Ad-ID
+AudioBed
+AudioElements
+AudioObject
+AudioSignal
+AudioSignals
+Bitstream
+BroadcastStreamID
+BsMod
+ChannelExclusions
+Class
+ComprProf
+Config
+ContainerConfig
+Content_ID
+DDplus_DRC_Profile
+DRC
+Dialnorm
+Distribution_ID
+Diverge
+DolbyE
+DynamicTags
+DynamicUpdate
+DynamicUpdates
+DynrngProf
+ED2
+ED2Turnaround
+EIDR
+Eac3EncodingParameters
+Element
+Encoder
+EncoderConfigurations
+Extension
+Flat_Panel_DRC_Profile
+FrameRate
+HMixLev
+HeadTrackingEnabled
+HeadphoneElement
+HeadphoneElements
+Home_Theater_DRC_Profile
+IAT
+ID
+Language
+LoRoCMixLev
+LoRoSurMixLev
+Loudness3Seconds
+LoudnessRange
+LoudnessRelativeGated
+LoudnessSpeechGated
+LtRtCMixLev
+LtRtSurMixLev
+Major_Channel_Number
+MaxLoudness3Seconds
+MaxMomentaryLoudness
+MaxTruePeak
+Minor_Channel_Number
+MomentaryLoudness
+Name
+Offset
+OutputTarget
+OutputTargets
+Portable_Headphones_DRC_Profile
+Portable_Speakers_DRC_Profile
+PracticeType
+PrefDMixMod
+Presentation
+PresentationId
+PresentationLoudness
+Presentations
+ProfessionalMetadata
+ProgramBoundary
+ProgramConfiguration
+Raw
+RenderMode
+SampleOffset
+Size
+Size_3D
+Smpte2109
+SourceBedId
+SourceGainDB
+SpeakerConfig
+SurMod
+Surround90
+Tag
+Timestamp
+Title
+TruePeak
+UUID
+User_Data
+Validity_Duration
+X_Pos
+Y_Pos
+Z_Pos
+ascii
+base16
+xml
+bits
+correction_type
+dialgate
+id
+language
+offset
+practice
+profile_level
+profile_number
+sample_time
+source_gain_db
+type
+version
+EOF
+
+cat > $OUTPUT <<EOF
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+EOF
+
+awk '
+BEGIN {
+    for (i = 1; i < 128; ++i) ord[sprintf("%c", i)] = i;
+}
+{
+    key = tolower($1);
+    if (!(key in seen)) { seen[key] = 1; names[++n] = $1; }
+}
+END {
+    for (i = 1; i <= n; ++i)
+    {
+        len[i] = length(names[i]);
+        for (j = 1; j <= len[i]; ++j)
+        {
+            c = ord[substr(names[i], j, 1)];
+            if ((c % 64) < 32) c += 32;              # c | 0x20
+            code[i, j] = c;
+        }
+    }
+
+    # search for a small table, then the smallest multiplier, with no collisions
+    found = 0;
+    for (size = 4 * n; !found; size += 16)
+    {
+        for (mul = 3; mul < 4096 && !found; mul += 2)
+        {
+            delete used;
+            ok = 1;
+            for (i = 1; i <= n && ok; ++i)
+            {
+                h = 0;
+                for (j = 1; j <= len[i]; ++j) h = (h * mul + code[i, j]) % 4294967296;
+                s = h % size;
+                if (s in used) ok = 0;
+                used[s] = i;
+                slot[i] = s;
+            }
+            if (ok) { found = 1; tsize = size; tmul = mul; }
+        }
+    }
+
+    print "#ifndef _PMD_XML_NAMES_H_";
+    print "#define _PMD_XML_NAMES_H_";
+    print "";
+    print "/**";
+    print " * @file xml_names.h";
+    print " * @brief perfect hash table of PMD XML tag and attribute names";
+    print " *";
+    print " * generated by mknames.sh: do not edit";
+    print " */";
+    print "";
+    print "#include <stdint.h>";
+    print "#include <string.h>";
+    print "";
+    print "#ifdef _MSC_VER";
+    print "#  define strcasecmp _stricmp";
+    print "#endif";
+    print "";
+    print "";
+    print "/**";
+    print " * @def XML_NAME_HASH_SIZE";
+    print " * @brief number of slots in the hash table";
+    print " */";
+    printf("#define XML_NAME_HASH_SIZE (%d)\n", tsize);
+    print "";
+    print "";
+    print "/**";
+    print " * @def XML_NAME_HASH_MULTIPLIER";
+    print " * @brief multiplier of the hash function, chosen so no two names collide";
+    print " */";
+    printf("#define XML_NAME_HASH_MULTIPLIER (%du)\n", tmul);
+    print "";
+    print "";
+    print "/**";
+    print " * @brief interned PMD XML tag and attribute names";
+    print " */";
+    print "typedef enum";
+    print "{";
+    print "    XML_NAME_UNKNOWN,";
+    for (i = 1; i <= n; ++i)
+    {
+        e = names[i];
+        gsub(/-/, "_", e);
+        printf("    XML_NAME_%s,\n", e);
+    }
+    print "    XML_NAME_COUNT";
+    print "} xml_name;";
+    print "";
+    print "";
+    print "/**";
+    print " * @brief spelling of each name, indexed by #xml_name";
+    print " */";
+    print "static const char *xml_name_strings[XML_NAME_COUNT] =";
+    print "{";
+    print "    \"\",";
+    for (i = 1; i <= n; ++i) printf("    \"%s\",\n", names[i]);
+    print "};";
+    print "";
+    print "";
+    print "/**";
+    print " * @brief the #xml_name hashing to each slot, or XML_NAME_UNKNOWN";
+    print " */";
+    print "static const unsigned char xml_name_slots[XML_NAME_HASH_SIZE] =";
+    print "{";
+    for (s = 0; s < tsize; ++s) table[s] = 0;
+    for (i = 1; i <= n; ++i) table[slot[i]] = i;
+    for (s = 0; s < tsize; s += 16)
+    {
+        line = "   ";
+        for (k = s; k < s + 16 && k < tsize; ++k) line = line sprintf(" %3d,", table[k]);
+        print line;
+    }
+    print "};";
+    print "";
+    print "";
+    print "/**";
+    print " * @brief intern a tag or attribute name, ignoring case";
+    print " */";
+    print "static inline";
+    print "xml_name              /** @return name, or XML_NAME_UNKNOWN if not a PMD name */";
+    print "xml_name_lookup";
+    print "    (const char *s    /**< [in] tag or attribute name */";
+    print "    )";
+    print "{";
+    print "    const unsigned char *c = (const unsigned char *)s;";
+    print "    uint32_t h = 0;";
+    print "    xml_name name;";
+    print "";
+    print "    while (*c)";
+    print "    {";
+    print "        h = h * XML_NAME_HASH_MULTIPLIER + (*c++ | 0x20);";
+    print "    }";
+    print "    name = (xml_name)xml_name_slots[h % XML_NAME_HASH_SIZE];";
+    print "    if (name && !strcasecmp(s, xml_name_strings[name]))";
+    print "    {";
+    print "        return name;";
+    print "    }";
+    print "    return XML_NAME_UNKNOWN;";
+    print "}";
+    print "";
+    print "";
+    print "#endif /* _PMD_XML_NAMES_H_ */";
+}' tmp >> $OUTPUT
+
+rm -f tmp
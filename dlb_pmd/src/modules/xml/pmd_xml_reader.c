@@ -44,6 +44,8 @@
 #include "xml_eidr.h"
 #include "xml_ad_id.h"
 #include "xml_cdata.h"
+#include "xml_names.h"
+#include "xml_number.h"
 
 #include "pmd_model.h"
 
@@ -719,12 +721,12 @@ report_error
 static
 int  /** @return 1 if the tag is <literal>, 0 otherwise */
 is_open_tag
-    (const char *tag      /**< [in] current tag */
+    (xml_name tag         /**< [in] current tag, interned */
     ,const char *text     /**< [in] tag's text */
-    ,const char *literal  /**< [in] pattern to match */
+    ,xml_name literal     /**< [in] pattern to match */
     )
 {
-    return !strcasecmp(tag, literal) && NULL == text;
+    return tag == literal && NULL == text;
 }
 
 
@@ -734,19 +736,22 @@ is_open_tag
 static
 int  /** @return 1 if the tag is </literal>, 0 otherwise */
 is_closed_tag
-    (const char *tag      /**< [in] current tag */
+    (xml_name tag         /**< [in] current tag, interned */
     ,const char *text     /**< [in] tag's text */
-    ,const char *literal  /**< [in] pattern to match */
+    ,xml_name literal     /**< [in] pattern to match */
     )
 {
-    return !strcasecmp(tag, literal) && NULL != text;
+    return tag == literal && NULL != text;
 }
 
 
 
+/* tags are named by their #xml_name enumerator without the XML_NAME_
+ * prefix, e.g. open_tag(AudioSignal), and compared to the interned tag
+ */
 #define next_tag()           COROUTINE_RETURN(0)
-#define open_tag(literal)    (is_open_tag(tag, text, literal))
-#define closed_tag(literal)  (is_closed_tag(tag, text, literal))
+#define open_tag(literal)    (is_open_tag(tagname, text, XML_NAME_##literal))
+#define closed_tag(literal)  (is_closed_tag(tagname, text, XML_NAME_##literal))
 #define error()              { report_error(context, tag, text); return 1; }
 #define push_tag()           tag_stack_push(&p->tagstack, tag, p->lineno, NULL)
 #define push_action_tag(a)   tag_stack_push(&p->tagstack, tag, p->lineno, a)
@@ -756,7 +761,7 @@ is_closed_tag
     push_tag();                                     \
     while (!closed_tag(name))                       \
     {                                               \
-        parser_trace(p, "loop tag <%s>\n", name);   \
+        parser_trace(p, "loop tag <%s>\n", #name);  \
 
                                                           
 #define end_loop()                              \
@@ -767,7 +772,7 @@ is_closed_tag
 #define if_begin_popaction_tag(name, action, popaction)         \
     if (open_tag(name))                                         \
     {                                                           \
-        parser_trace(p, "parsing body of <%s>\n", name);        \
+        parser_trace(p, "parsing body of <%s>\n", #name);       \
         push_action_tag(popaction);                             \
         next_tag();                                             \
         action;                                                 \
@@ -789,10 +794,10 @@ is_closed_tag
 #define if_tag(name)                                            \
     if (open_tag(name))                                         \
     {                                                           \
-        parser_trace(p, "parsing body of <%s>\n", name);        \
+        parser_trace(p, "parsing body of <%s>\n", #name);       \
         push_tag();                                             \
         next_tag();                                             \
-        parser_trace(p, "**** %s: %s\n", name, text);           \
+        parser_trace(p, "**** %s: %s\n", #name, text);          \
         if (!closed_tag(name)) error();                         \
 
 
@@ -803,7 +808,7 @@ is_closed_tag
 #define if_open_tag(name)                                   \
     if (open_tag(name))                                     \
     {                                                       \
-        parser_trace(p, "parsing body of <%s>\n", name);    \
+        parser_trace(p, "parsing body of <%s>\n", #name);   \
         push_tag();                                         \
         next_tag();
       
@@ -868,13 +873,17 @@ decode_xml_escape
     }
     
     *textptr = end + 1;
-    if (1 == sscanf(text, "&#%u;", unicode))
-    {
-        return 1;
-    }
-    if (1 == sscanf(text, "&#x%x;", unicode))
+    if (text[0] == '&' && text[1] == '#')
     {
-        return 1;
+        const char *digits = text[2] == 'x' ? text + 3 : text + 2;
+        char *endp;
+        long long v = xml_strtoll(digits, &endp, text[2] == 'x' ? 16 : 10);
+
+        if (endp != digits)
+        {
+            *unicode = (unsigned int)v;
+            return 1;
+        }
     }
     if (0 == strncmp(text, "&amp;", 5))
     {
@@ -1062,7 +1071,7 @@ decode_uint
         return 0;
     }
 
-    v = strtoll(text, &endp, 0);
+    v = xml_strtoll(text, &endp, 0);
     if (v < 0 || v > (long long)max || endp == text)
     {
         errmsg(p, "Invalid %s: \"%s\"", name, text);
@@ -1193,7 +1202,7 @@ decode_coordinate
         return 0;
     }
 
-    f = (float)strtod(text, &endp);
+    f = (float)xml_strtod(text, &endp);
     if (f < -1.0f || f > 1.0f || endp == text)
     {
         errmsg(p, "Invalid co-ordinate: \"%s\"",  text);
@@ -1242,7 +1251,7 @@ decode_gain
         return 1;
     }
     
-    *gain = (float)strtod(text, &endp);
+    *gain = (float)xml_strtod(text, &endp);
     if (*gain < -25.0f || *gain > 6.0f || endp == text)
     {
         errmsg(p, "Invalid gain: \"%s\"",  text);
@@ -1281,7 +1290,7 @@ decode_size
         return 0;
     }
 
-    f = (float)strtod(text, &endp);
+    f = (float)xml_strtod(text, &endp);
     if (f < 0 || f > 1 || endp == text)
     {
         errmsg(p, "Invalid size: \"%s\"",  text);
@@ -1810,7 +1819,7 @@ decode_eepid
         return 0;
     }
 
-    v = strtol(text, &endp, 0);
+    v = xml_strtol(text, &endp, 0);
     if (v < 1 || v > 255 || endp == text)
     {
         errmsg(p, "Invalid EAC3 encoding parameter id: \"%s\"", text);
@@ -1956,7 +1965,7 @@ decode_cmixlev
         return 0;
     }
     
-    v = strtod(text, &endp);
+    v = xml_strtod(text, &endp);
     if (text_is_minf_db(text))
     {
         *mixlev = PMD_CMIX_LEVEL_MINF;
@@ -2001,7 +2010,7 @@ decode_surmixlev
         return 0;
     }
     
-    v = strtod(text, &endp);
+    v = xml_strtod(text, &endp);
     if (text_is_minf_db(text))
     {
         *mixlev = PMD_SURMIX_LEVEL_MINF;
@@ -2049,7 +2058,7 @@ decode_hmixlev
         return 1;
     }
 
-    v = strtod(text, &endp);
+    v = xml_strtod(text, &endp);
     if (v <= 0.0 && v >= -30.0 && endp != text)
     {
         *hmixlev = -v;
@@ -2545,7 +2554,7 @@ decode_iat_timestamp
         return 0;
     }
 
-    v = strtoll(text, &endp, 0);
+    v = xml_strtoll(text, &endp, 0);
     if (v < 0 || v > (long long)(1ull<<35)-1 || endp == text)
     {
         errmsg(p, "Invalid IAT Timestamp: \"%s\"", text);
@@ -2681,7 +2690,7 @@ decode_pld_presid
         return 0;
     }
 
-    v = strtol(text, &endp, 0);
+    v = xml_strtol(text, &endp, 0);
     if (v < 0 || v > MAX_PRESENTATIONS || endp == text)
     {
         errmsg(p, "Invalid presentation id: \"%s\"", text);
@@ -2761,7 +2770,7 @@ decode_pld_lufs
         return 0;
     }
 
-    f = strtod(text, &endp);
+    f = xml_strtod(text, &endp);
     if (f < DLB_PMD_LUFS_MIN || f > DLB_PMD_LUFS_MAX || endp == text)
     {
         errmsg(p, "Invalid LUFS value \"%s\" in field %s",  text, field);
@@ -2907,7 +2916,7 @@ decode_pld_prgmbndy
         return 0;
     }
 
-    v = strtol(text, &endp, 0);
+    v = xml_strtol(text, &endp, 0);
     x = labs(v);
     sign = v < 0 ? -1 : 1;
     if (x < 2 || x > 512 || endp == text)
@@ -2960,7 +2969,7 @@ decode_pld_lra
         return 0;
     }
 
-    f = strtod(text, &endp);
+    f = xml_strtod(text, &endp);
     if (f < DLB_PMD_LU_MIN || f > DLB_PMD_LU_MAX || endp == text)
     {
         errmsg(p, "Invalid LRA value \"%s\"",  text);
@@ -3183,54 +3192,55 @@ element_callback
     )
 {
     parser *p = (parser *)context;
+    xml_name tagname = xml_name_lookup(tag);
 
     COROUTINE_BEGIN;
 
-    if_begin_tag("Smpte2109",)
+    if_begin_tag(Smpte2109,)
     {
-        if_begin_tag("ContainerConfig",)
+        if_begin_tag(ContainerConfig,)
         {
-            if_tag("SampleOffset") parse_sample_offset();
-            elif_begin_tag("DynamicTags",)
+            if_tag(SampleOffset) parse_sample_offset();
+            elif_begin_tag(DynamicTags,)
             {
-                if_tag("Tag") parse_dynamic_tag();
+                if_tag(Tag) parse_dynamic_tag();
                 endif();
             }
             endif();
         }
-        elif_begin_tag("ProfessionalMetadata", set_profile(p))
+        elif_begin_tag(ProfessionalMetadata, set_profile(p))
         {
-            if_tag("Title")
+            if_tag(Title)
             {
                 parse_title();
             }
-            elif_begin_tag("AudioSignals",)
+            elif_begin_tag(AudioSignals,)
             {
-                if_begin_popaction_tag("AudioSignal",,add_signal_to_model)
+                if_begin_popaction_tag(AudioSignal,,add_signal_to_model)
                 {
-                    if_tag("Name");
+                    if_tag(Name);
                     endif();
                 }
                 endif();
             }
-            elif_begin_tag("AudioElements",)
+            elif_begin_tag(AudioElements,)
             {
-                if_begin_popaction_tag("AudioBed", new_bed(p), add_bed_to_model)
+                if_begin_popaction_tag(AudioBed, new_bed(p), add_bed_to_model)
                 {
-                    if_tag("Name")            parse_element_name(p->bed.name);
-                    elif_tag("SpeakerConfig") parse_speaker_config(&p->bed.config);
-                    elif_tag("SourceBedId")
+                    if_tag(Name)            parse_element_name(p->bed.name);
+                    elif_tag(SpeakerConfig) parse_speaker_config(&p->bed.config);
+                    elif_tag(SourceBedId)
                     {
                         parse_element_id(p->bed.source_id);
                         p->bed.bed_type = PMD_BED_DERIVED;
                     }
-                    elif_begin_tag("OutputTargets",)
+                    elif_begin_tag(OutputTargets,)
                     {
-                        if_begin_tag("OutputTarget",)
+                        if_begin_tag(OutputTarget,)
                         {
-                            if_begin_tag("AudioSignals",)
+                            if_begin_tag(AudioSignals,)
                             {
-                                if_tag("ID")
+                                if_tag(ID)
                                 {
                                     parse_signal_id(p->source->source);
                                     /* current target set by attribute_callback
@@ -3251,101 +3261,101 @@ element_callback
                     }
                     endif();
                 }
-                elif_begin_popaction_tag("AudioObject", new_object(p), add_object_to_model)
+                elif_begin_popaction_tag(AudioObject, new_object(p), add_object_to_model)
                 {
-                    if_tag("Name")               parse_element_name   (p->object.name);
-                    elif_tag("Class")            parse_object_class   (p->object.object_class); 
-                    elif_tag("DynamicUpdates")   parse_bool           (p->object.dynamic_updates);
-                    elif_tag("X_Pos")            parse_coordinate     (p->object.x);
-                    elif_tag("Y_Pos")            parse_coordinate     (p->object.y);
-                    elif_tag("Z_Pos")            parse_coordinate     (p->object.z);
-                    elif_tag("Size")             parse_size           (p->object.size);
-                    elif_tag("Size_3D")          parse_bool           (p->object.size_3d);
-                    elif_tag("Diverge")          parse_bool           (p->object.diverge);
-                    elif_tag("AudioSignal")      parse_signal_id      (p->object.source);
-                    elif_tag("SourceGainDB")     parse_gain           (p->object.source_gain);
+                    if_tag(Name)               parse_element_name   (p->object.name);
+                    elif_tag(Class)            parse_object_class   (p->object.object_class); 
+                    elif_tag(DynamicUpdates)   parse_bool           (p->object.dynamic_updates);
+                    elif_tag(X_Pos)            parse_coordinate     (p->object.x);
+                    elif_tag(Y_Pos)            parse_coordinate     (p->object.y);
+                    elif_tag(Z_Pos)            parse_coordinate     (p->object.z);
+                    elif_tag(Size)             parse_size           (p->object.size);
+                    elif_tag(Size_3D)          parse_bool           (p->object.size_3d);
+                    elif_tag(Diverge)          parse_bool           (p->object.diverge);
+                    elif_tag(AudioSignal)      parse_signal_id      (p->object.source);
+                    elif_tag(SourceGainDB)     parse_gain           (p->object.source_gain);
                     endif();
                 }
                 endif();
             }
-            elif_begin_tag("Presentations",)
+            elif_begin_tag(Presentations,)
             {
-                if_begin_popaction_tag("Presentation", new_presentation(p), add_presentation_to_model)
+                if_begin_popaction_tag(Presentation, new_presentation(p), add_presentation_to_model)
                 {
-                    if_tag("Config")     parse_presentation_config(p->presentation.config);
-                    elif_tag("Language") parse_language(p->presentation.audio_language);
-                    elif_tag("Element")  parse_presentation_element(p);
-                    elif_tag("Name")     parse_presentation_name(p)
+                    if_tag(Config)     parse_presentation_config(p->presentation.config);
+                    elif_tag(Language) parse_language(p->presentation.audio_language);
+                    elif_tag(Element)  parse_presentation_element(p);
+                    elif_tag(Name)     parse_presentation_name(p)
                     endif();
                 }
                 endif();
             }
-            elif_begin_tag("PresentationLoudness",)
+            elif_begin_tag(PresentationLoudness,)
             {
-                if_begin_popaction_tag("Presentation", new_loudness(p), add_loudness_to_model)
+                if_begin_popaction_tag(Presentation, new_loudness(p), add_loudness_to_model)
                 {
-                    if_tag("PresentationId")          parse_pld_presid(p);
-                    elif_tag("PracticeType")          parse_pld_practype(p);
-                    elif_tag("LoudnessRelativeGated") parse_pld_loudrelgat(p);
-                    elif_tag("LoudnessSpeechGated")   parse_pld_loudspchgat(p);
-                    elif_tag("Loudness3Seconds")      parse_pld_loud3sgat(p);
-                    elif_tag("MaxLoudness3Seconds")   parse_pld_maxloud3sgat(p);
-                    elif_tag("TruePeak")              parse_pld_truepeak(p);
-                    elif_tag("MaxTruePeak")           parse_pld_max_truepeak(p);
-                    elif_tag("ProgramBoundary")       parse_pld_prgmbndy(p);
-                    elif_tag("LoudnessRange")         parse_pld_lra(p);
-                    elif_tag("MomentaryLoudness")     parse_pld_loudmntry(p);
-                    elif_tag("MaxMomentaryLoudness")  parse_pld_max_loudmntry(p);
-                    elif_open_tag("Extension")
+                    if_tag(PresentationId)          parse_pld_presid(p);
+                    elif_tag(PracticeType)          parse_pld_practype(p);
+                    elif_tag(LoudnessRelativeGated) parse_pld_loudrelgat(p);
+                    elif_tag(LoudnessSpeechGated)   parse_pld_loudspchgat(p);
+                    elif_tag(Loudness3Seconds)      parse_pld_loud3sgat(p);
+                    elif_tag(MaxLoudness3Seconds)   parse_pld_maxloud3sgat(p);
+                    elif_tag(TruePeak)              parse_pld_truepeak(p);
+                    elif_tag(MaxTruePeak)           parse_pld_max_truepeak(p);
+                    elif_tag(ProgramBoundary)       parse_pld_prgmbndy(p);
+                    elif_tag(LoudnessRange)         parse_pld_lra(p);
+                    elif_tag(MomentaryLoudness)     parse_pld_loudmntry(p);
+                    elif_tag(MaxMomentaryLoudness)  parse_pld_max_loudmntry(p);
+                    elif_open_tag(Extension)
                     {
-                        if_tag("ascii")    parse_pld_extension(p, 0);
-                        elif_tag("base16") parse_pld_extension(p, 1);
+                        if_tag(ascii)    parse_pld_extension(p, 0);
+                        elif_tag(base16) parse_pld_extension(p, 1);
                         endif();
                     }
                     endif();
                 }
                 endif();
             }
-            elif_begin_tag("EncoderConfigurations",)
+            elif_begin_tag(EncoderConfigurations,)
             {
-                if_begin_popaction_tag("Eac3EncodingParameters", new_eac3(p), add_eac3_to_model)
+                if_begin_popaction_tag(Eac3EncodingParameters, new_eac3(p), add_eac3_to_model)
                 {
-                    if_tag("Name");
-                    elif_begin_tag("Bitstream",)
+                    if_tag(Name);
+                    elif_begin_tag(Bitstream,)
                     {
                         p->eac3.b_bitstream_params = 1;
-                        if_tag("BsMod")             parse_bsmod(p->eac3.bsmod);
-                        elif_tag("SurMod")          parse_dsurmod(p->eac3.dsurmod);
-                        elif_tag("Dialnorm")        parse_dialnorm(p->eac3.dialnorm);
-                        elif_tag("PrefDMixMod")     parse_dmixmod(p->eac3.dmixmod);
-                        elif_tag("LtRtCMixLev")     parse_cmixlev(p->eac3.ltrtcmixlev);
-                        elif_tag("LtRtSurMixLev")   parse_surmixlev(p->eac3.ltrtsurmixlev);
-                        elif_tag("LoRoCMixLev")     parse_cmixlev(p->eac3.lorocmixlev);
-                        elif_tag("LoRoSurMixLev")   parse_surmixlev(p->eac3.lorosurmixlev);
+                        if_tag(BsMod)             parse_bsmod(p->eac3.bsmod);
+                        elif_tag(SurMod)          parse_dsurmod(p->eac3.dsurmod);
+                        elif_tag(Dialnorm)        parse_dialnorm(p->eac3.dialnorm);
+                        elif_tag(PrefDMixMod)     parse_dmixmod(p->eac3.dmixmod);
+                        elif_tag(LtRtCMixLev)     parse_cmixlev(p->eac3.ltrtcmixlev);
+                        elif_tag(LtRtSurMixLev)   parse_surmixlev(p->eac3.ltrtsurmixlev);
+                        elif_tag(LoRoCMixLev)     parse_cmixlev(p->eac3.lorocmixlev);
+                        elif_tag(LoRoSurMixLev)   parse_surmixlev(p->eac3.lorosurmixlev);
                         endif();
                     }
-                    elif_begin_tag("Encoder",)
+                    elif_begin_tag(Encoder,)
                     {
                         p->eac3.b_encoder_params = 1;
-                        if_tag("DynrngProf")    parse_compr(p->eac3.dynrng_prof);
-                        elif_tag("ComprProf")   parse_compr(p->eac3.compr_prof);
-                        elif_tag("Surround90")  parse_surround90(p->eac3.surround90);
-                        elif_tag("HMixLev")     parse_hmixlev(p->eac3.hmixlev);
+                        if_tag(DynrngProf)    parse_compr(p->eac3.dynrng_prof);
+                        elif_tag(ComprProf)   parse_compr(p->eac3.compr_prof);
+                        elif_tag(Surround90)  parse_surround90(p->eac3.surround90);
+                        elif_tag(HMixLev)     parse_hmixlev(p->eac3.hmixlev);
                         endif();
                     }
-                    elif_begin_tag("DRC",)
+                    elif_begin_tag(DRC,)
                     {
                         p->eac3.b_drc_params = 1;
-                        if_tag("Portable_Speakers_DRC_Profile")     parse_compr(p->eac3.drc_port_spkr);
-                        elif_tag("Portable_Headphones_DRC_Profile") parse_compr(p->eac3.drc_port_hphone);
-                        elif_tag("Flat_Panel_DRC_Profile")          parse_compr(p->eac3.drc_flat_panl);
-                        elif_tag("Home_Theater_DRC_Profile")        parse_compr(p->eac3.drc_home_thtr);
-                        elif_tag("DDplus_DRC_Profile")              parse_compr(p->eac3.drc_ddplus);
+                        if_tag(Portable_Speakers_DRC_Profile)     parse_compr(p->eac3.drc_port_spkr);
+                        elif_tag(Portable_Headphones_DRC_Profile) parse_compr(p->eac3.drc_port_hphone);
+                        elif_tag(Flat_Panel_DRC_Profile)          parse_compr(p->eac3.drc_flat_panl);
+                        elif_tag(Home_Theater_DRC_Profile)        parse_compr(p->eac3.drc_home_thtr);
+                        elif_tag(DDplus_DRC_Profile)              parse_compr(p->eac3.drc_ddplus);
                         endif();
                     }
-                    elif_begin_tag("Presentations", )
+                    elif_begin_tag(Presentations, )
                     {
-                        if_tag("ID")
+                        if_tag(ID)
                         {
                             if (p->eac3.num_presentations == PMD_EEP_MAX_PRESENTATIONS)
                             {
@@ -3359,21 +3369,21 @@ element_callback
                     }
                     endif();
                 }
-                elif_begin_popaction_tag("ED2Turnaround", new_etd(p), add_ed2_turnaround_to_model)
+                elif_begin_popaction_tag(ED2Turnaround, new_etd(p), add_ed2_turnaround_to_model)
                 {
-                    if_tag("Name");
-                    elif_begin_tag("ED2",)
+                    if_tag(Name);
+                    elif_begin_tag(ED2,)
                     {
-                        if_tag("FrameRate")  parse_framerate(p->etd.ed2_framerate);
-                        elif_begin_tag("Presentations",)
+                        if_tag(FrameRate)  parse_framerate(p->etd.ed2_framerate);
+                        elif_begin_tag(Presentations,)
                         {
-                            if_begin_tag("Presentation", new_ed2_turnaround(p))
+                            if_begin_tag(Presentation, new_ed2_turnaround(p))
                             {
-                                if_tag("ID")
+                                if_tag(ID)
                                 {
                                     parse_presentation_id(p->turnaround->presid);
                                 }
-                                elif_tag("Eac3EncodingParameters")
+                                elif_tag(Eac3EncodingParameters)
                                 {
                                     parse_eep_id(p->turnaround->eepid);
                                 }
@@ -3383,19 +3393,19 @@ element_callback
                         }
                         endif();
                     }
-                    elif_begin_tag("DolbyE",)
+                    elif_begin_tag(DolbyE,)
                     {
-                        if_tag("FrameRate")  parse_framerate(p->etd.de_framerate);
-                        elif_tag("ProgramConfiguration") parse_pgmcfg(p->etd.pgm_config);
-                        elif_begin_tag("Presentations",)
+                        if_tag(FrameRate)  parse_framerate(p->etd.de_framerate);
+                        elif_tag(ProgramConfiguration) parse_pgmcfg(p->etd.pgm_config);
+                        elif_begin_tag(Presentations,)
                         {
-                            if_begin_tag("Presentation", new_de_turnaround(p))
+                            if_begin_tag(Presentation, new_de_turnaround(p))
                             {
-                                if_tag("ID")
+                                if_tag(ID)
                                 {
                                     parse_presentation_id(p->turnaround->presid);
                                 }
-                                elif_tag("Eac3EncodingParameters")
+                                elif_tag(Eac3EncodingParameters)
                                 {
                                     parse_eep_id(p->turnaround->eepid);
                                 }
@@ -3409,36 +3419,36 @@ element_callback
                 }
                 endif();
             }
-            elif_begin_popaction_tag("DynamicUpdate", new_update(p), add_update_to_model)
+            elif_begin_popaction_tag(DynamicUpdate, new_update(p), add_update_to_model)
             {
-                loop_until_closed("DynamicUpdate")
+                loop_until_closed(DynamicUpdate)
                 {
-                    if_tag("ID")      parse_element_id(p->update.id);
-                    elif_tag("X_Pos") parse_coordinate(p->update.x);
-                    elif_tag("Y_Pos") parse_coordinate(p->update.y);
-                    elif_tag("Z_Pos") parse_coordinate(p->update.z);
+                    if_tag(ID)      parse_element_id(p->update.id);
+                    elif_tag(X_Pos) parse_coordinate(p->update.x);
+                    elif_tag(Y_Pos) parse_coordinate(p->update.y);
+                    elif_tag(Z_Pos) parse_coordinate(p->update.z);
                     endif();
                 }
                 end_loop();
             }
-            elif_begin_popaction_tag("IAT", new_iat(p), add_iat_to_model)
+            elif_begin_popaction_tag(IAT, new_iat(p), add_iat_to_model)
             {
-                if_open_tag("Content_ID")
+                if_open_tag(Content_ID)
                 {
-                    if_tag("UUID")    parse_iat_content_id(p, PMD_IAT_CONTENT_ID_UUID, 0);
-                    elif_tag("EIDR")  parse_iat_content_id(p, PMD_IAT_CONTENT_ID_EIDR, 0);
-                    elif_tag("Ad-ID") parse_iat_content_id(p, PMD_IAT_CONTENT_ID_AD_ID, 0);
-                    elif_open_tag("Raw")
+                    if_tag(UUID)    parse_iat_content_id(p, PMD_IAT_CONTENT_ID_UUID, 0);
+                    elif_tag(EIDR)  parse_iat_content_id(p, PMD_IAT_CONTENT_ID_EIDR, 0);
+                    elif_tag(Ad_ID) parse_iat_content_id(p, PMD_IAT_CONTENT_ID_AD_ID, 0);
+                    elif_open_tag(Raw)
                     {
-                        if_tag("ascii")    parse_iat_content_id(p, p->current_raw_type, 0);
-                        elif_tag("base16") parse_iat_content_id(p, p->current_raw_type, 1);
+                        if_tag(ascii)    parse_iat_content_id(p, p->current_raw_type, 0);
+                        elif_tag(base16) parse_iat_content_id(p, p->current_raw_type, 1);
                         endif();
                     }
                     endif();
                 }
-                elif_open_tag("Distribution_ID")
+                elif_open_tag(Distribution_ID)
                 {
-                    if_open_tag("ATSC3")
+                    if_open_tag(ATSC3)
                     {
                         p->iat.distribution_id.type = PMD_IAT_DISTRIBUTION_ID_ATSC3;
                         p->atsc3_channel_bsid = 0;
@@ -3446,51 +3456,51 @@ element_callback
                         p->atsc3_channel_minno = 0;
                         p->atsc3_unread_fields = 0x7;
                         
-                        loop_until_closed("ATSC3")
+                        loop_until_closed(ATSC3)
                         {
-                            if_tag("BroadcastStreamID")      parse_iat_distid_atsc3_bsid(p);
-                            elif_tag("Major_Channel_Number") parse_iat_distid_atsc3_majno(p);
-                            elif_tag("Minor_Channel_Number") parse_iat_distid_atsc3_minno(p);
+                            if_tag(BroadcastStreamID)      parse_iat_distid_atsc3_bsid(p);
+                            elif_tag(Major_Channel_Number) parse_iat_distid_atsc3_majno(p);
+                            elif_tag(Minor_Channel_Number) parse_iat_distid_atsc3_minno(p);
                             endif();
                         }
                         end_loop();
                     }
-                    elif_open_tag("Raw")
+                    elif_open_tag(Raw)
                     {
-                        if_tag("ascii")    parse_iat_distid_raw(p, p->current_raw_type, 0);
-                        elif_tag("base16") parse_iat_distid_raw(p, p->current_raw_type, 1);
+                        if_tag(ascii)    parse_iat_distid_raw(p, p->current_raw_type, 0);
+                        elif_tag(base16) parse_iat_distid_raw(p, p->current_raw_type, 1);
                         endif();
                     }
                     endif();
                     parse_iat_distid_default(p);
                 }
-                elif_tag("Timestamp")         parse_iat_timestamp(p);
-                elif_tag("Offset"   )         parse_iat_offset(p);
-                elif_tag("Validity_Duration") parse_iat_validity_duration(p);
-                elif_open_tag("User_Data")
+                elif_tag(Timestamp)         parse_iat_timestamp(p);
+                elif_tag(Offset   )         parse_iat_offset(p);
+                elif_tag(Validity_Duration) parse_iat_validity_duration(p);
+                elif_open_tag(User_Data)
                 {
-                    if_tag("ascii")    parse_iat_user_data(p, 0);
-                    elif_tag("base16") parse_iat_user_data(p, 1);
+                    if_tag(ascii)    parse_iat_user_data(p, 0);
+                    elif_tag(base16) parse_iat_user_data(p, 1);
                     endif();
                 }
-                elif_open_tag("Extension")
+                elif_open_tag(Extension)
                 {
-                    if_tag("ascii")    parse_iat_extension(p, 0);
-                    elif_tag("base16") parse_iat_extension(p, 1);
+                    if_tag(ascii)    parse_iat_extension(p, 0);
+                    elif_tag(base16) parse_iat_extension(p, 1);
                     endif();
                 }
                 endif();
             }
-            elif_begin_tag("HeadphoneElements",)
+            elif_begin_tag(HeadphoneElements,)
             {
-                if_begin_popaction_tag("HeadphoneElement", new_headphone(p), add_headphone_to_model)
+                if_begin_popaction_tag(HeadphoneElement, new_headphone(p), add_headphone_to_model)
                 {
-                    if_tag("Element")                    parse_hed_element(p);
-                    elif_tag("HeadTrackingEnabled")      parse_hed_tracking(p);
-                    elif_tag("RenderMode")               parse_hed_render_mode(p);
-                    elif_begin_tag("ChannelExclusions",)
+                    if_tag(Element)                    parse_hed_element(p);
+                    elif_tag(HeadTrackingEnabled)      parse_hed_tracking(p);
+                    elif_tag(RenderMode)               parse_hed_render_mode(p);
+                    elif_begin_tag(ChannelExclusions,)
                     {
-                        if_tag("ID") parse_hed_channel_id(p);
+                        if_tag(ID) parse_hed_channel_id(p);
                         endif();
                     }
                     endif();
@@ -3519,26 +3529,36 @@ attribute_callback
     )
 {
     parser *p = (parser*)context;
+    xml_name tagname = xml_name_lookup(tag);
     unsigned int time;
     unsigned int id;
     char *endp;
 
-    if (!strcasecmp(tag, "xml"))
+    if (XML_NAME_xml == tagname)
     {
         return 0;
     }
 
-    if (!strcasecmp(attribute, "version"))
+    switch (xml_name_lookup(attribute))
     {
-        if (!strcasecmp(tag, "ProfessionalMetadata"))
+    case XML_NAME_version:
+        if (XML_NAME_ProfessionalMetadata == tagname)
         {
-            int maj;
-            int min;
-            int pos;
-            if (2 != sscanf(value, "%d.%d%n", &maj, &min, &pos)
-                || maj < 0 || maj > 255
+            long int maj = xml_strtol(value, &endp, 10);
+            long int min = -1;
+
+            if (endp != value && *endp == '.')
+            {
+                char *minp = endp + 1;
+                min = xml_strtol(minp, &endp, 10);
+                if (endp == minp)
+                {
+                    min = -1;
+                }
+            }
+            if (maj < 0 || maj > 255
                 || min < 0 || min > 255
-                || value[pos] != '\0')
+                || *endp != '\0')
             {
                 errmsg(p, "incorrect version format \"%s\"", value);
                 return 1;
@@ -3551,7 +3571,8 @@ attribute_callback
                     if (maj != p->model->version_maj || min != p->model->version_min)
                     {
                         errmsg(p, "version number already specified as %u.%u, not %u.%u",
-                               p->model->version_maj, p->model->version_min, maj, min);
+                               p->model->version_maj, p->model->version_min,
+                               (unsigned int)maj, (unsigned int)min);
                         return 1;
                     }
                 }
@@ -3563,7 +3584,7 @@ attribute_callback
                 {
                     errmsg(p, "major version number in XML (%u) "
                            "incompatible with supported version (%u)",
-                           maj, PMD_BITSTREAM_VERSION_MAJOR);
+                           (unsigned int)maj, PMD_BITSTREAM_VERSION_MAJOR);
                     return 1;
                 }
             }
@@ -3573,12 +3594,12 @@ attribute_callback
             p->model->version_min = (uint8_t)(min & 0xff);
             return 0;
         }
-    }
-    else if (!strcasecmp(attribute, "profile_number"))
-    {
-        if (!strcasecmp(tag, "ProfessionalMetadata"))
+        break;
+
+    case XML_NAME_profile_number:
+        if (XML_NAME_ProfessionalMetadata == tagname)
         {
-            long int tmp = strtol(value, &endp, 0);
+            long int tmp = xml_strtol(value, &endp, 0);
             if (tmp < 1 || tmp > MAX_PROFILE_NUMBER)
             {
                 errmsg(p, "profile_number attribute has illegal value %ld", tmp);
@@ -3586,12 +3607,12 @@ attribute_callback
             }
             p->profile_number = (unsigned int)tmp;
         }
-    }
-    else if (!strcasecmp(attribute, "profile_level"))
-    {
-        if (!strcasecmp(tag, "ProfessionalMetadata"))
+        break;
+
+    case XML_NAME_profile_level:
+        if (XML_NAME_ProfessionalMetadata == tagname)
         {
-            long int tmp = strtol(value, &endp, 0);
+            long int tmp = xml_strtol(value, &endp, 0);
             if (tmp < 1 || tmp > MAX_PROFILE_LEVEL)
             {
                 errmsg(p, "profile_level attribute has illegal value %ld", tmp);
@@ -3599,24 +3620,23 @@ attribute_callback
             }
             p->profile_level = (unsigned int)tmp;
         }
-    }
-    else if (!strcasecmp(attribute, "id"))
-    {
-        if (!strcasecmp(tag, "Tag"))
+        break;
+
+    case XML_NAME_ID:
+        if (XML_NAME_Tag == tagname)
         {
-            unsigned int localtag;
-            int pos;
-            if (1 != sscanf(value, "%x%n", &localtag, &pos)
-                || localtag > 255
-                || value[pos] != '\0')
+            long int localtag = xml_strtol(value, &endp, 16);
+            if (endp == value
+                || localtag < 0 || localtag > 255
+                || *endp != '\0')
             {
                 errmsg(p, "incorrect Local Tag format \"%s\"", value);
                 return 1;
             }
-            p->current_dynamic_tag = localtag;
+            p->current_dynamic_tag = (unsigned int)localtag;
             return 0;
         }
-        else if (!strcasecmp(tag, "OutputTarget"))
+        else if (XML_NAME_OutputTarget == tagname)
         {
             if (!decode_speaker_name(p, value, &p->current_target))
             {
@@ -3631,48 +3651,36 @@ attribute_callback
             return 1;
         }
         
-        if (!strcasecmp(tag, "AudioSignal"))
+        switch (tagname)
         {
+        case XML_NAME_AudioSignal:
             p->current_signal_id = id;
             return 0;
-        }
-        else if (!strcasecmp(tag, "AudioBed"))
-        {
-            p->current_element_id = id;
-            return 0;
-        }
-        else if (!strcasecmp(tag, "AudioObject"))
-        {
+        case XML_NAME_AudioBed:
+        case XML_NAME_AudioObject:
             p->current_element_id = id;
             return 0;
-        }
-        else if (!strcasecmp(tag, "Presentation"))
-        {
+        case XML_NAME_Presentation:
             p->current_presentation_id = id;
             return 0;
-        }
-        else if (!strcasecmp(tag, "Eac3EncodingParameters"))
-        {
+        case XML_NAME_Eac3EncodingParameters:
             p->current_eac3_id = id;
             return 0;
-        }
-        else if (!strcasecmp(tag, "ED2Turnaround"))
-        {
+        case XML_NAME_ED2Turnaround:
             p->current_etd_id = id;
             return 0;
-        }
-        else if (!strcasecmp(tag, "HeadphoneElement"))
-        {
+        case XML_NAME_HeadphoneElement:
             return 0;
+        default:
+            break;
         }
-    }
-    else if (!strcasecmp(attribute, "source_gain_db"))
-    {
+        break;
+
+    case XML_NAME_source_gain_db:
         return !decode_gain(p, value, &p->source_gain_db);
-    }
-    else if (!strcasecmp(attribute, "sample_time"))
-    {
-        if (!strcasecmp(tag, "DynamicUpdate"))
+
+    case XML_NAME_sample_time:
+        if (XML_NAME_DynamicUpdate == tagname)
         {
             if (!decode_uint(p, value, "update time", DLB_PMD_MAX_UPDATE_TIME, &time))
             {
@@ -3684,10 +3692,10 @@ attribute_callback
             p->update_time = time;
             return 0;
         }
-    }
-    else if (!strcasecmp(attribute, "type"))
-    {
-        if (!strcasecmp(tag, "Raw"))
+        break;
+
+    case XML_NAME_type:
+        if (XML_NAME_Raw == tagname)
         {
             if (decode_uint(p, value, "Raw type attribute", 0x1e, &p->current_raw_type))
             {
@@ -3695,42 +3703,44 @@ attribute_callback
             }
             errmsg(p, "unable to parse raw type \"%s\"", value);
         }
-    }
+        break;
+
     /* loudness */
-    else if (!strcasecmp(attribute, "dialgate"))
-    {
-        static const char *dialgate[] =
+    case XML_NAME_dialgate:
         {
-            "NI", "Center", "Front", "Manual", "4", "5", "6", "7"
-        };
+            static const char *dialgate[] =
+            {
+                "NI", "Center", "Front", "Manual", "4", "5", "6", "7"
+            };
 
-        if (!strcasecmp(tag, "PracticeType"))
-        {
-            int idx = decode_enum(value, dialgate, 8);
-            if (idx < 0)
+            if (XML_NAME_PracticeType == tagname)
             {
-                errmsg(p, "Unknown dialgate value \"%s\" in %s tag", value, tag);
-                return 1;
+                int idx = decode_enum(value, dialgate, 8);
+                if (idx < 0)
+                {
+                    errmsg(p, "Unknown dialgate value \"%s\" in %s tag", value, tag);
+                    return 1;
+                }
+                p->loudness.loudcorr_gating = (dlb_pmd_dialgate_practice)idx;
+                p->loudness.b_loudcorr_gating = 1;
+                return 0;
             }
-            p->loudness.loudcorr_gating = (dlb_pmd_dialgate_practice)idx;
-            p->loudness.b_loudcorr_gating = 1;
-            return 0;
-        }
-        else if (!strcasecmp(tag, "LoudnessSpeechGated"))
-        {
-            int idx = decode_enum(value, dialgate, 4);
-            if (idx < 0)
+            else if (XML_NAME_LoudnessSpeechGated == tagname)
             {
-                errmsg(p, "Unknown dialgate value \"%s\" in %s tag", value, tag);
-                return 1;
+                int idx = decode_enum(value, dialgate, 4);
+                if (idx < 0)
+                {
+                    errmsg(p, "Unknown dialgate value \"%s\" in %s tag", value, tag);
+                    return 1;
+                }
+                p->loudness.loudspch_gating = (dlb_pmd_dialgate_practice)idx;
+                return 0;
             }
-            p->loudness.loudspch_gating = (dlb_pmd_dialgate_practice)idx;
-            return 0;
         }
-    }
-    else if (!strcasecmp(attribute, "offset"))
-    {
-        if (!strcasecmp(tag, "ProgramBoundary"))
+        break;
+
+    case XML_NAME_Offset:
+        if (XML_NAME_ProgramBoundary == tagname)
         {
             if (!decode_uint(p, value, "Programme boundary offset",
                              2047, &p->loudness.prgmbndy_offset))
@@ -3740,31 +3750,32 @@ attribute_callback
             p->loudness.b_prgmbndy_offset = 1;
             return 0;
         }
-    }
-    else if (!strcasecmp(attribute, "practice"))
-    {
-        if (!strcasecmp(tag, "LoudnessRange"))
+        break;
+
+    case XML_NAME_practice:
+        if (XML_NAME_LoudnessRange == tagname)
         {
             unsigned int tmp;
             int res = !decode_uint(p, value, "Loudness Range Practice", 1, &tmp);
             p->loudness.lra_prac_type = (dlb_pmd_loudness_range_practice)tmp;
             return res;
         }
-    }
-    else if (!strcasecmp(attribute, "bits"))
-    {
-        unsigned int bits;
+        break;
 
-        if (!decode_uint(p, value, "bits", 8*sizeof(p->loudness.extension.data), &bits))
+    case XML_NAME_bits:
         {
-            p->loudness.extension.size = bits;
-            return 0;
+            unsigned int bits;
+
+            if (!decode_uint(p, value, "bits", 8*sizeof(p->loudness.extension.data), &bits))
+            {
+                p->loudness.extension.size = bits;
+                return 0;
+            }
+            return 1;
         }
-        return 1;
-    }
-    else if (!strcasecmp(attribute, "correction_type"))
-    {
-        if (!strcasecmp(tag, "PracticeType"))
+
+    case XML_NAME_correction_type:
+        if (XML_NAME_PracticeType == tagname)
         {
             if (!strcasecmp(value, "file"))
             {
@@ -3779,12 +3790,12 @@ attribute_callback
             errmsg(p, "Unknown loudness correction type \"%s\"\n", value);
             return 1;
         }
-    }
-    else if (!strcasecmp(attribute, "language"))
-    {
-        pmd_langcode code;
-        if (!strcasecmp(tag, "Name"))
+        break;
+
+    case XML_NAME_Language:
+        if (XML_NAME_Name == tagname)
         {
+            pmd_langcode code;
             if (!decode_langcode(p, value, &code))
             {
                 errmsg(p, "Unknown language code \"%s\"\n", code);
@@ -3793,6 +3804,10 @@ attribute_callback
             memmove(p->current_language, value, sizeof(p->current_language));
             return 0;
         }
+        break;
+
+    default:
+        break;
     }
     
     errmsg(p, "Unexpected attribute %s on tag %s (with value %s)\n", attribute, tag, value);
@@ -99,9 +99,10 @@ dlb_xmlpmd_file_write
    ,const dlb_pmd_model *model
    )
 {
-    static xml_buffer xbuf;
+    xml_buffer xbuf;
     dlb_pmd_success ret;
 
+    memset(&xbuf, 0, sizeof(xbuf));
     xbuf.fp = fopen(filename, "w");
     if (NULL == xbuf.fp)
     {
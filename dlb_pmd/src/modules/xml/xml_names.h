@@ -0,0 +1,373 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#ifndef _PMD_XML_NAMES_H_
+#define _PMD_XML_NAMES_H_
+
+/**
+ * @file xml_names.h
+ * @brief perfect hash table of PMD XML tag and attribute names
+ *
+ * generated by mknames.sh: do not edit
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#  define strcasecmp _stricmp
+#endif
+
+
+/**
+ * @def XML_NAME_HASH_SIZE
+ * @brief number of slots in the hash table
+ */
+#define XML_NAME_HASH_SIZE (588)
+
+
+/**
+ * @def XML_NAME_HASH_MULTIPLIER
+ * @brief multiplier of the hash function, chosen so no two names collide
+ */
+#define XML_NAME_HASH_MULTIPLIER (3059u)
+
+
+/**
+ * @brief interned PMD XML tag and attribute names
+ */
+typedef enum
+{
+    XML_NAME_UNKNOWN,
+    XML_NAME_ATSC3,
+    XML_NAME_Ad_ID,
+    XML_NAME_AudioBed,
+    XML_NAME_AudioElements,
+    XML_NAME_AudioObject,
+    XML_NAME_AudioSignal,
+    XML_NAME_AudioSignals,
+    XML_NAME_Bitstream,
+    XML_NAME_BroadcastStreamID,
+    XML_NAME_BsMod,
+    XML_NAME_ChannelExclusions,
+    XML_NAME_Class,
+    XML_NAME_ComprProf,
+    XML_NAME_Config,
+    XML_NAME_ContainerConfig,
+    XML_NAME_Content_ID,
+    XML_NAME_DDplus_DRC_Profile,
+    XML_NAME_DRC,
+    XML_NAME_Dialnorm,
+    XML_NAME_Distribution_ID,
+    XML_NAME_Diverge,
+    XML_NAME_DolbyE,
+    XML_NAME_DynamicTags,
+    XML_NAME_DynamicUpdate,
+    XML_NAME_DynamicUpdates,
+    XML_NAME_DynrngProf,
+    XML_NAME_ED2,
+    XML_NAME_ED2Turnaround,
+    XML_NAME_EIDR,
+    XML_NAME_Eac3EncodingParameters,
+    XML_NAME_Element,
+    XML_NAME_Encoder,
+    XML_NAME_EncoderConfigurations,
+    XML_NAME_Extension,
+    XML_NAME_Flat_Panel_DRC_Profile,
+    XML_NAME_FrameRate,
+    XML_NAME_HMixLev,
+    XML_NAME_HeadTrackingEnabled,
+    XML_NAME_HeadphoneElement,
+    XML_NAME_HeadphoneElements,
+    XML_NAME_Home_Theater_DRC_Profile,
+    XML_NAME_IAT,
+    XML_NAME_ID,
+    XML_NAME_Language,
+    XML_NAME_LoRoCMixLev,
+    XML_NAME_LoRoSurMixLev,
+    XML_NAME_Loudness3Seconds,
+    XML_NAME_LoudnessRange,
+    XML_NAME_LoudnessRelativeGated,
+    XML_NAME_LoudnessSpeechGated,
+    XML_NAME_LtRtCMixLev,
+    XML_NAME_LtRtSurMixLev,
+    XML_NAME_Major_Channel_Number,
+    XML_NAME_MaxLoudness3Seconds,
+    XML_NAME_MaxMomentaryLoudness,
+    XML_NAME_MaxTruePeak,
+    XML_NAME_Minor_Channel_Number,
+    XML_NAME_MomentaryLoudness,
+    XML_NAME_Name,
+    XML_NAME_Offset,
+    XML_NAME_OutputTarget,
+    XML_NAME_OutputTargets,
+    XML_NAME_Portable_Headphones_DRC_Profile,
+    XML_NAME_Portable_Speakers_DRC_Profile,
+    XML_NAME_PracticeType,
+    XML_NAME_PrefDMixMod,
+    XML_NAME_Presentation,
+    XML_NAME_PresentationId,
+    XML_NAME_PresentationLoudness,
+    XML_NAME_Presentations,
+    XML_NAME_ProfessionalMetadata,
+    XML_NAME_ProgramBoundary,
+    XML_NAME_ProgramConfiguration,
+    XML_NAME_Raw,
+    XML_NAME_RenderMode,
+    XML_NAME_SampleOffset,
+    XML_NAME_Size,
+    XML_NAME_Size_3D,
+    XML_NAME_Smpte2109,
+    XML_NAME_SourceBedId,
+    XML_NAME_SourceGainDB,
+    XML_NAME_SpeakerConfig,
+    XML_NAME_SurMod,
+    XML_NAME_Surround90,
+    XML_NAME_Tag,
+    XML_NAME_Timestamp,
+    XML_NAME_Title,
+    XML_NAME_TruePeak,
+    XML_NAME_UUID,
+    XML_NAME_User_Data,
+    XML_NAME_Validity_Duration,
+    XML_NAME_X_Pos,
+    XML_NAME_Y_Pos,
+    XML_NAME_Z_Pos,
+    XML_NAME_ascii,
+    XML_NAME_base16,
+    XML_NAME_xml,
+    XML_NAME_bits,
+    XML_NAME_correction_type,
+    XML_NAME_dialgate,
+    XML_NAME_practice,
+    XML_NAME_profile_level,
+    XML_NAME_profile_number,
+    XML_NAME_sample_time,
+    XML_NAME_source_gain_db,
+    XML_NAME_type,
+    XML_NAME_version,
+    XML_NAME_COUNT
+} xml_name;
+
+
+/**
+ * @brief spelling of each name, indexed by #xml_name
+ */
+static const char *xml_name_strings[XML_NAME_COUNT] =
+{
+    "",
+    "ATSC3",
+    "Ad-ID",
+    "AudioBed",
+    "AudioElements",
+    "AudioObject",
+    "AudioSignal",
+    "AudioSignals",
+    "Bitstream",
+    "BroadcastStreamID",
+    "BsMod",
+    "ChannelExclusions",
+    "Class",
+    "ComprProf",
+    "Config",
+    "ContainerConfig",
+    "Content_ID",
+    "DDplus_DRC_Profile",
+    "DRC",
+    "Dialnorm",
+    "Distribution_ID",
+    "Diverge",
+    "DolbyE",
+    "DynamicTags",
+    "DynamicUpdate",
+    "DynamicUpdates",
+    "DynrngProf",
+    "ED2",
+    "ED2Turnaround",
+    "EIDR",
+    "Eac3EncodingParameters",
+    "Element",
+    "Encoder",
+    "EncoderConfigurations",
+    "Extension",
+    "Flat_Panel_DRC_Profile",
+    "FrameRate",
+    "HMixLev",
+    "HeadTrackingEnabled",
+    "HeadphoneElement",
+    "HeadphoneElements",
+    "Home_Theater_DRC_Profile",
+    "IAT",
+    "ID",
+    "Language",
+    "LoRoCMixLev",
+    "LoRoSurMixLev",
+    "Loudness3Seconds",
+    "LoudnessRange",
+    "LoudnessRelativeGated",
+    "LoudnessSpeechGated",
+    "LtRtCMixLev",
+    "LtRtSurMixLev",
+    "Major_Channel_Number",
+    "MaxLoudness3Seconds",
+    "MaxMomentaryLoudness",
+    "MaxTruePeak",
+    "Minor_Channel_Number",
+    "MomentaryLoudness",
+    "Name",
+    "Offset",
+    "OutputTarget",
+    "OutputTargets",
+    "Portable_Headphones_DRC_Profile",
+    "Portable_Speakers_DRC_Profile",
+    "PracticeType",
+    "PrefDMixMod",
+    "Presentation",
+    "PresentationId",
+    "PresentationLoudness",
+    "Presentations",
+    "ProfessionalMetadata",
+    "ProgramBoundary",
+    "ProgramConfiguration",
+    "Raw",
+    "RenderMode",
+    "SampleOffset",
+    "Size",
+    "Size_3D",
+    "Smpte2109",
+    "SourceBedId",
+    "SourceGainDB",
+    "SpeakerConfig",
+    "SurMod",
+    "Surround90",
+    "Tag",
+    "Timestamp",
+    "Title",
+    "TruePeak",
+    "UUID",
+    "User_Data",
+    "Validity_Duration",
+    "X_Pos",
+    "Y_Pos",
+    "Z_Pos",
+    "ascii",
+    "base16",
+    "xml",
+    "bits",
+    "correction_type",
+    "dialgate",
+    "practice",
+    "profile_level",
+    "profile_number",
+    "sample_time",
+    "source_gain_db",
+    "type",
+    "version",
+};
+
+
+/**
+ * @brief the #xml_name hashing to each slot, or XML_NAME_UNKNOWN
+ */
+static const unsigned char xml_name_slots[XML_NAME_HASH_SIZE] =
+{
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,  95,   0,   0,   0,  10,   0,   0,   0,   0,  29,   0,   0,  70,   0,  99,
+      0,   0,   0,   0,  45,   0,   0,   0,   0,   0,  86,   0,   1,   0,   0,   0,
+      0,   0,  83,   0,   0,   0,   0,   0,   0,   0,   0,   0,  19,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,  47,   0,   0,   0,   0,   0,   0,
+      0,   0,   0, 101,   0,   0,   0,   0,   0,   0,  96,   0,   0,   0,   0,   0,
+      0,  28,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  61,   0,
+      0,  75, 105,   0,   0,   0,   0,   0,   0,  46,   0,   0,   9,  33,  50,  97,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  38,   0,   0,  82,   0,   0,
+      0,  76,  72,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,  74,  68,   0,   0,   0,   0,   6,   0,   0,   7,   0,   0,
+      0,   0,   0,  26,  31,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  69,
+      0,   0,   0,   0,   0,  77,   0,   0,  21,   0,   0,   0,  11,   0,  39,   0,
+      0,   0,   0,   0,   0,   0,   0,  43,   0,   0,   0,   0,   0,  62,   0,   0,
+     24,   0,   0,   0,   0,   0,   0,  59,   0,   0,   0,   0,  12,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,  85,   0,   0,  65,   0,   0,   0,  30,   0,  25,
+      0,  22, 102,   0,   0,   0,   0,  66,  13,  58,   0,   0,   0,  40,  73,   0,
+      0,   0,   0,   0,   0,   0,  98,   0,   0,   0,   0,   0,   0,  63,   0,  53,
+     23,   0,   0,   0,   0,  80,   0,   0,   0,   0,   0,   0,   0,   0, 106,   0,
+      0,  18,   0,   0,  42,   4,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,  55,   0,   0,   0,   0,   0,   0,   0,  91,   0,   3,
+      0,   0,   0,   0,   0,   0,   0,  78,   0,   0,   0,   0,   0,   0,   0,   0,
+     81,  41,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  88,   0,   0,
+      0,   8,   0,  89,   0,   0,   0,   0,  87,   0,   0,   0,   0,   5,   0,   0,
+      0,   0, 104,   0,   0,   0,   0,   0,   0,  54,  67,   0,   0,   0,  35,   0,
+      0,   2,   0,  27,   0,  37,   0,   0,   0,   0,   0,   0,   0,  16,  51,   0,
+      0,   0,   0,   0,   0,   0,  90,   0,  32,   0,   0,   0,   0,  84,   0,  15,
+      0,   0,  14,  34,   0,   0,   0,   0,   0,   0,  71,   0,   0,   0,   0,  94,
+      0,   0,   0,  79,   0,   0,   0,   0,   0,   0,  20,   0,   0,  36,   0,   0,
+      0,   0,  93,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,  44,  92,   0,   0,   0,   0,   0,  52,   0,   0,   0,   0,
+    107,   0,   0,  60,  49,   0,   0,   0,   0,   0,   0,   0,  48,   0,   0,   0,
+     64,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 100,   0,   0,   0, 103,
+      0,  56,   0,   0,   0,   0,   0,   0,   0,   0,  17,   0,   0,   0,   0,  57,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+
+/**
+ * @brief intern a tag or attribute name, ignoring case
+ */
+static inline
+xml_name              /** @return name, or XML_NAME_UNKNOWN if not a PMD name */
+xml_name_lookup
+    (const char *s    /**< [in] tag or attribute name */
+    )
+{
+    const unsigned char *c = (const unsigned char *)s;
+    uint32_t h = 0;
+    xml_name name;
+
+    while (*c)
+    {
+        h = h * XML_NAME_HASH_MULTIPLIER + (*c++ | 0x20);
+    }
+    name = (xml_name)xml_name_slots[h % XML_NAME_HASH_SIZE];
+    if (name && !strcasecmp(s, xml_name_strings[name]))
+    {
+        return name;
+    }
+    return XML_NAME_UNKNOWN;
+}
+
+
+#endif /* _PMD_XML_NAMES_H_ */
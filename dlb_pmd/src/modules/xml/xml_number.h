@@ -0,0 +1,275 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2017-2019, Dolby Laboratories Inc.
+ * Copyright (c) 2017-2019, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#ifndef _PMD_XML_NUMBER_H_
+#define _PMD_XML_NUMBER_H_
+
+/**
+ * @file xml_number.h
+ * @brief helper functions to read numbers from XML text
+ *
+ * These behave like strtoll, strtol and strtod, but read the common
+ * cases directly from the text with no locale lookups or library calls.
+ * Like the C library functions, they skip leading whitespace, accept a
+ * sign, and set @p endp to the first character they did not use, or to
+ * the start of the text if it does not start with a number.
+ */
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/**
+ * @brief helper to read a signed integer, as strtoll
+ *
+ * Base 0 reads a "0x" prefix as hex and a leading 0 as octal, base 16
+ * allows a "0x" prefix.  Values out of range are clamped.
+ */
+static inline
+long long                /** @return value read */
+xml_strtoll
+    (const char *text    /**< [in] text to read */
+    ,char **endp         /**< [out] first character after the number */
+    ,int base            /**< [in] 0, 8, 10 or 16 */
+    )
+{
+    const char *c = text;
+    unsigned long long limit;
+    unsigned long long v = 0;
+    const char *digits;
+    int overflow = 0;
+    int negative = 0;
+
+    while (isspace((unsigned char)*c))
+    {
+        ++c;
+    }
+    if (*c == '-' || *c == '+')
+    {
+        negative = *c++ == '-';
+    }
+    if ((base == 0 || base == 16) && c[0] == '0' && (c[1] | 0x20) == 'x'
+        && isxdigit((unsigned char)c[2]))
+    {
+        base = 16;
+        c += 2;
+    }
+    else if (base == 0)
+    {
+        base = c[0] == '0' ? 8 : 10;
+    }
+
+    limit = negative ? (unsigned long long)LLONG_MAX + 1 : (unsigned long long)LLONG_MAX;
+    digits = c;
+    for (;;)
+    {
+        unsigned int d;
+
+        if (*c >= '0' && *c <= '9')
+        {
+            d = *c - '0';
+        }
+        else if ((*c | 0x20) >= 'a' && (*c | 0x20) <= 'f')
+        {
+            d = (*c | 0x20) - 'a' + 10;
+        }
+        else
+        {
+            break;
+        }
+        if (d >= (unsigned int)base)
+        {
+            break;
+        }
+        if (v > (limit - d) / base)
+        {
+            overflow = 1;
+        }
+        else
+        {
+            v = v * base + d;
+        }
+        ++c;
+    }
+
+    if (c == digits)
+    {
+        *endp = (char *)text;
+        return 0;
+    }
+    *endp = (char *)c;
+    if (overflow)
+    {
+        return negative ? LLONG_MIN : LLONG_MAX;
+    }
+    return negative ? (long long)(0 - v) : (long long)v;
+}
+
+
+/**
+ * @brief helper to read a signed integer, as strtol
+ */
+static inline
+long                     /** @return value read */
+xml_strtol
+    (const char *text    /**< [in] text to read */
+    ,char **endp         /**< [out] first character after the number */
+    ,int base            /**< [in] 0, 8, 10 or 16 */
+    )
+{
+    long long v = xml_strtoll(text, endp, base);
+
+    if (v > LONG_MAX) return LONG_MAX;
+    if (v < LONG_MIN) return LONG_MIN;
+    return (long)v;
+}
+
+
+/**
+ * @brief helper to read a floating point number, as strtod
+ *
+ * Decimal numbers with at most 19 significant digits and a small power
+ * of ten are computed directly: both the digits and the power of ten
+ * are exact doubles, so one multiplication or division gives the
+ * correctly rounded result.  Anything else (hex floats, infinities,
+ * very long or very large numbers) is passed to strtod.
+ */
+static inline
+double                   /** @return value read */
+xml_strtod
+    (const char *text    /**< [in] text to read */
+    ,char **endp         /**< [out] first character after the number */
+    )
+{
+    static const double powers[] =
+    {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+        1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+        1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const char *c = text;
+    unsigned long long mantissa = 0;
+    unsigned int num_digits = 0;
+    int exponent = 0;
+    int negative = 0;
+    double v;
+
+    while (isspace((unsigned char)*c))
+    {
+        ++c;
+    }
+    if (*c == '-' || *c == '+')
+    {
+        negative = *c++ == '-';
+    }
+    if (c[0] == '0' && (c[1] | 0x20) == 'x')
+    {
+        return strtod(text, endp);
+    }
+
+    while (*c >= '0' && *c <= '9')
+    {
+        if (mantissa || *c != '0')
+        {
+            if (num_digits == 19) return strtod(text, endp);
+            mantissa = mantissa * 10 + (*c - '0');
+            ++num_digits;
+        }
+        ++c;
+    }
+    if (*c == '.')
+    {
+        const char *point = c++;
+
+        while (*c >= '0' && *c <= '9')
+        {
+            if (mantissa || *c != '0')
+            {
+                if (num_digits == 19) return strtod(text, endp);
+                mantissa = mantissa * 10 + (*c - '0');
+                ++num_digits;
+            }
+            --exponent;
+            ++c;
+        }
+        if (c == point + 1 && (point == text || point[-1] < '0' || point[-1] > '9'))
+        {
+            /* no digits on either side of the point */
+            return strtod(text, endp);
+        }
+    }
+    else if (c == text || c[-1] < '0' || c[-1] > '9')
+    {
+        /* not a decimal number: let strtod decide (e.g. "inf") */
+        return strtod(text, endp);
+    }
+
+    if ((*c | 0x20) == 'e')
+    {
+        const char *e = c + 1;
+        int negexp = 0;
+        int x = 0;
+
+        if (*e == '-' || *e == '+')
+        {
+            negexp = *e++ == '-';
+        }
+        if (*e >= '0' && *e <= '9')
+        {
+            while (*e >= '0' && *e <= '9')
+            {
+                if (x < 10000) x = x * 10 + (*e - '0');
+                ++e;
+            }
+            exponent += negexp ? -x : x;
+            c = e;
+        }
+    }
+
+    if (mantissa > (1ull << 53) || exponent < -22 || exponent > 22)
+    {
+        return strtod(text, endp);
+    }
+    v = (double)mantissa;
+    v = exponent < 0 ? v / powers[-exponent] : v * powers[exponent];
+    *endp = (char *)c;
+    return negative ? -v : v;
+}
+
+
+#endif /* _PMD_XML_NUMBER_H_ */
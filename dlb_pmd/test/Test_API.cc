@@ -51,6 +51,7 @@
 #include "gtest/gtest.h"
 
 #include <math.h>
+#include <string.h>
 
 #if defined(_MSC_VER)
 #  include <intrin.h>
@@ -304,6 +305,7 @@ TEST(PMD_API_Constrained, signals)
     size_t sz;
     unsigned int i;
 
+    memset(&constraints, '\0', sizeof(constraints));
     constraints.max_elements            = DLB_PMD_MAX_AUDIO_ELEMENTS;
     constraints.max_presentation_names  = MAX_PRESENTATION_NAMES;
     constraints.max.num_signals         = DLB_PMD_MAX_SIGNALS;
@@ -339,6 +341,7 @@ TEST(PMD_API_Constrained, elements)
     size_t sz;
     unsigned int i;
 
+    memset(&constraints, '\0', sizeof(constraints));
     constraints.max_elements            = DLB_PMD_MAX_AUDIO_ELEMENTS;
     constraints.max_presentation_names  = MAX_PRESENTATION_NAMES;
     constraints.max.num_signals         = DLB_PMD_MAX_SIGNALS;
@@ -374,6 +377,7 @@ TEST(PMD_API_Constrained, beds)
     size_t sz;
     unsigned int i;
 
+    memset(&constraints, '\0', sizeof(constraints));
     constraints.max_elements            = DLB_PMD_MAX_AUDIO_ELEMENTS;
     constraints.max_presentation_names  = MAX_PRESENTATION_NAMES;
     constraints.max.num_signals         = DLB_PMD_MAX_SIGNALS;
@@ -409,6 +413,7 @@ TEST(PMD_API_Constrained, objects)
     size_t sz;
     unsigned int i;
 
+    memset(&constraints, '\0', sizeof(constraints));
     constraints.max_elements            = DLB_PMD_MAX_AUDIO_ELEMENTS;
     constraints.max_presentation_names  = MAX_PRESENTATION_NAMES;
     constraints.max.num_signals         = DLB_PMD_MAX_SIGNALS;
@@ -444,6 +449,7 @@ TEST(PMD_API_Constrained, presentations)
     size_t sz;
     unsigned int i;
 
+    memset(&constraints, '\0', sizeof(constraints));
     constraints.max_elements            = DLB_PMD_MAX_AUDIO_ELEMENTS;
     constraints.max_presentation_names  = MAX_PRESENTATION_NAMES;
     constraints.max.num_signals         = DLB_PMD_MAX_SIGNALS;
@@ -479,6 +485,7 @@ TEST(PMD_API_Constrained, updates)
     size_t sz;
     unsigned int i;
 
+    memset(&constraints, '\0', sizeof(constraints));
     constraints.max_elements            = DLB_PMD_MAX_AUDIO_ELEMENTS;
     constraints.max_presentation_names  = MAX_PRESENTATION_NAMES;
     constraints.max.num_signals         = DLB_PMD_MAX_SIGNALS;
@@ -514,6 +521,7 @@ TEST(PMD_API_Constrained, loudness)
     size_t sz;
     unsigned int i;
 
+    memset(&constraints, '\0', sizeof(constraints));
     constraints.max_elements            = DLB_PMD_MAX_AUDIO_ELEMENTS;
     constraints.max_presentation_names  = MAX_PRESENTATION_NAMES;
     constraints.max.num_signals         = DLB_PMD_MAX_SIGNALS;
@@ -549,6 +557,7 @@ TEST(PMD_API_Constrained, iat)
     size_t sz;
     unsigned int i;
 
+    memset(&constraints, '\0', sizeof(constraints));
     constraints.max_elements            = DLB_PMD_MAX_AUDIO_ELEMENTS;
     constraints.max_presentation_names  = MAX_PRESENTATION_NAMES;
     constraints.max.num_signals         = DLB_PMD_MAX_SIGNALS;
@@ -584,6 +593,7 @@ TEST(PMD_API_Constrained, eac3)
     size_t sz;
     unsigned int i;
 
+    memset(&constraints, '\0', sizeof(constraints));
     constraints.max_elements            = DLB_PMD_MAX_AUDIO_ELEMENTS;
     constraints.max_presentation_names  = MAX_PRESENTATION_NAMES;
     constraints.max.num_signals         = DLB_PMD_MAX_SIGNALS;
@@ -619,6 +629,7 @@ TEST(PMD_API_Constrained, etd)
     size_t sz;
     unsigned int i;
 
+    memset(&constraints, '\0', sizeof(constraints));
     constraints.max_elements            = DLB_PMD_MAX_AUDIO_ELEMENTS;
     constraints.max_presentation_names  = MAX_PRESENTATION_NAMES;
     constraints.max.num_signals         = DLB_PMD_MAX_SIGNALS;
@@ -654,6 +665,7 @@ TEST(PMD_API_Constrained, hed)
     size_t sz;
     unsigned int i;
 
+    memset(&constraints, '\0', sizeof(constraints));
     constraints.max_elements            = DLB_PMD_MAX_AUDIO_ELEMENTS;
     constraints.max_presentation_names  = MAX_PRESENTATION_NAMES;
     constraints.max.num_signals         = DLB_PMD_MAX_SIGNALS;
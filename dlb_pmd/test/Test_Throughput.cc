@@ -0,0 +1,333 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+/**
+ * @file Test_Throughput.cc
+ * @brief micro-benchmarks for the PCM and XML hot paths
+ *
+ * These tests report throughput rather than check behaviour: each one
+ * times a fixed amount of work and records the rate as a test property,
+ * so that changes to the inner loops can be compared run against run
+ * (run with --gtest_output=xml to keep the rates).
+ */
+
+extern "C"
+{
+#include "dlb_pmd_api.h"
+#include "dlb_pmd_generate.h"
+#include "dlb_pmd_pcm.h"
+#include "dlb_pmd_xml_string.h"
+#include "frontend/pcm_vsync_timer.h"
+}
+
+#include "TestModel.hh"
+#include "DlbPmdModelWrapper.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Uncomment the next line to remove the tests in this file from the run:
+//#define DISABLE_THROUGHPUT_TESTS
+
+#ifndef DISABLE_THROUGHPUT_TESTS
+namespace
+{
+    static const dlb_pmd_frame_rate AUGMENT_FRAME_RATE = DLB_PMD_FRAMERATE_2500;
+    static const size_t AUGMENT_BLOCK_SIZE = 256;   /* samples per call, as a typical audio callback */
+    static const size_t AUGMENT_FRAMES = 50;        /* two seconds at 25 fps */
+    static const size_t AUGMENT_FRAME_SIZE = 1920;
+    static const unsigned int XML_CORPUS_SIZE = 4;      /* generated models to parse */
+    static const unsigned int XML_PARSE_REPEATS = 2;    /* times to parse the corpus */
+    static const size_t XML_MAX_SIZE = 32 * 1024 * 1024;
+}
+
+
+static bool build_throughput_model(TestModel& m)
+{
+    dlb_pmd_presentation_id pres = m.new_presid();
+    dlb_pmd_element_id bed = m.new_elid();
+
+    return !(   dlb_pmd_set_title(m, "throughput")
+             || dlb_pmd_add_signals(m, 6)
+             || dlb_pmd_add_bed(m, bed, NULL, DLB_PMD_SPEAKER_CONFIG_5_1, 1, 0)
+             || dlb_pmd_add_presentation(m, pres, "eng", "TESTPREZ", "eng",
+                                         DLB_PMD_SPEAKER_CONFIG_5_1, 1, &bed));
+}
+
+
+/**
+ * @brief augment #pcm, a block at a time
+ */
+static void augment_throughput_buffer(dlb_pcmpmd_augmentor *aug, uint32_t *pcm,
+                                      size_t num_samples, unsigned int num_channels)
+{
+    vsync_timer vt;
+
+    vsync_timer_init(&vt, AUGMENT_FRAME_RATE, 0);
+    while (num_samples)
+    {
+        size_t n = num_samples < AUGMENT_BLOCK_SIZE ? num_samples : AUGMENT_BLOCK_SIZE;
+        dlb_pcmpmd_augment(aug, pcm, n, vsync_timer_add_samples(&vt, n));
+        pcm += n * num_channels;
+        num_samples -= n;
+    }
+}
+
+
+static void record_throughput(size_t num_samples, std::chrono::duration<double> elapsed)
+{
+    double rate = elapsed.count() > 0.0 ? num_samples / elapsed.count() : 0.0;
+
+    ::testing::Test::RecordProperty("samples_per_second", std::to_string((unsigned long long)rate));
+    ::testing::Test::RecordProperty("times_real_time", (int)(rate / 48000.0));
+}
+
+
+class AugmentThroughputTest: public ::testing::TestWithParam<std::tr1::tuple<int, bool, int, bool> > {};
+
+TEST_P(AugmentThroughputTest, augment)
+{
+    unsigned int num_channels = std::tr1::get<0>(GetParam());
+    bool ispair = std::tr1::get<1>(GetParam());
+    unsigned int depth = std::tr1::get<2>(GetParam());
+    bool sadm = std::tr1::get<3>(GetParam());
+    size_t num_samples = AUGMENT_FRAMES * AUGMENT_FRAME_SIZE;
+    TestModel m;
+
+    if (!build_throughput_model(m))
+    {
+        FAIL() << "Failed to build model: " << dlb_pmd_error(m);
+    }
+
+    dlb_pmd_model_combo *combo_model;
+    DlbAdm::DlbPmdModelWrapper wrapper(&combo_model, m, PMD_FALSE);
+    std::vector<char> mem(dlb_pcmpmd_augmentor_query_mem(sadm));
+    std::vector<uint32_t> pcm(num_samples * num_channels);
+    dlb_pcmpmd_augmentor *aug;
+    unsigned int start = ispair ? num_channels - 2 : num_channels - 1;    /* last pair or channel */
+
+    dlb_pcmpmd_augmentor_init4(&aug, combo_model, &mem[0], depth, AUGMENT_FRAME_RATE,
+                               DLB_PMD_KLV_UL_ST2109, PMD_TRUE, num_channels, num_channels,
+                               ispair, start, sadm, DLB_PCMPMD_SADM_COMPRESSION_DEFAULT,
+                               DLB_PCMPMD_SADM_STRATEGY_DEFAULT);
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    augment_throughput_buffer(aug, &pcm[0], num_samples, num_channels);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    dlb_pcmpmd_augmentor_finish(aug);
+    record_throughput(num_samples, elapsed);
+
+    /* the augmentor must at least have written the first sync word */
+    uint32_t *first = &pcm[start];
+    EXPECT_NE(0u, first[32 * num_channels]);
+}
+
+
+INSTANTIATE_TEST_CASE_P(PMD_Throughput, AugmentThroughputTest,
+           testing::Combine(testing::Values(16, 64, 128),
+                            testing::Bool(),
+                            testing::Values(20, 24),
+                            testing::Bool()));
+
+
+static void count_frames(void *arg)
+{
+    ++*static_cast<int *>(arg);
+}
+
+
+class ExtractThroughputTest: public ::testing::TestWithParam<std::tr1::tuple<int, bool, bool, bool> > {};
+
+TEST_P(ExtractThroughputTest, extract)
+{
+    unsigned int num_channels = std::tr1::get<0>(GetParam());
+    bool ispair = std::tr1::get<1>(GetParam());
+    bool sadm = std::tr1::get<2>(GetParam());
+    bool augmented = std::tr1::get<3>(GetParam());  /* false: search PCM that has no metadata */
+    size_t num_samples = AUGMENT_FRAMES * AUGMENT_FRAME_SIZE;
+    const unsigned int depth = 24;
+    TestModel m;
+
+    if (!build_throughput_model(m))
+    {
+        FAIL() << "Failed to build model: " << dlb_pmd_error(m);
+    }
+
+    dlb_pmd_model_combo *combo_model;
+    DlbAdm::DlbPmdModelWrapper wrapper(&combo_model, m, PMD_FALSE);
+    std::vector<char> augmem(dlb_pcmpmd_augmentor_query_mem(sadm));
+    std::vector<uint32_t> pcm(num_samples * num_channels);
+    dlb_pcmpmd_augmentor *aug;
+    unsigned int start = ispair ? num_channels - 2 : num_channels - 1;    /* last pair or channel */
+    uint32_t noise = 1;
+
+    /* the extractor has to look at every sample: give it something other than silence */
+    for (size_t i = 0; i != pcm.size(); ++i)
+    {
+        noise = noise * 1664525u + 1013904223u;
+        pcm[i] = noise & 0xffffff00u;
+    }
+    dlb_pcmpmd_augmentor_init4(&aug, combo_model, &augmem[0], depth, AUGMENT_FRAME_RATE,
+                               DLB_PMD_KLV_UL_ST2109, PMD_FALSE, num_channels, num_channels,
+                               ispair, start, sadm, DLB_PCMPMD_SADM_COMPRESSION_DEFAULT,
+                               DLB_PCMPMD_SADM_STRATEGY_DEFAULT);
+    if (augmented)
+    {
+        augment_throughput_buffer(aug, &pcm[0], num_samples, num_channels);
+    }
+    dlb_pcmpmd_augmentor_finish(aug);
+
+    dlb_pmd_model_combo *extracted;
+    std::vector<char> extmem(dlb_pcmpmd_extractor_query_mem(sadm));
+    dlb_pcmpmd_extractor *ext;
+    int frames = 0;
+
+    ASSERT_EQ(PMD_SUCCESS, dlb_pmd_model_combo_init(&extracted, NULL, NULL, PMD_FALSE, NULL));
+    dlb_pcmpmd_extractor_init3(&ext, &extmem[0], depth, AUGMENT_FRAME_RATE, start, num_channels,
+                               ispair, extracted, NULL, sadm);
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    uint32_t *channeldata = &pcm[0];
+    size_t remaining = num_samples;
+    while (remaining)
+    {
+        size_t n = remaining < AUGMENT_BLOCK_SIZE ? remaining : AUGMENT_BLOCK_SIZE;
+        dlb_pcmpmd_extract2(ext, channeldata, n, count_frames, &frames, NULL);
+        channeldata += n * num_channels;
+        remaining -= n;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    dlb_pcmpmd_extractor_finish(ext);
+    (void)dlb_pmd_model_combo_destroy(&extracted);
+    record_throughput(num_samples, elapsed);
+
+    if (augmented)
+    {
+        EXPECT_LT(0, frames);
+    }
+}
+
+
+INSTANTIATE_TEST_CASE_P(PMD_Throughput, ExtractThroughputTest,
+           testing::Combine(testing::Values(16, 64, 128),
+                            testing::Bool(),
+                            testing::Bool(),
+                            testing::Bool()));
+
+/**
+ * @brief write the PMD XML of a randomly generated model
+ */
+static bool generate_xml(dlb_pmd_model *model, unsigned int seed, unsigned int num_updates,
+                         std::vector<char>& xml)
+{
+    dlb_pmd_metadata_count counts;
+    size_t size = XML_MAX_SIZE;
+
+    memset(&counts, '\0', sizeof(counts));
+    counts.num_signals         = PMD_GENERATE_RANDOM_NUMBER;
+    counts.num_beds            = PMD_GENERATE_RANDOM_NUMBER;
+    counts.num_objects         = PMD_GENERATE_RANDOM_NUMBER;
+    counts.num_updates         = num_updates;
+    counts.num_presentations   = PMD_GENERATE_RANDOM_NUMBER;
+    counts.num_loudness        = PMD_GENERATE_RANDOM_NUMBER;
+    counts.num_iat             = PMD_GENERATE_RANDOM_NUMBER;
+    counts.num_eac3            = PMD_GENERATE_RANDOM_NUMBER;
+    counts.num_ed2_system      = PMD_GENERATE_RANDOM_NUMBER;
+    counts.num_ed2_turnarounds = PMD_GENERATE_RANDOM_NUMBER;
+    counts.num_headphone_desc  = PMD_GENERATE_RANDOM_NUMBER;
+
+    xml.resize(XML_MAX_SIZE);
+    dlb_pmd_reset(model);
+    if (   dlb_pmd_generate_random(model, &counts, seed, 1, 0)
+        || dlb_xmlpmd_string_write(model, &xml[0], &size))
+    {
+        return false;
+    }
+    xml.resize(size);
+    return true;
+}
+
+
+class XmlParseThroughputTest: public ::testing::TestWithParam<int> {};
+
+TEST_P(XmlParseThroughputTest, parse)
+{
+    unsigned int num_updates = GetParam();
+    std::vector<std::vector<char> > corpus(XML_CORPUS_SIZE);
+    dlb_pmd_model *src;
+    dlb_pmd_model *dest;
+    size_t bytes = 0;
+    unsigned int seed;
+
+    dlb_pmd_init(&src, NULL);
+    dlb_pmd_init(&dest, NULL);
+    for (seed = 0; seed != XML_CORPUS_SIZE; ++seed)
+    {
+        ASSERT_TRUE(generate_xml(src, seed + 1, num_updates, corpus[seed])) << dlb_pmd_error(src);
+        bytes += corpus[seed].size();
+    }
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i != XML_PARSE_REPEATS; ++i)
+    {
+        for (seed = 0; seed != XML_CORPUS_SIZE; ++seed)
+        {
+            dlb_pmd_reset(dest);
+            ASSERT_EQ(PMD_SUCCESS, dlb_xmlpmd_string_read(&corpus[seed][0], corpus[seed].size(),
+                                                          dest, 1, NULL, NULL, NULL))
+                << dlb_pmd_error(dest);
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    double rate = elapsed.count() > 0.0 ? XML_PARSE_REPEATS * bytes / elapsed.count() : 0.0;
+
+    RecordProperty("bytes_per_second", std::to_string((unsigned long long)rate));
+    RecordProperty("us_per_model", (int)(1e6 * elapsed.count() / (XML_PARSE_REPEATS * XML_CORPUS_SIZE)));
+
+    /* the last model parsed must be the last one generated */
+    EXPECT_EQ(PMD_SUCCESS, dlb_pmd_equal(dest, src, 0, 0));
+    dlb_pmd_finish(src);
+    dlb_pmd_finish(dest);
+}
+
+
+INSTANTIATE_TEST_CASE_P(PMD_Throughput, XmlParseThroughputTest,
+           testing::Values(0, 256, DLB_PMD_MAX_UPDATES));
+
+#endif /* DISABLE_THROUGHPUT_TESTS */
@@ -0,0 +1,217 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#define _SILENCE_TR1_NAMESPACE_DEPRECATION_WARNING
+
+#include "gtest/gtest.h"
+
+extern "C"
+{
+#include "dlb_octfile/include/dlb_octfile.h"
+}
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+/* dlb_octfile_open_mapped maps a whole file where it can, and otherwise
+ * opens it through stdio; dlb_octfile_borrow hands out views of mapped
+ * data.  A mapping must behave like stdio at the end of the file.
+ */
+class DlbOctfile01 : public testing::Test
+{
+protected:
+    static const size_t FILE_SIZE = 1000;
+
+    std::vector<unsigned char> mContents;
+    dlb_octfile mFile;
+    dlb_octfile *mOpen;
+
+    virtual void SetUp()
+    {
+        mContents.resize(FILE_SIZE);
+        for (size_t i = 0; i < FILE_SIZE; i++)
+        {
+            mContents[i] = static_cast<unsigned char>(i * 7 + 3);
+        }
+        WriteFile("dlb_octfile_01.bin", &mContents[0], FILE_SIZE);
+        WriteFile("dlb_octfile_01_empty.bin", nullptr, 0);
+        mOpen = nullptr;
+    }
+
+    virtual void TearDown()
+    {
+        if (mOpen != nullptr)
+        {
+            (void)dlb_octfile_close(mOpen);
+        }
+        remove("dlb_octfile_01.bin");
+        remove("dlb_octfile_01_empty.bin");
+    }
+
+    static void WriteFile(const char *name, const unsigned char *data, size_t size)
+    {
+        FILE *f = fopen(name, "wb");
+
+        ASSERT_NE(nullptr, f);
+        if (size > 0)
+        {
+            ASSERT_EQ(size, fwrite(data, 1, size, f));
+        }
+        ASSERT_EQ(0, fclose(f));
+    }
+};
+
+
+TEST_F(DlbOctfile01, MappedReadsLikeStdio)
+{
+    unsigned char buffer[FILE_SIZE];
+
+    mOpen = dlb_octfile_open_mapped(&mFile, "dlb_octfile_01.bin", "rb");
+    ASSERT_NE(nullptr, mOpen);
+    EXPECT_EQ(nullptr, mFile.file);
+    ASSERT_NE(nullptr, dlb_octfile_get_memory(mOpen));
+
+    ASSERT_EQ(sizeof(buffer), dlb_octfile_read(buffer, 1, sizeof(buffer), mOpen));
+    EXPECT_EQ(0, memcmp(buffer, &mContents[0], FILE_SIZE));
+    EXPECT_EQ(static_cast<long>(FILE_SIZE), dlb_octfile_tell(mOpen));
+}
+
+TEST_F(DlbOctfile01, MappedReadAtEof)
+{
+    unsigned char buffer[FILE_SIZE];
+
+    mOpen = dlb_octfile_open_mapped(&mFile, "dlb_octfile_01.bin", "rb");
+    ASSERT_NE(nullptr, mOpen);
+    ASSERT_NE(nullptr, dlb_octfile_get_memory(mOpen));
+
+    // a read that runs into the end returns what there is...
+    ASSERT_EQ(0, dlb_octfile_seek(mOpen, FILE_SIZE - 10, DLB_OCTFILE_SEEK_SET));
+    EXPECT_EQ(10u, dlb_octfile_read(buffer, 1, sizeof(buffer), mOpen));
+    EXPECT_EQ(0, memcmp(buffer, &mContents[FILE_SIZE - 10], 10));
+
+    // ...and a read at the end returns nothing and sets EOF
+    EXPECT_EQ(0u, dlb_octfile_read(buffer, 1, 1, mOpen));
+    EXPECT_NE(0, dlb_octfile_eof(mOpen));
+
+    // like fseek(), seeking past the end is allowed, and reads nothing
+    ASSERT_EQ(0, dlb_octfile_seek(mOpen, FILE_SIZE + 100, DLB_OCTFILE_SEEK_SET));
+    EXPECT_EQ(0, dlb_octfile_eof(mOpen));
+    EXPECT_EQ(0u, dlb_octfile_read(buffer, 1, 1, mOpen));
+    EXPECT_NE(0, dlb_octfile_eof(mOpen));
+
+    // seeking back clears EOF
+    ASSERT_EQ(0, dlb_octfile_seek(mOpen, 5, DLB_OCTFILE_SEEK_SET));
+    EXPECT_EQ(0, dlb_octfile_eof(mOpen));
+    ASSERT_EQ(1u, dlb_octfile_read(buffer, 1, 1, mOpen));
+    EXPECT_EQ(mContents[5], buffer[0]);
+}
+
+TEST_F(DlbOctfile01, BorrowAcrossEndOfMapping)
+{
+    const unsigned char *view;
+    size_t avail;
+
+    mOpen = dlb_octfile_open_mapped(&mFile, "dlb_octfile_01.bin", "rb");
+    ASSERT_NE(nullptr, mOpen);
+    ASSERT_NE(nullptr, dlb_octfile_get_memory(mOpen));
+
+    // a view within the mapping is the data itself
+    view = static_cast<const unsigned char *>(dlb_octfile_borrow(mOpen, 100, &avail));
+    ASSERT_NE(nullptr, view);
+    EXPECT_EQ(100u, avail);
+    EXPECT_EQ(0, memcmp(view, &mContents[0], 100));
+    EXPECT_EQ(100, dlb_octfile_tell(mOpen));
+
+    // a view that would cross the end is cut short at the end
+    ASSERT_EQ(0, dlb_octfile_seek(mOpen, FILE_SIZE - 30, DLB_OCTFILE_SEEK_SET));
+    view = static_cast<const unsigned char *>(dlb_octfile_borrow(mOpen, 500, &avail));
+    ASSERT_NE(nullptr, view);
+    EXPECT_EQ(30u, avail);
+    EXPECT_EQ(0, memcmp(view, &mContents[FILE_SIZE - 30], 30));
+    EXPECT_EQ(static_cast<long>(FILE_SIZE), dlb_octfile_tell(mOpen));
+    EXPECT_NE(0, dlb_octfile_eof(mOpen));
+
+    // at, and past, the end there is nothing to view
+    avail = 1;
+    EXPECT_EQ(nullptr, dlb_octfile_borrow(mOpen, 1, &avail));
+    EXPECT_EQ(0u, avail);
+    ASSERT_EQ(0, dlb_octfile_seek(mOpen, FILE_SIZE + 100, DLB_OCTFILE_SEEK_SET));
+    avail = 1;
+    EXPECT_EQ(nullptr, dlb_octfile_borrow(mOpen, 1, &avail));
+    EXPECT_EQ(0u, avail);
+    EXPECT_NE(0, dlb_octfile_eof(mOpen));
+}
+
+TEST_F(DlbOctfile01, WritableModeFallsBackToStdio)
+{
+    unsigned char buffer[FILE_SIZE];
+    size_t avail = 1;
+
+    mOpen = dlb_octfile_open_mapped(&mFile, "dlb_octfile_01.bin", "rb+");
+    ASSERT_NE(nullptr, mOpen);
+    EXPECT_NE(nullptr, mFile.file);
+    EXPECT_EQ(nullptr, dlb_octfile_get_memory(mOpen));
+
+    // stdio files lend nothing, but read as usual
+    EXPECT_EQ(nullptr, dlb_octfile_borrow(mOpen, 10, &avail));
+    EXPECT_EQ(0u, avail);
+    ASSERT_EQ(sizeof(buffer), dlb_octfile_read(buffer, 1, sizeof(buffer), mOpen));
+    EXPECT_EQ(0, memcmp(buffer, &mContents[0], FILE_SIZE));
+    EXPECT_EQ(0u, dlb_octfile_read(buffer, 1, 1, mOpen));
+    EXPECT_NE(0, dlb_octfile_eof(mOpen));
+}
+
+TEST_F(DlbOctfile01, EmptyFileFallsBackToStdio)
+{
+    unsigned char buffer[1];
+    size_t avail = 1;
+
+    mOpen = dlb_octfile_open_mapped(&mFile, "dlb_octfile_01_empty.bin", "rb");
+    ASSERT_NE(nullptr, mOpen);
+    EXPECT_NE(nullptr, mFile.file);
+    EXPECT_EQ(nullptr, dlb_octfile_get_memory(mOpen));
+
+    EXPECT_EQ(nullptr, dlb_octfile_borrow(mOpen, 1, &avail));
+    EXPECT_EQ(0u, avail);
+    EXPECT_EQ(0u, dlb_octfile_read(buffer, 1, 1, mOpen));
+    EXPECT_NE(0, dlb_octfile_eof(mOpen));
+}
+
+TEST_F(DlbOctfile01, MissingFileFailsToOpen)
+{
+    EXPECT_EQ(nullptr, dlb_octfile_open_mapped(&mFile, "dlb_octfile_01_missing.bin", "rb"));
+}
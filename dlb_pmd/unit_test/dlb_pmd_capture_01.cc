@@ -40,8 +40,12 @@
 
 #include "dlb_pmd/include/dlb_pmd_capture.h"
 #include "dlb_pmd/include/dlb_pmd_pcm.h"
+#include "dlb_pmd/include/dlb_pmd_api.h"
+#include "dlb_pmd/include/dlb_pmd_model_combo.h"
 
+#include <stdio.h>
 #include <string.h>
+#include <vector>
 
 class DlbPmdCapture01 : public testing::Test
 {
@@ -118,6 +122,130 @@ protected:
         }
     }
 
+
+    static unsigned int FrameObjectCount(size_t frame)
+    {
+        return 2 + (unsigned int)(frame / 2);
+    }
+
+    /* build the model for one frame: the title and presentation name the
+     * frame, and the number of objects grows every other frame */
+    static dlb_pmd_success BuildFrameModel(dlb_pmd_model *model, size_t frame)
+    {
+        dlb_pmd_element_id elements[1 + 8];     // up to FrameObjectCount(13)
+        unsigned int object_count = FrameObjectCount(frame);
+        unsigned int i;
+        char title[32];
+        char name[32];
+        dlb_pmd_success success;
+
+        dlb_pmd_reset(model);
+        snprintf(title, sizeof(title), "frame %u", (unsigned int)frame);
+        elements[0] = 1;
+        success = dlb_pmd_set_title(model, title)
+               || dlb_pmd_add_signals(model, 16)
+               || dlb_pmd_add_bed(model, elements[0], "bed", DLB_PMD_SPEAKER_CONFIG_5_1, 1, 0);
+        for (i = 0; i < object_count && !success; i++)
+        {
+            elements[1 + i] = (dlb_pmd_element_id)(2 + i);
+            snprintf(name, sizeof(name), "object %u of frame %u", i, (unsigned int)frame);
+            success = dlb_pmd_add_generic_obj2(model, elements[1 + i], name, 7 + i, 0.1f * i, 0.5f, 0.0f);
+        }
+        return success
+            || dlb_pmd_add_presentation(model, 1, "eng", title, "eng", DLB_PMD_SPEAKER_CONFIG_5_1,
+                                        1 + object_count, elements);
+    }
+
+    /* Write a stream whose model changes every frame, and feed it to the
+     * captor in blobs shorter than a frame.  Every metadata set returned
+     * must describe one whole frame, no older than the last frame that
+     * could be decoded before the blob ended.
+     */
+    void StreamChangingModel(bool sadm)
+    {
+        static const unsigned int CHANNEL_COUNT = 16;
+        static const unsigned int PMD_PAIR = 14;
+        static const size_t FRAME_SIZE = 1920;          // 25 fps
+        static const size_t FRAME_COUNT = 12;
+        static const size_t STREAM_START = 700;         // deliberately not on a frame boundary
+        static const size_t LOCK_BLOB_SIZE = 2 * FRAME_SIZE + 200;
+        static const size_t STREAM_BLOB_SIZE = 333;
+
+        dlb_pmd_model *model = nullptr;
+        dlb_pmd_model_combo *combo = nullptr;
+        dlb_pmd_model *writable;
+
+        dlb_pmd_init(&model, nullptr);
+        ASSERT_NE(nullptr, model);
+        ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), dlb_pmd_model_combo_init(&combo, model, nullptr, PMD_FALSE, nullptr));
+
+        std::vector<uint32_t> pcm(FRAME_COUNT * FRAME_SIZE * CHANNEL_COUNT, 0);
+        std::vector<char> augmentorMemory(dlb_pcmpmd_augmentor_query_mem(sadm));
+        dlb_pcmpmd_augmentor *aug = nullptr;
+        size_t frame;
+
+        dlb_pcmpmd_augmentor_init2(&aug, combo, &augmentorMemory[0], DLB_PMD_FRAMERATE_2500, DLB_PMD_KLV_UL_ST2109,
+                                   PMD_FALSE, CHANNEL_COUNT, CHANNEL_COUNT, PMD_TRUE, PMD_PAIR, sadm);
+        for (frame = 0; frame < FRAME_COUNT; frame++)
+        {
+            ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), dlb_pmd_model_combo_get_writable_pmd_model(combo, &writable, PMD_TRUE));
+            ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), BuildFrameModel(writable, frame));
+            dlb_pcmpmd_augment(aug, &pcm[frame * FRAME_SIZE * CHANNEL_COUNT], FRAME_SIZE, 0);
+        }
+        dlb_pcmpmd_augmentor_finish(aug);
+
+        int status = OpenFrameCaptor();
+        ASSERT_EQ(DLB_PMD_FRAME_CAPTOR_STATUS_OK, status);
+
+        dlb_pmd_blob_descriptor descr;
+        size_t sample = STREAM_START;
+        size_t latest = 0;
+        // an S-ADM burst finishes early in the following frame, so S-ADM
+        // metadata is available one frame later than PMD
+        size_t lag = sadm ? 2 : 1;
+
+        ::memset(&descr, 0, sizeof(descr));
+        descr.number_of_channels = CHANNEL_COUNT;
+        descr.bit_depth = 32;
+        while (sample + STREAM_BLOB_SIZE <= pcm.size() / CHANNEL_COUNT)
+        {
+            dlb_pmd_metadata_set *pmds = nullptr;
+            size_t end;
+            unsigned int got;
+
+            descr.number_of_samples = static_cast<uint16_t>(sample == STREAM_START ? LOCK_BLOB_SIZE : STREAM_BLOB_SIZE);
+            end = sample + descr.number_of_samples;
+            status = dlb_pmd_frame_captor_stream(&pmds, theCaptor, &descr, &pcm[sample * CHANNEL_COUNT]);
+            ASSERT_EQ(DLB_PMD_FRAME_CAPTOR_STATUS_OK, status) << "at sample " << sample;
+            ASSERT_NE(nullptr, pmds);
+
+            // a whole frame (S-ADM replaces the title, so there the frame
+            // is named by the presentation)...
+            ASSERT_EQ(1u, pmds->count.num_presentations) << "at sample " << sample;
+            if (sadm)
+            {
+                ASSERT_LE(1u, pmds->presentations[0].num_names) << "at sample " << sample;
+                ASSERT_EQ(1, sscanf(pmds->presentations[0].names[0].text, "frame %u", &got)) << "at sample " << sample;
+            }
+            else
+            {
+                ASSERT_EQ(1, sscanf(pmds->title, "frame %u", &got)) << "at sample " << sample;
+            }
+            EXPECT_EQ(FrameObjectCount(got), pmds->count.num_objects) << "frame " << got << " at sample " << sample;
+            EXPECT_EQ(1u, pmds->count.num_beds) << "frame " << got << " at sample " << sample;
+
+            // ...that is up to date, and never goes back
+            EXPECT_LT(got, end / FRAME_SIZE + 1) << "at sample " << sample;
+            EXPECT_GE(got + lag, end / FRAME_SIZE) << "at sample " << sample;
+            EXPECT_GE(got, latest) << "at sample " << sample;
+            latest = got;
+            sample = end;
+        }
+        EXPECT_EQ(FRAME_COUNT - lag, latest);
+
+        (void)dlb_pmd_model_combo_destroy(&combo);
+        dlb_pmd_finish(model);
+    }
 };
 
 TEST(pmd_capture_test, QueryMem)
@@ -203,3 +331,138 @@ TEST_F(DlbPmdCapture01, CaptureBadArgs)
     status = dlb_pmd_frame_captor_capture(&metadata_set, theCaptor, &descriptor, buffer);
     EXPECT_EQ(DLB_PMD_FRAME_CAPTOR_STATUS_ERROR, status);
 }
+
+TEST_F(DlbPmdCapture01, StreamBadArgs)
+{
+    dlb_pmd_metadata_set *metadata_set = nullptr;
+    dlb_pmd_blob_descriptor descriptor;
+    char buffer[128];
+    int status;
+
+    status = dlb_pmd_frame_captor_open(&theCaptor, nullptr);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), status);
+    ::memset(&descriptor, 0, sizeof(descriptor));
+
+    status = dlb_pmd_frame_captor_stream(nullptr, nullptr, nullptr, nullptr);
+    EXPECT_EQ(DLB_PMD_FRAME_CAPTOR_STATUS_NULL_POINTER, status);
+    status = dlb_pmd_frame_captor_stream(&metadata_set, nullptr, nullptr, nullptr);
+    EXPECT_EQ(DLB_PMD_FRAME_CAPTOR_STATUS_NULL_POINTER, status);
+    status = dlb_pmd_frame_captor_stream(&metadata_set, theCaptor, &theBlobDescriptor, nullptr);
+    EXPECT_EQ(DLB_PMD_FRAME_CAPTOR_STATUS_NULL_POINTER, status);
+    status = dlb_pmd_frame_captor_stream(&metadata_set, theCaptor, &descriptor, buffer);
+    EXPECT_EQ(DLB_PMD_FRAME_CAPTOR_STATUS_ERROR, status);
+
+    descriptor = theBlobDescriptor;
+    descriptor.bit_depth = 99;
+    status = dlb_pmd_frame_captor_stream(&metadata_set, theCaptor, &descriptor, buffer);
+    EXPECT_EQ(DLB_PMD_FRAME_CAPTOR_STATUS_ERROR, status);
+}
+
+TEST_F(DlbPmdCapture01, StreamLockAndResync)
+{
+    static const unsigned int CHANNEL_COUNT = 8;
+    static const unsigned int PMD_PAIR = 2;
+    static const size_t FRAME_SIZE = 1920;          // 25 fps
+    static const size_t FRAME_COUNT = 16;
+    static const size_t SILENT_FRAMES = 4;
+    static const size_t STREAM_START = 700;         // deliberately not on a frame boundary
+    static const size_t LOCK_BLOB_SIZE = 2 * FRAME_SIZE + 200;
+    static const size_t STREAM_BLOB_SIZE = 1000;    // blobs shorter than a frame are fine once locked
+
+    dlb_pmd_model *model = nullptr;
+    dlb_pmd_model_combo *combo = nullptr;
+    dlb_pmd_element_id bed = 1;
+    dlb_pmd_success success;
+
+    dlb_pmd_init(&model, nullptr);
+    ASSERT_NE(nullptr, model);
+    success = dlb_pmd_set_title(model, "stream")
+           || dlb_pmd_add_signals(model, 6)
+           || dlb_pmd_add_bed(model, bed, nullptr, DLB_PMD_SPEAKER_CONFIG_5_1, 1, 0)
+           || dlb_pmd_add_presentation(model, 1, "eng", "TESTPREZ", "eng", DLB_PMD_SPEAKER_CONFIG_5_1, 1, &bed);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), dlb_pmd_model_combo_init(&combo, model, nullptr, PMD_FALSE, nullptr));
+
+    // Noise on every channel, PMD on one pair, then silence on the PMD pair, then PMD again
+    std::vector<uint32_t> pcm(FRAME_COUNT * FRAME_SIZE * CHANNEL_COUNT);
+    std::vector<char> augmentorMemory(dlb_pcmpmd_augmentor_query_mem(PMD_FALSE));
+    dlb_pcmpmd_augmentor *aug = nullptr;
+    uint32_t noise = 0x12345678;
+    size_t frame;
+    size_t i;
+
+    for (i = 0; i < pcm.size(); i++)
+    {
+        noise = noise * 1664525u + 1013904223u;
+        pcm[i] = noise & 0x0fffff00;    // keep the noise well away from the sync words
+    }
+    dlb_pcmpmd_augmentor_init(&aug, combo, &augmentorMemory[0], DLB_PMD_FRAMERATE_2500, DLB_PMD_KLV_UL_ST2109,
+                              PMD_FALSE, CHANNEL_COUNT, CHANNEL_COUNT, PMD_TRUE, PMD_PAIR);
+    for (frame = 0; frame < FRAME_COUNT; frame++)
+    {
+        dlb_pcmpmd_augment(aug, &pcm[frame * FRAME_SIZE * CHANNEL_COUNT], FRAME_SIZE, 0);
+    }
+    dlb_pcmpmd_augmentor_finish(aug);
+    for (frame = FRAME_COUNT / 2; frame < FRAME_COUNT / 2 + SILENT_FRAMES; frame++)
+    {
+        for (i = frame * FRAME_SIZE; i < (frame + 1) * FRAME_SIZE; i++)
+        {
+            pcm[i * CHANNEL_COUNT + PMD_PAIR] = 0;
+            pcm[i * CHANNEL_COUNT + PMD_PAIR + 1] = 0;
+        }
+    }
+
+    int status = OpenFrameCaptor();
+    ASSERT_EQ(DLB_PMD_FRAME_CAPTOR_STATUS_OK, status);
+
+    dlb_pmd_blob_descriptor descr;
+    size_t sample = STREAM_START;
+    size_t silence_start = (FRAME_COUNT / 2) * FRAME_SIZE;
+    size_t silence_end = silence_start + SILENT_FRAMES * FRAME_SIZE;
+    bool lost = false;
+    bool resynced = false;
+
+    ::memset(&descr, 0, sizeof(descr));
+    descr.number_of_channels = CHANNEL_COUNT;
+    descr.bit_depth = 32;
+    while (sample + LOCK_BLOB_SIZE <= pcm.size() / CHANNEL_COUNT)
+    {
+        dlb_pmd_metadata_set *pmds = nullptr;
+        bool locking = (sample == STREAM_START) || (lost && sample >= silence_end);
+
+        descr.number_of_samples = static_cast<uint16_t>(locking ? LOCK_BLOB_SIZE : STREAM_BLOB_SIZE);
+        status = dlb_pmd_frame_captor_stream(&pmds, theCaptor, &descr, &pcm[sample * CHANNEL_COUNT]);
+        if (sample + descr.number_of_samples <= silence_start || locking)
+        {
+            ASSERT_EQ(DLB_PMD_FRAME_CAPTOR_STATUS_OK, status) << "at sample " << sample;
+            ASSERT_NE(nullptr, pmds);
+            EXPECT_STREQ("stream", pmds->title);
+            EXPECT_EQ(1u, pmds->count.num_beds);
+            EXPECT_EQ(1u, pmds->count.num_presentations);
+            resynced = resynced || lost;
+            lost = false;
+        }
+        else if (status != DLB_PMD_FRAME_CAPTOR_STATUS_OK)
+        {
+            // the stream may only be declared lost two frame periods after the last frame start
+            EXPECT_LT(silence_start + FRAME_SIZE, sample + descr.number_of_samples) << "at sample " << sample;
+            lost = true;
+        }
+        sample += descr.number_of_samples;
+    }
+    EXPECT_TRUE(resynced);
+    EXPECT_FALSE(lost);
+
+    (void)dlb_pmd_model_combo_destroy(&combo);
+    dlb_pmd_finish(model);
+}
+
+TEST_F(DlbPmdCapture01, StreamFollowsChangingModel)
+{
+    StreamChangingModel(false);
+}
+
+TEST_F(DlbPmdCapture01, StreamFollowsChangingSadmModel)
+{
+    StreamChangingModel(true);
+}
@@ -0,0 +1,131 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#define _SILENCE_TR1_NAMESPACE_DEPRECATION_WARNING
+
+#include "gtest/gtest.h"
+
+#include "dlb_pmd/include/dlb_pmd_api.h"
+#include "random_model.h"
+
+#include <string.h>
+
+class DlbPmdCopy01 : public testing::Test
+{
+protected:
+    dlb_pmd_model *mSrc;
+    dlb_pmd_model *mDest;
+
+    virtual void SetUp()
+    {
+        mSrc = NULL;
+        mDest = NULL;
+        dlb_pmd_init(&mSrc, NULL);
+        dlb_pmd_init(&mDest, NULL);
+    }
+
+    virtual void TearDown()
+    {
+        dlb_pmd_finish(mSrc);
+        dlb_pmd_finish(mDest);
+    }
+};
+
+TEST_F(DlbPmdCopy01, CopyOverPopulatedModel)
+{
+    unsigned int seed;
+
+    for (seed = 1; seed != 33; ++seed)
+    {
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, GenerateRandomModel(mSrc, seed));
+        EXPECT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_copy(mDest, mSrc)) << "seed " << seed;
+        EXPECT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_equal(mDest, mSrc, 0, 0)) << "seed " << seed;
+    }
+}
+
+TEST_F(DlbPmdCopy01, CopyEmptyModelForgetsEntities)
+{
+    dlb_pmd_metadata_count counts;
+    dlb_pmd_object object;
+    dlb_pmd_bed bed;
+    dlb_pmd_element_id id;
+
+    ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, GenerateRandomModel(mSrc, 7));
+    ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_copy(mDest, mSrc));
+
+    dlb_pmd_reset(mSrc);
+    ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_copy(mDest, mSrc));
+    EXPECT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_equal(mDest, mSrc, 0, 0));
+
+    ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_count_entities(mDest, &counts));
+    EXPECT_EQ(0u, counts.num_objects);
+    EXPECT_EQ(0u, counts.num_beds);
+    EXPECT_EQ(0u, counts.num_presentations);
+    for (id = 1; id != DLB_PMD_MAX_AUDIO_ELEMENTS; ++id)
+    {
+        EXPECT_NE((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_object_lookup(mDest, id, &object));
+        EXPECT_NE((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_bed_lookup(mDest, id, &bed, 0, NULL));
+    }
+}
+
+TEST_F(DlbPmdCopy01, CopyBetweenDifferentLimits)
+{
+    dlb_pmd_model_constraints limits;
+    dlb_pmd_model *small = NULL;
+    unsigned int seed;
+
+    dlb_pmd_max_constraints(&limits, PMD_FALSE);
+    limits.max.num_presentations = 16;
+    limits.max.num_loudness = 16;
+    limits.max_presentation_names = 64;
+    dlb_pmd_init_constrained(&small, &limits, NULL);
+    ASSERT_NE(nullptr, small);
+
+    for (seed = 1; seed != 9; ++seed)
+    {
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, GenerateRandomModel(small, seed));
+        EXPECT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_copy(mDest, small)) << "seed " << seed;
+        EXPECT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_equal(mDest, small, 0, 0)) << "seed " << seed;
+
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, GenerateRandomModel(mSrc, seed + 100));
+        EXPECT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_copy(mDest, mSrc)) << "seed " << seed;
+        EXPECT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_equal(mDest, mSrc, 0, 0)) << "seed " << seed;
+    }
+
+    /* the small model has no room for the large model's name pool */
+    EXPECT_NE((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_copy(small, mSrc));
+    dlb_pmd_finish(small);
+}
@@ -0,0 +1,223 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#define _SILENCE_TR1_NAMESPACE_DEPRECATION_WARNING
+
+#include "gtest/gtest.h"
+
+#include "dlb_pmd/include/dlb_pmd_api.h"
+#include "dlb_pmd/include/dlb_pmd_klv.h"
+#include "pmd_idmap.h"
+#include "random_model.h"
+
+#include <string.h>
+#include <vector>
+
+class DlbPmdIdmap01 : public testing::Test
+{
+protected:
+    static const size_t KLV_BUFFER_SIZE = 1 << 20;
+
+    dlb_pmd_model *mDense;
+    dlb_pmd_model *mCompact;
+    dlb_pmd_model_constraints mLimits;
+
+    virtual void SetUp()
+    {
+        mDense = NULL;
+        mCompact = NULL;
+        dlb_pmd_max_constraints(&mLimits, PMD_FALSE);
+        dlb_pmd_init_constrained(&mDense, &mLimits, NULL);
+        dlb_pmd_init_constrained2(&mCompact, &mLimits, PMD_TRUE, NULL);
+    }
+
+    virtual void TearDown()
+    {
+        dlb_pmd_finish(mDense);
+        dlb_pmd_finish(mCompact);
+    }
+
+    static std::vector<unsigned int> ObjectIds(const dlb_pmd_model *m)
+    {
+        std::vector<unsigned int> ids;
+        dlb_pmd_object_iterator it;
+        dlb_pmd_object object;
+
+        dlb_pmd_object_iterator_init(&it, m);
+        while (!dlb_pmd_object_iterator_next(&it, &object))
+        {
+            ids.push_back(object.id);
+        }
+        return ids;
+    }
+
+    static std::vector<unsigned int> PresentationIds(const dlb_pmd_model *m)
+    {
+        std::vector<unsigned int> ids;
+        dlb_pmd_presentation_iterator it;
+        dlb_pmd_presentation pres;
+        dlb_pmd_element_id elements[DLB_PMD_MAX_AUDIO_ELEMENTS];
+
+        dlb_pmd_presentation_iterator_init(&it, m);
+        while (!dlb_pmd_presentation_iterator_next(&it, &pres, DLB_PMD_MAX_AUDIO_ELEMENTS, elements))
+        {
+            ids.push_back(pres.id);
+        }
+        return ids;
+    }
+};
+
+TEST_F(DlbPmdIdmap01, CompactModelIsSmaller)
+{
+    dlb_pmd_model_constraints limits;
+    size_t dense;
+    size_t compact;
+
+    dlb_pmd_max_constraints(&limits, PMD_FALSE);
+    limits.max_elements = 20;
+    limits.max.num_beds = 4;
+    limits.max.num_objects = 16;
+    limits.max.num_presentations = 8;
+    limits.max.num_loudness = 8;
+    limits.max.num_eac3 = 8;
+    limits.max.num_ed2_turnarounds = 8;
+    limits.max_presentation_names = 64;
+
+    dense = dlb_pmd_query_mem_constrained(&limits);
+    compact = dlb_pmd_query_mem_constrained2(&limits, PMD_TRUE);
+
+    /* five dense maps of 4096 16-bit entries give way to a few dozen entries */
+    EXPECT_GE(dense - compact, 5u * 4096u * 2u - 1024u);
+    EXPECT_EQ(dense, dlb_pmd_query_mem_constrained2(&limits, PMD_FALSE));
+}
+
+TEST_F(DlbPmdIdmap01, FullCompactMapRefusesNewIds)
+{
+    pmd_idmap_entry entries[2];
+    pmd_idmap map;
+    uint16_t idx;
+
+    pmd_idmap_attach(&map, entries, PMD_TRUE, 2);
+    pmd_idmap_init(&map);
+    EXPECT_TRUE(pmd_idmap_insert(&map, 7, 0));
+    EXPECT_TRUE(pmd_idmap_insert(&map, 3, 1));
+    EXPECT_FALSE(pmd_idmap_insert(&map, 5, 2));
+    EXPECT_FALSE(pmd_idmap_lookup(&map, 5, &idx));
+
+    /* remapping an id that is already there still works */
+    EXPECT_TRUE(pmd_idmap_insert(&map, 7, 2));
+    ASSERT_TRUE(pmd_idmap_lookup(&map, 7, &idx));
+    EXPECT_EQ(2u, idx);
+}
+
+TEST_F(DlbPmdIdmap01, CompactMatchesDense)
+{
+    unsigned int seed;
+
+    for (seed = 1; seed != 33; ++seed)
+    {
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, GenerateRandomModel(mDense, seed));
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, GenerateRandomModel(mCompact, seed));
+        EXPECT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_equal(mDense, mCompact, 0, 0)) << "seed " << seed;
+        EXPECT_EQ(ObjectIds(mDense), ObjectIds(mCompact)) << "seed " << seed;
+        EXPECT_EQ(PresentationIds(mDense), PresentationIds(mCompact)) << "seed " << seed;
+    }
+}
+
+TEST_F(DlbPmdIdmap01, CompactKlvRoundTrip)
+{
+    std::vector<uint8_t> klv(KLV_BUFFER_SIZE);
+    dlb_pmd_model *decodedDense = NULL;
+    dlb_pmd_model *decodedCompact = NULL;
+    unsigned int decoded = 0;
+    unsigned int seed;
+    int denseRes;
+    int compactRes;
+    int size;
+
+    dlb_pmd_init_constrained2(&decodedCompact, &mLimits, PMD_TRUE, NULL);
+    dlb_pmd_init_constrained(&decodedDense, &mLimits, NULL);
+    ASSERT_NE(nullptr, decodedDense);
+    ASSERT_NE(nullptr, decodedCompact);
+
+    /* randomly generated loudness does not always survive KLV, and
+     * is beside the point here.  Decoded presentations do not compare
+     * equal even between two decodes of the same payload, so they are
+     * checked by id only.  Each payload is unrelated to the last, so
+     * start every decode from an empty model.
+     */
+    for (seed = 1; seed != 33; ++seed)
+    {
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, GenerateRandomModel(mCompact, seed, false));
+        size = dlb_klvpmd_write_all(mCompact, DLB_PMD_NO_ED2_STREAM_INDEX, &klv[0], klv.size(), DLB_PMD_KLV_UL_DOLBY);
+        ASSERT_LT(0, size) << "seed " << seed;
+        dlb_pmd_reset(decodedDense);
+        dlb_pmd_reset(decodedCompact);
+        denseRes = dlb_klvpmd_read_payload(&klv[0], size, decodedDense, 1, NULL, NULL);
+        compactRes = dlb_klvpmd_read_payload(&klv[0], size, decodedCompact, 1, NULL, NULL);
+        EXPECT_EQ(denseRes, compactRes) << "seed " << seed;
+        if (!denseRes && !compactRes)
+        {
+            EXPECT_EQ((dlb_pmd_success)PMD_SUCCESS,
+                      dlb_pmd_equal3(decodedDense, decodedCompact, 0, ~(uint32_t)PMD_EQUAL_MASK_PRESENTATIONS))
+                << "seed " << seed;
+            EXPECT_EQ(ObjectIds(decodedDense), ObjectIds(decodedCompact)) << "seed " << seed;
+            EXPECT_EQ(PresentationIds(decodedDense), PresentationIds(decodedCompact)) << "seed " << seed;
+            ++decoded;
+        }
+    }
+    EXPECT_LT(0u, decoded);
+    dlb_pmd_finish(decodedDense);
+    dlb_pmd_finish(decodedCompact);
+}
+
+TEST_F(DlbPmdIdmap01, CopyBetweenDenseAndCompact)
+{
+    unsigned int seed;
+
+    for (seed = 1; seed != 17; ++seed)
+    {
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, GenerateRandomModel(mDense, seed));
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_copy(mCompact, mDense));
+        EXPECT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_equal(mDense, mCompact, 0, 0)) << "seed " << seed;
+        EXPECT_EQ(ObjectIds(mDense), ObjectIds(mCompact)) << "seed " << seed;
+
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, GenerateRandomModel(mCompact, seed + 100));
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_copy(mDense, mCompact));
+        EXPECT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_equal(mDense, mCompact, 0, 0)) << "seed " << seed;
+        EXPECT_EQ(PresentationIds(mDense), PresentationIds(mCompact)) << "seed " << seed;
+    }
+}
@@ -40,9 +40,12 @@
 
 #include "dlb_pmd/include/dlb_pmd_api.h"
 #include "dlb_pmd/include/dlb_pmd_pcm.h"
+#include "pmd_s337m_scan.h"
 
 #include <stdint.h>
 #include <string.h>
+#include <algorithm>
+#include <vector>
 
 class DlbPmdPcm01 : public testing::Test
 {
@@ -436,6 +439,77 @@ TEST(DlbPmdPcm, MinFrameSize)
     }
 }
 
+TEST(DlbPmdPcm, FindPaCandidates)
+{
+    static const size_t channelCount = 16;
+    static const size_t sampleCount = 100;
+    static const uint32_t PA_20 = 0x6f872000;
+    static const uint32_t PA_24 = 0x96f87200;
+    uint32_t pcm[channelCount * sampleCount];
+    uint32_t stereo[2 * sampleCount];
+    const uint32_t *p;
+
+    ::memset(pcm, 0, sizeof(pcm));
+    ::memset(stereo, 0, sizeof(stereo));
+
+    // Nothing to find: the search runs off the end of the block
+    p = pmd_s337m_find_pa(pcm + 6, pcm + 6 + channelCount * sampleCount, channelCount, 2);
+    EXPECT_EQ(pcm + 6 + channelCount * sampleCount, p);
+
+    // Pa in the second channel of a pair, in a 16-channel buffer
+    pcm[37 * channelCount + 7] = PA_24;
+    pcm[12 * channelCount + 7] = PA_24 + 1;     // near miss
+    p = pmd_s337m_find_pa(pcm + 6, pcm + 6 + channelCount * sampleCount, channelCount, 2);
+    EXPECT_EQ(pcm + 6 + 37 * channelCount, p);
+    p = pmd_s337m_find_pa(pcm + 7, pcm + 7 + channelCount * sampleCount, channelCount, 1);
+    EXPECT_EQ(pcm + 7 + 37 * channelCount, p);
+    p = pmd_s337m_find_pa(pcm + 6, pcm + 6 + channelCount * sampleCount, channelCount, 1);
+    EXPECT_EQ(pcm + 6 + channelCount * sampleCount, p);
+
+    // Contiguous pair and channel buffers take the vector path
+    stereo[2 * 41 + 1] = PA_20;
+    stereo[2 * 90] = PA_24;
+    p = pmd_s337m_find_pa(stereo, stereo + 2 * sampleCount, 2, 2);
+    EXPECT_EQ(stereo + 2 * 41, p);
+    p = pmd_s337m_find_pa(stereo, stereo + 2 * sampleCount, 1, 1);
+    EXPECT_EQ(stereo + 2 * 41 + 1, p);
+    p = pmd_s337m_find_pa(stereo + 2 * 42, stereo + 2 * sampleCount, 2, 2);
+    EXPECT_EQ(stereo + 2 * 90, p);
+}
+
+TEST(DlbPmdPcm, ScanPaMostSignificantBytes)
+{
+    static const size_t channelCount = 3;
+    static const size_t sampleCount = 100;
+    static const size_t sampleSize = 3;
+    static const size_t size = channelCount * sampleCount * sampleSize;
+    uint8_t blob[size];
+    size_t pos;
+
+    // 24-bit big-endian: the MSB is the first byte of each sample
+    ::memset(blob, 0, sizeof(blob));
+    pos = pmd_s337m_scan_msb(blob, size, sampleSize, 0);
+    EXPECT_EQ(size, pos);
+
+    blob[(1 * channelCount + 1) * sampleSize + 1] = 0x96;   // not an MSB
+    blob[(70 * channelCount + 2) * sampleSize + 0] = 0x96;
+    blob[(70 * channelCount + 2) * sampleSize + 1] = 0xf8;
+    blob[(70 * channelCount + 2) * sampleSize + 2] = 0x72;
+    pos = pmd_s337m_scan_msb(blob, size, sampleSize, 0);
+    EXPECT_EQ((70 * channelCount + 2) * sampleSize, pos);
+
+    // The same bytes read as 24-bit little-endian put the MSB last
+    pos = pmd_s337m_scan_msb(blob, size, sampleSize, 2);
+    EXPECT_EQ(size, pos);
+    blob[(80 * channelCount + 0) * sampleSize + 2] = 0x6f;
+    pos = pmd_s337m_scan_msb(blob, size, sampleSize, 2);
+    EXPECT_EQ((80 * channelCount + 0) * sampleSize + 2, pos);
+
+    // Resuming after a hit finds the next one
+    pos = pmd_s337m_scan_msb(blob + 71 * channelCount * sampleSize, size - 71 * channelCount * sampleSize, sampleSize, 2);
+    EXPECT_EQ((80 - 71) * channelCount * sampleSize + 2, pos);
+}
+
 TEST_F(DlbPmdPcm01, ModelTryFrame_Bad_Small)
 {
     static const size_t FRAME_SIZE = 400;
@@ -733,6 +807,7 @@ TEST_F(DlbPmdPcm01, ReadPresentationIdAndLoudnessCorrectionType)    // PMDLIB-13
         &ext, mExtractorMemory, DLB_PMD_FRAMERATE_3000, 0, CHANNEL_COUNT, true, mPmdModelCombo2, nullptr);
 
     success = dlb_pcmpmd_extract(ext, buffer, FRAME_SIZE, 0);
+    dlb_pcmpmd_extractor_finish(ext);
     ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
 
     dlb_pmd_loudness_iterator it;
@@ -745,3 +820,57 @@ TEST_F(DlbPmdPcm01, ReadPresentationIdAndLoudnessCorrectionType)    // PMDLIB-13
     EXPECT_EQ(PRESENTATION_ID, pld.presid);                     // PMDLIB-138
     EXPECT_EQ(PMD_PLD_CORRECTION_REALTIME, pld.loudcorr_type);  // PMDLIB-139
 }
+
+TEST_F(DlbPmdPcm01, AugmentorRestart)
+{
+    static const size_t FRAME_SIZE = 1920;  // 25 fps
+    static const size_t CHANNEL_COUNT = 2;
+    static const size_t HISTORY_SIZE = FRAME_SIZE / 3 + 7;  // ends part way through a frame
+
+    // PMD spreads payloads over frames, keeping track in the model, so give
+    // each augmentor its own copy of the model, with the same history
+    dlb_pmd_success success = AddBasicModel();
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+    success = dlb_pmd_copy(mModel2, mModel1);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+    ASSERT_TRUE(InitComboModel1(mModel1, nullptr));
+    ASSERT_TRUE(InitComboModel2(mModel2, nullptr));
+
+    for (int sadm = 0; sadm < 2; sadm++)
+    {
+        std::vector<uint8_t> initMemory(dlb_pcmpmd_augmentor_query_mem(sadm));
+        std::vector<uint8_t> restartMemory(dlb_pcmpmd_augmentor_query_mem(sadm));
+        std::vector<uint32_t> history(HISTORY_SIZE * CHANNEL_COUNT, 0);
+        std::vector<uint32_t> initialized(FRAME_SIZE * CHANNEL_COUNT, 0);
+        std::vector<uint32_t> restarted(FRAME_SIZE * CHANNEL_COUNT, 0);
+        dlb_pcmpmd_augmentor *initAug;
+        dlb_pcmpmd_augmentor *restartAug;
+
+        // Leave both augmentors part way through a frame...
+        dlb_pcmpmd_augmentor_init3(
+            &initAug, mPmdModelCombo1, &initMemory[0], 0,
+            DLB_PMD_FRAMERATE_2500, DLB_PMD_KLV_UL_ST2109,
+            false, CHANNEL_COUNT, CHANNEL_COUNT, true, 0, sadm);
+        dlb_pcmpmd_augment(initAug, &history[0], HISTORY_SIZE, 0);
+        dlb_pcmpmd_augmentor_init3(
+            &restartAug, mPmdModelCombo2, &restartMemory[0], 0,
+            DLB_PMD_FRAMERATE_2500, DLB_PMD_KLV_UL_ST2109,
+            false, CHANNEL_COUNT, CHANNEL_COUNT, true, 0, sadm);
+        dlb_pcmpmd_augment(restartAug, &history[0], HISTORY_SIZE, 0);
+
+        // ...then start one over by initializing it again, and the other by restarting it
+        dlb_pcmpmd_augmentor_init3(
+            &initAug, mPmdModelCombo1, &initMemory[0], 0,
+            DLB_PMD_FRAMERATE_2500, DLB_PMD_KLV_UL_ST2109,
+            false, CHANNEL_COUNT, CHANNEL_COUNT, true, 0, sadm);
+        dlb_pcmpmd_augment(initAug, &initialized[0], FRAME_SIZE, 0);
+        dlb_pcmpmd_augmentor_restart(restartAug);
+        dlb_pcmpmd_augment(restartAug, &restarted[0], FRAME_SIZE, 0);
+
+        dlb_pcmpmd_augmentor_finish(initAug);
+        dlb_pcmpmd_augmentor_finish(restartAug);
+
+        EXPECT_NE(initialized.size(), (size_t)std::count(initialized.begin(), initialized.end(), 0u)) << (sadm ? "sADM" : "PMD");
+        EXPECT_TRUE(initialized == restarted) << (sadm ? "sADM" : "PMD");
+    }
+}
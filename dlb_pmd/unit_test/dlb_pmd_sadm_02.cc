@@ -45,6 +45,7 @@
 #include "sadm_bitstream_decoder.h"
 #include "pmd_profile.h"
 #include "test_data.h"
+#include "dlb_adm/include/dlb_adm_api.h"
 
 #include <string.h>
 #include <stdio.h>
@@ -58,6 +59,7 @@ protected:
     dlb_pmd_model *pmdModel;
     dlb_pcmpmd_augmentor *augmentor;
     dlb_pcmpmd_extractor *extractor;
+    sadm_bitstream_decoder *decoder;
 
     uint8_t *pmdModelMemory;
     uint8_t *encoderMemory;
@@ -113,6 +115,7 @@ protected:
         pmdModelMemory = nullptr;
         augmentor = nullptr;
         extractor = nullptr;
+        decoder = nullptr;
 
         encoderMemory = nullptr;
         decoderMemory = nullptr;
@@ -160,6 +163,11 @@ protected:
             augmentorMemory = nullptr;
         }
 
+        if (decoder != nullptr)
+        {
+            sadm_bitstream_decoder_finish(decoder);
+            decoder = nullptr;
+        }
         if (decoderMemory != nullptr)
         {
             delete[] decoderMemory;
@@ -231,12 +239,26 @@ protected:
         ::puts(msg);
     }
 
+    struct SetModelArg
+    {
+        dlb_pcmpmd_augmentor *augmentor;
+        dlb_pmd_model_combo *model;
+        int calls;
+    };
+
+    static void SetModelCallback(void *arg)
+    {
+        SetModelArg *a = static_cast<SetModelArg *>(arg);
+
+        ::dlb_pcmpmd_augmentor_set_model(a->augmentor, a->model);
+        a->calls++;
+    }
+
 };
 
 TEST_F(DlbPmdSadm02, BitstreamCompressDecompress)
 {
     sadm_bitstream_encoder *encoder = nullptr;
-    sadm_bitstream_decoder *decoder = nullptr;
     dlb_pmd_success success;
     int encodedCount;
     int decodedCount;
@@ -274,6 +296,131 @@ TEST_F(DlbPmdSadm02, BitstreamCompressDecompress)
     EXPECT_EQ(0, comp);
 }
 
+TEST_F(DlbPmdSadm02, BitstreamCompressionSettings)
+{
+    static const int levels[] = { 9, 1, 6, 0, 9 };
+    sadm_bitstream_encoder *encoder = nullptr;
+    dlb_pmd_success success;
+    int bestCount = 0;
+    size_t len;
+    size_t sz;
+
+    sz = ::sadm_bitstream_encoder_query_mem();
+    encoderMemory = new uint8_t[sz];
+    ASSERT_NE(nullptr, encoderMemory);
+    success = ::sadm_bitstream_encoder_init(encoderMemory, &encoder);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+
+    sz = ::sadm_bitstream_decoder_query_mem();
+    decoderMemory = new uint8_t[sz];
+    ASSERT_NE(nullptr, decoderMemory);
+    success = ::sadm_bitstream_decoder_init(decoderMemory, &decoder);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+
+    EXPECT_EQ(static_cast<dlb_pmd_success>(PMD_FAIL), ::sadm_bitstream_encoder_set_compression(encoder, 10, 0));
+    EXPECT_EQ(static_cast<dlb_pmd_success>(PMD_FAIL), ::sadm_bitstream_encoder_set_compression(encoder, 9, 5));
+
+    ::strcpy(encoder->xmlbuf, smallXML1);
+    len = ::strlen(encoder->xmlbuf);
+
+    // The same encoder and decoder streams are reused across frames and settings
+    for (int level : levels)
+    {
+        for (int frame = 0; frame < 3; frame++)
+        {
+            int encodedCount;
+            int decodedCount;
+
+            success = ::sadm_bitstream_encoder_set_compression(encoder, level, DLB_PCMPMD_SADM_STRATEGY_DEFAULT);
+            ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+            encoder->size = len;
+            encodedCount = ::compress_sadm_xml(encoder, binaryBuffer, MAX_DATA_BYTES);
+            ASSERT_LT(0, encodedCount);
+            ASSERT_GE(MAX_DATA_BYTES, encodedCount);
+            if (level == 9)
+            {
+                if (bestCount == 0)
+                {
+                    bestCount = encodedCount;
+                }
+                EXPECT_EQ(bestCount, encodedCount);
+            }
+            else
+            {
+                EXPECT_LE(bestCount, encodedCount);
+            }
+
+            decodedCount = ::decompress_sadm_xml(decoder, binaryBuffer, encodedCount);
+            ASSERT_EQ(static_cast<int>(len), decodedCount);
+            EXPECT_EQ(0, ::memcmp(smallXML1, decoder->xmlbuf, len));
+        }
+    }
+}
+
+TEST_F(DlbPmdSadm02, BitstreamEncoderTrackChanges)
+{
+    const char *inputXMLFileName = "stereo_sadm_02_track_changes_input.xml";
+    sadm_bitstream_encoder *encoder = nullptr;
+    const dlb_adm_core_model *coreModel = nullptr;
+    dlb_adm_core_model *writableCoreModel = nullptr;
+    uint8_t firstPayload[MAX_DATA_BYTES];
+    uint64_t generation1 = 0;
+    uint64_t generation2 = 0;
+    dlb_pmd_success success;
+    int firstCount;
+    int encodedCount;
+    int status;
+    size_t sz;
+
+    // Build the core model from the test input
+    success = WriteStringToFile(inputXMLFileName, smallXML1);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+    sz = ::dlb_pmd_query_mem_constrained(&limits);
+    pmdModelMemory = new uint8_t[sz];
+    ASSERT_NE(nullptr, pmdModelMemory);
+    ::dlb_pmd_init_constrained(&pmdModel, &limits, pmdModelMemory);
+    ASSERT_TRUE(InitComboModel(pmdModel, nullptr));
+    success = ::dlb_pmd_sadm_file_read(inputXMLFileName, mPmdModelCombo, PMD_FALSE, errorCallback, NULL);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+    success = ::dlb_pmd_model_combo_ensure_readable_core_model(mPmdModelCombo, &coreModel);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+
+    sz = ::sadm_bitstream_encoder_query_mem();
+    encoderMemory = new uint8_t[sz];
+    ASSERT_NE(nullptr, encoderMemory);
+    success = ::sadm_bitstream_encoder_init(encoderMemory, &encoder);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+    ::sadm_bitstream_encoder_track_changes(encoder, PMD_TRUE);
+
+    // First payload is generated from the model
+    firstCount = ::sadm_bitstream_encoder_payload(encoder, coreModel, firstPayload);
+    ASSERT_LT(0, firstCount);
+    ASSERT_GE(MAX_DATA_BYTES, firstCount);
+    EXPECT_LT(0u, encoder->size);
+
+    // Unchanged model: the same payload is re-emitted without regenerating the XML
+    encoder->size = 0;
+    encodedCount = ::sadm_bitstream_encoder_payload(encoder, coreModel, binaryBuffer);
+    ASSERT_EQ(firstCount, encodedCount);
+    EXPECT_EQ(0, ::memcmp(firstPayload, binaryBuffer, firstCount));
+    EXPECT_EQ(0u, encoder->size);
+
+    // Changing the model changes its generation and forces regeneration
+    status = ::dlb_adm_core_model_get_generation(coreModel, &generation1);
+    ASSERT_EQ(DLB_ADM_STATUS_OK, status);
+    success = ::dlb_pmd_model_combo_get_writable_core_model(mPmdModelCombo, &writableCoreModel);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+    status = ::dlb_adm_core_model_clear(writableCoreModel);
+    ASSERT_EQ(DLB_ADM_STATUS_OK, status);
+    status = ::dlb_adm_core_model_get_generation(writableCoreModel, &generation2);
+    ASSERT_EQ(DLB_ADM_STATUS_OK, status);
+    EXPECT_NE(generation1, generation2);
+
+    encodedCount = ::sadm_bitstream_encoder_payload(encoder, writableCoreModel, binaryBuffer);
+    EXPECT_LT(0u, encoder->size);
+    EXPECT_NE(firstCount, encodedCount);
+}
+
 TEST_F(DlbPmdSadm02, BitstreamEncodeDecodeSubframeMode)
 {
     //
@@ -466,6 +613,214 @@ TEST_F(DlbPmdSadm02, BitstreamEncodeDecodeFrameMode)
     EXPECT_EQ(0, compare);
 }
 
+TEST_F(DlbPmdSadm02, BitstreamEncodeDecodeDictionary)
+{
+    const char *inputXMLFileName   = "stereo_sadm_02_dict_input.xml";
+    const char *compareXMLFileName = "stereo_sadm_02_dict_compare.xml";
+    const char *outputXMLFileName  = "stereo_sadm_02_dict_output.xml";
+    sadm_bitstream_encoder *encoder = nullptr;
+    dlb_pmd_success success;
+    int gzipCount;
+    int dictCount;
+    int decodedCount;
+    int compare;
+    size_t len;
+    size_t sz;
+
+    // The preset dictionary must beat plain gzip on a typical S-ADM document
+    sz = ::sadm_bitstream_encoder_query_mem();
+    encoderMemory = new uint8_t[sz];
+    ASSERT_NE(nullptr, encoderMemory);
+    success = ::sadm_bitstream_encoder_init(encoderMemory, &encoder);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+
+    sz = ::sadm_bitstream_decoder_query_mem();
+    decoderMemory = new uint8_t[sz];
+    ASSERT_NE(nullptr, decoderMemory);
+    success = ::sadm_bitstream_decoder_init(decoderMemory, &decoder);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+
+    ::strcpy(encoder->xmlbuf, smallXML1);
+    len = ::strlen(encoder->xmlbuf);
+
+    encoder->size = len;
+    gzipCount = ::compress_sadm_xml(encoder, binaryBuffer, MAX_DATA_BYTES);
+    ASSERT_LT(0, gzipCount);
+
+    ::sadm_bitstream_encoder_use_dictionary(encoder, PMD_TRUE);
+    for (int frame = 0; frame < 2; frame++)
+    {
+        encoder->size = len;
+        dictCount = ::compress_sadm_xml(encoder, binaryBuffer, MAX_DATA_BYTES);
+        ASSERT_LT(0, dictCount);
+        EXPECT_GT(gzipCount, dictCount);
+
+        decodedCount = ::decompress_sadm_xml(decoder, binaryBuffer, dictCount);
+        ASSERT_EQ(static_cast<int>(len), decodedCount);
+        EXPECT_EQ(0, ::memcmp(smallXML1, decoder->xmlbuf, len));
+    }
+
+    // Round trip through SMPTE 337m with the dictionary signalled in format_info
+    success = WriteStringToFile(inputXMLFileName, smallXML1);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+
+    sz = ::dlb_pmd_query_mem_constrained(&limits);
+    pmdModelMemory = new uint8_t[sz];
+    ASSERT_NE(nullptr, pmdModelMemory);
+    ::dlb_pmd_init_constrained(&pmdModel, &limits, pmdModelMemory);
+
+    ASSERT_TRUE(InitComboModel(pmdModel, nullptr));
+    success = ::dlb_pmd_sadm_file_read(inputXMLFileName, mPmdModelCombo, PMD_FALSE, errorCallback, NULL);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+    success = ::dlb_pmd_sadm_file_write(compareXMLFileName, mPmdModelCombo);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+
+    sz = ::dlb_pcmpmd_augmentor_query_mem(PMD_TRUE);
+    augmentorMemory = new uint8_t[sz];
+    ASSERT_NE(nullptr, augmentorMemory);
+    ::dlb_pcmpmd_augmentor_init5
+    (
+        &augmentor,
+        mPmdModelCombo,
+        augmentorMemory,
+        0,
+        DLB_PMD_FRAMERATE_2500,
+        DLB_PMD_KLV_UL_ST2109,
+        PMD_FALSE,
+        2,
+        2,
+        PMD_TRUE,
+        0,
+        PMD_TRUE,
+        DLB_PCMPMD_SADM_COMPRESSION_DEFAULT,
+        DLB_PCMPMD_SADM_STRATEGY_DEFAULT,
+        PMD_TRUE
+    );
+    ::dlb_pcmpmd_augment(augmentor, pcmBuffer, FRAME_SAMPLES, 0);
+    EXPECT_NE(0u, pcmBuffer[GUARDBAND * 2]);
+
+    success = dlb_pmd_model_combo_clear(mPmdModelCombo);
+    ASSERT_EQ(PMD_SUCCESS, success);
+
+    sz = ::dlb_pcmpmd_extractor_query_mem(PMD_TRUE);
+    extractorMemory = new uint8_t[sz];
+    ASSERT_NE(nullptr, extractorMemory);
+    dlb_pcmpmd_extractor_init2
+    (
+        &extractor,
+        extractorMemory,
+        DLB_PMD_FRAMERATE_2500,
+        0,
+        2,
+        PMD_TRUE,
+        mPmdModelCombo,
+        nullptr,
+        PMD_TRUE
+    );
+    success = ::dlb_pcmpmd_extract(extractor, pcmBuffer, FRAME_SAMPLES, 0);
+    EXPECT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+
+    success = ::dlb_pmd_sadm_file_write(outputXMLFileName, mPmdModelCombo);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+
+    success = ReadStringFromFile(decodedXml, sizeof(decodedXml) - 1, outputXMLFileName);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+    success = ReadStringFromFile(compareXml, sizeof(compareXml) - 1, compareXMLFileName);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+    compare = ::strcmp(decodedXml, compareXml);
+    EXPECT_EQ(0, compare);
+}
+
+TEST_F(DlbPmdSadm02, AugmentorSetModel)
+{
+    const char *inputXMLFileName   = "stereo_sadm_02_set_model_input.xml";
+    const char *compareXMLFileName = "stereo_sadm_02_set_model_compare.xml";
+    const char *outputXMLFileName  = "stereo_sadm_02_set_model_output.xml";
+    dlb_pmd_model_combo *nextModel = nullptr;
+    SetModelArg arg;
+    dlb_pmd_success success;
+    int compare;
+    size_t sz;
+
+    // The augmentor starts with one model...
+    success = WriteStringToFile(inputXMLFileName, smallXML1);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+    ASSERT_TRUE(InitComboModel(nullptr, nullptr));
+    success = ::dlb_pmd_sadm_file_read(inputXMLFileName, mPmdModelCombo, PMD_FALSE, errorCallback, NULL);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+
+    // ...and is switched to another one when the second frame is about to begin
+    success = WriteStringToFile(inputXMLFileName, smallXML2);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+    success = ::dlb_pmd_model_combo_init(&nextModel, nullptr, nullptr, PMD_FALSE, nullptr);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+    success = ::dlb_pmd_sadm_file_read(inputXMLFileName, nextModel, PMD_FALSE, errorCallback, NULL);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+    success = ::dlb_pmd_sadm_file_write(compareXMLFileName, nextModel);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+
+    sz = ::dlb_pcmpmd_augmentor_query_mem(PMD_TRUE);
+    augmentorMemory = new uint8_t[sz];
+    ASSERT_NE(nullptr, augmentorMemory);
+    ::dlb_pcmpmd_augmentor_init4
+    (
+        &augmentor,
+        mPmdModelCombo,
+        augmentorMemory,
+        0,
+        DLB_PMD_FRAMERATE_2500,
+        DLB_PMD_KLV_UL_ST2109,
+        PMD_FALSE,
+        2,
+        2,
+        PMD_TRUE,
+        0,
+        PMD_TRUE,
+        DLB_PCMPMD_SADM_COMPRESSION_DEFAULT,
+        DLB_PCMPMD_SADM_STRATEGY_DEFAULT
+    );
+    arg.augmentor = augmentor;
+    arg.model = nextModel;
+    arg.calls = 0;
+    ::dlb_pcmpmd_augment2(augmentor, pcmBuffer, FRAME_SAMPLES, 0, SetModelCallback, &arg);
+    ::dlb_pcmpmd_augment2(augmentor, pcmBuffer, FRAME_SAMPLES, 0, SetModelCallback, &arg);
+    EXPECT_LT(0, arg.calls);
+
+    // Only the second model can be found in the second frame
+    success = dlb_pmd_model_combo_clear(mPmdModelCombo);
+    ASSERT_EQ(PMD_SUCCESS, success);
+
+    sz = ::dlb_pcmpmd_extractor_query_mem(PMD_TRUE);
+    extractorMemory = new uint8_t[sz];
+    ASSERT_NE(nullptr, extractorMemory);
+    dlb_pcmpmd_extractor_init2
+    (
+        &extractor,
+        extractorMemory,
+        DLB_PMD_FRAMERATE_2500,
+        0,
+        2,
+        PMD_TRUE,
+        mPmdModelCombo,
+        nullptr,
+        PMD_TRUE
+    );
+    success = ::dlb_pcmpmd_extract(extractor, pcmBuffer, FRAME_SAMPLES, 0);
+    EXPECT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+
+    success = ::dlb_pmd_sadm_file_write(outputXMLFileName, mPmdModelCombo);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+
+    success = ReadStringFromFile(decodedXml, sizeof(decodedXml) - 1, outputXMLFileName);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+    success = ReadStringFromFile(compareXml, sizeof(compareXml) - 1, compareXMLFileName);
+    ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+    compare = ::strcmp(decodedXml, compareXml);
+    EXPECT_EQ(0, compare);
+
+    (void)dlb_pmd_model_combo_destroy(&nextModel);
+}
+
 TEST_F(DlbPmdSadm02, InOutAndCompareADM)
 {
     const char *inputXMLFileName = "stereo_2D_ADM_sadm_02_input.xml";
@@ -526,6 +881,7 @@ TEST_F(DlbPmdSadm02, SADMEncodeDecodeBuffer)
                                       ,errorCallback
                                       ,NULL);
     ASSERT_EQ(static_cast<dlb_pmd_success>(PMD_SUCCESS), success);
+    dlb_pmd_sadm_buffer_reader_finish(reader);
 
     /* Write test input file */
 
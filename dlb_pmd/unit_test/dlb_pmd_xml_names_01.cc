@@ -0,0 +1,227 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#define _SILENCE_TR1_NAMESPACE_DEPRECATION_WARNING
+
+#include "gtest/gtest.h"
+
+#include "dlb_pmd/include/dlb_pmd_api.h"
+#include "dlb_pmd/include/dlb_pmd_generate.h"
+#include "dlb_pmd/include/dlb_pmd_xml_string.h"
+#include "dlb_pmd/src/modules/xml/xml_names.h"
+#include "dlb_pmd/src/modules/xml/xml_number.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+/* The XML reader interns tag and attribute names through a generated
+ * perfect hash, and reads numbers with its own versions of strtoll,
+ * strtol and strtod.  These tests check the hash against every name it
+ * knows and some it does not, check the number readers against the C
+ * library, and check that generated models survive an XML round trip.
+ */
+
+TEST(DlbPmdXmlNames01, EveryNameInterns)
+{
+    for (unsigned int i = XML_NAME_UNKNOWN + 1; i != XML_NAME_COUNT; ++i)
+    {
+        std::string name = xml_name_strings[i];
+        std::string upper = name;
+        std::string lower = name;
+
+        for (size_t j = 0; j != name.size(); ++j)
+        {
+            upper[j] = (char)toupper((unsigned char)name[j]);
+            lower[j] = (char)tolower((unsigned char)name[j]);
+        }
+        EXPECT_EQ((xml_name)i, xml_name_lookup(name.c_str())) << name;
+        EXPECT_EQ((xml_name)i, xml_name_lookup(upper.c_str())) << name;
+        EXPECT_EQ((xml_name)i, xml_name_lookup(lower.c_str())) << name;
+    }
+}
+
+TEST(DlbPmdXmlNames01, UnknownNamesDoNotIntern)
+{
+    static const char *unknown[] =
+    {
+        "", "Audio", "AudioSignalz", "AudioSignal ", "Ad_ID", "Smpte2110", "x", "xmlns"
+    };
+
+    for (size_t i = 0; i != sizeof(unknown)/sizeof(unknown[0]); ++i)
+    {
+        EXPECT_EQ(XML_NAME_UNKNOWN, xml_name_lookup(unknown[i])) << unknown[i];
+    }
+
+    /* every single-character change to a known name is unknown, unless
+     * it is only a change of case */
+    for (unsigned int i = XML_NAME_UNKNOWN + 1; i != XML_NAME_COUNT; ++i)
+    {
+        std::string name = xml_name_strings[i];
+
+        for (size_t j = 0; j != name.size(); ++j)
+        {
+            std::string changed = name;
+            changed[j] = name[j] == '_' ? '-' : '_';
+            EXPECT_EQ(XML_NAME_UNKNOWN, xml_name_lookup(changed.c_str())) << changed;
+        }
+    }
+}
+
+TEST(DlbPmdXmlNames01, IntegersMatchStrtoll)
+{
+    static const char *text[] =
+    {
+        "0", "7", "-7", "+7", "  42", "\t-42dB", "010", "0x1f", "0X1F", "0x", "0xg",
+        "1e3", "", "-", "+", " ", "abc", "255", "256", "ff", "FF", "9223372036854775807",
+        "9223372036854775808", "-9223372036854775808", "-9223372036854775809",
+        "123456789012345678901234567890", "08", "1.5"
+    };
+    static const int bases[] = { 0, 10, 16 };
+
+    for (size_t i = 0; i != sizeof(text)/sizeof(text[0]); ++i)
+    {
+        for (size_t b = 0; b != sizeof(bases)/sizeof(bases[0]); ++b)
+        {
+            char *expected_end;
+            char *end;
+            long long expected = strtoll(text[i], &expected_end, bases[b]);
+            long long v = xml_strtoll(text[i], &end, bases[b]);
+
+            EXPECT_EQ(expected, v) << "\"" << text[i] << "\" base " << bases[b];
+            EXPECT_EQ(expected_end - text[i], end - text[i]) << "\"" << text[i] << "\" base " << bases[b];
+
+            long expected_l = strtol(text[i], &expected_end, bases[b]);
+            long l = xml_strtol(text[i], &end, bases[b]);
+
+            EXPECT_EQ(expected_l, l) << "\"" << text[i] << "\" base " << bases[b];
+            EXPECT_EQ(expected_end - text[i], end - text[i]) << "\"" << text[i] << "\" base " << bases[b];
+        }
+    }
+}
+
+TEST(DlbPmdXmlNames01, DoublesMatchStrtod)
+{
+    std::vector<std::string> text;
+    static const char *fixed[] =
+    {
+        "0", "-0", "0.0", "1", "-1.5", "+2.25", "  3.0dB", "-infdB", "inf", "nan", "0x1p3",
+        ".5", "5.", ".", "-.", "e5", "1e", "1e+", "1e-3", "1E3", "1.5e22", "1.5e23",
+        "1e-22", "1e-23", "0.1", "0.2", "0.3", "-31.5", "-1.0E-1", "123456789012345678",
+        "1234567890123456789", "12345678901234567890", "0.000000000000000000001",
+        "00000000000000000000000001.5", "9007199254740993", "", "-", "dB", "1e99999"
+    };
+    unsigned int seed = 1;
+    char buf[64];
+
+    for (size_t i = 0; i != sizeof(fixed)/sizeof(fixed[0]); ++i)
+    {
+        text.push_back(fixed[i]);
+    }
+    for (unsigned int i = 0; i != 10000; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        double v = ((double)(seed >> 8) / (1 << 24) - 0.5) * 200.0;
+        snprintf(buf, sizeof(buf), "%.*f", (int)(seed % 8), v);
+        text.push_back(buf);
+        snprintf(buf, sizeof(buf), "%.*g", 1 + (int)(seed % 17), v);
+        text.push_back(buf);
+    }
+
+    for (size_t i = 0; i != text.size(); ++i)
+    {
+        const char *t = text[i].c_str();
+        char *expected_end;
+        char *end;
+        double expected = strtod(t, &expected_end);
+        double v = xml_strtod(t, &end);
+
+        if (expected != expected)
+        {
+            EXPECT_NE(v, v) << "\"" << t << "\"";
+        }
+        else
+        {
+            EXPECT_EQ(0, memcmp(&expected, &v, sizeof(v))) << "\"" << t << "\": " << expected << " vs " << v;
+        }
+        EXPECT_EQ(expected_end - t, end - t) << "\"" << t << "\"";
+    }
+}
+
+TEST(DlbPmdXmlNames01, GeneratedModelsRoundTrip)
+{
+    dlb_pmd_model *src = NULL;
+    dlb_pmd_model *dest = NULL;
+    std::vector<char> xml(32 * 1024 * 1024);
+
+    dlb_pmd_init(&src, NULL);
+    dlb_pmd_init(&dest, NULL);
+
+    for (unsigned int seed = 1; seed != 9; ++seed)
+    {
+        dlb_pmd_metadata_count counts;
+        size_t size = xml.size();
+
+        memset(&counts, '\0', sizeof(counts));
+        counts.num_signals         = PMD_GENERATE_RANDOM_NUMBER;
+        counts.num_beds            = PMD_GENERATE_RANDOM_NUMBER;
+        counts.num_objects         = PMD_GENERATE_RANDOM_NUMBER;
+        counts.num_updates         = 256 * seed;
+        counts.num_presentations   = PMD_GENERATE_RANDOM_NUMBER;
+        counts.num_loudness        = PMD_GENERATE_RANDOM_NUMBER;
+        counts.num_iat             = PMD_GENERATE_RANDOM_NUMBER;
+        counts.num_eac3            = PMD_GENERATE_RANDOM_NUMBER;
+        counts.num_ed2_system      = PMD_GENERATE_RANDOM_NUMBER;
+        counts.num_ed2_turnarounds = PMD_GENERATE_RANDOM_NUMBER;
+        counts.num_headphone_desc  = PMD_GENERATE_RANDOM_NUMBER;
+
+        dlb_pmd_reset(src);
+        dlb_pmd_reset(dest);
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_generate_random(src, &counts, seed, 1, 0))
+            << "seed " << seed << ": " << dlb_pmd_error(src);
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_xmlpmd_string_write(src, &xml[0], &size))
+            << "seed " << seed;
+        EXPECT_EQ((dlb_pmd_success)PMD_SUCCESS,
+                  dlb_xmlpmd_string_read(&xml[0], size, dest, 1, NULL, NULL, NULL))
+            << "seed " << seed << ": " << dlb_pmd_error(dest);
+        EXPECT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_equal(dest, src, 0, 0)) << "seed " << seed;
+    }
+
+    dlb_pmd_finish(src);
+    dlb_pmd_finish(dest);
+}
@@ -0,0 +1,410 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#define _SILENCE_TR1_NAMESPACE_DEPRECATION_WARNING
+
+#include "gtest/gtest.h"
+
+#include "dlb_http_client.h"
+#include "dlb_http_server.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* A minimal HTTP/1.1 server that keeps connections open, answering each
+ * request on a connection in turn, so that the client's reuse of
+ * connections and pipelining can be counted.  A request whose body is
+ * "reject" is answered 404, and if mCloseEvery is set, the server
+ * closes the connection after that many responses.
+ */
+class DlbSocketHttpClient01 : public testing::Test
+{
+protected:
+    static const int PORT = 18471;
+
+    std::thread mServer;
+    std::atomic<bool> mRunning;
+    std::mutex mLock;
+    std::vector<std::string> mBodies;
+    unsigned int mConnections;
+    unsigned int mCloseEvery;
+    dlb_http_client mClient;
+    std::string mResponse;
+
+    virtual void SetUp()
+    {
+        mConnections = 0;
+        mCloseEvery = 0;
+        memset(&mClient, '\0', sizeof(mClient));
+    }
+
+    virtual void TearDown()
+    {
+        dlb_http_client_close(&mClient);
+        if (mServer.joinable())
+        {
+            mRunning.store(false);
+            mServer.join();
+        }
+    }
+
+    void StartServer()
+    {
+        dlb_socket listener;
+        int err;
+
+        ASSERT_EQ(DLB_SOCKET_OK, dlb_socket_create_stream_server(&listener, NULL, PORT, &err));
+        mRunning.store(true);
+        mServer = std::thread(&DlbSocketHttpClient01::Serve, this, listener);
+    }
+
+    void Serve(dlb_socket listener)
+    {
+        char address[DLB_SOCKET_MAX_ADDRESS_SIZE];
+        dlb_socket conn;
+        int ready;
+        int err;
+
+        while (mRunning.load())
+        {
+            if (DLB_SOCKET_OK == dlb_socket_select(&listener, NULL, 1, 0, 20, &ready, &err)
+                && DLB_SOCKET_OK == dlb_socket_accept(listener, &conn, DLB_SOCKET_BLOCKING, &address, &err))
+            {
+                {
+                    std::lock_guard<std::mutex> guard(mLock);
+                    ++mConnections;
+                }
+                ServeConnection(conn);
+                dlb_socket_close(conn);
+            }
+        }
+        dlb_socket_close(listener);
+    }
+
+    /* make sure at least n bytes are buffered; false if the peer closed */
+    static bool Need(dlb_socket conn, std::string &buf, size_t n)
+    {
+        char data[4096];
+        ssize_t sz;
+        int err;
+
+        while (buf.size() < n)
+        {
+            if (DLB_SOCKET_OK != dlb_socket_read(conn, data, sizeof(data), &sz, DLB_SOCKET_BLOCKING, &err)
+                || sz <= 0)
+            {
+                return false;
+            }
+            buf.append(data, sz);
+        }
+        return true;
+    }
+
+    /* buffer up to and including the next occurrence of delim */
+    static bool NeedUntil(dlb_socket conn, std::string &buf, const char *delim, size_t &end)
+    {
+        while (std::string::npos == (end = buf.find(delim)))
+        {
+            if (!Need(conn, buf, buf.size() + 1))
+            {
+                return false;
+            }
+        }
+        end += strlen(delim);
+        return true;
+    }
+
+    void ServeConnection(dlb_socket conn)
+    {
+        std::string buf;
+        unsigned int served = 0;
+        size_t end;
+
+        while (NeedUntil(conn, buf, "\r\n\r\n", end))
+        {
+            std::string header = buf.substr(0, end);
+            std::string body;
+            buf.erase(0, end);
+
+            if (std::string::npos != header.find("Transfer-Encoding: chunked"))
+            {
+                unsigned long len;
+                do
+                {
+                    if (!NeedUntil(conn, buf, "\r\n", end))
+                    {
+                        return;
+                    }
+                    len = strtoul(buf.c_str(), NULL, 16);
+                    buf.erase(0, end);
+                    if (!Need(conn, buf, len + 2))
+                    {
+                        return;
+                    }
+                    body.append(buf, 0, len);
+                    buf.erase(0, len + 2);
+                }
+                while (len);
+            }
+            else if (std::string::npos != (end = header.find("Content-Length: ")))
+            {
+                unsigned long len = strtoul(header.c_str() + end + 16, NULL, 10);
+                if (!Need(conn, buf, len))
+                {
+                    return;
+                }
+                body = buf.substr(0, len);
+                buf.erase(0, len);
+            }
+
+            unsigned int index;
+            {
+                std::lock_guard<std::mutex> guard(mLock);
+                index = (unsigned int)mBodies.size();
+                mBodies.push_back(body);
+            }
+
+            bool close = mCloseEvery && ++served == mCloseEvery;
+            std::string reply = "ack " + std::to_string(index);
+            std::string response = std::string(body == "reject" ? "HTTP/1.1 404 Not Found" : "HTTP/1.1 200 OK")
+                + "\r\nContent-Length: " + std::to_string(reply.size())
+                + (close ? "\r\nConnection: close" : "")
+                + "\r\n\r\n" + reply;
+            int err;
+
+            if (DLB_SOCKET_OK != dlb_socket_stream_write(conn, (void*)response.data(), response.size(), &err)
+                || close)
+            {
+                return;
+            }
+        }
+    }
+
+    static void GotData(void *arg, char *buffer, size_t length)
+    {
+        ((std::string*)arg)->append(buffer, length);
+    }
+
+    dlb_socket_res Post(const char *body)
+    {
+        int err;
+        dlb_socket_res res = dlb_http_client_post(&mClient, "text/plain", 0, &err);
+        if (DLB_SOCKET_OK == res)
+        {
+            res = dlb_http_client_send(&mClient, (char*)body, strlen(body), &err);
+        }
+        return res;
+    }
+
+    dlb_socket_res Read()
+    {
+        mResponse.clear();
+        return dlb_http_client_read(&mClient, GotData, &mResponse);
+    }
+
+    std::string Url()
+    {
+        return "http://localhost:" + std::to_string(PORT) + "/md";
+    }
+};
+
+
+TEST_F(DlbSocketHttpClient01, KeepAliveReusesConnection)
+{
+    int err;
+
+    StartServer();
+    ASSERT_EQ(DLB_SOCKET_OK, dlb_http_client_open2(&mClient, Url().c_str(), 1, &err));
+    for (unsigned int i = 0; i != 20; ++i)
+    {
+        std::string body = "model " + std::to_string(i);
+        ASSERT_EQ(DLB_SOCKET_OK, Post(body.c_str()));
+        ASSERT_EQ(DLB_SOCKET_OK, Read()) << "request " << i;
+        EXPECT_EQ("ack " + std::to_string(i), mResponse);
+    }
+    EXPECT_EQ(1u, mClient.connections);
+    EXPECT_EQ(20u, mClient.responses);
+    dlb_http_client_close(&mClient);
+
+    TearDown();
+    EXPECT_EQ(1u, mConnections);
+    ASSERT_EQ(20u, mBodies.size());
+    EXPECT_EQ("model 19", mBodies[19]);
+}
+
+
+TEST_F(DlbSocketHttpClient01, PipelinedResponsesInOrder)
+{
+    const unsigned int DEPTH = 8;
+    int err;
+
+    StartServer();
+    ASSERT_EQ(DLB_SOCKET_OK, dlb_http_client_open2(&mClient, Url().c_str(), 1, &err));
+    for (unsigned int round = 0; round != 3; ++round)
+    {
+        for (unsigned int i = 0; i != DEPTH; ++i)
+        {
+            ASSERT_EQ(DLB_SOCKET_OK, Post("pipelined"));
+            ASSERT_EQ(DLB_SOCKET_OK, dlb_http_client_end_request(&mClient, &err));
+        }
+        EXPECT_EQ(DEPTH, mClient.pending);
+        for (unsigned int i = 0; i != DEPTH; ++i)
+        {
+            ASSERT_EQ(DLB_SOCKET_OK, Read());
+            EXPECT_EQ("ack " + std::to_string(round * DEPTH + i), mResponse);
+        }
+    }
+    EXPECT_EQ(0u, mClient.pending);
+    EXPECT_EQ(1u, mClient.connections);
+}
+
+
+TEST_F(DlbSocketHttpClient01, RejectionKeepsConnection)
+{
+    int err;
+
+    StartServer();
+    ASSERT_EQ(DLB_SOCKET_OK, dlb_http_client_open2(&mClient, Url().c_str(), 1, &err));
+    ASSERT_EQ(DLB_SOCKET_OK, Post("reject"));
+    ASSERT_EQ(DLB_SOCKET_OK, dlb_http_client_end_request(&mClient, &err));
+    ASSERT_EQ(DLB_SOCKET_OK, Post("accept"));
+    EXPECT_EQ(DLB_SOCKET_LIBRARY_ERR, Read());
+    EXPECT_EQ("", mResponse);
+    EXPECT_EQ(1, mClient.connected);
+    EXPECT_EQ(DLB_SOCKET_OK, Read());
+    EXPECT_EQ("ack 1", mResponse);
+    EXPECT_EQ(1u, mClient.connections);
+}
+
+
+TEST_F(DlbSocketHttpClient01, ReconnectsWhenServerCloses)
+{
+    int err;
+
+    mCloseEvery = 3;
+    StartServer();
+    ASSERT_EQ(DLB_SOCKET_OK, dlb_http_client_open2(&mClient, Url().c_str(), 1, &err));
+    for (unsigned int i = 0; i != 9; ++i)
+    {
+        ASSERT_EQ(DLB_SOCKET_OK, Post("model"));
+        ASSERT_EQ(DLB_SOCKET_OK, Read()) << "request " << i;
+        EXPECT_EQ(i % 3 != 2, mClient.connected) << "request " << i;
+    }
+    EXPECT_EQ(3u, mClient.connections);
+}
+
+
+TEST_F(DlbSocketHttpClient01, CloseModeConnectsPerRequest)
+{
+    int err;
+
+    StartServer();
+    ASSERT_EQ(DLB_SOCKET_OK, dlb_http_client_open(&mClient, Url().c_str(), &err));
+    for (unsigned int i = 0; i != 4; ++i)
+    {
+        ASSERT_EQ(DLB_SOCKET_OK, Post("model"));
+        ASSERT_EQ(DLB_SOCKET_OK, Read());
+        EXPECT_EQ(0, mClient.connected);
+    }
+    EXPECT_EQ(4u, mClient.connections);
+}
+
+
+static
+int
+baseline_guts
+    (void *cbarg
+    ,dlb_http_request *request
+    )
+{
+    ++*(unsigned int *)cbarg;
+    request->return_code = (char*)"200 OK";
+    request->response_body = (char*)"ok";
+    request->response_body_size = 2;
+    return 1;
+}
+
+
+/* the library's own server closes the connection after every response */
+TEST_F(DlbSocketHttpClient01, KeepAliveAgainstClosingServer)
+{
+    const int BASELINE_PORT = PORT + 1;
+    dlb_http_server server;
+    unsigned int requests = 0;
+    std::string url = "http://localhost:" + std::to_string(BASELINE_PORT) + "/md";
+    int err;
+
+    memset(&server, '\0', sizeof(server));
+    std::thread thread([&]()
+    {
+        int serr;
+        dlb_http_server_run(&server, BASELINE_PORT, baseline_guts, &requests, &serr);
+    });
+
+    /* the server connects on demand, so wait for it to listen */
+    dlb_socket_res res = DLB_SOCKET_LIBRARY_ERR;
+    for (unsigned int tries = 0; tries != 100 && DLB_SOCKET_OK != res; ++tries)
+    {
+        dlb_http_client_close(&mClient);
+        res = dlb_http_client_open2(&mClient, url.c_str(), 1, &err);
+        if (DLB_SOCKET_OK != res)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    ASSERT_EQ(DLB_SOCKET_OK, res);
+    unsigned int before = mClient.connections;
+
+    for (unsigned int i = 0; i != 5; ++i)
+    {
+        ASSERT_EQ(DLB_SOCKET_OK, Post("model"));
+        ASSERT_EQ(DLB_SOCKET_OK, Read()) << "request " << i;
+        EXPECT_EQ("ok", mResponse);
+        EXPECT_EQ(0, mClient.connected);
+    }
+    EXPECT_EQ(before + 4, mClient.connections);
+
+    dlb_http_server_stop(&server);
+    thread.join();
+    EXPECT_EQ(5u, requests);
+}
+
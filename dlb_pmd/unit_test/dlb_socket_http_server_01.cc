@@ -0,0 +1,422 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#define _SILENCE_TR1_NAMESPACE_DEPRECATION_WARNING
+
+#include "gtest/gtest.h"
+
+#include "dlb_http_client.h"
+#include "dlb_http_server.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Runs the event-driven server on its own thread.  Each request body is
+ * recorded and acknowledged with "ack <n>", except that a body of
+ * "missing" is declined, which the server must answer with 404.
+ */
+class DlbSocketHttpServer01 : public testing::Test
+{
+protected:
+    static const int PORT = 18481;
+
+    dlb_http_server mServer;
+    std::thread mThread;
+    std::mutex mLock;
+    std::vector<std::string> mBodies;
+    std::string mReply;
+    dlb_socket_res mRunResult;
+
+    virtual void SetUp()
+    {
+        memset(&mServer, '\0', sizeof(mServer));
+        mRunResult = DLB_SOCKET_OK;
+    }
+
+    virtual void TearDown()
+    {
+        if (mThread.joinable())
+        {
+            dlb_http_server_stop(&mServer);
+            mThread.join();
+        }
+    }
+
+    static int Guts(void *arg, dlb_http_request *request)
+    {
+        DlbSocketHttpServer01 *self = (DlbSocketHttpServer01 *)arg;
+        std::string body(request->body, request->buflen - (request->body - request->buf));
+        std::lock_guard<std::mutex> guard(self->mLock);
+
+        if (body == "missing")
+        {
+            return 0;
+        }
+        self->mReply = "ack " + std::to_string(self->mBodies.size());
+        self->mBodies.push_back(body);
+        request->return_code = (char*)"200 OK";
+        request->response_body = (char*)self->mReply.data();
+        request->response_body_size = self->mReply.size();
+        return 1;
+    }
+
+    void StartServer(unsigned int max_connections)
+    {
+        mThread = std::thread([this, max_connections]()
+        {
+            int err;
+            mRunResult = dlb_http_server_run2(&mServer, PORT, max_connections, Guts, this, &err);
+        });
+
+        /* wait for the server to listen */
+        for (unsigned int tries = 0; tries != 100; ++tries)
+        {
+            dlb_socket s;
+            int err;
+            if (DLB_SOCKET_OK == dlb_socket_connect(&s, (char*)"127.0.0.1", PORT, NULL, &err))
+            {
+                dlb_socket_close(s);
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        FAIL() << "server did not start";
+    }
+
+    std::vector<std::string> Bodies()
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+        return mBodies;
+    }
+
+    static std::string Url()
+    {
+        return "http://localhost:" + std::to_string(PORT) + "/md";
+    }
+
+    static void GotData(void *arg, char *buffer, size_t length)
+    {
+        ((std::string*)arg)->append(buffer, length);
+    }
+
+    /* post a body on a client, and read the response */
+    static dlb_socket_res Exchange(dlb_http_client *client, const std::string &body, std::string &response)
+    {
+        int err;
+        dlb_socket_res res = dlb_http_client_post(client, "text/plain", body.size(), &err);
+        if (DLB_SOCKET_OK == res)
+        {
+            res = dlb_http_client_send(client, (char*)body.data(), body.size(), &err);
+        }
+        response.clear();
+        return DLB_SOCKET_OK == res ? dlb_http_client_read(client, GotData, &response) : res;
+    }
+
+    static dlb_socket Connect()
+    {
+        dlb_socket s;
+        int err;
+        EXPECT_EQ(DLB_SOCKET_OK, dlb_socket_connect(&s, (char*)"127.0.0.1", PORT, NULL, &err));
+        return s;
+    }
+
+    static bool Write(dlb_socket s, const std::string &data)
+    {
+        int err;
+        return DLB_SOCKET_OK == dlb_socket_stream_write(s, (void*)data.data(), data.size(), &err);
+    }
+
+    /* read one whole response from a raw socket: "" if the server closed first */
+    static std::string ReadResponse(dlb_socket s)
+    {
+        std::string buf;
+        char data[4096];
+        size_t end;
+        ssize_t sz;
+        int err;
+
+        while (std::string::npos == (end = buf.find("\r\n\r\n"))
+               || buf.size() < end + 4 + strtoul(buf.c_str() + buf.find("Content-Length: ") + 16, NULL, 10))
+        {
+            if (DLB_SOCKET_OK != dlb_socket_read(s, data, sizeof(data), &sz, DLB_SOCKET_BLOCKING, &err)
+                || sz <= 0)
+            {
+                return "";
+            }
+            buf.append(data, sz);
+        }
+        return buf;
+    }
+
+    /* true if the server closes the connection without saying more */
+    static bool Closed(dlb_socket s)
+    {
+        char data[64];
+        ssize_t sz;
+        int err;
+        return DLB_SOCKET_OK != dlb_socket_read(s, data, sizeof(data), &sz, DLB_SOCKET_BLOCKING, &err) || sz <= 0;
+    }
+};
+
+
+TEST_F(DlbSocketHttpServer01, KeepAliveServesManyRequests)
+{
+    dlb_http_client client;
+    std::string response;
+    int err;
+
+    StartServer(16);
+    memset(&client, '\0', sizeof(client));
+    ASSERT_EQ(DLB_SOCKET_OK, dlb_http_client_open2(&client, Url().c_str(), 1, &err));
+    for (unsigned int i = 0; i != 50; ++i)
+    {
+        ASSERT_EQ(DLB_SOCKET_OK, Exchange(&client, "model " + std::to_string(i), response)) << "request " << i;
+        EXPECT_EQ("ack " + std::to_string(i), response);
+        EXPECT_EQ(1, client.connected);
+    }
+    EXPECT_EQ(1u, client.connections);
+    dlb_http_client_close(&client);
+
+    std::vector<std::string> bodies = Bodies();
+    ASSERT_EQ(50u, bodies.size());
+    EXPECT_EQ("model 49", bodies[49]);
+}
+
+
+TEST_F(DlbSocketHttpServer01, PipelinedRequestsAnsweredInOrder)
+{
+    const unsigned int DEPTH = 16;
+    dlb_http_client client;
+    std::string response;
+    int err;
+
+    StartServer(16);
+    memset(&client, '\0', sizeof(client));
+    ASSERT_EQ(DLB_SOCKET_OK, dlb_http_client_open2(&client, Url().c_str(), 1, &err));
+    for (unsigned int i = 0; i != DEPTH; ++i)
+    {
+        std::string body = "pipelined " + std::to_string(i);
+        ASSERT_EQ(DLB_SOCKET_OK, dlb_http_client_post(&client, "text/plain", 0, &err));
+        ASSERT_EQ(DLB_SOCKET_OK, dlb_http_client_send(&client, (char*)body.data(), body.size(), &err));
+        ASSERT_EQ(DLB_SOCKET_OK, dlb_http_client_end_request(&client, &err));
+    }
+    for (unsigned int i = 0; i != DEPTH; ++i)
+    {
+        response.clear();
+        ASSERT_EQ(DLB_SOCKET_OK, dlb_http_client_read(&client, GotData, &response));
+        EXPECT_EQ("ack " + std::to_string(i), response);
+    }
+    EXPECT_EQ(1u, client.connections);
+    dlb_http_client_close(&client);
+
+    std::vector<std::string> bodies = Bodies();
+    ASSERT_EQ(DEPTH, bodies.size());
+    EXPECT_EQ("pipelined 15", bodies[15]);
+}
+
+
+/* a chunked body much larger than the old line buffer arrives whole */
+TEST_F(DlbSocketHttpServer01, LargeChunkedBody)
+{
+    const size_t SIZE = 3 * 1024 * 1024 + 17;
+    const size_t PIECE = 60000;
+    dlb_http_client client;
+    std::string body;
+    std::string response;
+    int err;
+
+    for (size_t i = 0; i != SIZE; ++i)
+    {
+        body.push_back((char)('a' + (i * 7) % 26));
+    }
+
+    StartServer(16);
+    memset(&client, '\0', sizeof(client));
+    ASSERT_EQ(DLB_SOCKET_OK, dlb_http_client_open2(&client, Url().c_str(), 1, &err));
+    ASSERT_EQ(DLB_SOCKET_OK, dlb_http_client_post(&client, "text/xml", 0, &err));
+    for (size_t pos = 0; pos < SIZE; pos += PIECE)
+    {
+        size_t len = SIZE - pos < PIECE ? SIZE - pos : PIECE;
+        ASSERT_EQ(DLB_SOCKET_OK, dlb_http_client_send(&client, (char*)body.data() + pos, len, &err));
+    }
+    ASSERT_EQ(DLB_SOCKET_OK, dlb_http_client_read(&client, GotData, &response));
+    EXPECT_EQ("ack 0", response);
+
+    /* and the connection is still good for small requests afterwards */
+    ASSERT_EQ(DLB_SOCKET_OK, Exchange(&client, "small", response));
+    EXPECT_EQ("ack 1", response);
+    EXPECT_EQ(1u, client.connections);
+    dlb_http_client_close(&client);
+
+    std::vector<std::string> bodies = Bodies();
+    ASSERT_EQ(2u, bodies.size());
+    EXPECT_EQ(SIZE, bodies[0].size());
+    EXPECT_TRUE(body == bodies[0]);
+}
+
+
+/* a client that stalls half way through a request holds up nobody else */
+TEST_F(DlbSocketHttpServer01, SlowSenderDoesNotBlockOthers)
+{
+    dlb_http_client client;
+    std::string response;
+    int err;
+
+    StartServer(16);
+    dlb_socket slow = Connect();
+    ASSERT_TRUE(Write(slow, "POST /md HTTP/1.1\r\nContent-Type: text/plain\r\nContent-Len"));
+
+    memset(&client, '\0', sizeof(client));
+    ASSERT_EQ(DLB_SOCKET_OK, dlb_http_client_open2(&client, Url().c_str(), 1, &err));
+    for (unsigned int i = 0; i != 10; ++i)
+    {
+        ASSERT_EQ(DLB_SOCKET_OK, Exchange(&client, "fast", response)) << "request " << i;
+    }
+
+    ASSERT_TRUE(Write(slow, "gth: 4\r\n\r\nsl"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(DLB_SOCKET_OK, Exchange(&client, "fast", response));
+    EXPECT_EQ("ack 10", response);
+
+    ASSERT_TRUE(Write(slow, "ow"));
+    response = ReadResponse(slow);
+    EXPECT_EQ(0u, response.find("HTTP/1.1 200 OK\r\n"));
+    EXPECT_NE(std::string::npos, response.find("\r\n\r\nack 11"));
+    dlb_socket_close(slow);
+    dlb_http_client_close(&client);
+
+    std::vector<std::string> bodies = Bodies();
+    ASSERT_EQ(12u, bodies.size());
+    EXPECT_EQ("slow", bodies[11]);
+}
+
+
+/* more clients than the server takes at once are served in turn */
+TEST_F(DlbSocketHttpServer01, ManyConcurrentClients)
+{
+    const unsigned int CLIENTS = 48;
+    const unsigned int REQUESTS = 20;
+    std::vector<std::thread> clients;
+    std::atomic<unsigned int> good(0);
+
+    StartServer(8);
+    for (unsigned int c = 0; c != CLIENTS; ++c)
+    {
+        clients.push_back(std::thread([&good, c]()
+        {
+            dlb_http_client client;
+            std::string response;
+            int err;
+
+            memset(&client, '\0', sizeof(client));
+            if (DLB_SOCKET_OK != dlb_http_client_open2(&client, Url().c_str(), 1, &err))
+            {
+                return;
+            }
+            for (unsigned int i = 0; i != REQUESTS; ++i)
+            {
+                std::string body = "client " + std::to_string(c) + " request " + std::to_string(i);
+                if (DLB_SOCKET_OK == Exchange(&client, body, response) && 0 == response.find("ack "))
+                {
+                    ++good;
+                }
+            }
+            dlb_http_client_close(&client);
+        }));
+    }
+    for (std::vector<std::thread>::iterator t = clients.begin(); t != clients.end(); ++t)
+    {
+        t->join();
+    }
+
+    EXPECT_EQ(CLIENTS * REQUESTS, good.load());
+    EXPECT_EQ(CLIENTS * REQUESTS, Bodies().size());
+}
+
+
+TEST_F(DlbSocketHttpServer01, DeclinedRequestGets404)
+{
+    StartServer(4);
+    dlb_socket s = Connect();
+
+    ASSERT_TRUE(Write(s, "POST /md HTTP/1.1\r\nContent-Length: 7\r\n\r\nmissing"));
+    std::string response = ReadResponse(s);
+    EXPECT_EQ(0u, response.find("HTTP/1.1 404 Not Found\r\n"));
+    EXPECT_NE(std::string::npos, response.find("Content-Length: 0\r\n"));
+
+    /* the connection survives for the next request */
+    ASSERT_TRUE(Write(s, "POST /md HTTP/1.1\r\nContent-Length: 5\r\n\r\nfound"));
+    response = ReadResponse(s);
+    EXPECT_EQ(0u, response.find("HTTP/1.1 200 OK\r\n"));
+    dlb_socket_close(s);
+}
+
+
+TEST_F(DlbSocketHttpServer01, OversizedBodyRefused)
+{
+    StartServer(4);
+    dlb_socket s = Connect();
+
+    ASSERT_TRUE(Write(s, "POST /md HTTP/1.1\r\nContent-Length: "
+                      + std::to_string(DLB_HTTP_SERVER_MAX_BODY + 1) + "\r\n\r\n"));
+    std::string response = ReadResponse(s);
+    EXPECT_EQ(0u, response.find("HTTP/1.1 413 Payload Too Large\r\n"));
+    EXPECT_NE(std::string::npos, response.find("Connection: close\r\n"));
+    EXPECT_TRUE(Closed(s));
+    dlb_socket_close(s);
+    EXPECT_EQ(0u, Bodies().size());
+}
+
+
+TEST_F(DlbSocketHttpServer01, ClientAskingToCloseIsClosed)
+{
+    StartServer(4);
+    dlb_socket s = Connect();
+
+    ASSERT_TRUE(Write(s, "POST /md HTTP/1.1\r\nConnection: close\r\nContent-Length: 3\r\n\r\nbye"));
+    std::string response = ReadResponse(s);
+    EXPECT_EQ(0u, response.find("HTTP/1.1 200 OK\r\n"));
+    EXPECT_NE(std::string::npos, response.find("Connection: close\r\n"));
+    EXPECT_TRUE(Closed(s));
+    dlb_socket_close(s);
+}
@@ -0,0 +1,220 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#define _SILENCE_TR1_NAMESPACE_DEPRECATION_WARNING
+
+#include "gtest/gtest.h"
+
+#include "dlb_pmd/include/dlb_pmd_api.h"
+#include "dlb_pmd/include/dlb_pmd_generate.h"
+#include "dlb_pmd/frontend/pmd_realtime/snapshot_queue.h"
+
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/* The producer queues copies of a handful of generated models, tagging
+ * each with a frame number that picks the model.  The consumer checks
+ * that it sees frames in increasing order, that every snapshot matches
+ * the model its frame number names, and that every frame is either
+ * delivered, coalesced or dropped.  Even reading a model sets its error
+ * state, so the consumer compares against its own copies of the models.
+ */
+class PmdRealtimeSnapshotQueue01 : public testing::Test
+{
+protected:
+    static const unsigned int NUM_MODELS = 4;
+
+    dlb_pmd_model *mModels[NUM_MODELS];
+    dlb_pmd_model *mExpected[NUM_MODELS];
+    snapshot_queue *mQueue;
+
+    virtual void SetUp()
+    {
+        dlb_pmd_metadata_count counts;
+        unsigned int i;
+
+        memset(&counts, '\0', sizeof(counts));
+        counts.num_signals       = PMD_GENERATE_RANDOM_NUMBER;
+        counts.num_beds          = PMD_GENERATE_RANDOM_NUMBER;
+        counts.num_objects       = PMD_GENERATE_RANDOM_NUMBER;
+        counts.num_presentations = PMD_GENERATE_RANDOM_NUMBER;
+        counts.num_loudness      = PMD_GENERATE_RANDOM_NUMBER;
+
+        for (i = 0; i != NUM_MODELS; ++i)
+        {
+            mModels[i] = NULL;
+            dlb_pmd_init(&mModels[i], NULL);
+            mExpected[i] = NULL;
+            dlb_pmd_init(&mExpected[i], NULL);
+            ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS,
+                      dlb_pmd_generate_random(mModels[i], &counts, i + 1, 0, 0));
+            ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_copy(mExpected[i], mModels[i]));
+        }
+        mQueue = NULL;
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, snapshot_queue_init(&mQueue));
+    }
+
+    virtual void TearDown()
+    {
+        unsigned int i;
+
+        snapshot_queue_finish(mQueue);
+        for (i = 0; i != NUM_MODELS; ++i)
+        {
+            dlb_pmd_finish(mModels[i]);
+            dlb_pmd_finish(mExpected[i]);
+        }
+    }
+
+    dlb_pmd_success Push(unsigned int frame)
+    {
+        return snapshot_queue_push(mQueue, mModels[frame % NUM_MODELS], frame);
+    }
+
+    void ExpectNext(unsigned int frame)
+    {
+        snapshot_slot *slot = snapshot_queue_claim(mQueue);
+
+        ASSERT_NE(nullptr, slot);
+        EXPECT_EQ(frame, slot->frame);
+        EXPECT_EQ((dlb_pmd_success)PMD_SUCCESS,
+                  dlb_pmd_equal(slot->snapshot.model, mExpected[frame % NUM_MODELS], 0, 0)) << "frame " << frame;
+        snapshot_queue_release(mQueue, slot);
+    }
+};
+
+TEST_F(PmdRealtimeSnapshotQueue01, DeliversInOrder)
+{
+    unsigned int frame;
+
+    EXPECT_EQ(nullptr, snapshot_queue_claim(mQueue));
+    for (frame = 0; frame != 3 * SNAPSHOT_QUEUE_DEPTH; frame += 2)
+    {
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, Push(frame));
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, Push(frame + 1));
+        ExpectNext(frame);
+        ExpectNext(frame + 1);
+        EXPECT_EQ(nullptr, snapshot_queue_claim(mQueue));
+    }
+    EXPECT_EQ(0ul, snapshot_queue_coalesced(mQueue));
+    EXPECT_EQ(0ul, snapshot_queue_dropped(mQueue));
+}
+
+TEST_F(PmdRealtimeSnapshotQueue01, CoalescesWhenFull)
+{
+    unsigned int frame;
+
+    for (frame = 0; frame != SNAPSHOT_QUEUE_DEPTH + 3; ++frame)
+    {
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, Push(frame));
+    }
+    EXPECT_EQ(3ul, snapshot_queue_coalesced(mQueue));
+    EXPECT_EQ(0ul, snapshot_queue_dropped(mQueue));
+
+    /* the oldest snapshots survive, and the newest wins the last slot */
+    for (frame = 0; frame != SNAPSHOT_QUEUE_DEPTH - 1; ++frame)
+    {
+        ExpectNext(frame);
+    }
+    ExpectNext(SNAPSHOT_QUEUE_DEPTH + 2);
+    EXPECT_EQ(nullptr, snapshot_queue_claim(mQueue));
+
+    /* and the queue carries on normally afterwards */
+    ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, Push(100));
+    ExpectNext(100);
+}
+
+TEST_F(PmdRealtimeSnapshotQueue01, SlowConsumer)
+{
+    static const unsigned int NUM_FRAMES = 5000;
+    std::atomic<bool> done(false);
+    unsigned int delivered = 0;
+    unsigned int last = 0;
+    unsigned int backwards = 0;
+    unsigned int mismatched = 0;
+
+    std::thread producer([this, &done]()
+    {
+        unsigned int frame;
+        for (frame = 1; frame <= NUM_FRAMES; ++frame)
+        {
+            (void)Push(frame);
+            if (0 == frame % 64)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+        done = true;
+    });
+
+    for (;;)
+    {
+        bool finished = done;
+        snapshot_slot *slot;
+
+        while (NULL != (slot = snapshot_queue_claim(mQueue)))
+        {
+            if (slot->frame <= last)
+            {
+                ++backwards;
+            }
+            if (dlb_pmd_equal(slot->snapshot.model, mExpected[slot->frame % NUM_MODELS], 0, 0))
+            {
+                ++mismatched;
+            }
+            last = slot->frame;
+            ++delivered;
+            /* an egress that is much slower than the producer */
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            snapshot_queue_release(mQueue, slot);
+        }
+        if (finished)
+        {
+            break;
+        }
+        std::this_thread::yield();
+    }
+    producer.join();
+
+    EXPECT_EQ(0u, backwards);
+    EXPECT_EQ(0u, mismatched);
+    EXPECT_EQ(NUM_FRAMES, last);
+    EXPECT_LT(0ul, snapshot_queue_coalesced(mQueue));
+    EXPECT_EQ((unsigned long)NUM_FRAMES,
+              delivered + snapshot_queue_coalesced(mQueue) + snapshot_queue_dropped(mQueue));
+}
@@ -0,0 +1,195 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#define _SILENCE_TR1_NAMESPACE_DEPRECATION_WARNING
+
+#include "gtest/gtest.h"
+#include "dlb_pmd/frontend/pmd_studio/ring_buffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/* Editors hammer a set of ring buffers while a simulated 1 ms audio
+ * callback reads them.  Every commit fills its buffer with a single
+ * value, larger than any earlier one on that ring, so a reader that
+ * sees a mixture of values within one data buffer, or a value going
+ * backwards, has caught the hand-off sharing a buffer.
+ */
+class PmdStudioRingBuffer01 : public testing::Test
+{
+protected:
+    static const unsigned int NUM_CHANNELS = 16;
+    static const unsigned int NUM_PCM_RINGS = 3;
+    static const unsigned int PCM_RING_CHANNELS = 2;
+    static const unsigned int DATA_CHANNEL = 8;
+    static const unsigned int RECONFIGURED_CHANNEL = 10;
+    static const unsigned int CALLBACK_FRAMES = 48;
+    static const unsigned int TEST_DURATION_MS = 1000;
+};
+
+const unsigned int PmdStudioRingBuffer01::TEST_DURATION_MS;
+
+TEST_F(PmdStudioRingBuffer01, EditsRaceCallback)
+{
+    PMDStudioRingBufferList list(NUM_CHANNELS);
+    std::vector<int32_t> output(CALLBACK_FRAMES * NUM_CHANNELS);
+    std::vector<uint32_t> data(MAX_DATA_BYTES / sizeof(uint32_t));
+    std::vector<std::thread> editors;
+    std::atomic<bool> running(true);
+    std::chrono::steady_clock::duration worst(0);
+    uint32_t lastPcm[NUM_PCM_RINGS] = { 0 };
+    uint32_t lastData = 0;
+    unsigned int pcmBackwards = 0;
+    unsigned int dataTorn = 0;
+    unsigned int dataBackwards = 0;
+    unsigned int dataReads = 0;
+    unsigned int callbacks = 0;
+    unsigned int i;
+
+    for (i = 0; i < NUM_PCM_RINGS; i++)
+    {
+        list.AddRingBuffer(i * PCM_RING_CHANNELS, PCM_RING_CHANNELS, FPS_60);
+    }
+    list.AddRingBuffer(DATA_CHANNEL, 1, INVALID_FRAME_RATE);
+    list.AddRingBuffer(RECONFIGURED_CHANNEL, PCM_RING_CHANNELS, FPS_50);
+
+    for (i = 0; i < NUM_PCM_RINGS; i++)
+    {
+        editors.push_back(std::thread([&list, &running, i]()
+        {
+            uint32_t value = 0;
+            while (running.load())
+            {
+                unsigned int sizeBytes;
+                uint32_t *buf = (uint32_t *)list.GetBufferForUpdate(i * PCM_RING_CHANNELS, sizeBytes);
+                std::fill(buf, buf + sizeBytes / sizeof(uint32_t), ++value);
+                list.CommitUpdate(i * PCM_RING_CHANNELS);
+            }
+        }));
+    }
+
+    editors.push_back(std::thread([&list, &running]()
+    {
+        uint32_t value = 0;
+        unsigned int n = 1;
+        while (running.load())
+        {
+            unsigned int sizeBytes;
+            uint32_t *buf = (uint32_t *)list.GetBufferForUpdate(DATA_CHANNEL, sizeBytes);
+            /* vary the committed size, as S-ADM payloads do */
+            n = (n % (sizeBytes / sizeof(uint32_t))) + 1;
+            std::fill(buf, buf + n, ++value);
+            list.CommitUpdate(DATA_CHANNEL, n * sizeof(uint32_t));
+        }
+    }));
+
+    editors.push_back(std::thread([&list, &running]()
+    {
+        while (running.load())
+        {
+            list.DeleteRingBuffer(RECONFIGURED_CHANNEL);
+            list.AddRingBuffer(RECONFIGURED_CHANNEL, PCM_RING_CHANNELS, FPS_50);
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }));
+
+    std::chrono::steady_clock::time_point tick = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point end = tick + std::chrono::milliseconds(TEST_DURATION_MS);
+    while (tick < end)
+    {
+        tick += std::chrono::milliseconds(1);
+        std::this_thread::sleep_until(tick);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        list.WriteRingBuffers(&output[0], NUM_CHANNELS, CALLBACK_FRAMES);
+        unsigned int bytes = list.CopyEntireActiveBufferBytes(DATA_CHANNEL, &data[0]);
+        worst = std::max(worst, std::chrono::steady_clock::now() - start);
+        ++callbacks;
+
+        for (unsigned int f = 0; f < CALLBACK_FRAMES; f++)
+        {
+            for (unsigned int r = 0; r < NUM_PCM_RINGS; r++)
+            {
+                for (unsigned int c = 0; c < PCM_RING_CHANNELS; c++)
+                {
+                    uint32_t v = (uint32_t)output[f * NUM_CHANNELS + r * PCM_RING_CHANNELS + c];
+                    if (v < lastPcm[r])
+                    {
+                        ++pcmBackwards;
+                    }
+                    lastPcm[r] = v;
+                }
+            }
+        }
+
+        if (bytes)
+        {
+            unsigned int n = bytes / sizeof(uint32_t);
+            ++dataReads;
+            if (std::count(data.begin(), data.begin() + n, data[0]) != (std::ptrdiff_t)n)
+            {
+                ++dataTorn;
+            }
+            if (data[0] < lastData)
+            {
+                ++dataBackwards;
+            }
+            lastData = data[0];
+        }
+    }
+
+    running.store(false);
+    for (std::vector<std::thread>::iterator t = editors.begin(); t != editors.end(); ++t)
+    {
+        t->join();
+    }
+
+    long long worstUs = std::chrono::duration_cast<std::chrono::microseconds>(worst).count();
+    RecordProperty("callbacks", callbacks);
+    RecordProperty("worst_callback_us", (int)worstUs);
+
+    EXPECT_EQ(0u, pcmBackwards);
+    EXPECT_EQ(0u, dataTorn);
+    EXPECT_EQ(0u, dataBackwards);
+    EXPECT_LT(0u, dataReads);
+    for (i = 0; i < NUM_PCM_RINGS; i++)
+    {
+        EXPECT_LT(0u, lastPcm[i]) << "ring " << i;
+    }
+}
@@ -0,0 +1,202 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * Copyright (c) 2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#define _SILENCE_TR1_NAMESPACE_DEPRECATION_WARNING
+
+#include "gtest/gtest.h"
+
+#include "dlb_pmd/include/dlb_pmd_api.h"
+#include "dlb_pmd/include/dlb_pmd_xml_string.h"
+#include "dlb_pmd/include/dlb_pmd_model_combo.h"
+#include "test_data.h"
+
+extern "C"
+{
+#include "dlb_wave/include/dlb_wave_int.h"
+#include "dlb_pmd/frontend/pmd_tool/pcm.h"
+}
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+/* pmd_tool converts a single file without a workspace, so pcm_read and
+ * pcm_write allocate and free their augmentor or extractor memory per
+ * call.  Batch mode passes a workspace instead.  Both must carry a model
+ * through a wave file unchanged, apart from the IAT timestamp, which the
+ * augmentor advances every frame.
+ */
+class PmdToolPcm01 : public testing::Test
+{
+protected:
+    static const unsigned int NUM_CHANNELS = 2;
+    static const unsigned int BIT_DEPTH = 32;
+    static const size_t NUM_SAMPLES = 48000;    // 25 frames at 25 fps
+
+    dlb_pmd_model_combo *mWritten;
+    dlb_pmd_model_combo *mRead;
+
+    virtual void SetUp()
+    {
+        mWritten = NULL;
+        mRead = NULL;
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_model_combo_init(&mWritten, NULL, NULL, PMD_FALSE, NULL));
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_model_combo_init(&mRead, NULL, NULL, PMD_FALSE, NULL));
+        WriteSilence("pmd_tool_pcm_01_in.wav");
+    }
+
+    virtual void TearDown()
+    {
+        dlb_pmd_model_combo_destroy(&mWritten);
+        dlb_pmd_model_combo_destroy(&mRead);
+        remove("pmd_tool_pcm_01_in.wav");
+        remove("pmd_tool_pcm_01_out.wav");
+        remove("pmd_tool_pcm_01_pipe.wav");
+    }
+
+    static std::vector<unsigned char> ReadBytes(const char *filename)
+    {
+        std::vector<unsigned char> bytes;
+        FILE *f = fopen(filename, "rb");
+        int c;
+
+        if (f)
+        {
+            while ((c = fgetc(f)) != EOF)
+            {
+                bytes.push_back((unsigned char)c);
+            }
+            fclose(f);
+        }
+        return bytes;
+    }
+
+    void WriteSilence(const char *filename)
+    {
+        std::vector<uint32_t> samples(NUM_SAMPLES * NUM_CHANNELS, 0);
+        void *ppdata[NUM_CHANNELS];
+        dlb_buffer buffer;
+        dlb_wave_file out;
+
+        ASSERT_EQ(DLB_RIFF_OK, dlb_wave_open_write(&out, filename, 0, 48000, NUM_CHANNELS, 0, BIT_DEPTH));
+        ASSERT_EQ(DLB_RIFF_OK, dlb_wave_begin_data(&out));
+
+        ppdata[0] = &samples[0];
+        ppdata[1] = &samples[1];
+        buffer.data_type = DLB_BUFFER_INT_LEFT;
+        buffer.nchannel = NUM_CHANNELS;
+        buffer.nstride = NUM_CHANNELS;
+        buffer.ppdata = ppdata;
+        EXPECT_EQ(0, dlb_wave_int_write(&out, &buffer, NUM_SAMPLES));
+
+        EXPECT_EQ(DLB_RIFF_OK, dlb_wave_end_data(&out));
+        dlb_wave_close(&out);
+    }
+
+    void Load(dlb_pmd_model_combo *combo)
+    {
+        dlb_pmd_model *m;
+
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_model_combo_get_writable_pmd_model(combo, &m, PMD_FALSE));
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS,
+                  dlb_xmlpmd_string_read(stereo_2D_PMD, strlen(stereo_2D_PMD), m, PMD_TRUE, NULL, NULL, NULL));
+    }
+
+    void RoundTrip(pcm_workspace *ws)
+    {
+        const dlb_pmd_model *written;
+        const dlb_pmd_model *read;
+
+        ASSERT_EQ(0, pcm_write("pmd_tool_pcm_01_in.wav", "pmd_tool_pcm_01_out.wav", DLB_PMD_FRAMERATE_2500,
+                               0, PMD_TRUE, DLB_PMD_KLV_UL_ST2109, PMD_FALSE, PMD_FALSE,
+                               0, PMD_FALSE, ws, mWritten));
+        ASSERT_EQ(0, pcm_read("pmd_tool_pcm_01_out.wav", NULL, DLB_PMD_FRAMERATE_2500,
+                              0, PMD_TRUE, 0, 0, 0, PMD_FALSE, ws, mRead));
+
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_model_combo_get_readable_pmd_model(mWritten, &written, PMD_FALSE));
+        ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_model_combo_get_readable_pmd_model(mRead, &read, PMD_FALSE));
+        EXPECT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_equal3(read, written, 0, ~(uint32_t)PMD_EQUAL_MASK_IAT));
+    }
+};
+
+TEST_F(PmdToolPcm01, ReadWriteWithoutWorkspace)
+{
+    Load(mWritten);
+    RoundTrip(NULL);
+}
+
+TEST_F(PmdToolPcm01, ReadWriteWithWorkspace)
+{
+    pcm_workspace ws;
+
+    pcm_workspace_init(&ws);
+    Load(mWritten);
+    RoundTrip(&ws);
+    EXPECT_EQ((uint64_t)NUM_SAMPLES, ws.samples);
+    pcm_workspace_finish(&ws);
+}
+
+TEST_F(PmdToolPcm01, PipelineMatchesSerial)
+{
+    const dlb_pmd_model *serial;
+    const dlb_pmd_model *pipelined;
+    std::vector<unsigned char> serial_bytes;
+
+    /* the augmentor advances the model's IAT, so each write starts from a
+     * freshly loaded model; an odd block size makes blocks straddle frames
+     */
+    Load(mWritten);
+    Load(mRead);
+    ASSERT_EQ(0, pcm_write("pmd_tool_pcm_01_in.wav", "pmd_tool_pcm_01_out.wav", DLB_PMD_FRAMERATE_2500,
+                           0, PMD_TRUE, DLB_PMD_KLV_UL_ST2109, PMD_FALSE, PMD_FALSE,
+                           100, PMD_FALSE, NULL, mWritten));
+    ASSERT_EQ(0, pcm_write("pmd_tool_pcm_01_in.wav", "pmd_tool_pcm_01_pipe.wav", DLB_PMD_FRAMERATE_2500,
+                           0, PMD_TRUE, DLB_PMD_KLV_UL_ST2109, PMD_FALSE, PMD_FALSE,
+                           100, PMD_TRUE, NULL, mRead));
+
+    serial_bytes = ReadBytes("pmd_tool_pcm_01_out.wav");
+    ASSERT_FALSE(serial_bytes.empty());
+    EXPECT_TRUE(serial_bytes == ReadBytes("pmd_tool_pcm_01_pipe.wav"));
+
+    ASSERT_EQ(0, pcm_read("pmd_tool_pcm_01_out.wav", NULL, DLB_PMD_FRAMERATE_2500,
+                          0, PMD_TRUE, 0, 0, 100, PMD_FALSE, NULL, mWritten));
+    ASSERT_EQ(0, pcm_read("pmd_tool_pcm_01_out.wav", NULL, DLB_PMD_FRAMERATE_2500,
+                          0, PMD_TRUE, 0, 0, 100, PMD_TRUE, NULL, mRead));
+    ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_model_combo_get_readable_pmd_model(mWritten, &serial, PMD_FALSE));
+    ASSERT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_model_combo_get_readable_pmd_model(mRead, &pipelined, PMD_FALSE));
+    EXPECT_EQ((dlb_pmd_success)PMD_SUCCESS, dlb_pmd_equal3(pipelined, serial, 0, 0));
+}
@@ -0,0 +1,74 @@
+/************************************************************************
+ * dlb_pmd
+ * Copyright (c) 2021-2025, Dolby Laboratories Inc.
+ * Copyright (c) 2021-2025, Dolby International AB.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+#ifndef DLB_PMD_RANDOM_MODEL_H
+#define DLB_PMD_RANDOM_MODEL_H
+
+#include "dlb_pmd/include/dlb_pmd_api.h"
+#include "dlb_pmd/include/dlb_pmd_generate.h"
+
+#include <string.h>
+
+/**
+ * @brief reset a model and fill it with a random number of every kind
+ * of entity, reproducibly for a given seed
+ */
+static inline
+dlb_pmd_success
+GenerateRandomModel
+    (dlb_pmd_model *m          /**< [in] model to fill */
+    ,unsigned int seed         /**< [in] random seed */
+    ,bool loudness = true      /**< [in] include loudness payloads? */
+    )
+{
+    dlb_pmd_metadata_count counts;
+
+    memset(&counts, '\0', sizeof(counts));
+    counts.num_signals         = PMD_GENERATE_RANDOM_NUMBER;
+    counts.num_beds            = PMD_GENERATE_RANDOM_NUMBER;
+    counts.num_objects         = PMD_GENERATE_RANDOM_NUMBER;
+    counts.num_presentations   = PMD_GENERATE_RANDOM_NUMBER;
+    counts.num_loudness        = loudness ? PMD_GENERATE_RANDOM_NUMBER : 0;
+    counts.num_iat             = PMD_GENERATE_RANDOM_NUMBER;
+    counts.num_eac3            = PMD_GENERATE_RANDOM_NUMBER;
+    counts.num_ed2_turnarounds = PMD_GENERATE_RANDOM_NUMBER;
+    counts.num_headphone_desc  = PMD_GENERATE_RANDOM_NUMBER;
+
+    dlb_pmd_reset(m);
+    return dlb_pmd_generate_random(m, &counts, seed, 0, 0);
+}
+
+#endif /* DLB_PMD_RANDOM_MODEL_H */
@@ -36,6 +36,12 @@
 /**
  * @file dlb_http_client.h
  * @brief API for simple cross-platform HTTP client
+ *
+ * A client opened with #dlb_http_client_open2 and keep_alive set keeps
+ * its connection open between requests, and reconnects automatically
+ * before the next request if the server has closed it.  Requests may
+ * also be pipelined: finish each with #dlb_http_client_end_request, and
+ * then read the responses in order with #dlb_http_client_read.
  */
 
 #ifndef HTTP_CLIENT_H
@@ -52,6 +58,14 @@ extern "C" {
 #endif
 
 
+/**
+ * @def DLB_HTTP_CLIENT_BUFSIZE (8192)
+ * @brief size of the client's transmit and receive buffers; a response
+ * header must fit in the receive buffer
+ */
+#define DLB_HTTP_CLIENT_BUFSIZE (8192)
+
+
 /**
  * @brief encapsulation of stuff required by HTTP connection
  */
@@ -62,6 +76,17 @@ typedef struct
     char *filename;
     int port;
     int chunked;
+    int keep_alive;               /**< reuse the connection between requests? */
+    int connected;                /**< is the socket open? */
+    int request_open;             /**< has the current request not been ended yet? */
+    unsigned int pending;         /**< requests sent whose responses are still to be read */
+    unsigned int connections;     /**< number of connections made so far */
+    unsigned int responses;       /**< number of responses read so far */
+
+    size_t txlen;                 /**< bytes waiting in txbuf */
+    size_t rxlen;                 /**< bytes received but not yet consumed in rxbuf */
+    char txbuf[DLB_HTTP_CLIENT_BUFSIZE];   /**< outgoing request data */
+    char rxbuf[DLB_HTTP_CLIENT_BUFSIZE+1]; /**< incoming response data, NUL-terminated */
 }  dlb_http_client;
     
     
@@ -79,6 +104,9 @@ void
 
 /**
  * @brief open an HTTP socket connection
+ *
+ * The connection is closed once the response to one request has been
+ * read.
  */
 dlb_socket_res                  /** @return success or failure */
 dlb_http_client_open
@@ -86,6 +114,23 @@ dlb_http_client_open
     ,const char *uri            /**< [in] URI */
     ,int *err                   /**< [out] OS-specific error code */
     );
+
+
+/**
+ * @brief open an HTTP socket connection, optionally keeping it alive
+ *
+ * If the connection fails, the client is still set up for the URI, and
+ * the next request will try to connect again.
+ */
+dlb_socket_res                  /** @return DLB_SOCKET_INVALID_ARG if the URI is not http://,
+                                  * DLB_SOCKET_LIBRARY_ERR if the connection failed,
+                                  * DLB_SOCKET_OK otherwise */
+dlb_http_client_open2
+    (dlb_http_client *http      /**< [in] http client */
+    ,const char *uri            /**< [in] URI */
+    ,int keep_alive             /**< [in] 1: reuse the connection for later requests */
+    ,int *err                   /**< [out] OS-specific error code */
+    );
     
 
 /**
@@ -144,8 +189,28 @@ dlb_http_client_send
     );
     
 
+/**
+ * @brief finish sending the current request without waiting for its response
+ *
+ * This lets several requests be pipelined on one connection before any
+ * of their responses are read.  #dlb_http_client_read ends the current
+ * request itself if this has not been called.
+ */
+dlb_socket_res                  /** @return success or failure */
+dlb_http_client_end_request
+    (dlb_http_client *http      /**< [in] http client */
+    ,int *err                   /**< [out] OS-specific error code */
+    );
+
+
 /**
  * @brief read response from an HTTP GET or HTTP POST message
+ *
+ * Responses are read in the order their requests were sent.  If the
+ * server rejects a request, its response is still read in full so that
+ * the connection can carry on; if the connection fails, or the server
+ * closes it, the responses to any requests still pending are lost, and
+ * #dlb_http_client::connected is cleared.
  */
 dlb_socket_res
 dlb_http_client_read
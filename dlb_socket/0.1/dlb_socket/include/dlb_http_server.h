@@ -36,6 +36,14 @@
 /**
  * @file dlb_http_server.h
  * @brief API for a very basic simple cross-platform HTTP server
+ *
+ * #dlb_http_server_run serves one connection at a time, one request per
+ * connection.  #dlb_http_server_run2 can instead serve many connections
+ * at once from a single thread, waiting on all of them with epoll (or
+ * poll where there is no epoll).  It keeps connections alive between
+ * requests, and gathers each request body as it arrives, so bodies are
+ * not limited to #LINESIZE.  Either way, the callback sees one complete
+ * request at a time.
  */
 
 #ifndef HTTP_SERVER_H
@@ -57,6 +65,12 @@ extern "C" {
 #define URI_SIZE (256)
 #define CT_SIZE (128)
 
+/**
+ * @def DLB_HTTP_SERVER_MAX_BODY
+ * @brief largest request body #dlb_http_server_run2 accepts
+ */
+#define DLB_HTTP_SERVER_MAX_BODY (16 * 1024 * 1024)
+
 /**
  * @brief encapsulation of HTTP request processing
  */
@@ -64,7 +78,8 @@ typedef struct
 {
     dlb_socket socket;           /**< current request socket */
 
-    char buf[LINESIZE];          /**< input buffer */
+    char *buf;                   /**< input buffer: request header, then as much
+                                  * of the body as has been read */
     char method[METHOD_SIZE];    /**< method, e.g., GET or POST */
     char uri[URI_SIZE];          /**< requested URI */
     char content_type[CT_SIZE];  /**< incoming/outgoing Content-Type field
@@ -74,6 +89,7 @@ typedef struct
     
     ssize_t buflen;              /**< length of actual data in buffer */
     char *body;                  /**< location of beginning of body in buf */
+    int body_complete;           /**< 1 if buf already holds the whole body */
 
     char *return_code;           /**< HTTP return code, e.g., "200 OK" */
     char *response_body;         /**< response body text */
@@ -115,6 +131,9 @@ typedef struct
 
 /**
  * @brief read more data off the HTTP connection
+ *
+ * If the request buffer already holds the whole body, there is nothing
+ * more to read, and this returns DLB_SOCKET_NO_DATA.
  */
 dlb_socket_res                    /** @return DLB_SOCKET_OK on success, otherwise failure */
 dlb_http_request_read
@@ -144,6 +163,30 @@ dlb_http_server_run
     );
 
 
+/**
+ * @brief run the http server, serving many connections at once
+ *
+ * This behaves like #dlb_http_server_run, except that up to
+ * @p max_connections connections are served concurrently, each kept
+ * alive for as many requests as the client sends, with pipelining.  A
+ * request is only handed to the callback once all of its body has
+ * arrived, so the body is in the request buffer, and
+ * #dlb_http_request_read has nothing more to give.  Bodies larger than
+ * #DLB_HTTP_SERVER_MAX_BODY are refused.
+ */
+dlb_socket_res                   /** @return return status */
+dlb_http_server_run2
+    (dlb_http_server *server     /**< [in] server struct managed by this function */
+    ,uint16_t port               /**< [in] local host port number */
+    ,unsigned int max_connections /**< [in] connections to serve at once, or 0 to
+                                   * behave exactly as #dlb_http_server_run */
+    ,dlb_http_server_guts cb     /**< [in] client code to process given request */
+    ,void *cbarg                 /**< [in] client argument to callback */
+    ,int *err                    /**< [out] OS-specific error code in case the
+                                   * server doesn't run */
+    );
+
+
 /**
  * @brief asynchronous stop function
  */
@@ -45,6 +45,10 @@
 #include <stddef.h>
 #include "dlb_socket_os_impl.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef dlb_socket_os_impl dlb_socket;
 
 
@@ -99,6 +103,26 @@ dlb_socket_create_stream_server
     );
 
 
+/**
+ * @brief create a (TCP) stream server socket, with a given connection backlog
+ *
+ * #dlb_socket_create_stream_server lets only one connection wait to be
+ * accepted; a server handling many clients at once should allow more,
+ * e.g. SOMAXCONN.
+ */
+dlb_socket_res /** @return DLB_SOCKET_INVALID_ARG if arguments are wrong
+                *          DLB_SOCKET_LIBRARY_ERR if system could not create
+                *          DLB_SOCKET_OK          on success 
+                */
+dlb_socket_create_stream_server2
+    (dlb_socket* p_socket   /**< [out] socket to create */
+    ,const char* iface      /**< [in] interface to listen on, NULL for default */
+    ,int local_port         /**< [in] local port to listen on */
+    ,int backlog            /**< [in] most connections waiting to be accepted */
+    ,int* err               /**< [out] sytem error code upon failure */
+    );
+
+
 /**
  * @brief accept a stream socket connection on given server socket
  *
@@ -136,7 +160,8 @@ dlb_socket_accept
  * server.  For instance, if we were writing a web-browser, we should
  * use this call to attempt connection to a given web-server address.
  *
- * This call will create a socket. 
+ * This call will create a socket, which is closed again if the
+ * connection fails.
  *
  * @note DNS resolution should be done outside this call
  *
@@ -208,8 +233,27 @@ dlb_socket_open_datagram
     );
 
 
+/**
+ * @brief send small writes to a stream socket straight away
+ *
+ * This disables Nagle's algorithm, so that a request-response protocol
+ * sending several small writes before waiting for a reply does not stall
+ * waiting for the peer's delayed acknowledgement.
+ */
+dlb_socket_res                     /** @return DLB_SOCKET_INVALID_ARG
+                                    *          DLB_SOCKET_LIBRARY_ERR
+                                    *        or DLB_SOCKET_OK
+                                    */
+dlb_socket_set_nodelay
+   (dlb_socket socket             /**< [in] stream socket */
+   ,int* err                      /**< [out] system-level error code */
+   );
+
+
 /**
  * @brief write data to a stream socket
+ *
+ * All of the data is written, even if the OS accepts it in pieces.
  */
 dlb_socket_res                     /** @return DLB_SOCKET_INVALID_ARG
                                     *          DLB_SOCKET_LIBRARY_ERR
@@ -223,6 +267,29 @@ dlb_socket_stream_write
    );
 
 
+/**
+ * @brief write data to a stream socket, optionally without blocking
+ *
+ * In blocking mode this is #dlb_socket_stream_write.  In non-blocking
+ * mode it writes as much as the socket will take straight away, which
+ * may be less than all of it.
+ */
+dlb_socket_res                     /** @return DLB_SOCKET_INVALID_ARG
+                                    *          DLB_SOCKET_LIBRARY_ERR
+                                    *          DLB_SOCKET_NO_DATA if nothing could be
+                                    *            written without blocking
+                                    *        or DLB_SOCKET_OK
+                                    */
+dlb_socket_stream_write2
+   (dlb_socket socket             /**< [in] socket to write to */
+   ,void* buff                    /**< [in] data to write */
+   ,size_t send_len               /**< [in] size of data in bytes */
+   ,size_t* sent                  /**< [out] number of bytes written */
+   ,dlb_socket_mode mode          /**< [in] blocking or non-blocking */
+   ,int* err                      /**< [out] system-level error code */
+   );
+
+
 /**
  * @brief write data to a datagram socket
  */
@@ -395,4 +462,8 @@ dlb_socket_pair
     );
 
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* dlb_socket_H */
@@ -40,6 +40,7 @@
 #include <string.h>
 #include <limits.h>
 #include <assert.h>
+#include <ctype.h>
 
 #ifdef _MSC_VER
 #  define snprintf _snprintf
@@ -56,6 +57,207 @@
 #endif
 
 
+/**
+ * @brief drop the connection, and with it any responses still pending
+ */
+static
+void
+client_disconnect
+    (dlb_http_client *client
+    )
+{
+    if (client->connected)
+    {
+        dlb_socket_close(client->socket);
+        client->connected = 0;
+    }
+    client->request_open = 0;
+    client->pending = 0;
+    client->txlen = 0;
+    client->rxlen = 0;
+}
+
+
+/**
+ * @brief make sure there is a usable connection before sending a request
+ *
+ * An idle kept-alive connection has nothing to read, so if the socket is
+ * readable the server has closed it (or sent something unasked for), and
+ * we reconnect rather than find out after sending the request.
+ */
+static
+dlb_socket_res
+client_connect
+    (dlb_http_client *client
+    ,int *err
+    )
+{
+    dlb_socket_res res;
+
+    if (client->connected && !client->pending && !client->request_open)
+    {
+        int ready;
+
+        if (client->rxlen
+            || DLB_SOCKET_NO_DATA != dlb_socket_select(&client->socket, NULL, 1, 0, 0, &ready, err))
+        {
+            TRACE(("HTTP CLIENT: idle connection closed by server\n"));
+            client_disconnect(client);
+        }
+    }
+
+    if (client->connected)
+    {
+        return DLB_SOCKET_OK;
+    }
+
+    res = dlb_socket_connect(&client->socket, client->hostname, client->port, NULL, err);
+    TRACE(("HTTP CLIENT: connect status res:%d err:%d\n", res, *err));
+    if (DLB_SOCKET_OK == res)
+    {
+        (void)dlb_socket_set_nodelay(client->socket, err);
+        client->connected = 1;
+        client->connections += 1;
+        client->pending = 0;
+        client->txlen = 0;
+        client->rxlen = 0;
+    }
+    return res;
+}
+
+
+/**
+ * @brief send everything buffered for transmission
+ */
+static
+dlb_socket_res
+client_flush
+    (dlb_http_client *client
+    ,int *err
+    )
+{
+    dlb_socket_res res = DLB_SOCKET_OK;
+
+    if (client->txlen)
+    {
+        res = dlb_socket_stream_write(client->socket, client->txbuf, client->txlen, err);
+        client->txlen = 0;
+        if (DLB_SOCKET_OK != res)
+        {
+            client_disconnect(client);
+        }
+    }
+    return res;
+}
+
+
+/**
+ * @brief buffer data for transmission, so that small pieces of a request
+ * go out together
+ */
+static
+dlb_socket_res
+client_write
+    (dlb_http_client *client
+    ,const char *data
+    ,size_t len
+    ,int *err
+    )
+{
+    dlb_socket_res res;
+
+    if (!client->connected)
+    {
+        return DLB_SOCKET_INVALID_ARG;
+    }
+    if (client->txlen + len > sizeof(client->txbuf))
+    {
+        res = client_flush(client, err);
+        if (DLB_SOCKET_OK != res)
+        {
+            return res;
+        }
+        if (len > sizeof(client->txbuf))
+        {
+            res = dlb_socket_stream_write(client->socket, (void*)data, len, err);
+            if (DLB_SOCKET_OK != res)
+            {
+                client_disconnect(client);
+            }
+            return res;
+        }
+    }
+    memcpy(client->txbuf + client->txlen, data, len);
+    client->txlen += len;
+    return DLB_SOCKET_OK;
+}
+
+
+/**
+ * @brief read more of the response into the receive buffer
+ */
+static
+dlb_socket_res
+client_fill
+    (dlb_http_client *client
+    ,int *err
+    )
+{
+    dlb_socket_res res;
+    ssize_t sz;
+
+    if (client->rxlen >= DLB_HTTP_CLIENT_BUFSIZE)
+    {
+        return DLB_SOCKET_INVALID_ARG;
+    }
+    res = dlb_socket_read(client->socket, client->rxbuf + client->rxlen,
+                          DLB_HTTP_CLIENT_BUFSIZE - client->rxlen, &sz,
+                          DLB_SOCKET_BLOCKING, err);
+    if (DLB_SOCKET_OK != res || sz <= 0)
+    {
+        /* a zero-length read means the server closed the connection */
+        return DLB_SOCKET_OK == res ? DLB_SOCKET_NO_DATA : res;
+    }
+    client->rxlen += sz;
+    client->rxbuf[client->rxlen] = '\0';
+    return DLB_SOCKET_OK;
+}
+
+
+/**
+ * @brief find the value of a response header field
+ */
+static
+const char *                     /** @return start of value, or NULL if not present */
+find_header
+    (const char *header          /**< [in] start of the response header */
+    ,const char *end             /**< [in] end of the response header */
+    ,const char *name            /**< [in] field name, without colon */
+    )
+{
+    size_t len = strlen(name);
+    const char *line = strstr(header, "\r\n");
+
+    while (NULL != line && line < end)
+    {
+        const char *c = line + 2;
+        size_t i;
+
+        for (i = 0; i != len && tolower((unsigned char)c[i]) == tolower((unsigned char)name[i]); ++i)
+        {
+        }
+        if (i == len && c[len] == ':')
+        {
+            c += len + 1;
+            while (*c == ' ' || *c == '\t') ++c;
+            return c;
+        }
+        line = strstr(c, "\r\n");
+    }
+    return NULL;
+}
+
+
 dlb_socket_res
 dlb_http_client_open
     (dlb_http_client *client
@@ -63,23 +265,45 @@ dlb_http_client_open
     ,int *err
     )
 {
-    dlb_socket_res res;
+    return dlb_http_client_open2(client, uri, 0, err);
+}
+
+
+dlb_socket_res
+dlb_http_client_open2
+    (dlb_http_client *client
+    ,const char *uri
+    ,int keep_alive
+    ,int *err
+    )
+{
     char *c;
     char *port = "80";  /* default HTTP port */
-    int p;
     
     memset(client->hostname, '\0', sizeof(client->hostname));
+    client->keep_alive = keep_alive;
+    client->connected = 0;
+    client->request_open = 0;
+    client->pending = 0;
+    client->connections = 0;
+    client->responses = 0;
+    client->txlen = 0;
+    client->rxlen = 0;
     if (0 != strncmp("http://", uri, 7))
     {
-        return 0;
+        return DLB_SOCKET_INVALID_ARG;
     }
-    strncpy(client->hostname, uri+7, sizeof(client->hostname));
+    strncpy(client->hostname, uri+7, sizeof(client->hostname) - 1);
     client->filename = strchr(client->hostname, '/');
     if (client->filename)
     {
         *client->filename = '\0';
         client->filename++;
     }
+    else
+    {
+        client->filename = client->hostname + strlen(client->hostname);
+    }
 
     /* extract port */
     c = strchr(client->hostname, ':');
@@ -89,10 +313,8 @@ dlb_http_client_open
         port = c+1;
     }
 
-    p = atoi(port);
-    res = dlb_socket_connect(&client->socket, client->hostname, p, NULL, err);
-    TRACE(("HTTP CLIENT: connect status res:%d err:%d\n", res, *err));
-    return res;
+    client->port = atoi(port);
+    return client_connect(client, err);
 }
 
 
@@ -103,7 +325,7 @@ dlb_http_client_close
 {
     if (client != NULL)
     {
-        dlb_socket_close(client->socket);
+        client_disconnect(client);
     }
 }
 
@@ -117,8 +339,15 @@ dlb_http_client_get
     )
 {
     char sbuffer[1024];
+    dlb_socket_res res;
     size_t len;
 
+    res = client_connect(client, err);
+    if (DLB_SOCKET_OK != res)
+    {
+        return res;
+    }
+
     /* generate request */
     len = snprintf(sbuffer, sizeof(sbuffer),
                    "GET /%s HTTP/1.1\r\n"
@@ -126,7 +355,7 @@ dlb_http_client_get
                    "User-Agent: dlb_http_client\r\n"
                    "%s%s%s"
                    "%s%s%s"
-                   "Client: keep-alive\r\n\r\n",
+                   "Connection: %s\r\n\r\n",
                    client->filename, 
                    client->hostname,
                    NULL == range ? "" : "Range: ",
@@ -134,13 +363,19 @@ dlb_http_client_get
                    NULL == range ? "" : "\r\n",
                    NULL == content_type ? "" : "Content-Type: ",
                    NULL == content_type ? "" : content_type,
-                   NULL == content_type ? "" : "\r\n"
+                   NULL == content_type ? "" : "\r\n",
+                   client->keep_alive ? "keep-alive" : "close"
                    );
     
     TRACE(("HTTP-CLIENT: sending request:\n%s\n", sbuffer));
 
-    /* send request */
-    return dlb_socket_stream_write(client->socket, sbuffer, len, err);
+    /* send request; a GET has no body, so it is complete straight away */
+    client->chunked = 0;
+    client->request_open = 1;
+    res = client_write(client, sbuffer, len, err);
+    return DLB_SOCKET_OK == res
+        ? dlb_http_client_end_request(client, err)
+        : res;
 }
 
 
@@ -154,8 +389,15 @@ dlb_http_client_post
 {
     char sbuffer[1024];
     char clen[128];
+    dlb_socket_res res;
     size_t len;
 
+    res = client_connect(client, err);
+    if (DLB_SOCKET_OK != res)
+    {
+        return res;
+    }
+
     if (content_length)
     {
         snprintf(clen, sizeof(clen), "Content-Length: %u", (unsigned int)content_length);
@@ -174,6 +416,7 @@ dlb_http_client_post
                    "Host: %s\r\n"
                    "User-Agent: dlb_http_client\r\n"
                    "%s%s%s"
+                   "Connection: %s\r\n"
                    "%s\r\n"
                    "\r\n",
                    client->filename,
@@ -181,13 +424,15 @@ dlb_http_client_post
                    NULL == content_type ? "" : "Content-Type: ",
                    NULL == content_type ? "" : content_type,
                    NULL == content_type ? "" : "\r\n",
+                   client->keep_alive ? "keep-alive" : "close",
                    clen
                    );
     
     TRACE(("HTTP-CLIENT: sending request:\n%s\n", sbuffer));
 
     /* send request */
-    return dlb_socket_stream_write(client->socket, sbuffer, len, err);
+    client->request_open = 1;
+    return client_write(client, sbuffer, len, err);
 }
 
 
@@ -207,17 +452,49 @@ dlb_http_client_send
         TRACE_DATA(data, len);
         TRACE(("\r\n  --------------------------------\n"));
 
-        return dlb_socket_stream_write(http->socket, hdr, hdrlen, err)
-            || dlb_socket_stream_write(http->socket, data, len, err)
-            || dlb_socket_stream_write(http->socket, "\r\n", 2, err);
+        return client_write(http, hdr, hdrlen, err)
+            || client_write(http, data, len, err)
+            || client_write(http, "\r\n", 2, err);
     }
     else
     {
         TRACE(("HTTP CLIENT: posting \n%s\n --------------------------------\n", data));
-        return dlb_socket_stream_write(http->socket, data, len, err);        
+        return client_write(http, data, len, err);
     }
 }
-    
+
+
+dlb_socket_res
+dlb_http_client_end_request
+    (dlb_http_client *client
+    ,int *err
+    )
+{
+    dlb_socket_res res;
+
+    if (!client->request_open)
+    {
+        return DLB_SOCKET_INVALID_ARG;
+    }
+    client->request_open = 0;
+
+    if (client->chunked)
+    {
+        /* send terminating, 0-length chunk */
+        res = client_write(client, "0\r\n\r\n", 5, err);
+        if (DLB_SOCKET_OK != res)
+        {
+            printf("could not send terminating chunk: %d\n", *err);
+            return res;
+        }
+    }
+    res = client_flush(client, err);
+    if (DLB_SOCKET_OK == res)
+    {
+        client->pending += 1;
+    }
+    return res;
+}
 
 
 dlb_socket_res
@@ -228,82 +505,107 @@ dlb_http_client_read
     )
 {
     dlb_socket_res res;
-    char buffer[8196];
+    const char *field;
     char *datastart;
-    char *ok;
-    int datalength;
-    int datagot;
-    int err;
-    ssize_t sz;
+    size_t datalength;
+    size_t headerlength;
+    size_t datagot;
+    size_t avail;
+    int close_after;
+    int status_ok;
+    int err = 0;
 
-    if (client->chunked)
+    if (client->request_open)
     {
-        /* send terminating, 0-length chunk */
-        res = dlb_socket_stream_write(client->socket, "0\r\n\r\n", 5, &err);
+        res = dlb_http_client_end_request(client, &err);
         if (DLB_SOCKET_OK != res)
         {
-            printf("could not send terminating chunk: %d\n", err);
             return res;
         }
     }
-
-    /* now receive response */
-    memset(buffer, '\0', sizeof(buffer));
-    res = dlb_socket_read(client->socket, buffer, sizeof(buffer), &sz,
-                          DLB_SOCKET_BLOCKING, &err);
-    if (DLB_SOCKET_OK != res)
+    if (!client->connected || !client->pending)
     {
-        printf("dlb_http_client_read error: %d\n", err);
-        return res;
+        return DLB_SOCKET_INVALID_ARG;
     }
-    
-    TRACE(("HTTP CLIENT: received: \n%s\n --------------------------------\n", buffer));
-    /* check to make sure we've received the full header */
-    datastart = strstr(buffer, "\r\n\r\n");
-    if (datastart == NULL)
+
+    /* receive the whole response header; anything after it belongs to
+     * the body, or with pipelining, perhaps to the next response */
+    client->rxbuf[client->rxlen] = '\0';
+    while (NULL == (datastart = strstr(client->rxbuf, "\r\n\r\n")))
     {
-        printf("ERROR: did not receive HTTP header\n");
-        return DLB_SOCKET_LIBRARY_ERR;
+        res = client_fill(client, &err);
+        if (DLB_SOCKET_OK != res)
+        {
+            printf("dlb_http_client_read error: %d\n", err);
+            client_disconnect(client);
+            return DLB_SOCKET_OK == res ? DLB_SOCKET_LIBRARY_ERR : res;
+        }
     }
+    
+    TRACE(("HTTP CLIENT: received: \n%s\n --------------------------------\n", client->rxbuf));
+    datastart += 4;
+    headerlength = datastart - client->rxbuf;
 
-    ok = strstr(buffer, "HTTP/1.1 200 OK");
-    if (ok == NULL || ok > datastart)
+    status_ok = (0 == strncmp(client->rxbuf, "HTTP/1.1 200 OK", 15));
+    if (!status_ok)
     {
         printf("HTTP-CLIENT: ERROR: did not receive HTTP status 200 OK:\n\n");
-        printf("%s", buffer);
+        printf("%.*s", (int)headerlength, client->rxbuf);
         printf("\n\n");
-        return DLB_SOCKET_LIBRARY_ERR;
     }
-    
-    ok = strstr(buffer, "Content-Length:");
-    if (ok == NULL || ok > datastart)
+
+    field = find_header(client->rxbuf, datastart, "Content-Length");
+    if (NULL == field)
     {
         printf("HTTP-CLIENT: ERROR: did not receive Content-Length field\n");
+        client_disconnect(client);
         return DLB_SOCKET_LIBRARY_ERR;
     }
-    datalength = atoi(ok + 15);
+    datalength = (size_t)strtoul(field, NULL, 10);
 
-    /* skip \r\n\r\n terminator */
-    datastart += 4;
-    datagot = (buffer + sz) - datastart;
+    field = find_header(client->rxbuf, datastart, "Connection");
+    close_after = !client->keep_alive
+        || (NULL != field && 0 == strncmp(field, "close", 5));
 
-    if (cb)
+    /* consume the header, then the body, passing it on as it arrives */
+    avail = client->rxlen - headerlength;
+    memmove(client->rxbuf, datastart, avail);
+    client->rxlen = avail;
+    datagot = 0;
+    while (datagot < datalength)
     {
-        cb(cbarg, datastart, datagot);
-    
-        /* download remaining, if any */
-        while (datagot < datalength)
+        size_t take;
+
+        if (!client->rxlen)
         {
-            res = dlb_socket_read(client->socket, buffer, sizeof(buffer), &sz,
-                                  DLB_SOCKET_BLOCKING, &err);
+            res = client_fill(client, &err);
             if (DLB_SOCKET_OK != res)
             {
-                return res;
+                client_disconnect(client);
+                return DLB_SOCKET_OK == res ? DLB_SOCKET_LIBRARY_ERR : res;
             }
-            cb(cbarg, buffer, sz);
-            datagot += sz;
         }
+        take = client->rxlen;
+        if (take > datalength - datagot)
+        {
+            take = datalength - datagot;
+        }
+        if (cb && status_ok)
+        {
+            cb(cbarg, client->rxbuf, take);
+        }
+        datagot += take;
+        client->rxlen -= take;
+        memmove(client->rxbuf, client->rxbuf + take, client->rxlen);
     }
+    client->rxbuf[client->rxlen] = '\0';
+    client->pending -= 1;
+    client->responses += 1;
 
-    return DLB_SOCKET_OK;
+    if (close_after)
+    {
+        TRACE(("HTTP CLIENT: closing connection after response\n"));
+        client_disconnect(client);
+    }
+    return status_ok ? DLB_SOCKET_OK : DLB_SOCKET_LIBRARY_ERR;
 }
@@ -34,8 +34,11 @@
  **********************************************************************/
 
 #include "dlb_http_server.h"
+#include "dlb_socket_impl.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
 
 /**
  * @file dlb_http_server.c
@@ -75,10 +78,12 @@ parse_http_request_header
     char *ct;
     int err;
     
-    res = dlb_socket_read(request->socket, request->buf, sizeof(request->buf),
+    res = dlb_socket_read(request->socket, request->buf, LINESIZE - 1,
                           &request->buflen, DLB_SOCKET_BLOCKING, &err);
     if (DLB_SOCKET_OK == res)
     {
+        request->buf[request->buflen] = '\0';
+
         TRACE(("HTTP-SERVER: received request:\n%s\n\n", request->buf));
 
         /* extract method and uri from request */
@@ -92,7 +97,8 @@ parse_http_request_header
         /* skip the end of header */
         request->body += 4;
     
-        sscanf(request->buf, "%s %s", request->method, request->uri);
+        /* field widths are METHOD_SIZE-1 and URI_SIZE-1 */
+        sscanf(request->buf, "%15s %255s", request->method, request->uri);
         TRACE(("HTTP-SERVER: method: %s\n", request->method));
         TRACE(("HTTP-SERVER: uri: %s\n", request->uri));
 
@@ -163,6 +169,12 @@ dlb_http_request_read
     dlb_socket_res res;
     ssize_t sz;
 
+    if (request->body_complete)
+    {
+        *read = 0;
+        return DLB_SOCKET_NO_DATA;
+    }
+
     res = dlb_socket_read(request->socket, buffer, capacity, &sz, DLB_SOCKET_BLOCKING, err);
     if (DLB_SOCKET_OK != res)
     {
@@ -228,10 +240,11 @@ send_response
     len = snprintf(response, sizeof(response),
                    "HTTP/1.1 %s\r\n"
                    "Server: dlb_http_server\r\n"
+                   "Connection: close\r\n"
                    "Content-Length: %u\r\n"
                    "%s\r\n",
                    request->return_code,
-                   request->response_body_size,
+                   (unsigned int)request->response_body_size,
                    content_type_str);
 
     TRACE(("HTTP-SERVER: sending response:\n%s", response));
@@ -270,12 +283,16 @@ dlb_http_server_run
     dlb_http_request request;
     dlb_socket_res res;
     char client[DLB_SOCKET_MAX_ADDRESS_SIZE];
+    char buf[LINESIZE];
 
     if (!cb)
     {
         return DLB_SOCKET_INVALID_ARG;
     }
 
+    memset(&request, '\0', sizeof(request));
+    request.buf = buf;
+
     res = dlb_socket_create_stream_server(&server->listener_socket, NULL, port, err);
     if (DLB_SOCKET_OK != res)
     {
@@ -295,12 +312,17 @@ dlb_http_server_run
             if (server->running)
             {
                 TRACE(("HTTP-SERVER: accepted connection from client %s\n", client));
+                request.return_code = "400 Bad Request";
+                request.content_type[0] = '\0';
+                request.response_body_size = 0;
                 if (parse_http_request_header(&request))
                 {
+                    request.return_code = "200 OK";
                     if (!cb(cbarg, &request))
                     {
                         request.return_code = "404 Not Found";
                         request.content_type[0] = '\0';
+                        request.response_body_size = 0;
                     }
                     else
                     {
@@ -323,6 +345,983 @@ dlb_http_server_run
 }
 
 
+/**
+ * @def POLL_MSEC
+ * @brief longest the event-driven server waits before checking for a stop
+ */
+#define POLL_MSEC (250)
+
+/**
+ * @def CHUNK_LINE_MAX
+ * @brief longest chunk-size or trailer line the event-driven server accepts
+ */
+#define CHUNK_LINE_MAX (256)
+
+/**
+ * @def INPUT_MAX
+ * @brief most input one connection may buffer: a header, a whole body and
+ * some framing
+ */
+#define INPUT_MAX (LINESIZE + DLB_HTTP_SERVER_MAX_BODY + LINESIZE)
+
+
+/**
+ * @brief where a connection is in its current request
+ */
+typedef enum
+{
+    CONN_HEADER,                  /**< reading the request header */
+    CONN_BODY,                    /**< reading a Content-Length body */
+    CONN_CHUNK_SIZE,              /**< reading a chunk-size line */
+    CONN_CHUNK_DATA,              /**< reading chunk data */
+    CONN_CHUNK_END,               /**< reading the CRLF after chunk data */
+    CONN_TRAILER,                 /**< reading trailer lines after the last chunk */
+    CONN_RESPOND                  /**< sending the response */
+} connection_state;
+
+
+/**
+ * @brief one client connection of the event-driven server
+ *
+ * The input buffer holds the request header, then the body decoded so
+ * far, then input not decoded yet.  Decoding only ever removes chunk
+ * framing, so the decoded body never overtakes the input.
+ */
+typedef struct
+{
+    dlb_socket socket;            /**< client socket */
+    unsigned int index;           /**< position in the server's connection table */
+    connection_state state;       /**< progress through the current request */
+    int interest;                 /**< poller events currently asked for */
+    int keep_alive;               /**< keep the connection after this response? */
+
+    char *in;                     /**< input buffer, NUL-terminated */
+    size_t incap;                 /**< capacity of in, not counting the NUL */
+    size_t inlen;                 /**< bytes in in */
+    size_t pos;                   /**< start of undecoded input */
+    size_t header_len;            /**< length of request header, once complete */
+    size_t body_len;              /**< decoded body bytes, following the header */
+    size_t left;                  /**< bytes left in the body or current chunk */
+
+    char *out;                    /**< response bytes to send */
+    size_t outcap;                /**< capacity of out */
+    size_t outlen;                /**< bytes in out */
+    size_t outpos;                /**< bytes of out already sent */
+
+    dlb_http_request request;     /**< request handed to the callback */
+} http_connection;
+
+
+/**
+ * @brief state of one run of the event-driven server
+ */
+typedef struct
+{
+    dlb_http_server *server;      /**< server being run */
+    dlb_http_server_guts cb;      /**< client code to process requests */
+    void *cbarg;                  /**< client argument to callback */
+    dlb_socket_impl_poller poller;/**< readiness of listener and connections */
+    http_connection **conns;      /**< connections being served */
+    unsigned int count;           /**< number of connections being served */
+    unsigned int max;             /**< most connections to serve at once */
+    int listening;                /**< is the listener being polled? */
+} event_server;
+
+
+/**
+ * @brief find a byte pattern in a buffer
+ */
+static
+const char *                      /** @return start of pattern, or NULL */
+find_bytes
+    (const char *buf
+    ,size_t len
+    ,const char *pattern
+    ,size_t patlen
+    )
+{
+    const char *end = buf + len;
+
+    while ((size_t)(end - buf) >= patlen)
+    {
+        const char *c = (const char *)memchr(buf, pattern[0], end - buf - patlen + 1);
+        if (NULL == c)
+        {
+            break;
+        }
+        if (0 == memcmp(c, pattern, patlen))
+        {
+            return c;
+        }
+        buf = c + 1;
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief case-insensitive comparison of a counted string with a token
+ */
+static
+int                               /** @return 1 if equal, 0 if not */
+same_token
+    (const char *s
+    ,size_t len
+    ,const char *token
+    )
+{
+    size_t i;
+
+    for (i = 0; i != len; ++i)
+    {
+        if (token[i] == '\0' || tolower((unsigned char)s[i]) != tolower((unsigned char)token[i]))
+        {
+            return 0;
+        }
+    }
+    return token[len] == '\0';
+}
+
+
+/**
+ * @brief find the value of a request header field
+ */
+static
+const char *                      /** @return start of value, or NULL if not present */
+header_field
+    (const char *header           /**< [in] request header, from the request line */
+    ,size_t len                   /**< [in] length of header */
+    ,const char *name             /**< [in] field name, without colon */
+    ,size_t *vlen                 /**< [out] length of value, without surrounding space */
+    )
+{
+    const char *end = header + len;
+    const char *line = (const char *)memchr(header, '\n', len);
+    size_t namelen = strlen(name);
+
+    while (NULL != line && ++line < end)
+    {
+        const char *eol = (const char *)memchr(line, '\n', end - line);
+        if (NULL == eol)
+        {
+            break;
+        }
+        if ((size_t)(eol - line) > namelen && line[namelen] == ':' && same_token(line, namelen, name))
+        {
+            const char *v = line + namelen + 1;
+            while (v < eol && (*v == ' ' || *v == '\t')) ++v;
+            while (eol > v && (eol[-1] == '\r' || eol[-1] == ' ' || eol[-1] == '\t')) --eol;
+            *vlen = eol - v;
+            return v;
+        }
+        line = eol;
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief does a comma-separated header value list a given token?
+ */
+static
+int                               /** @return 1 if it does, 0 if not */
+has_token
+    (const char *value
+    ,size_t vlen
+    ,const char *token
+    )
+{
+    const char *end = value + vlen;
+
+    while (value < end)
+    {
+        const char *comma = (const char *)memchr(value, ',', end - value);
+        const char *tend = comma ? comma : end;
+
+        while (value < tend && (*value == ' ' || *value == '\t')) ++value;
+        while (tend > value && (tend[-1] == ' ' || tend[-1] == '\t')) --tend;
+        if (same_token(value, tend - value, token))
+        {
+            return 1;
+        }
+        value = comma ? comma + 1 : end;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief queue bytes to send to the client
+ */
+static
+int                               /** @return 1 on success, 0 if out of memory */
+connection_queue
+    (http_connection *c
+    ,const char *data
+    ,size_t len
+    )
+{
+    if (c->outlen + len > c->outcap)
+    {
+        size_t cap = c->outcap ? c->outcap : 1024;
+        char *out;
+
+        while (cap < c->outlen + len)
+        {
+            cap *= 2;
+        }
+        out = (char *)realloc(c->out, cap);
+        if (NULL == out)
+        {
+            return 0;
+        }
+        c->out = out;
+        c->outcap = cap;
+    }
+    memcpy(c->out + c->outlen, data, len);
+    c->outlen += len;
+    return 1;
+}
+
+
+/**
+ * @brief send as much queued output as the socket takes without blocking
+ */
+static
+int                               /** @return 1 on success, 0 if the connection failed */
+connection_flush
+    (http_connection *c
+    )
+{
+    dlb_socket_res res;
+    size_t sent;
+    int err;
+
+    while (c->outpos < c->outlen)
+    {
+        res = dlb_socket_stream_write2(c->socket, c->out + c->outpos, c->outlen - c->outpos,
+                                       &sent, DLB_SOCKET_NONBLOCKING, &err);
+        if (DLB_SOCKET_NO_DATA == res)
+        {
+            return 1;
+        }
+        if (DLB_SOCKET_OK != res)
+        {
+            TRACE(("HTTP-SERVER: failed to send response: %d\n", err));
+            return 0;
+        }
+        c->outpos += sent;
+    }
+    c->outpos = 0;
+    c->outlen = 0;
+    return 1;
+}
+
+
+/**
+ * @brief queue the response to the current request
+ */
+static
+void
+connection_respond
+    (http_connection *c
+    )
+{
+    dlb_http_request *r = &c->request;
+    char header[1024];
+    int len;
+
+    len = snprintf(header, sizeof(header),
+                   "HTTP/1.1 %s\r\n"
+                   "Server: dlb_http_server\r\n"
+                   "Connection: %s\r\n"
+                   "Content-Length: %u\r\n"
+                   "%s%s%s"
+                   "\r\n",
+                   r->return_code,
+                   c->keep_alive ? "keep-alive" : "close",
+                   (unsigned int)r->response_body_size,
+                   r->content_type[0] ? "Content-Type: " : "",
+                   r->content_type,
+                   r->content_type[0] ? "\r\n" : "");
+    TRACE(("HTTP-SERVER: sending response:\n%s", header));
+
+    if (len < 0 || len >= (int)sizeof(header)
+        || !connection_queue(c, header, len)
+        || (r->response_body_size && !connection_queue(c, r->response_body, r->response_body_size)))
+    {
+        /* give up on the connection rather than send half a response */
+        c->outlen = c->outpos;
+        c->keep_alive = 0;
+    }
+    c->state = CONN_RESPOND;
+}
+
+
+/**
+ * @brief refuse a malformed or oversized request, and close afterwards
+ */
+static
+void
+connection_refuse
+    (http_connection *c
+    ,char *return_code
+    )
+{
+    TRACE(("HTTP-SERVER: refusing request: %s\n", return_code));
+    c->request.return_code = return_code;
+    c->request.content_type[0] = '\0';
+    c->request.response_body_size = 0;
+    c->keep_alive = 0;
+    connection_respond(c);
+}
+
+
+/**
+ * @brief interpret a complete request header, and decide how to read the body
+ */
+static
+char *                            /** @return NULL if ok, otherwise the status to refuse with */
+connection_header
+    (http_connection *c
+    )
+{
+    dlb_http_request *r = &c->request;
+    unsigned long length = 0;
+    char version[16];
+    const char *v;
+    size_t vlen;
+
+    /* field widths are METHOD_SIZE-1, URI_SIZE-1 and sizeof(version)-1 */
+    if (3 != sscanf(c->in, "%15s %255s %15s", r->method, r->uri, version)
+        || 0 != strncmp(version, "HTTP/1.", 7))
+    {
+        return "400 Bad Request";
+    }
+    TRACE(("HTTP-SERVER: %s %s\n", r->method, r->uri));
+
+    r->content_type[0] = '\0';
+    v = header_field(c->in, c->header_len, "Content-Type", &vlen);
+    if (NULL != v)
+    {
+        if (vlen >= sizeof(r->content_type))
+        {
+            vlen = sizeof(r->content_type) - 1;
+        }
+        memcpy(r->content_type, v, vlen);
+        r->content_type[vlen] = '\0';
+    }
+
+    /* HTTP/1.1 connections persist unless asked not to; HTTP/1.0 the reverse */
+    v = header_field(c->in, c->header_len, "Connection", &vlen);
+    c->keep_alive = (0 == strcmp(version, "HTTP/1.0"))
+        ? (NULL != v && has_token(v, vlen, "keep-alive"))
+        : !(NULL != v && has_token(v, vlen, "close"));
+
+    v = header_field(c->in, c->header_len, "Transfer-Encoding", &vlen);
+    if (NULL != v && has_token(v, vlen, "chunked"))
+    {
+        c->state = CONN_CHUNK_SIZE;
+    }
+    else
+    {
+        v = header_field(c->in, c->header_len, "Content-Length", &vlen);
+        if (NULL != v)
+        {
+            char *end;
+
+            if (0 == vlen || !isdigit((unsigned char)*v))
+            {
+                return "400 Bad Request";
+            }
+            length = strtoul(v, &end, 10);
+            if (end != v + vlen)
+            {
+                return "400 Bad Request";
+            }
+            if (length > DLB_HTTP_SERVER_MAX_BODY)
+            {
+                return "413 Payload Too Large";
+            }
+        }
+        c->left = length;
+        c->state = CONN_BODY;
+    }
+
+    v = header_field(c->in, c->header_len, "Expect", &vlen);
+    if (NULL != v && has_token(v, vlen, "100-continue") && (CONN_CHUNK_SIZE == c->state || length))
+    {
+        static const char cont[] = "HTTP/1.1 100 Continue\r\n\r\n";
+        if (!connection_queue(c, cont, sizeof(cont) - 1))
+        {
+            return "500 Internal Server Error";
+        }
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief move decoded body bytes from the undecoded input into place
+ */
+static
+void
+connection_take
+    (http_connection *c
+    )
+{
+    size_t n = c->inlen - c->pos;
+
+    if (n > c->left)
+    {
+        n = c->left;
+    }
+    memmove(c->in + c->header_len + c->body_len, c->in + c->pos, n);
+    c->body_len += n;
+    c->pos += n;
+    c->left -= n;
+}
+
+
+/**
+ * @brief decode as much of the current request as has arrived
+ */
+static
+int                               /** @return 1 if the request is complete,
+                                    *  0 if more input is needed,
+                                    *  -1 if the request has been refused */
+connection_parse
+    (http_connection *c
+    )
+{
+    for (;;)
+    {
+        const char *p = c->in + c->pos;
+        size_t avail = c->inlen - c->pos;
+        const char *eol;
+        char *status;
+
+        switch (c->state)
+        {
+            case CONN_HEADER:
+                eol = find_bytes(c->in, c->inlen, "\r\n\r\n", 4);
+                if (NULL == eol || eol + 4 - c->in > LINESIZE)
+                {
+                    if (c->inlen >= LINESIZE)
+                    {
+                        connection_refuse(c, "431 Request Header Fields Too Large");
+                        return -1;
+                    }
+                    return 0;
+                }
+                c->header_len = eol + 4 - c->in;
+                c->pos = c->header_len;
+                c->body_len = 0;
+                status = connection_header(c);
+                if (NULL != status)
+                {
+                    connection_refuse(c, status);
+                    return -1;
+                }
+                break;
+
+            case CONN_BODY:
+                connection_take(c);
+                if (c->left)
+                {
+                    return 0;
+                }
+                return 1;
+
+            case CONN_CHUNK_SIZE:
+                eol = find_bytes(p, avail, "\r\n", 2);
+                if (NULL == eol)
+                {
+                    if (avail > CHUNK_LINE_MAX)
+                    {
+                        connection_refuse(c, "400 Bad Request");
+                        return -1;
+                    }
+                    return 0;
+                }
+                if (!isxdigit((unsigned char)*p))
+                {
+                    connection_refuse(c, "400 Bad Request");
+                    return -1;
+                }
+                /* any chunk extension after the size is ignored */
+                c->left = strtoul(p, NULL, 16);
+                c->pos += eol + 2 - p;
+                if (c->left > DLB_HTTP_SERVER_MAX_BODY - c->body_len)
+                {
+                    connection_refuse(c, "413 Payload Too Large");
+                    return -1;
+                }
+                c->state = c->left ? CONN_CHUNK_DATA : CONN_TRAILER;
+                break;
+
+            case CONN_CHUNK_DATA:
+                connection_take(c);
+                if (c->left)
+                {
+                    return 0;
+                }
+                c->state = CONN_CHUNK_END;
+                break;
+
+            case CONN_CHUNK_END:
+                if (avail < 2)
+                {
+                    return 0;
+                }
+                if (p[0] != '\r' || p[1] != '\n')
+                {
+                    connection_refuse(c, "400 Bad Request");
+                    return -1;
+                }
+                c->pos += 2;
+                c->state = CONN_CHUNK_SIZE;
+                break;
+
+            case CONN_TRAILER:
+                eol = find_bytes(p, avail, "\r\n", 2);
+                if (NULL == eol)
+                {
+                    if (avail > LINESIZE)
+                    {
+                        connection_refuse(c, "431 Request Header Fields Too Large");
+                        return -1;
+                    }
+                    return 0;
+                }
+                c->pos += eol + 2 - p;
+                if (eol == p)
+                {
+                    /* empty line: end of request */
+                    return 1;
+                }
+                break;
+
+            case CONN_RESPOND:
+            default:
+                return 0;
+        }
+    }
+}
+
+
+/**
+ * @brief hand a complete request to the client callback, and queue its response
+ */
+static
+void
+connection_dispatch
+    (event_server *es
+    ,http_connection *c
+    )
+{
+    dlb_http_request *r = &c->request;
+    char *end = c->in + c->header_len + c->body_len;
+    char saved = *end;
+
+    r->socket = c->socket;
+    r->buf = c->in;
+    r->buflen = (ssize_t)(c->header_len + c->body_len);
+    r->body = c->in + c->header_len;
+    r->body_complete = 1;
+    r->chunked_transfer = 0;
+    r->chunk_left = 0;
+    r->return_code = "200 OK";
+    r->response_body = NULL;
+    r->response_body_size = 0;
+
+    /* terminate the body, for callbacks that treat it as a string; the
+     * byte after it may be the start of a pipelined request */
+    *end = '\0';
+    if (!es->cb(es->cbarg, r))
+    {
+        r->return_code = "404 Not Found";
+        r->content_type[0] = '\0';
+        r->response_body_size = 0;
+    }
+    *end = saved;
+    TRACE(("HTTP-SERVER: return \"%s\"\n", r->return_code));
+    connection_respond(c);
+}
+
+
+/**
+ * @brief get ready for the next request on a kept-alive connection
+ */
+static
+void
+connection_next
+    (http_connection *c
+    )
+{
+    size_t leftover = c->inlen - c->pos;
+
+    memmove(c->in, c->in + c->pos, leftover);
+    c->inlen = leftover;
+    c->pos = 0;
+    c->header_len = 0;
+    c->body_len = 0;
+    c->left = 0;
+    c->state = CONN_HEADER;
+
+    /* give back memory used for a large body */
+    if (c->incap > 4 * LINESIZE && leftover < LINESIZE)
+    {
+        char *in = (char *)realloc(c->in, LINESIZE + 1);
+        if (NULL != in)
+        {
+            c->in = in;
+            c->incap = LINESIZE;
+        }
+    }
+    c->in[c->inlen] = '\0';
+}
+
+
+/**
+ * @brief read whatever input is waiting on the connection
+ */
+static
+int                               /** @return 1 on success, 0 if the connection is finished */
+connection_read
+    (http_connection *c
+    )
+{
+    dlb_socket_res res;
+    ssize_t sz;
+    int err;
+
+    if (c->inlen == c->incap)
+    {
+        size_t decoded = c->header_len + c->body_len;
+
+        /* first squeeze out chunk framing, then grow */
+        if (CONN_HEADER != c->state && c->pos > decoded)
+        {
+            memmove(c->in + decoded, c->in + c->pos, c->inlen - c->pos);
+            c->inlen -= c->pos - decoded;
+            c->pos = decoded;
+        }
+        if (c->inlen == c->incap)
+        {
+            size_t cap = c->incap * 2;
+            char *in;
+
+            if (c->incap >= INPUT_MAX)
+            {
+                return 0;
+            }
+            if (cap > INPUT_MAX)
+            {
+                cap = INPUT_MAX;
+            }
+            in = (char *)realloc(c->in, cap + 1);
+            if (NULL == in)
+            {
+                return 0;
+            }
+            c->in = in;
+            c->incap = cap;
+        }
+    }
+
+    res = dlb_socket_read(c->socket, c->in + c->inlen, c->incap - c->inlen, &sz,
+                          DLB_SOCKET_NONBLOCKING, &err);
+    if (DLB_SOCKET_NO_DATA == res)
+    {
+        return 1;
+    }
+    if (DLB_SOCKET_OK != res || sz <= 0)
+    {
+        /* error, or the client closed the connection */
+        return 0;
+    }
+    c->inlen += sz;
+    c->in[c->inlen] = '\0';
+    return 1;
+}
+
+
+/**
+ * @brief work through everything the connection can do without blocking
+ */
+static
+int                               /** @return 1 on success, 0 if the connection is finished */
+connection_service
+    (event_server *es
+    ,http_connection *c
+    )
+{
+    int interest;
+
+    for (;;)
+    {
+        if (!connection_flush(c))
+        {
+            return 0;
+        }
+        if (CONN_RESPOND == c->state)
+        {
+            if (c->outpos < c->outlen)
+            {
+                break;
+            }
+            if (!c->keep_alive)
+            {
+                return 0;
+            }
+            connection_next(c);
+        }
+
+        switch (connection_parse(c))
+        {
+            case 1:
+                connection_dispatch(es, c);
+                break;
+            case 0:
+                goto wait;
+            default:
+                break;
+        }
+    }
+
+  wait:
+    interest = (CONN_RESPOND != c->state ? DLB_SOCKET_IMPL_POLL_READ : 0)
+             | (c->outpos < c->outlen ? DLB_SOCKET_IMPL_POLL_WRITE : 0);
+    if (interest != c->interest)
+    {
+        if (dlb_socket_impl_poller_modify(&es->poller, c->socket, interest, c))
+        {
+            return 0;
+        }
+        c->interest = interest;
+    }
+    return 1;
+}
+
+
+/**
+ * @brief start serving a newly accepted connection
+ */
+static
+int                               /** @return 1 on success, 0 on failure */
+connection_open
+    (event_server *es
+    ,dlb_socket s
+    )
+{
+    http_connection *c = (http_connection *)calloc(1, sizeof(http_connection));
+    int err;
+
+    if (NULL == c)
+    {
+        return 0;
+    }
+    c->in = (char *)malloc(LINESIZE + 1);
+    if (NULL == c->in)
+    {
+        free(c);
+        return 0;
+    }
+    c->in[0] = '\0';
+    c->incap = LINESIZE;
+    c->socket = s;
+    c->state = CONN_HEADER;
+    c->interest = DLB_SOCKET_IMPL_POLL_READ;
+
+    dlb_socket_impl_setmode(s, DLB_SOCKET_NONBLOCKING);
+    (void)dlb_socket_set_nodelay(s, &err);
+    if (dlb_socket_impl_poller_add(&es->poller, s, c->interest, c))
+    {
+        free(c->in);
+        free(c);
+        return 0;
+    }
+    c->index = es->count;
+    es->conns[es->count++] = c;
+    return 1;
+}
+
+
+/**
+ * @brief stop serving a connection
+ */
+static
+void
+connection_close
+    (event_server *es
+    ,http_connection *c
+    )
+{
+    dlb_socket_impl_poller_remove(&es->poller, c->socket);
+    dlb_socket_close(c->socket);
+
+    es->count -= 1;
+    es->conns[c->index] = es->conns[es->count];
+    es->conns[c->index]->index = c->index;
+
+    free(c->in);
+    free(c->out);
+    free(c);
+
+    if (!es->listening
+        && !dlb_socket_impl_poller_modify(&es->poller, es->server->listener_socket,
+                                          DLB_SOCKET_IMPL_POLL_READ, es))
+    {
+        es->listening = 1;
+    }
+}
+
+
+/**
+ * @brief accept waiting connections, up to the limit
+ */
+static
+void
+event_server_accept
+    (event_server *es
+    )
+{
+    dlb_socket s;
+    int err;
+
+    while (es->count < es->max)
+    {
+        if (DLB_SOCKET_OK != dlb_socket_accept(es->server->listener_socket, &s,
+                                               DLB_SOCKET_NONBLOCKING, NULL, &err))
+        {
+            if (!dlb_socket_impl_would_block())
+            {
+                printf("HTTP-SERVER: socket accept error %d\n", err);
+            }
+            return;
+        }
+        TRACE(("HTTP-SERVER: accepted connection %u\n", es->count));
+        if (!connection_open(es, s))
+        {
+            printf("HTTP-SERVER: could not serve new connection\n");
+            dlb_socket_close(s);
+        }
+    }
+
+    /* at the limit: leave further connections waiting in the backlog */
+    if (!dlb_socket_impl_poller_modify(&es->poller, es->server->listener_socket, 0, es))
+    {
+        es->listening = 0;
+    }
+}
+
+
+dlb_socket_res
+dlb_http_server_run2
+    (dlb_http_server *server
+    ,uint16_t port
+    ,unsigned int max_connections
+    ,dlb_http_server_guts cb
+    ,void *cbarg
+    ,int *err
+    )
+{
+    dlb_socket_impl_poll_event events[DLB_SOCKET_IMPL_POLL_MAX_EVENTS];
+    dlb_socket_res res;
+    event_server es;
+    int n;
+    int i;
+
+    if (!max_connections)
+    {
+        return dlb_http_server_run(server, port, cb, cbarg, err);
+    }
+    if (!cb)
+    {
+        return DLB_SOCKET_INVALID_ARG;
+    }
+
+    memset(&es, '\0', sizeof(es));
+    es.server = server;
+    es.cb = cb;
+    es.cbarg = cbarg;
+    es.max = max_connections;
+    es.conns = (http_connection **)calloc(max_connections, sizeof(http_connection *));
+    if (NULL == es.conns)
+    {
+        *err = 0;
+        return DLB_SOCKET_LIBRARY_ERR;
+    }
+    if (dlb_socket_impl_poller_init(&es.poller, max_connections + 1))
+    {
+        *err = getLastError();
+        free(es.conns);
+        return DLB_SOCKET_LIBRARY_ERR;
+    }
+
+    res = dlb_socket_create_stream_server2(&server->listener_socket, NULL, port, SOMAXCONN, err);
+    if (DLB_SOCKET_OK != res)
+    {
+        goto done;
+    }
+    dlb_socket_impl_setmode(server->listener_socket, DLB_SOCKET_NONBLOCKING);
+    if (dlb_socket_impl_poller_add(&es.poller, server->listener_socket, DLB_SOCKET_IMPL_POLL_READ, &es))
+    {
+        *err = getLastError();
+        dlb_socket_close(server->listener_socket);
+        res = DLB_SOCKET_LIBRARY_ERR;
+        goto done;
+    }
+    es.listening = 1;
+
+    server->running = 1;
+    server->port = port;
+    while (server->running)
+    {
+        n = dlb_socket_impl_poller_wait(&es.poller, events, DLB_SOCKET_IMPL_POLL_MAX_EVENTS, POLL_MSEC);
+        if (n < 0)
+        {
+            *err = getLastError();
+            res = DLB_SOCKET_LIBRARY_ERR;
+            break;
+        }
+        for (i = 0; i != n; ++i)
+        {
+            if (events[i].arg == &es)
+            {
+                event_server_accept(&es);
+            }
+            else
+            {
+                http_connection *c = (http_connection *)events[i].arg;
+
+                if (((events[i].events & DLB_SOCKET_IMPL_POLL_READ)
+                     && CONN_RESPOND != c->state
+                     && !connection_read(c))
+                    || !connection_service(&es, c))
+                {
+                    TRACE(("HTTP-SERVER: closing connection\n"));
+                    connection_close(&es, c);
+                }
+            }
+        }
+    }
+    TRACE(("HTTP-SERVER: ended\n"));
+
+    while (es.count)
+    {
+        connection_close(&es, es.conns[0]);
+    }
+    dlb_socket_close(server->listener_socket);
+
+  done:
+    dlb_socket_impl_poller_finish(&es.poller);
+    free(es.conns);
+    return res;
+}
+
+
 void
 dlb_http_server_stop
     (dlb_http_server *server
@@ -344,6 +1343,6 @@ dlb_http_server_stop
     else
     {
         printf("signaled\n");
+        dlb_socket_close(closer);
     }
-    dlb_socket_close(closer);
 }
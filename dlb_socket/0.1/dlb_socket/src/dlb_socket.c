@@ -122,12 +122,24 @@ dlb_socket_create_stream_server
     ,const char* iface
     ,int local_port
     ,int* err)
+{
+    return dlb_socket_create_stream_server2(p_socket, iface, local_port, 1, err);
+}
+
+
+dlb_socket_res
+dlb_socket_create_stream_server2
+    (dlb_socket* p_socket
+    ,const char* iface
+    ,int local_port
+    ,int backlog
+    ,int* err)
 {
     dlb_socket_res res =
         dlb_open_socket(p_socket, iface, local_port, SOCK_STREAM, err);
     if (DLB_SOCKET_OK == res)
     {
-        listen(*p_socket, 1);
+        listen(*p_socket, backlog);
     }
     return res;
 }
@@ -251,6 +263,7 @@ dlb_socket_connect
     if (0 != *err)
     {
         //printf("failed to resolve hostname %s: %s\n", name, gai_strerror(err));
+        dlb_socket_impl_close(*p_socket);
         return DLB_SOCKET_LIBRARY_ERR;
     }
     
@@ -265,6 +278,10 @@ dlb_socket_connect
         *err = getLastError();
     }
     freeaddrinfo(server_info);
+    if (DLB_SOCKET_OK != res)
+    {
+        dlb_socket_impl_close(*p_socket);
+    }
 #endif
 
     return res;
@@ -454,13 +471,88 @@ dlb_socket_stream_write
 #ifdef MSG_NOSIGNAL
     flags = MSG_NOSIGNAL;
 #endif
-    res = send(socket, (const char*)buff, send_len, flags);
-    if (res == SOCKET_ERROR)
+    while (send_len > 0)
+    {
+        res = send(socket, (const char*)buff, send_len, flags);
+        if (res == SOCKET_ERROR)
+        {
+            *err = getLastError();
+            return DLB_SOCKET_LIBRARY_ERR;
+        }
+        buff = (char*)buff + res;
+        send_len -= res;
+    }
+
+    return DLB_SOCKET_OK;
+}
+
+
+dlb_socket_res
+dlb_socket_stream_write2
+    (dlb_socket socket
+    ,void* buff
+    ,size_t send_len
+    ,size_t* sent
+    ,dlb_socket_mode mode
+    ,int* err)
+{
+    dlb_socket_res res;
+    int flags = 0;
+    int n;
+
+    if (dlb_socket_impl_invalid(socket) || (NULL == buff) || (NULL == sent))
+    {
+        return DLB_SOCKET_INVALID_ARG;
+    }
+
+    *sent = 0;
+    dlb_socket_impl_setmode(socket, mode);
+    if (DLB_SOCKET_BLOCKING == mode)
+    {
+        res = dlb_socket_stream_write(socket, buff, send_len, err);
+        if (DLB_SOCKET_OK == res)
+        {
+            *sent = send_len;
+        }
+        return res;
+    }
+
+#ifdef MSG_NOSIGNAL
+    flags = MSG_NOSIGNAL;
+#endif
+    while (*sent < send_len)
+    {
+        n = send(socket, (const char*)buff + *sent, send_len - *sent, flags);
+        if (n == SOCKET_ERROR)
+        {
+            if (dlb_socket_impl_would_block())
+            {
+                break;
+            }
+            *err = getLastError();
+            return DLB_SOCKET_LIBRARY_ERR;
+        }
+        *sent += n;
+    }
+    return (*sent || !send_len) ? DLB_SOCKET_OK : DLB_SOCKET_NO_DATA;
+}
+
+
+dlb_socket_res
+dlb_socket_set_nodelay
+    (dlb_socket socket
+    ,int* err)
+{
+    if (dlb_socket_impl_invalid(socket))
+    {
+        return DLB_SOCKET_INVALID_ARG;
+    }
+
+    if (SOCKET_ERROR == dlb_socket_impl_nodelay(socket))
     {
         *err = getLastError();
         return DLB_SOCKET_LIBRARY_ERR;
     }
-
     return DLB_SOCKET_OK;
 }
 
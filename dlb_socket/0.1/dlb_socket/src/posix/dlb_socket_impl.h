@@ -43,10 +43,20 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <netdb.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __linux__
+#  include <sys/epoll.h>
+#else
+#  include <poll.h>
+#endif
 
 typedef socklen_t size_type;
 typedef socklen_t addr_size_type;
@@ -101,6 +111,17 @@ dlb_socket_impl_reuseaddr
 }
 
 
+static inline
+int
+dlb_socket_impl_nodelay
+    (dlb_socket s
+    )
+{
+    int optval = 1;
+    return setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &optval, sizeof(optval));
+}
+
+
 static inline
 void
 dlb_socket_impl_setmode
@@ -108,10 +129,14 @@ dlb_socket_impl_setmode
     ,dlb_socket_mode mode
     )
 {
-    if (mode == DLB_SOCKET_NONBLOCKING)
+    int flags = fcntl(s, F_GETFL, 0);
+    int want = (mode == DLB_SOCKET_NONBLOCKING)
+        ? flags | O_NONBLOCK
+        : flags & ~O_NONBLOCK;
+
+    if (flags != -1 && want != flags)
     {
-        int flags = fcntl(s, F_GETFL, 0);
-        fcntl(s, F_SETFL, flags | O_NONBLOCK);
+        fcntl(s, F_SETFL, want);
     }
 }
 
@@ -176,4 +201,319 @@ dlb_socket_impl_pair
 }
 
 
+/**
+ * @def DLB_SOCKET_IMPL_POLL_READ
+ * @brief poller interest/readiness: socket can be read, or has hung up
+ */
+#define DLB_SOCKET_IMPL_POLL_READ (1)
+
+/**
+ * @def DLB_SOCKET_IMPL_POLL_WRITE
+ * @brief poller interest/readiness: socket can be written
+ */
+#define DLB_SOCKET_IMPL_POLL_WRITE (2)
+
+/**
+ * @def DLB_SOCKET_IMPL_POLL_MAX_EVENTS
+ * @brief most events one wait on a poller reports
+ */
+#define DLB_SOCKET_IMPL_POLL_MAX_EVENTS (64)
+
+
+/**
+ * @brief one socket reported ready by #dlb_socket_impl_poller_wait
+ */
+typedef struct
+{
+    void *arg;                    /**< argument the socket was registered with */
+    int events;                   /**< DLB_SOCKET_IMPL_POLL_READ and/or _WRITE */
+} dlb_socket_impl_poll_event;
+
+
+#ifdef __linux__
+
+/**
+ * @brief readiness notification for many sockets at once: epoll
+ */
+typedef struct
+{
+    int epfd;
+} dlb_socket_impl_poller;
+
+
+static inline
+int
+dlb_socket_impl_poller_init
+    (dlb_socket_impl_poller *p
+    ,unsigned int capacity
+    )
+{
+    (void)capacity;
+    p->epfd = epoll_create1(EPOLL_CLOEXEC);
+    return p->epfd < 0 ? SOCKET_ERROR : 0;
+}
+
+
+static inline
+void
+dlb_socket_impl_poller_finish
+    (dlb_socket_impl_poller *p
+    )
+{
+    close(p->epfd);
+}
+
+
+static inline
+int
+dlb_socket_impl_poller_ctl
+    (dlb_socket_impl_poller *p
+    ,int op
+    ,dlb_socket s
+    ,int events
+    ,void *arg
+    )
+{
+    struct epoll_event ev;
+
+    memset(&ev, '\0', sizeof(ev));
+    ev.events = ((events & DLB_SOCKET_IMPL_POLL_READ) ? EPOLLIN : 0)
+              | ((events & DLB_SOCKET_IMPL_POLL_WRITE) ? EPOLLOUT : 0);
+    ev.data.ptr = arg;
+    return epoll_ctl(p->epfd, op, s, &ev);
+}
+
+
+static inline
+int
+dlb_socket_impl_poller_add
+    (dlb_socket_impl_poller *p
+    ,dlb_socket s
+    ,int events
+    ,void *arg
+    )
+{
+    return dlb_socket_impl_poller_ctl(p, EPOLL_CTL_ADD, s, events, arg);
+}
+
+
+static inline
+int
+dlb_socket_impl_poller_modify
+    (dlb_socket_impl_poller *p
+    ,dlb_socket s
+    ,int events
+    ,void *arg
+    )
+{
+    return dlb_socket_impl_poller_ctl(p, EPOLL_CTL_MOD, s, events, arg);
+}
+
+
+static inline
+void
+dlb_socket_impl_poller_remove
+    (dlb_socket_impl_poller *p
+    ,dlb_socket s
+    )
+{
+    struct epoll_event ev;
+    (void)epoll_ctl(p->epfd, EPOLL_CTL_DEL, s, &ev);
+}
+
+
+static inline
+int                                 /** @return number of events, or SOCKET_ERROR */
+dlb_socket_impl_poller_wait
+    (dlb_socket_impl_poller *p
+    ,dlb_socket_impl_poll_event *events
+    ,int max
+    ,int timeout_msec
+    )
+{
+    struct epoll_event ready[DLB_SOCKET_IMPL_POLL_MAX_EVENTS];
+    int n;
+    int i;
+
+    if (max > DLB_SOCKET_IMPL_POLL_MAX_EVENTS)
+    {
+        max = DLB_SOCKET_IMPL_POLL_MAX_EVENTS;
+    }
+    n = epoll_wait(p->epfd, ready, max, timeout_msec);
+    if (n < 0)
+    {
+        return errno == EINTR ? 0 : SOCKET_ERROR;
+    }
+    for (i = 0; i != n; ++i)
+    {
+        /* errors and hang-ups show up as readable, for the read to report */
+        events[i].arg = ready[i].data.ptr;
+        events[i].events = ((ready[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) ? DLB_SOCKET_IMPL_POLL_READ : 0)
+                         | ((ready[i].events & EPOLLOUT) ? DLB_SOCKET_IMPL_POLL_WRITE : 0);
+    }
+    return n;
+}
+
+#else
+
+/**
+ * @brief readiness notification for many sockets at once: poll
+ */
+typedef struct
+{
+    struct pollfd *fds;
+    void **args;
+    unsigned int count;
+    unsigned int capacity;
+} dlb_socket_impl_poller;
+
+
+static inline
+int
+dlb_socket_impl_poller_init
+    (dlb_socket_impl_poller *p
+    ,unsigned int capacity
+    )
+{
+    p->fds = (struct pollfd*)malloc(capacity * sizeof(struct pollfd));
+    p->args = (void**)malloc(capacity * sizeof(void*));
+    p->count = 0;
+    p->capacity = capacity;
+    if (NULL == p->fds || NULL == p->args)
+    {
+        free(p->fds);
+        free(p->args);
+        return SOCKET_ERROR;
+    }
+    return 0;
+}
+
+
+static inline
+void
+dlb_socket_impl_poller_finish
+    (dlb_socket_impl_poller *p
+    )
+{
+    free(p->fds);
+    free(p->args);
+}
+
+
+static inline
+short
+dlb_socket_impl_poll_mask
+    (int events
+    )
+{
+    return (short)(((events & DLB_SOCKET_IMPL_POLL_READ) ? POLLIN : 0)
+                 | ((events & DLB_SOCKET_IMPL_POLL_WRITE) ? POLLOUT : 0));
+}
+
+
+static inline
+int
+dlb_socket_impl_poller_add
+    (dlb_socket_impl_poller *p
+    ,dlb_socket s
+    ,int events
+    ,void *arg
+    )
+{
+    if (p->count == p->capacity)
+    {
+        errno = ENOMEM;
+        return SOCKET_ERROR;
+    }
+    p->fds[p->count].fd = s;
+    p->fds[p->count].events = dlb_socket_impl_poll_mask(events);
+    p->fds[p->count].revents = 0;
+    p->args[p->count] = arg;
+    p->count += 1;
+    return 0;
+}
+
+
+static inline
+int
+dlb_socket_impl_poller_modify
+    (dlb_socket_impl_poller *p
+    ,dlb_socket s
+    ,int events
+    ,void *arg
+    )
+{
+    unsigned int i;
+
+    for (i = 0; i != p->count; ++i)
+    {
+        if (p->fds[i].fd == s)
+        {
+            p->fds[i].events = dlb_socket_impl_poll_mask(events);
+            p->args[i] = arg;
+            return 0;
+        }
+    }
+    errno = ENOENT;
+    return SOCKET_ERROR;
+}
+
+
+static inline
+void
+dlb_socket_impl_poller_remove
+    (dlb_socket_impl_poller *p
+    ,dlb_socket s
+    )
+{
+    unsigned int i;
+
+    for (i = 0; i != p->count; ++i)
+    {
+        if (p->fds[i].fd == s)
+        {
+            p->count -= 1;
+            p->fds[i] = p->fds[p->count];
+            p->args[i] = p->args[p->count];
+            return;
+        }
+    }
+}
+
+
+static inline
+int                                 /** @return number of events, or SOCKET_ERROR */
+dlb_socket_impl_poller_wait
+    (dlb_socket_impl_poller *p
+    ,dlb_socket_impl_poll_event *events
+    ,int max
+    ,int timeout_msec
+    )
+{
+    unsigned int i;
+    int n;
+
+    n = poll(p->fds, p->count, timeout_msec);
+    if (n < 0)
+    {
+        return errno == EINTR ? 0 : SOCKET_ERROR;
+    }
+    n = 0;
+    for (i = 0; i != p->count && n != max; ++i)
+    {
+        short r = p->fds[i].revents;
+        if (r)
+        {
+            events[n].arg = p->args[i];
+            events[n].events = ((r & (POLLIN | POLLERR | POLLHUP | POLLNVAL)) ? DLB_SOCKET_IMPL_POLL_READ : 0)
+                             | ((r & POLLOUT) ? DLB_SOCKET_IMPL_POLL_WRITE : 0);
+            ++n;
+        }
+    }
+    return n;
+}
+
+#endif
+
+
 #endif /*  dlb_socket_impl_H */
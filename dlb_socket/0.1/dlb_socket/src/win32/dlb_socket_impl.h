@@ -43,6 +43,7 @@
 #include <winsock2.h>
 #include <Ws2tcpip.h>
 #include <mswsock.h>
+#include <stdlib.h>
 
 #if defined(_MSC_VER) && !defined(inline)
 #define inline __inline
@@ -130,6 +131,18 @@ dlb_socket_impl_reuseaddr
 }
 
 
+static inline
+int
+dlb_socket_impl_nodelay
+    (dlb_socket s
+    )
+{
+    BOOL nodelay = TRUE;
+    return setsockopt(s, IPPROTO_TCP, TCP_NODELAY,
+                      (char *)&nodelay, (socklen_t)sizeof(nodelay));
+}
+
+
 
 
 
@@ -196,6 +209,7 @@ dlb_socket_impl_would_block
 
 
 
+static inline
 dlb_socket_res
 dlb_socket_impl_pair
     (int datagram
@@ -259,6 +273,198 @@ dlb_socket_impl_pair
 }
 
 
-        
+
+/**
+ * @def DLB_SOCKET_IMPL_POLL_READ
+ * @brief poller interest/readiness: socket can be read, or has hung up
+ */
+#define DLB_SOCKET_IMPL_POLL_READ (1)
+
+/**
+ * @def DLB_SOCKET_IMPL_POLL_WRITE
+ * @brief poller interest/readiness: socket can be written
+ */
+#define DLB_SOCKET_IMPL_POLL_WRITE (2)
+
+/**
+ * @def DLB_SOCKET_IMPL_POLL_MAX_EVENTS
+ * @brief most events one wait on a poller reports
+ */
+#define DLB_SOCKET_IMPL_POLL_MAX_EVENTS (64)
+
+
+/**
+ * @brief one socket reported ready by #dlb_socket_impl_poller_wait
+ */
+typedef struct
+{
+    void *arg;                    /**< argument the socket was registered with */
+    int events;                   /**< DLB_SOCKET_IMPL_POLL_READ and/or _WRITE */
+} dlb_socket_impl_poll_event;
+
+
+/**
+ * @brief readiness notification for many sockets at once: WSAPoll
+ */
+typedef struct
+{
+    WSAPOLLFD *fds;
+    void **args;
+    unsigned int count;
+    unsigned int capacity;
+} dlb_socket_impl_poller;
+
+
+static inline
+int
+dlb_socket_impl_poller_init
+    (dlb_socket_impl_poller *p
+    ,unsigned int capacity
+    )
+{
+    p->fds = (WSAPOLLFD*)malloc(capacity * sizeof(WSAPOLLFD));
+    p->args = (void**)malloc(capacity * sizeof(void*));
+    p->count = 0;
+    p->capacity = capacity;
+    if (NULL == p->fds || NULL == p->args)
+    {
+        free(p->fds);
+        free(p->args);
+        return SOCKET_ERROR;
+    }
+    return 0;
+}
+
+
+static inline
+void
+dlb_socket_impl_poller_finish
+    (dlb_socket_impl_poller *p
+    )
+{
+    free(p->fds);
+    free(p->args);
+}
+
+
+static inline
+SHORT
+dlb_socket_impl_poll_mask
+    (int events
+    )
+{
+    return (SHORT)(((events & DLB_SOCKET_IMPL_POLL_READ) ? POLLRDNORM : 0)
+                 | ((events & DLB_SOCKET_IMPL_POLL_WRITE) ? POLLWRNORM : 0));
+}
+
+
+static inline
+int
+dlb_socket_impl_poller_add
+    (dlb_socket_impl_poller *p
+    ,dlb_socket s
+    ,int events
+    ,void *arg
+    )
+{
+    if (p->count == p->capacity)
+    {
+        WSASetLastError(WSAENOBUFS);
+        return SOCKET_ERROR;
+    }
+    p->fds[p->count].fd = s;
+    p->fds[p->count].events = dlb_socket_impl_poll_mask(events);
+    p->fds[p->count].revents = 0;
+    p->args[p->count] = arg;
+    p->count += 1;
+    return 0;
+}
+
+
+static inline
+int
+dlb_socket_impl_poller_modify
+    (dlb_socket_impl_poller *p
+    ,dlb_socket s
+    ,int events
+    ,void *arg
+    )
+{
+    unsigned int i;
+
+    for (i = 0; i != p->count; ++i)
+    {
+        if (p->fds[i].fd == s)
+        {
+            p->fds[i].events = dlb_socket_impl_poll_mask(events);
+            p->args[i] = arg;
+            return 0;
+        }
+    }
+    WSASetLastError(WSAENOTSOCK);
+    return SOCKET_ERROR;
+}
+
+
+static inline
+void
+dlb_socket_impl_poller_remove
+    (dlb_socket_impl_poller *p
+    ,dlb_socket s
+    )
+{
+    unsigned int i;
+
+    for (i = 0; i != p->count; ++i)
+    {
+        if (p->fds[i].fd == s)
+        {
+            p->count -= 1;
+            p->fds[i] = p->fds[p->count];
+            p->args[i] = p->args[p->count];
+            return;
+        }
+    }
+}
+
+
+static inline
+int                                 /** @return number of events, or SOCKET_ERROR */
+dlb_socket_impl_poller_wait
+    (dlb_socket_impl_poller *p
+    ,dlb_socket_impl_poll_event *events
+    ,int max
+    ,int timeout_msec
+    )
+{
+    unsigned int i;
+    int n;
+
+    if (0 == p->count)
+    {
+        /* WSAPoll rejects an empty set */
+        Sleep(timeout_msec < 0 ? INFINITE : (DWORD)timeout_msec);
+        return 0;
+    }
+    n = WSAPoll(p->fds, p->count, timeout_msec);
+    if (n == SOCKET_ERROR)
+    {
+        return SOCKET_ERROR;
+    }
+    n = 0;
+    for (i = 0; i != p->count && n != max; ++i)
+    {
+        SHORT r = p->fds[i].revents;
+        if (r)
+        {
+            events[n].arg = p->args[i];
+            events[n].events = ((r & (POLLRDNORM | POLLERR | POLLHUP | POLLNVAL)) ? DLB_SOCKET_IMPL_POLL_READ : 0)
+                             | ((r & POLLWRNORM) ? DLB_SOCKET_IMPL_POLL_WRITE : 0);
+            ++n;
+        }
+    }
+    return n;
+}
+
 
 #endif /*  dlb_socket_impl_H */
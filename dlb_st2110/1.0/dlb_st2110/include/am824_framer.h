@@ -53,8 +53,21 @@
 #define _AM824_FRAMER_H_
 
 #include <stdint.h>
+#include <string.h>
 
 #define CHANNEL_STATUS_BYTES 24
+#define CHANNEL_STATUS_FRAMES (CHANNEL_STATUS_BYTES * 8)
+
+#define AM824_B_BIT (1u << 29) // Start of channel status block
+#define AM824_F_BIT (1u << 28) // Start of frame
+#define AM824_P_BIT (1u << 27)
+#define AM824_C_BIT (1u << 26)
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define ST2110_AM824_HOST_LITTLE_ENDIAN 0
+#else
+#define ST2110_AM824_HOST_LITTLE_ENDIAN 1
+#endif
 
 #define WIDTH  (8)
 #define BOTTOMBIT 1
@@ -76,6 +89,9 @@ class AM824Framer
 	uint8_t bitDepth;
 	uint8_t crcTable[256];
 	AM824Endianess endian;
+	// B and C bits for every frame of the channel status block, so the
+	// block functions need no per-sample bit twiddling
+	uint32_t frameFlags[CHANNEL_STATUS_FRAMES];
 
 	static uint8_t getParity(unsigned int n) 
 	{ 
@@ -122,8 +138,102 @@ class AM824Framer
 	        remainder = crcTable[data];
 	    }
 	    channelStatus[23] = remainder;
+	    buildFrameFlags();
+	}
+
+	void buildFrameFlags(void)
+	{
+		for (unsigned int frame = 0 ; frame < CHANNEL_STATUS_FRAMES ; frame++)
+		{
+			frameFlags[frame] = ((channelStatus[frame / 8] >> (frame % 8)) & 1) ? AM824_C_BIT : 0;
+		}
+		frameFlags[0] |= AM824_B_BIT;
+	}
+
+	// Branch-free parity of a 32 bit word, folded down to a nibble
+	// and looked up in a 16 entry bit table
+	static uint32_t wordParity(uint32_t n)
+	{
+		n ^= n >> 16;
+		n ^= n >> 8;
+		n ^= n >> 4;
+		return((0x6996u >> (n & 0xf)) & 1);
+	}
+
+	static uint32_t byteSwap(uint32_t n)
+	{
+		return((n >> 24) | ((n >> 8) & 0x0000ff00) | ((n << 8) & 0x00ff0000) | (n << 24));
+	}
+
+	uint32_t alignSample(uint32_t inputSample) const
+	{
+		// Input samples are MSB justified as per AES3
+		if (bitDepth == 16)
+		{
+			return(inputSample << 8);
+		}
+		else if (bitDepth == 32)
+		{
+			return(inputSample >> 8);
+		}
+		return(inputSample);
 	}
 
+	// Frame numSamples interleaved samples, loaded by 'load', continuing
+	// from wherever the previous call stopped.  Each run of subframes
+	// within one frame shares its flags, so the inner loop is a plain
+	// shift/or/parity/swap/store that the compiler can vectorise
+	template <class Load>
+	void frameSamples(Load load, unsigned int numSamples, uint8_t *outputBytes)
+	{
+		unsigned int frame = channelStatusIndex * 8u;
+		unsigned int subFrame = subFrameCounter;
+		unsigned int done = 0;
+		bool swap = (endian == AM824_BIG_ENDIAN) == ST2110_AM824_HOST_LITTLE_ENDIAN;
+
+		for (uint8_t mask = channelStatusMask ; mask > 1 ; mask >>= 1)
+		{
+			frame++;
+		}
+
+		while (done < numSamples)
+		{
+			unsigned int run = numChannels - subFrame;
+			uint32_t flags = frameFlags[frame];
+
+			if (run > numSamples - done)
+			{
+				run = numSamples - done;
+			}
+			for (unsigned int k = 0 ; k < run ; k++)
+			{
+				uint32_t word = alignSample(load(done + k)) | flags;
+				if (subFrame + k == 0)
+				{
+					word |= AM824_F_BIT;
+				}
+				word |= wordParity(word) << 27;
+				if (swap)
+				{
+					word = byteSwap(word);
+				}
+				memcpy(outputBytes + (done + k) * 4, &word, sizeof(word));
+			}
+			done += run;
+			subFrame += run;
+			if (subFrame == numChannels)
+			{
+				subFrame = 0;
+				if (++frame == CHANNEL_STATUS_FRAMES)
+				{
+					frame = 0;
+				}
+			}
+		}
+		subFrameCounter = (uint8_t)subFrame;
+		channelStatusIndex = (uint8_t)(frame / 8);
+		channelStatusMask = (uint8_t)(1u << (frame % 8));
+	}
 
 public:
 
@@ -311,6 +421,54 @@ public:
 		}
 	}
 
+	// Block versions of getAM824Sample: frame numSamples interleaved
+	// samples into numSamples 32 bit AM824 words.  numSamples need not
+	// be a whole number of frames; framing continues from where the
+	// previous call, block or per-sample, left off
+	void getAM824Samples(const uint16_t *inputSamples, unsigned int numSamples, uint8_t *outputBytes)
+	{
+		frameSamples([inputSamples](unsigned int i) { return((uint32_t)inputSamples[i]); }, numSamples, outputBytes);
+	}
+
+	void getAM824Samples(const uint32_t *inputSamples, unsigned int numSamples, uint8_t *outputBytes)
+	{
+		frameSamples([inputSamples](unsigned int i) { return(inputSamples[i]); }, numSamples, outputBytes);
+	}
+
+	// Packed 24 bit input in machine byte order
+	void getAM824Samples24(const uint8_t *inputBytes, unsigned int numSamples, uint8_t *outputBytes)
+	{
+		frameSamples([inputBytes](unsigned int i)
+		{
+			const uint8_t *p = &inputBytes[i * 3];
+#if ST2110_AM824_HOST_LITTLE_ENDIAN
+			return((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16));
+#else
+			return(((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | (uint32_t)p[2]);
+#endif
+		}, numSamples, outputBytes);
+	}
+
+	// Strip the PCUV byte from numSamples big endian AM824 words, giving
+	// MSB justified 32 bit samples in machine order.  Returns the number
+	// of words that failed their parity check
+	static unsigned int getPCMSamples(const uint8_t *inputBytes, unsigned int numSamples, int32_t *outputSamples)
+	{
+		unsigned int parityErrors = 0;
+
+		for (unsigned int i = 0 ; i < numSamples ; i++)
+		{
+			uint32_t word;
+			memcpy(&word, inputBytes + i * 4, sizeof(word));
+#if ST2110_AM824_HOST_LITTLE_ENDIAN
+			word = byteSwap(word);
+#endif
+			parityErrors += wordParity(word);
+			outputSamples[i] = (int32_t)(word << 8);
+		}
+		return(parityErrors);
+	}
+
 	/* Simple test code to check CRC implementation */
 	/* See EBU Tech 3250 or AES3 for the reference for these examples */
 	void testCRC(void)
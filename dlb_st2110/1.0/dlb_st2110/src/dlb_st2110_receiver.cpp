@@ -446,12 +446,39 @@ unsigned int ST2110Receiver::DeformatPacketData(void *streamPacketBuf, unsigned
 			}
 			break;
 		case AM824:
+			numSamples = floor(numBytes / 4); // AM824 packet has 4 bytes per sample in stream
+			if (callBackBytesPerSample == 4)
+			{
+				// Strip the PCUV bytes a block at a time, in runs up to the wrap point
+				// of the output buffer. Parity is checked but not yet acted on
+				unsigned int run;
+				pStream = (uint8_t *)streamPacketBuf;
+				for (i = 0 ; i < numSamples ; i += run)
+				{
+					run = (outputBufSize - index) / 4;
+					if (run == 0)
+					{
+						index = 0;
+						continue;
+					}
+					if (run > numSamples - i)
+					{
+						run = numSamples - i;
+					}
+					AM824Framer::getPCMSamples(pStream + i * 4, run, (int32_t *)&((uint8_t *)outputBufBegin)[index]);
+					index += run * 4;
+					if (index >= outputBufSize)
+					{
+						index = 0;
+					}
+				}
+				return(numSamples * 4);
+			}
 			// Simply strip off PCUV word and return 24bit word for now
 			// No checking of CRC etc.
 			// Step over the first PCUV byte
 			pStream = (uint8_t *)streamPacketBuf + 1;
 			pNew = &((uint8_t *)outputBufBegin)[index];
-			numSamples = floor(numBytes / 4); // AM824 packet has 4 bytes per sample in stream
 			if (ST2110Hardware::IsLittleEndian())
 			{
 				// start at MSB on output
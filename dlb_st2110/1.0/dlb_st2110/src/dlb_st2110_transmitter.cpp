@@ -897,12 +897,10 @@ unsigned int ST2110Transmitter::GetSMPTE2116Header(uint8_t *const buff)
 
 unsigned int ST2110Transmitter::FormatPacketData(unsigned int& readIndex, void *readBufBegin, unsigned int readBufSize, void *streamPacketBuf)
 {
-	uint16_t *p16;
-	uint32_t *p32;
 	uint8_t *pRead = &((uint8_t *)readBufBegin)[readIndex];
 	uint8_t *pStream = (uint8_t *)streamPacketBuf;
 	uint32_t i,j;
-	uint32_t input24;
+	unsigned int remaining;
 	unsigned int callBackBytesPerSample;
 	unsigned int totalCallBackBytes;
 
@@ -997,64 +995,45 @@ unsigned int ST2110Transmitter::FormatPacketData(unsigned int& readIndex, void *
 		}
 		break;
 		case AM824:
-		switch(callBackBytesPerSample)
+		// Frame in runs up to the wrap point of the read buffer
+		remaining = streamInfo.audio.samplesPerPacket * streamInfo.audio.numChannels;
+		while (remaining > 0)
 		{
-			case 2:
-			p16 = (uint16_t *)pRead;
-			for (i = 0 ; i < streamInfo.audio.samplesPerPacket * streamInfo.audio.numChannels; i++)
+			unsigned int run = (readBufSize - readIndex) / callBackBytesPerSample;
+			if (run > remaining)
 			{
-				aM824Framer.getAM824Sample(*p16++, pStream);
-				pStream += streamBytesPerSample;
-				readIndex += 2;
-				if (readIndex >= readBufSize)
-				{
-					p16 = (uint16_t *)readBufBegin;
-					readIndex = 0;
-				}
+				run = remaining;
 			}
-			break;
-			case 3:
-			for (i = 0 ; i < streamInfo.audio.samplesPerPacket * streamInfo.audio.numChannels ; i++)
+			if (run == 0)
 			{
-				if (ST2110Hardware::IsLittleEndian())
-				{
-					// Conversion to big endian for 24 bit word
-					input24 = *pRead++;
-					input24 += *pRead++ << 8;
-					input24 += *pRead++ << 16;
-				}
-				else
-				{
-					input24 = *pRead++ << 16;
-					input24 += *pRead++ << 8;
-					input24 += *pRead++;
-				}
-				aM824Framer.getAM824Sample(input24, pStream);
-				pStream += streamBytesPerSample;
-				readIndex += 3;
-				if (readIndex >= readBufSize)
-				{
-					pRead = (uint8_t *)readBufBegin;
-					readIndex = 0;
-				}				
+				// Sample straddles the end of the buffer
+				pRead = (uint8_t *)readBufBegin;
+				readIndex = 0;
+				continue;
 			}
-			break;
-			case 4:
-			p32 = (uint32_t *)pRead;
-			for (i = 0 ; i < streamInfo.audio.samplesPerPacket * streamInfo.audio.numChannels; i++)
+			switch(callBackBytesPerSample)
 			{
-				aM824Framer.getAM824Sample(*p32++, pStream);
-				pStream += streamBytesPerSample;
-				readIndex += 4;
-				if (readIndex >= readBufSize)
-				{
-					p32 = (uint32_t *)readBufBegin;
-					readIndex = 0;
-				}
+				case 2:
+				aM824Framer.getAM824Samples((const uint16_t *)pRead, run, pStream);
+				break;
+				case 3:
+				aM824Framer.getAM824Samples24(pRead, run, pStream);
+				break;
+				case 4:
+				aM824Framer.getAM824Samples((const uint32_t *)pRead, run, pStream);
+				break;
+				default:
+				throw runtime_error("Error: Unsupported bit depth");
+			}
+			pStream += run * streamBytesPerSample;
+			pRead += run * callBackBytesPerSample;
+			readIndex += run * callBackBytesPerSample;
+			remaining -= run;
+			if (readIndex >= readBufSize)
+			{
+				pRead = (uint8_t *)readBufBegin;
+				readIndex = 0;
 			}
-			break;
-			default:
-			throw runtime_error("Error: Unsupported bit depth");
 		}
 		break;
 		default:
@@ -0,0 +1,218 @@
+/************************************************************************
+ * dlb_st2110
+ * Copyright (c) 2023, Dolby Laboratories Inc.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+// Checks the block AM824 framer against the per-sample reference and
+// reports the throughput of both
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+
+#include "am824_framer.h"
+
+#define NUM_CHANNELS 64
+#define NUM_FRAMES 4800
+#define NUM_PASSES 20
+
+using namespace std;
+
+static uint32_t nextRandom(uint32_t &state)
+{
+	state = state * 1664525 + 1013904223;
+	return(state);
+}
+
+// Frame the input through both paths in odd sized chunks so that
+// chunk boundaries land mid frame and mid channel status block
+static bool checkFramer(uint8_t bitDepth, AM824Endianess endian)
+{
+	AM824ErrorCode err;
+	AM824Framer reference(NUM_CHANNELS, bitDepth, endian, err);
+	AM824Framer block(NUM_CHANNELS, bitDepth, endian, err);
+	unsigned int numSamples = NUM_CHANNELS * NUM_FRAMES;
+	vector<uint32_t> input(numSamples);
+	vector<uint16_t> input16(numSamples);
+	vector<uint8_t> input24(numSamples * 3);
+	vector<uint8_t> expected(numSamples * 4);
+	vector<uint8_t> actual(numSamples * 4);
+	uint32_t state = bitDepth;
+	unsigned int done = 0;
+	unsigned int chunk = 1;
+
+	if (err != AM824_ERR_OK)
+	{
+		cerr << "Failed to initialise " << (int)bitDepth << " bit framer" << endl;
+		return(false);
+	}
+	for (unsigned int i = 0 ; i < numSamples ; i++)
+	{
+		uint32_t sample = nextRandom(state);
+		if (bitDepth == 16)
+		{
+			sample &= 0xffff;
+			input16[i] = (uint16_t)sample;
+		}
+		else if (bitDepth == 24)
+		{
+			sample &= 0xffffff;
+#if ST2110_AM824_HOST_LITTLE_ENDIAN
+			memcpy(&input24[i * 3], &sample, 3);
+#else
+			memcpy(&input24[i * 3], (uint8_t *)&sample + 1, 3);
+#endif
+		}
+		input[i] = sample;
+		reference.getAM824Sample(sample, &expected[i * 4]);
+	}
+
+	while (done < numSamples)
+	{
+		unsigned int n = chunk;
+		if (n > numSamples - done)
+		{
+			n = numSamples - done;
+		}
+		if (bitDepth == 16)
+		{
+			block.getAM824Samples(&input16[done], n, &actual[done * 4]);
+		}
+		else if (bitDepth == 24)
+		{
+			block.getAM824Samples24(&input24[done * 3], n, &actual[done * 4]);
+		}
+		else
+		{
+			block.getAM824Samples(&input[done], n, &actual[done * 4]);
+		}
+		done += n;
+		chunk = (chunk * 7 + 3) % 331 + 1;
+	}
+
+	if (memcmp(expected.data(), actual.data(), expected.size()))
+	{
+		cerr << "Block framer mismatch, " << (int)bitDepth << " bit, "
+			<< (endian == AM824_BIG_ENDIAN ? "big" : "little") << " endian" << endl;
+		return(false);
+	}
+
+	if (endian == AM824_BIG_ENDIAN)
+	{
+		vector<int32_t> pcm(numSamples);
+		unsigned int parityErrors = AM824Framer::getPCMSamples(actual.data(), numSamples, pcm.data());
+		for (unsigned int i = 0 ; i < numSamples ; i++)
+		{
+			uint32_t original = bitDepth == 16 ? input[i] << 16 : bitDepth == 24 ? input[i] << 8 : input[i] & 0xffffff00;
+			if ((uint32_t)pcm[i] != original)
+			{
+				cerr << "Deframe mismatch at sample " << i << ", " << (int)bitDepth << " bit" << endl;
+				return(false);
+			}
+		}
+		if (parityErrors)
+		{
+			cerr << parityErrors << " parity errors on deframe, " << (int)bitDepth << " bit" << endl;
+			return(false);
+		}
+	}
+	return(true);
+}
+
+static void benchmark(void)
+{
+	AM824ErrorCode err;
+	AM824Framer framer(NUM_CHANNELS, 32, AM824_BIG_ENDIAN, err);
+	unsigned int numSamples = NUM_CHANNELS * NUM_FRAMES;
+	vector<uint32_t> input(numSamples);
+	vector<uint8_t> output(numSamples * 4);
+	vector<int32_t> pcm(numSamples);
+	uint32_t state = 1;
+	unsigned int parityErrors = 0;
+
+	for (unsigned int i = 0 ; i < numSamples ; i++)
+	{
+		input[i] = nextRandom(state);
+	}
+
+	auto start = chrono::steady_clock::now();
+	for (unsigned int pass = 0 ; pass < NUM_PASSES ; pass++)
+	{
+		for (unsigned int i = 0 ; i < numSamples ; i++)
+		{
+			framer.getAM824Sample(input[i], &output[i * 4]);
+		}
+	}
+	auto perSample = chrono::steady_clock::now();
+	for (unsigned int pass = 0 ; pass < NUM_PASSES ; pass++)
+	{
+		framer.getAM824Samples(input.data(), numSamples, output.data());
+	}
+	auto block = chrono::steady_clock::now();
+	for (unsigned int pass = 0 ; pass < NUM_PASSES ; pass++)
+	{
+		parityErrors += AM824Framer::getPCMSamples(output.data(), numSamples, pcm.data());
+	}
+	auto deframe = chrono::steady_clock::now();
+
+	double total = (double)numSamples * NUM_PASSES;
+	double perSampleRate = total / chrono::duration<double>(perSample - start).count();
+	double blockRate = total / chrono::duration<double>(block - perSample).count();
+	double deframeRate = total / chrono::duration<double>(deframe - block).count();
+
+	cout << NUM_CHANNELS << " channels, " << NUM_FRAMES * NUM_PASSES << " frames" << endl;
+	cout << "Per-sample framing: " << perSampleRate / 1e6 << " Msamples/s" << endl;
+	cout << "Block framing:      " << blockRate / 1e6 << " Msamples/s (x" << blockRate / perSampleRate << ")" << endl;
+	cout << "Block deframing:    " << deframeRate / 1e6 << " Msamples/s, " << parityErrors << " parity errors" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+	bool ok = true;
+	uint8_t bitDepths[] = { 16, 24, 32 };
+
+	for (uint8_t bitDepth : bitDepths)
+	{
+		ok &= checkFramer(bitDepth, AM824_BIG_ENDIAN);
+		ok &= checkFramer(bitDepth, AM824_LITTLE_ENDIAN);
+	}
+	if (!ok)
+	{
+		return(EXIT_FAILURE);
+	}
+	cout << "Block framer matches per-sample framer" << endl;
+	benchmark();
+	return(EXIT_SUCCESS);
+}
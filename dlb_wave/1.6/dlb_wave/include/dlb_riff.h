@@ -247,6 +247,16 @@ dlb_riff_read_chunk_data
     ,size_t          ndata
     );
 
+/** Borrow a direct view of up to ndata octets of data from the current RIFF
+ * chunk, if the underlying file can provide one (see dlb_octfile_borrow()).
+ * Returns NULL, with *pnavail set to 0, if it cannot. */
+const unsigned char *
+dlb_riff_borrow_chunk_data
+    (dlb_riff_chunk *pck
+    ,size_t          ndata
+    ,size_t         *pnavail
+    );
+
 /** Skip to the next RIFF chunk. */
 int
 dlb_riff_skip_chunk_data
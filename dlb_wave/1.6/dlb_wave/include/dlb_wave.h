@@ -301,6 +301,17 @@ dlb_wave_read_data
     ,size_t        *pnread
     );
 
+/** Borrow a direct view of up to ndata octets of audio data from the current
+ * data chunk, when the file is memory-based or memory-mapped. The view stays
+ * valid until the file is closed. Returns NULL, with *pnavail set to 0, if no
+ * view is available; use dlb_wave_read_data() instead. */
+const void *
+dlb_wave_borrow_data
+    (dlb_wave_file *pwf
+    ,size_t         ndata
+    ,size_t        *pnavail
+    );
+
 /******************************************************************************
 functions for writing wave files
 ******************************************************************************/
@@ -184,7 +184,7 @@ dlb_riff_open_read
     )
 {
     priff->pfile = &priff->file;
-    if (NULL == dlb_octfile_open(priff->pfile, filename, "rb"))
+    if (NULL == dlb_octfile_open_mapped(priff->pfile, filename, "rb"))
     {
         priff->pfile = NULL;
         return DLB_RIFF_E_FILE;
@@ -276,6 +276,26 @@ dlb_riff_read_chunk_data
     return ndata;
 }
 
+const unsigned char *
+dlb_riff_borrow_chunk_data
+    (dlb_riff_chunk *pck
+    ,size_t          ndata
+    ,size_t         *pnavail
+    )
+{
+    const unsigned char *pdata;
+
+    assert(pck->status >= 0);
+
+    if ((pck->location + ndata) > pck->size)
+    {
+        ndata = (size_t) (pck->size - pck->location);
+    }
+    pdata = dlb_octfile_borrow(pck->priff->pfile, ndata, pnavail);
+    pck->location += *pnavail;
+    return pdata;
+}
+
 static
 int
 dlb_riff_seek_chunk_internal
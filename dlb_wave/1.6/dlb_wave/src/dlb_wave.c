@@ -670,6 +670,21 @@ dlb_wave_read_data
     return status;
 }
 
+const void *
+dlb_wave_borrow_data
+    (dlb_wave_file *pwf
+    ,size_t         ndata
+    ,size_t        *pnavail
+    )
+{
+    *pnavail = 0;
+    if (!pwf->pdata)
+    {
+        return NULL;
+    }
+    return dlb_riff_borrow_chunk_data(pwf->pdata, ndata, pnavail);
+}
+
 /******************************************************************************
 functions for writing wave files
 ******************************************************************************/
@@ -0,0 +1,363 @@
+/************************************************************************
+ * dlb_wave
+ * Copyright (c) 2025, Dolby Laboratories Inc.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ **********************************************************************/
+
+/**************************************************************************//**
+Block-buffered access to the sample data of a wave file.
+
+Reading or writing one sample at a time through dlb_wave_read_data() and
+dlb_wave_write_data() costs a chunk lookup and a dlb_octfile call per sample,
+which dominates the time spent on wide multichannel files. The sample loops
+in dlb_wave_int.c and dlb_wave_float.c instead fetch their samples from (or
+stage them in) a block of DLB_WAVE_BLOCK_OCTETS octets that is transferred
+with a single call.
+
+The block size is a multiple of every supported sample width, so a sample
+never straddles two blocks unless the file ends in the middle of one.
+
+When a caller's dlb_buffer is a single interleaved array, the samples of a
+block are in the same order as the array, and whole runs of them can be
+converted at once. On x86 the 16-, 24- and 32-bit and IEEE float runs are
+converted four or eight samples at a time with SSE2, giving the same
+results as the scalar loops, which convert whatever is left over and are
+all there is on other targets.
+******************************************************************************/
+#ifndef dlb_wave_block_H
+#define dlb_wave_block_H
+
+#include "dlb_wave/include/dlb_wave.h"
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define DLB_WAVE_SSE2
+#endif
+
+#define DLB_WAVE_BLOCK_OCTETS (12288)
+
+typedef struct
+{
+    dlb_wave_file *pwf;
+    size_t         remaining;   /**< octets still to be fetched for this call */
+    size_t         pos;         /**< read position within the block */
+    size_t         size;        /**< valid octets within the block */
+    int            status;      /**< status of the last fetch */
+    const unsigned char *block; /**< the block: data, or a view borrowed from the file */
+    unsigned char  data[DLB_WAVE_BLOCK_OCTETS];
+} dlb_wave_block_reader;
+
+typedef struct
+{
+    dlb_wave_file *pwf;
+    size_t         pos;         /**< octets staged within data */
+    int            status;      /**< status of the last flush */
+    unsigned char  data[DLB_WAVE_BLOCK_OCTETS];
+} dlb_wave_block_writer;
+
+/** Prepare to read ndata samples per channel.  IEEE float files are read as
+ *  four octets per sample, whatever their declared width. */
+static void
+dlb_wave_block_reader_init
+    (dlb_wave_block_reader *prd
+    ,dlb_wave_file         *pwf
+    ,size_t                 ndata
+    )
+{
+    size_t octets_per_frame = dlb_wave_get_channel_count(pwf);
+
+    octets_per_frame *= (dlb_wave_get_format_flags(pwf) & DLB_WAVE_FLOAT)
+                      ? 4
+                      : dlb_wave_get_format(pwf)->octets_per_sample;
+
+    prd->pwf       = pwf;
+    prd->remaining = (octets_per_frame && ndata > (size_t)-1 / octets_per_frame)
+                   ? (size_t)-1
+                   : ndata * octets_per_frame;
+    prd->pos       = 0;
+    prd->size      = 0;
+    prd->status    = DLB_RIFF_OK;
+    prd->block     = prd->data;
+}
+
+/** Refill the block, keeping any unread octets at its start.  Files that
+ *  are memory-mapped lend their data in place rather than copying it. */
+static int                      /** @return non-zero if octets are now available */
+dlb_wave_block_fill
+    (dlb_wave_block_reader *prd
+    ,size_t                 octets
+    )
+{
+    size_t kept = prd->size - prd->pos;
+    size_t want;
+    size_t nread = 0;
+
+    if (prd->status || !prd->remaining)
+    {
+        return 0;
+    }
+    if (!kept)
+    {
+        const unsigned char *view = (const unsigned char *)dlb_wave_borrow_data(prd->pwf, prd->remaining, &nread);
+
+        if (view)
+        {
+            prd->block      = view;
+            prd->remaining -= nread;
+            prd->pos        = 0;
+            prd->size       = nread;
+            if (nread >= octets || !prd->remaining)
+            {
+                return nread >= octets;
+            }
+            /* The data chunk ended part way through a sample */
+            kept = nread;
+        }
+    }
+    if (kept)
+    {
+        memmove(prd->data, prd->block + prd->pos, kept);
+    }
+    prd->block = prd->data;
+    want = sizeof(prd->data) - kept;
+    if (want > prd->remaining)
+    {
+        want = prd->remaining;
+    }
+    nread = 0;
+    prd->status = dlb_wave_read_data(prd->pwf, prd->data + kept, want, &nread);
+    prd->remaining -= want;
+    prd->pos  = 0;
+    prd->size = kept + nread;
+    return prd->size >= octets;
+}
+
+/** Return the next sample of the given width, or NULL if the data ran out
+ *  (the reason is left in prd->status). */
+static const unsigned char *
+dlb_wave_block_read
+    (dlb_wave_block_reader *prd
+    ,size_t                 octets
+    )
+{
+    const unsigned char *blob;
+
+    if (prd->size - prd->pos < octets && !dlb_wave_block_fill(prd, octets))
+    {
+        return NULL;
+    }
+    blob = prd->block + prd->pos;
+    prd->pos += octets;
+    return blob;
+}
+
+/** Return a run of up to max consecutive samples of the given width, or NULL
+ *  if the data ran out (the reason is left in prd->status). */
+static const unsigned char *
+dlb_wave_block_read_run
+    (dlb_wave_block_reader *prd
+    ,size_t                 octets
+    ,size_t                 max
+    ,size_t                *pn      /**< [out] samples in the run */
+    )
+{
+    const unsigned char *blob;
+    size_t n;
+
+    if (prd->size - prd->pos < octets && !dlb_wave_block_fill(prd, octets))
+    {
+        return NULL;
+    }
+    n = (prd->size - prd->pos) / octets;
+    if (n > max)
+    {
+        n = max;
+    }
+    blob = prd->block + prd->pos;
+    prd->pos += n * octets;
+    *pn = n;
+    return blob;
+}
+
+static void
+dlb_wave_block_writer_init
+    (dlb_wave_block_writer *pwr
+    ,dlb_wave_file         *pwf
+    )
+{
+    pwr->pwf    = pwf;
+    pwr->pos    = 0;
+    pwr->status = DLB_RIFF_OK;
+}
+
+/** Write out all staged samples. */
+static int                      /** @return status of the write */
+dlb_wave_block_flush
+    (dlb_wave_block_writer *pwr
+    )
+{
+    if (!pwr->status && pwr->pos)
+    {
+        pwr->status = dlb_wave_write_data(pwr->pwf, pwr->data, pwr->pos);
+    }
+    pwr->pos = 0;
+    return pwr->status;
+}
+
+/** Return space for the next sample of the given width, or NULL if an
+ *  earlier flush failed (the reason is left in pwr->status). */
+static unsigned char *
+dlb_wave_block_write
+    (dlb_wave_block_writer *pwr
+    ,size_t                 octets
+    )
+{
+    unsigned char *blob;
+
+    if (pwr->pos + octets > sizeof(pwr->data) && dlb_wave_block_flush(pwr))
+    {
+        return NULL;
+    }
+    blob = pwr->data + pwr->pos;
+    pwr->pos += octets;
+    return blob;
+}
+
+/** Return space for a run of up to max consecutive samples of the given
+ *  width, or NULL if an earlier flush failed. */
+static unsigned char *
+dlb_wave_block_write_run
+    (dlb_wave_block_writer *pwr
+    ,size_t                 octets
+    ,size_t                 max
+    ,size_t                *pn      /**< [out] samples in the run */
+    )
+{
+    unsigned char *blob;
+    size_t n;
+
+    if (pwr->pos + octets > sizeof(pwr->data) && dlb_wave_block_flush(pwr))
+    {
+        return NULL;
+    }
+    n = (sizeof(pwr->data) - pwr->pos) / octets;
+    if (n > max)
+    {
+        n = max;
+    }
+    blob = pwr->data + pwr->pos;
+    pwr->pos += n * octets;
+    *pn = n;
+    return blob;
+}
+
+/** Non-zero if the channel pointers of a buffer address a single interleaved
+ *  array of elements of the given size, so that a call's samples can be
+ *  converted in file order with no per-channel bookkeeping. */
+static int
+dlb_wave_block_is_interleaved
+    (const void * const pvdata[]
+    ,size_t             size
+    ,unsigned           channel_count
+    ,ptrdiff_t          nstride
+    ,size_t             ndata
+    )
+{
+    const unsigned char *base = (const unsigned char *)pvdata[0];
+    unsigned c;
+
+    if (!channel_count || nstride != (ptrdiff_t)channel_count || ndata > (size_t)-1 / channel_count)
+    {
+        return 0;
+    }
+    for (c = 1; c < channel_count; c++)
+    {
+        if ((const unsigned char *)pvdata[c] != base + c * size)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+#ifdef DLB_WAVE_SSE2
+/** Load four packed little-endian 24-bit samples (12 octets), each into the
+ *  top 24 bits of a 32-bit lane. */
+static __m128i
+dlb_wave_sse2_load24
+    (const unsigned char *blob
+    )
+{
+    const __m128i lane0 = _mm_setr_epi32(-1, 0, 0, 0);
+    const __m128i lane1 = _mm_setr_epi32(0, -1, 0, 0);
+    const __m128i lane2 = _mm_setr_epi32(0, 0, -1, 0);
+    const __m128i lane3 = _mm_setr_epi32(0, 0, 0, -1);
+    int tail;
+    __m128i v;
+
+    memcpy(&tail, blob + 8, sizeof(tail));
+    v = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)blob), _mm_cvtsi32_si128(tail));
+
+    /* shifting the register left by k octets lines sample k up with lane k */
+    v = _mm_or_si128(_mm_or_si128(_mm_and_si128(v, lane0),
+                                  _mm_and_si128(_mm_slli_si128(v, 1), lane1)),
+                     _mm_or_si128(_mm_and_si128(_mm_slli_si128(v, 2), lane2),
+                                  _mm_and_si128(_mm_slli_si128(v, 3), lane3)));
+    return _mm_slli_epi32(v, 8);
+}
+
+/** Store the low 24 bits of each 32-bit lane as four packed little-endian
+ *  24-bit samples (12 octets). */
+static void
+dlb_wave_sse2_store24
+    (unsigned char *blob
+    ,__m128i        v
+    )
+{
+    const __m128i lane0 = _mm_setr_epi32(0xFFFFFF, 0, 0, 0);
+    const __m128i lane1 = _mm_setr_epi32(0, 0xFFFFFF, 0, 0);
+    const __m128i lane2 = _mm_setr_epi32(0, 0, 0xFFFFFF, 0);
+    const __m128i lane3 = _mm_setr_epi32(0, 0, 0, 0xFFFFFF);
+    int tail;
+
+    v = _mm_or_si128(_mm_or_si128(_mm_and_si128(v, lane0),
+                                  _mm_srli_si128(_mm_and_si128(v, lane1), 1)),
+                     _mm_or_si128(_mm_srli_si128(_mm_and_si128(v, lane2), 2),
+                                  _mm_srli_si128(_mm_and_si128(v, lane3), 3)));
+    _mm_storel_epi64((__m128i *)blob, v);
+    tail = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+    memcpy(blob + 8, &tail, sizeof(tail));
+}
+#endif
+
+#endif
@@ -37,6 +37,7 @@
 #include <assert.h>
 #include "dlb_wave/include/dlb_wave_float.h"
 #include "dlb_wave/include/dlb_wave_int.h"
+#include "dlb_wave_block.h"
 
 static unsigned memle16(const unsigned char *data)
 {
@@ -260,6 +261,264 @@ round_double(double f, unsigned mant_bits)
     return l;
 }
 
+#ifdef DLB_WAVE_SSE2
+/** Scale four floats to signed integers of mant_bits + 1 bits, rounding and
+ *  saturating as round_float() does. */
+static __m128i
+dlb_wave_sse2_round_float
+    (__m128   f
+    ,unsigned mant_bits
+    )
+{
+    const long    max   = (long)((1ul << mant_bits) - 1ul);
+    const long    min   = -max - 1l;
+    const __m128  fmin  = _mm_set1_ps((float)min);
+    const __m128  fmax  = _mm_set1_ps((float)max);
+    __m128        neg;
+    __m128i       low;
+    __m128i       high;
+    __m128i       l;
+
+    f    = _mm_mul_ps(f, _mm_set1_ps(-(float)min));
+    neg  = _mm_cmplt_ps(f, _mm_setzero_ps());
+    f    = _mm_add_ps(f, _mm_or_ps(_mm_and_ps(neg, _mm_set1_ps(-0.5f)),
+                                   _mm_andnot_ps(neg, _mm_set1_ps(0.5f))));
+    low  = _mm_castps_si128(_mm_cmple_ps(f, fmin));
+    high = _mm_castps_si128(_mm_cmpge_ps(f, fmax));
+    l    = _mm_andnot_si128(_mm_or_si128(low, high), _mm_cvttps_epi32(f));
+    return _mm_or_si128(l, _mm_or_si128(_mm_and_si128(low,  _mm_set1_epi32((int)min)),
+                                        _mm_and_si128(high, _mm_set1_epi32((int)max))));
+}
+
+/** Convert four IEEE floats from a file as unpack_float() does: magnitudes
+ *  of one or more saturate, and zeros, denormals and NaNs give zero. */
+static __m128
+dlb_wave_sse2_unpack_float
+    (const unsigned char *blob
+    )
+{
+    const __m128i sign = _mm_set1_epi32((int)0x80000000u);
+    __m128i bits = _mm_loadu_si128((const __m128i *)blob);
+    __m128i mag  = _mm_andnot_si128(sign, bits);
+    __m128i zero = _mm_or_si128(_mm_cmplt_epi32(mag, _mm_set1_epi32(0x00800000)),
+                                _mm_cmpgt_epi32(mag, _mm_set1_epi32(0x7F800000)));
+    __m128i one  = _mm_cmpgt_epi32(mag, _mm_set1_epi32(0x3F7FFFFF));
+
+    bits = _mm_or_si128(_mm_andnot_si128(one, bits),
+                        _mm_and_si128(one, _mm_or_si128(_mm_and_si128(bits, sign), _mm_set1_epi32(0x3F800000))));
+    return _mm_castsi128_ps(_mm_andnot_si128(zero, bits));
+}
+
+/** Convert four floats to IEEE floats for a file as pack_float() does:
+ *  zeros and denormals give zero, and the mantissa is rounded to even, which
+ *  can carry into the exponent. */
+static void
+dlb_wave_sse2_pack_float
+    (unsigned char *blob
+    ,__m128         f
+    )
+{
+    __m128i bits = _mm_castps_si128(f);
+    __m128i mag  = _mm_and_si128(bits, _mm_set1_epi32(0x7FFFFFFF));
+    __m128i tiny = _mm_cmplt_epi32(mag, _mm_set1_epi32(0x00800000));
+
+    bits = _mm_add_epi32(bits, _mm_and_si128(bits, _mm_set1_epi32(1)));
+    _mm_storeu_si128((__m128i *)blob, _mm_andnot_si128(tiny, bits));
+}
+#endif
+
+/** Convert a run of samples, in file order, into one interleaved float array. */
+static size_t                   /** @return number of samples converted */
+dlb_wave_float_read_interleaved
+    (dlb_wave_block_reader *prd     /**< block reader on the file */
+    ,float                 *pdata   /**< interleaved destination */
+    ,size_t                 nsamples/**< samples to convert */
+    ,unsigned               octets  /**< octets per sample in the file */
+    ,int                    ieee    /**< non-zero for IEEE_FLOAT files */
+    )
+{
+    size_t done = 0;
+
+    while (done < nsamples)
+    {
+        float *pout = pdata + done;
+        const unsigned char *blob;
+        size_t n;
+        size_t k;
+
+        blob = dlb_wave_block_read_run(prd, octets, nsamples - done, &n);
+        if (!blob)
+        {
+            break;
+        }
+
+        k = 0;
+        if (ieee)
+        {
+#ifdef DLB_WAVE_SSE2
+            for (; k + 4 <= n; k += 4)
+            {
+                _mm_storeu_ps(pout + k, dlb_wave_sse2_unpack_float(blob + 4*k));
+            }
+#endif
+            for (; k < n; k++)
+            {
+                pout[k] = unpack_float(blob + 4*k);
+            }
+        }
+        else
+            switch (octets)
+            {
+            case 4:
+#ifdef DLB_WAVE_SSE2
+                for (; k + 4 <= n; k += 4)
+                {
+                    __m128 v = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(blob + 4*k)));
+
+                    _mm_storeu_ps(pout + k, _mm_mul_ps(v, _mm_set1_ps(1.0f / (1ul << 31))));
+                }
+#endif
+                for (; k < n; k++)
+                {
+                    pout[k] = twosu32(memle32(blob + 4*k)) * (1.0f / (1ul << 31));
+                }
+                break;
+            case 3:
+#ifdef DLB_WAVE_SSE2
+                for (; k + 4 <= n; k += 4)
+                {
+                    __m128 v = _mm_cvtepi32_ps(dlb_wave_sse2_load24(blob + 3*k));
+
+                    _mm_storeu_ps(pout + k, _mm_mul_ps(v, _mm_set1_ps(1.0f / (1ul << 31))));
+                }
+#endif
+                for (; k < n; k++)
+                {
+                    pout[k] = twosu32(memle24(blob + 3*k) << 8) * (1.0f / (1ul << 31));
+                }
+                break;
+            case 2:
+#ifdef DLB_WAVE_SSE2
+                for (; k + 8 <= n; k += 8)
+                {
+                    __m128i v  = _mm_loadu_si128((const __m128i *)(blob + 2*k));
+                    __m128  lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(_mm_setzero_si128(), v), 16));
+                    __m128  hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(_mm_setzero_si128(), v), 16));
+
+                    _mm_storeu_ps(pout + k,     _mm_mul_ps(lo, _mm_set1_ps(1.0f / (1ul << 15))));
+                    _mm_storeu_ps(pout + k + 4, _mm_mul_ps(hi, _mm_set1_ps(1.0f / (1ul << 15))));
+                }
+#endif
+                for (; k < n; k++)
+                {
+                    pout[k] = twosu16(memle16(blob + 2*k)) * (1.0f / (1ul << 15));
+                }
+                break;
+            default:
+                for (; k < n; k++)
+                {
+                    pout[k] = twosu16((unsigned)(blob[k] ^ 0x80u) << 8) * (1.0f / (1ul << 15));
+                }
+                break;
+            }
+        done += n;
+    }
+    return done;
+}
+
+/** Convert one interleaved float array, in file order, into a run of samples. */
+static int                      /** @return status of the write */
+dlb_wave_float_write_interleaved
+    (dlb_wave_block_writer *pwr     /**< block writer on the file */
+    ,const float           *pdata   /**< interleaved source */
+    ,size_t                 nsamples/**< samples to convert */
+    ,unsigned               octets  /**< octets per sample in the file */
+    ,int                    ieee    /**< non-zero for IEEE_FLOAT files */
+    )
+{
+    size_t done = 0;
+
+    while (done < nsamples)
+    {
+        const float *pin = pdata + done;
+        unsigned char *blob;
+        size_t n;
+        size_t k;
+
+        blob = dlb_wave_block_write_run(pwr, octets, nsamples - done, &n);
+        if (!blob)
+        {
+            return pwr->status;
+        }
+
+        k = 0;
+        if (ieee)
+        {
+#ifdef DLB_WAVE_SSE2
+            for (; k + 4 <= n; k += 4)
+            {
+                dlb_wave_sse2_pack_float(blob + 4*k, _mm_loadu_ps(pin + k));
+            }
+#endif
+            for (; k < n; k++)
+            {
+                pack_float(blob + 4*k, pin[k]);
+            }
+        }
+        else
+            switch (octets)
+            {
+            case 4:
+#ifdef DLB_WAVE_SSE2
+                for (; k + 4 <= n; k += 4)
+                {
+                    _mm_storeu_si128((__m128i *)(blob + 4*k), dlb_wave_sse2_round_float(_mm_loadu_ps(pin + k), 31));
+                }
+#endif
+                for (; k < n; k++)
+                {
+                    le32mem((unsigned long)round_float(pin[k], 31) & 0xFFFFFFFFu, blob + 4*k);
+                }
+                break;
+            case 3:
+#ifdef DLB_WAVE_SSE2
+                for (; k + 4 <= n; k += 4)
+                {
+                    dlb_wave_sse2_store24(blob + 3*k, dlb_wave_sse2_round_float(_mm_loadu_ps(pin + k), 23));
+                }
+#endif
+                for (; k < n; k++)
+                {
+                    le24mem((unsigned long)round_float(pin[k], 23) & 0xFFFFFFu, blob + 3*k);
+                }
+                break;
+            case 2:
+#ifdef DLB_WAVE_SSE2
+                for (; k + 8 <= n; k += 8)
+                {
+                    __m128i lo = dlb_wave_sse2_round_float(_mm_loadu_ps(pin + k), 15);
+                    __m128i hi = dlb_wave_sse2_round_float(_mm_loadu_ps(pin + k + 4), 15);
+
+                    _mm_storeu_si128((__m128i *)(blob + 2*k), _mm_packs_epi32(lo, hi));
+                }
+#endif
+                for (; k < n; k++)
+                {
+                    le16mem((unsigned)round_float(pin[k], 15) & 0xFFFFu, blob + 2*k);
+                }
+                break;
+            default:
+                for (; k < n; k++)
+                {
+                    blob[k] = ((unsigned)round_float(pin[k], 7) & 0xFFu) ^ 0x80u;
+                }
+                break;
+            }
+        done += n;
+    }
+    return dlb_wave_block_flush(pwr);
+}
+
 static
 int
 dlb_wave_core_float_read
@@ -273,6 +532,24 @@ dlb_wave_core_float_read
     unsigned channel_count = dlb_wave_get_channel_count(pwf);
     size_t i = 0;
     float * const * const pdata = (float * const *) pvdata;
+    int ieee = (dlb_wave_get_format_flags(pwf) & DLB_WAVE_FLOAT) != 0;
+    unsigned octets = ieee ? 4 : dlb_wave_get_format(pwf)->octets_per_sample;
+    dlb_wave_block_reader reader;
+
+    dlb_wave_block_reader_init(&reader, pwf, ndata);
+
+    if  (   octets >= 1 && octets <= 4
+        &&  dlb_wave_block_is_interleaved((const void * const *)pvdata, sizeof(float), channel_count, nstride, ndata)
+        )
+    {
+        size_t nsamples = ndata * channel_count;
+        size_t done = dlb_wave_float_read_interleaved(&reader, pdata[0], nsamples, octets, ieee);
+
+        if (pnread)
+            *pnread = done / channel_count;
+        return (done < nsamples) ? reader.status : DLB_RIFF_OK;
+    }
+
     if (dlb_wave_get_format_flags(pwf) & DLB_WAVE_FLOAT)
     {
         /* Special case for IEEE_FLOAT files.
@@ -286,15 +563,14 @@ dlb_wave_core_float_read
             unsigned c;
             for (c = 0; c < channel_count; c++)
             {
-                unsigned char blob[4];
-                int status;
+                const unsigned char *blob;
 
-                status = dlb_wave_read_data(pwf, blob, 4, 0);
-                if (status)
+                blob = dlb_wave_block_read(&reader, 4);
+                if (!blob)
                 {
                     if (pnread)
                         *pnread = i;
-                    return status;
+                    return reader.status;
                 }
 
                 /* Write the resulting data to the array */
@@ -311,14 +587,13 @@ dlb_wave_core_float_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[4];
-                    status = dlb_wave_read_data(pwf, blob, 4, 0);
-                    if (status)
+                    const unsigned char *blob;
+                    blob = dlb_wave_block_read(&reader, 4);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     pdata[c][i*nstride] = twosu32(memle32(blob)) * (1.0f / (1ul << 31));
@@ -331,15 +606,14 @@ dlb_wave_core_float_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[3];
+                    const unsigned char *blob;
 
-                    status = dlb_wave_read_data(pwf, blob, 3, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 3);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     pdata[c][i*nstride] = twosu32(memle24(blob) << 8) * (1.0f / (1ul << 31));
@@ -352,15 +626,14 @@ dlb_wave_core_float_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[2];
+                    const unsigned char *blob;
 
-                    status = dlb_wave_read_data(pwf, blob, 2, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 2);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     pdata[c][i*nstride] = twosu16(memle16(blob)) * (1.0f / (1ul << 15));
@@ -373,15 +646,14 @@ dlb_wave_core_float_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[1];
+                    const unsigned char *blob;
 
-                    status = dlb_wave_read_data(pwf, blob, 1, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 1);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     pdata[c][i*nstride] = twosu16((unsigned)(blob[0] ^ 0x80u) << 8) * (1.0f / (1ul << 15));
@@ -403,10 +675,22 @@ dlb_wave_core_float_write
     ,ptrdiff_t          nstride
     )
 {
-    int status;
     size_t i;
     unsigned channel_count = dlb_wave_get_channel_count(pwf);
     const float * const * const pdata = (const float * const *) pvdata;
+    int ieee = (dlb_wave_get_format_flags(pwf) & DLB_WAVE_FLOAT) != 0;
+    unsigned octets = ieee ? 4 : dlb_wave_get_format(pwf)->octets_per_sample;
+    dlb_wave_block_writer writer;
+
+    dlb_wave_block_writer_init(&writer, pwf);
+
+    if  (   octets >= 1 && octets <= 4
+        &&  dlb_wave_block_is_interleaved(pvdata, sizeof(float), channel_count, nstride, ndata)
+        )
+    {
+        return dlb_wave_float_write_interleaved(&writer, pdata[0], ndata * channel_count, octets, ieee);
+    }
+
     if (dlb_wave_get_format_flags(pwf) & DLB_WAVE_FLOAT)
     {
         /* Special case for IEEE_FLOAT files.
@@ -420,14 +704,13 @@ dlb_wave_core_float_write
             unsigned c;
             for (c = 0; c < channel_count; c++)
             {
-                unsigned char blob[4];
+                unsigned char *blob;
 
-                pack_float(blob, pdata[c][i*nstride]);
+                blob = dlb_wave_block_write(&writer, 4);
+                if (!blob)
+                    return writer.status;
 
-                /* write it to disk */
-                status = dlb_wave_write_data(pwf, blob, 4);
-                if (status)
-                    return status;
+                pack_float(blob, pdata[c][i*nstride]);
             }
         }
     }
@@ -441,13 +724,13 @@ dlb_wave_core_float_write
 
                 for (c = 0; c < channel_count; c++)
                 {
-                    unsigned char blob[4];
+                    unsigned char *blob;
 
-                    le32mem((unsigned long)round_float(pdata[c][i*nstride], 31) & 0xFFFFFFFFu, blob);
+                    blob = dlb_wave_block_write(&writer, 4);
+                    if (!blob)
+                        return writer.status;
 
-                    status = dlb_wave_write_data(pwf, blob, 4);
-                    if (status)
-                        return status;
+                    le32mem((unsigned long)round_float(pdata[c][i*nstride], 31) & 0xFFFFFFFFu, blob);
                 }
             }
             break;
@@ -458,13 +741,13 @@ dlb_wave_core_float_write
 
                 for (c = 0; c < channel_count; c++)
                 {
-                    unsigned char blob[3];
+                    unsigned char *blob;
 
-                    le24mem((unsigned long)round_float(pdata[c][i*nstride], 23) & 0xFFFFFFu, blob);
+                    blob = dlb_wave_block_write(&writer, 3);
+                    if (!blob)
+                        return writer.status;
 
-                    status = dlb_wave_write_data(pwf, blob, 3);
-                    if (status)
-                        return status;
+                    le24mem((unsigned long)round_float(pdata[c][i*nstride], 23) & 0xFFFFFFu, blob);
                 }
             }
             break;
@@ -475,13 +758,13 @@ dlb_wave_core_float_write
 
                 for (c = 0; c < channel_count; c++)
                 {
-                    unsigned char blob[2];
+                    unsigned char *blob;
 
-                    le16mem((unsigned)round_float(pdata[c][i*nstride], 15) & 0xFFFFu, blob);
+                    blob = dlb_wave_block_write(&writer, 2);
+                    if (!blob)
+                        return writer.status;
 
-                    status = dlb_wave_write_data(pwf, blob, 2);
-                    if (status)
-                        return status;
+                    le16mem((unsigned)round_float(pdata[c][i*nstride], 15) & 0xFFFFu, blob);
                 }
             }
             break;
@@ -492,18 +775,18 @@ dlb_wave_core_float_write
 
                 for (c = 0; c < channel_count; c++)
                 {
-                    unsigned char blob[1];
+                    unsigned char *blob;
 
-                    blob[0] = ((unsigned)round_float(pdata[c][i*nstride], 7) & 0xFFu) ^ 0x80u;
+                    blob = dlb_wave_block_write(&writer, 1);
+                    if (!blob)
+                        return writer.status;
 
-                    status = dlb_wave_write_data(pwf, blob, 1);
-                    if (status)
-                        return status;
+                    blob[0] = ((unsigned)round_float(pdata[c][i*nstride], 7) & 0xFFu) ^ 0x80u;
                 }
             }
             break;
         }
-    return DLB_RIFF_OK;
+    return dlb_wave_block_flush(&writer);
 }
 
 static
@@ -519,6 +802,10 @@ dlb_wave_core_double_read
     unsigned channel_count = dlb_wave_get_channel_count(pwf);
     size_t i = 0;
     double * const * const pdata = (double * const *) pvdata;
+    dlb_wave_block_reader reader;
+
+    dlb_wave_block_reader_init(&reader, pwf, ndata);
+
     if (dlb_wave_get_format_flags(pwf) & DLB_WAVE_FLOAT)
     {
         /* Special case for IEEE_FLOAT files.
@@ -532,15 +819,14 @@ dlb_wave_core_double_read
             unsigned c;
             for (c = 0; c < channel_count; c++)
             {
-                unsigned char blob[4];
-                int status;
+                const unsigned char *blob;
 
-                status = dlb_wave_read_data(pwf, blob, 4, 0);
-                if (status)
+                blob = dlb_wave_block_read(&reader, 4);
+                if (!blob)
                 {
                     if (pnread)
                         *pnread = i;
-                    return status;
+                    return reader.status;
                 }
 
                 /* Write the resulting data to the array */
@@ -557,15 +843,14 @@ dlb_wave_core_double_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[4];
+                    const unsigned char *blob;
 
-                    status = dlb_wave_read_data(pwf, blob, 4, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 4);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     pdata[c][i*nstride] = twosu32(memle32(blob)) * (1.0 / (1ul << 31));
@@ -578,15 +863,14 @@ dlb_wave_core_double_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[3];
+                    const unsigned char *blob;
 
-                    status = dlb_wave_read_data(pwf, blob, 3, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 3);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     pdata[c][i*nstride] = twosu32(memle24(blob) << 8) * (1.0 / (1ul << 31));
@@ -599,15 +883,14 @@ dlb_wave_core_double_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[2];
+                    const unsigned char *blob;
 
-                    status = dlb_wave_read_data(pwf, blob, 2, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 2);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     pdata[c][i*nstride] = twosu16(memle16(blob)) * (1.0 / (1ul << 15));
@@ -620,15 +903,14 @@ dlb_wave_core_double_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[1];
+                    const unsigned char *blob;
 
-                    status = dlb_wave_read_data(pwf, blob, 1, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 1);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     pdata[c][i*nstride] = twosu16((unsigned)(blob[0] ^ 0x80u) << 8) * (1.0 / (1ul << 15));
@@ -650,10 +932,13 @@ dlb_wave_core_double_write
     ,ptrdiff_t          nstride
     )
 {
-    int status;
     size_t i;
     unsigned channel_count = dlb_wave_get_channel_count(pwf);
     const double * const * const pdata = (const double * const *) pvdata;
+    dlb_wave_block_writer writer;
+
+    dlb_wave_block_writer_init(&writer, pwf);
+
     if (dlb_wave_get_format_flags(pwf) & DLB_WAVE_FLOAT)
     {
         /* Special case for IEEE_FLOAT files.
@@ -667,14 +952,13 @@ dlb_wave_core_double_write
             unsigned c;
             for (c = 0; c < channel_count; c++)
             {
-                unsigned char blob[4];
+                unsigned char *blob;
 
-                pack_float(blob, (float)pdata[c][i*nstride]);
+                blob = dlb_wave_block_write(&writer, 4);
+                if (!blob)
+                    return writer.status;
 
-                /* write it to disk */
-                status = dlb_wave_write_data(pwf, blob, 4);
-                if (status)
-                    return status;
+                pack_float(blob, (float)pdata[c][i*nstride]);
             }
         }
     }
@@ -688,13 +972,13 @@ dlb_wave_core_double_write
 
                 for (c = 0; c < channel_count; c++)
                 {
-                    unsigned char blob[4];
+                    unsigned char *blob;
 
-                    le32mem((unsigned long)round_double(pdata[c][i*nstride], 31) & 0xFFFFFFFFu, blob);
+                    blob = dlb_wave_block_write(&writer, 4);
+                    if (!blob)
+                        return writer.status;
 
-                    status = dlb_wave_write_data(pwf, blob, 4);
-                    if (status)
-                        return status;
+                    le32mem((unsigned long)round_double(pdata[c][i*nstride], 31) & 0xFFFFFFFFu, blob);
                 }
             }
             break;
@@ -705,13 +989,13 @@ dlb_wave_core_double_write
 
                 for (c = 0; c < channel_count; c++)
                 {
-                    unsigned char blob[3];
+                    unsigned char *blob;
 
-                    le24mem((unsigned long)round_double(pdata[c][i*nstride], 23) & 0xFFFFFFu, blob);
+                    blob = dlb_wave_block_write(&writer, 3);
+                    if (!blob)
+                        return writer.status;
 
-                    status = dlb_wave_write_data(pwf, blob, 3);
-                    if (status)
-                        return status;
+                    le24mem((unsigned long)round_double(pdata[c][i*nstride], 23) & 0xFFFFFFu, blob);
                 }
             }
             break;
@@ -722,13 +1006,13 @@ dlb_wave_core_double_write
 
                 for (c = 0; c < channel_count; c++)
                 {
-                    unsigned char blob[2];
+                    unsigned char *blob;
 
-                    le16mem((unsigned)round_double(pdata[c][i*nstride], 15) & 0xFFFFu, blob);
+                    blob = dlb_wave_block_write(&writer, 2);
+                    if (!blob)
+                        return writer.status;
 
-                    status = dlb_wave_write_data(pwf, blob, 2);
-                    if (status)
-                        return status;
+                    le16mem((unsigned)round_double(pdata[c][i*nstride], 15) & 0xFFFFu, blob);
                 }
             }
             break;
@@ -739,19 +1023,19 @@ dlb_wave_core_double_write
 
                 for (c = 0; c < channel_count; c++)
                 {
-                    unsigned char blob[1];
+                    unsigned char *blob;
 
-                    blob[0] = ((unsigned)round_double(pdata[c][i*nstride], 7) & 0xFFu) ^ 0x80u;
+                    blob = dlb_wave_block_write(&writer, 1);
+                    if (!blob)
+                        return writer.status;
 
-                    status = dlb_wave_write_data(pwf, blob, 1);
-                    if (status)
-                        return status;
+                    blob[0] = ((unsigned)round_double(pdata[c][i*nstride], 7) & 0xFFu) ^ 0x80u;
                 }
             }
 
             break;
         }
-    return DLB_RIFF_OK;
+    return dlb_wave_block_flush(&writer);
 }
 
 int
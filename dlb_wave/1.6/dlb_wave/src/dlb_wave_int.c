@@ -34,6 +34,7 @@
  **********************************************************************/
 
 #include "dlb_wave/include/dlb_wave_int.h"
+#include "dlb_wave_block.h"
 #include <assert.h>
 
 /**************************************************************************//**
@@ -362,6 +363,10 @@ dlb_wave_short_16_read
     unsigned channel_count = dlb_wave_get_channel_count(pwf);
     size_t i = 0;
     short * const * const pdata = (short * const *) pvdata;
+    dlb_wave_block_reader reader;
+
+    dlb_wave_block_reader_init(&reader, pwf, ndata);
+
     if (dlb_wave_get_format_flags(pwf) & DLB_WAVE_FLOAT)
     {
         /* Special case for IEEE_FLOAT files.
@@ -375,15 +380,14 @@ dlb_wave_short_16_read
             unsigned c;
             for (c = 0; c < channel_count; c++)
             {
-                unsigned char blob[4];
-                int status;
+                const unsigned char *blob;
 
-                status = dlb_wave_read_data(pwf, blob, 4, 0);
-                if (status)
+                blob = dlb_wave_block_read(&reader, 4);
+                if (!blob)
                 {
                     if (pnread)
                         *pnread = i;
-                    return status;
+                    return reader.status;
                 }
 
                 /* Write the resulting data to the array */
@@ -400,17 +404,16 @@ dlb_wave_short_16_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[4];
+                    const unsigned char *blob;
                     unsigned valint;
                     unsigned valfrac;
 
-                    status = dlb_wave_read_data(pwf, blob, 4, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 4);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     valint  = memle16(blob + 2);
@@ -427,17 +430,16 @@ dlb_wave_short_16_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[3];
+                    const unsigned char *blob;
                     unsigned valint;
                     unsigned valfrac;
 
-                    status = dlb_wave_read_data(pwf, blob, 3, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 3);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     valint  = memle16(blob + 1);
@@ -454,15 +456,14 @@ dlb_wave_short_16_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[2];
+                    const unsigned char *blob;
 
-                    status = dlb_wave_read_data(pwf, blob, 2, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 2);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     pdata[c][i*nstride] = (short)twosu16(memle16(blob));
@@ -475,15 +476,14 @@ dlb_wave_short_16_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[1];
+                    const unsigned char *blob;
                     
-                    status = dlb_wave_read_data(pwf, blob, 1, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 1);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     pdata[c][i*nstride] = (short)twosu16(((blob[0] & 0xFFu) ^ 0x80u) << 8);
@@ -504,10 +504,13 @@ dlb_wave_short_16_write
     ,ptrdiff_t           nstride    /**< distance (chars) between samples of one channel */
     )
 {
-    int status;
     size_t i;
     unsigned channel_count = dlb_wave_get_channel_count(pwf);
     const short * const * const pdata = (const short * const *) pvdata;
+    dlb_wave_block_writer writer;
+
+    dlb_wave_block_writer_init(&writer, pwf);
+
     if (dlb_wave_get_format_flags(pwf) & DLB_WAVE_FLOAT)
     {
         /* Special case for IEEE_FLOAT files.
@@ -521,14 +524,13 @@ dlb_wave_short_16_write
             unsigned c;
             for (c = 0; c < channel_count; c++)
             {
-                unsigned char blob[4];
+                unsigned char *blob;
 
-                pack_long_float(blob, pdata[c][i*nstride], 15);
+                blob = dlb_wave_block_write(&writer, 4);
+                if (!blob)
+                    return writer.status;
 
-                /* write it to disk */
-                status = dlb_wave_write_data(pwf, blob, 4);
-                if (status)
-                    return status;
+                pack_long_float(blob, pdata[c][i*nstride], 15);
             }
         }
     }
@@ -543,15 +545,15 @@ dlb_wave_short_16_write
                 for (c = 0; c < channel_count; c++)
                 {
                     unsigned x = (unsigned)pdata[c][i*nstride];
-                    unsigned char blob[4];
+                    unsigned char *blob;
+
+                    blob = dlb_wave_block_write(&writer, 4);
+                    if (!blob)
+                        return writer.status;
 
                     blob[0] = 0;
                     blob[1] = 0;
                     le16mem(x & 0xFFFFu, blob + 2);
-
-                    status = dlb_wave_write_data(pwf, blob, 4);
-                    if (status)
-                        return status;
                 }
             }
             break;
@@ -563,14 +565,14 @@ dlb_wave_short_16_write
                 for (c = 0; c < channel_count; c++)
                 {
                     unsigned x = (unsigned)pdata[c][i*nstride];
-                    unsigned char blob[3];
+                    unsigned char *blob;
+
+                    blob = dlb_wave_block_write(&writer, 3);
+                    if (!blob)
+                        return writer.status;
 
                     blob[0] = 0;
                     le16mem(x & 0xFFFFu, blob + 1);
-
-                    status = dlb_wave_write_data(pwf, blob, 3);
-                    if (status)
-                        return status;
                 }
             }
             break;
@@ -582,13 +584,13 @@ dlb_wave_short_16_write
                 for (c = 0; c < channel_count; c++)
                 {
                     unsigned x = (unsigned)pdata[c][i*nstride];
-                    unsigned char blob[2];
+                    unsigned char *blob;
 
-                    le16mem(x & 0xFFFFu, blob);
+                    blob = dlb_wave_block_write(&writer, 2);
+                    if (!blob)
+                        return writer.status;
 
-                    status = dlb_wave_write_data(pwf, blob, 2);
-                    if (status)
-                        return status;
+                    le16mem(x & 0xFFFFu, blob);
                 }
             }
             break;
@@ -600,24 +602,207 @@ dlb_wave_short_16_write
                 for (c = 0; c < channel_count; c++)
                 {
                     unsigned x = (unsigned)pdata[c][i*nstride];
-                    unsigned char blob[1];
+                    unsigned char *blob;
                     unsigned valint;
                     unsigned valfrac;
 
+                    blob = dlb_wave_block_write(&writer, 1);
+                    if (!blob)
+                        return writer.status;
+
                     valint  = x >> 8;
                     valfrac = x & 0xFFu;
                     valint += (valint != 0x7Fu && (valfrac > 0x80u || (valfrac == 0x80u && valint & 0x1u)));
 
                     blob[0] = (unsigned char)((valint & 0xFFu) ^ 0x80u);
-
-                    status = dlb_wave_write_data(pwf, blob, 1);
-                    if (status)
-                        return status;
                 }
             }
             break;
         }
-    return DLB_RIFF_OK;
+    return dlb_wave_block_flush(&writer);
+}
+
+#ifdef DLB_WAVE_SSE2
+/** Shift four ints down by shift bits, rounding and saturating as
+ *  intmax_to_twos() does; the result is left in the low bits of each lane. */
+static __m128i
+dlb_wave_sse2_round_down
+    (__m128i  x
+    ,unsigned shift
+    )
+{
+    const __m128i one     = _mm_set1_epi32(1);
+    const __m128i half    = _mm_set1_epi32(1 << (shift - 1));
+    const __m128i max     = _mm_set1_epi32(INT_MAX >> shift);
+    __m128i valint        = _mm_srl_epi32(x, _mm_cvtsi32_si128((int)shift));
+    __m128i valfrac       = _mm_and_si128(x, _mm_set1_epi32((1 << shift) - 1));
+    __m128i odd           = _mm_cmpeq_epi32(_mm_and_si128(valint, one), one);
+    __m128i up;
+
+    up = _mm_or_si128(_mm_cmpgt_epi32(valfrac, half),
+                      _mm_and_si128(_mm_cmpeq_epi32(valfrac, half), odd));
+    up = _mm_andnot_si128(_mm_cmpeq_epi32(valint, max), up);
+    return _mm_sub_epi32(valint, up);
+}
+#endif
+
+/** Convert a run of samples, in file order, into one interleaved int array. */
+static size_t                   /** @return number of samples converted */
+dlb_wave_int_left_read_interleaved
+    (dlb_wave_block_reader *prd     /**< block reader on the file */
+    ,int                   *pdata   /**< interleaved destination */
+    ,size_t                 nsamples/**< samples to convert */
+    ,unsigned               octets  /**< octets per sample in the file */
+    )
+{
+    size_t done = 0;
+
+    while (done < nsamples)
+    {
+        int *pout = pdata + done;
+        const unsigned char *blob;
+        size_t n;
+        size_t k;
+
+        blob = dlb_wave_block_read_run(prd, octets, nsamples - done, &n);
+        if (!blob)
+        {
+            break;
+        }
+
+        k = 0;
+        switch (octets)
+        {
+        case 4:
+#ifdef DLB_WAVE_SSE2
+            for (; k + 4 <= n; k += 4)
+            {
+                _mm_storeu_si128((__m128i *)(pout + k), _mm_loadu_si128((const __m128i *)(blob + 4*k)));
+            }
+#endif
+            for (; k < n; k++)
+            {
+                pout[k] = twos_to_intmax(memle32(blob + 4*k), 0x7FFFFFFFul);
+            }
+            break;
+        case 3:
+#ifdef DLB_WAVE_SSE2
+            for (; k + 4 <= n; k += 4)
+            {
+                _mm_storeu_si128((__m128i *)(pout + k), dlb_wave_sse2_load24(blob + 3*k));
+            }
+#endif
+            for (; k < n; k++)
+            {
+                pout[k] = twos_to_intmax(memle24(blob + 3*k), 0x7FFFFFul);
+            }
+            break;
+        case 2:
+#ifdef DLB_WAVE_SSE2
+            for (; k + 8 <= n; k += 8)
+            {
+                __m128i v = _mm_loadu_si128((const __m128i *)(blob + 2*k));
+
+                _mm_storeu_si128((__m128i *)(pout + k),     _mm_unpacklo_epi16(_mm_setzero_si128(), v));
+                _mm_storeu_si128((__m128i *)(pout + k + 4), _mm_unpackhi_epi16(_mm_setzero_si128(), v));
+            }
+#endif
+            for (; k < n; k++)
+            {
+                pout[k] = twos_to_intmax(memle16(blob + 2*k), 0x7FFFu);
+            }
+            break;
+        default:
+            for (; k < n; k++)
+            {
+                pout[k] = twos_to_intmax(blob[k] ^ 0x80u, 0x7Fu);
+            }
+            break;
+        }
+        done += n;
+    }
+    return done;
+}
+
+/** Convert one interleaved int array, in file order, into a run of samples. */
+static int                      /** @return status of the write */
+dlb_wave_int_left_write_interleaved
+    (dlb_wave_block_writer *pwr     /**< block writer on the file */
+    ,const int             *pdata   /**< interleaved source */
+    ,size_t                 nsamples/**< samples to convert */
+    ,unsigned               octets  /**< octets per sample in the file */
+    )
+{
+    size_t done = 0;
+
+    while (done < nsamples)
+    {
+        const int *pin = pdata + done;
+        unsigned char *blob;
+        size_t n;
+        size_t k;
+
+        blob = dlb_wave_block_write_run(pwr, octets, nsamples - done, &n);
+        if (!blob)
+        {
+            return pwr->status;
+        }
+
+        k = 0;
+        switch (octets)
+        {
+        case 4:
+#ifdef DLB_WAVE_SSE2
+            for (; k + 4 <= n; k += 4)
+            {
+                _mm_storeu_si128((__m128i *)(blob + 4*k), _mm_loadu_si128((const __m128i *)(pin + k)));
+            }
+#endif
+            for (; k < n; k++)
+            {
+                le32mem(intmax_to_twos(pin[k], 0x7FFFFFFFul), blob + 4*k);
+            }
+            break;
+        case 3:
+#ifdef DLB_WAVE_SSE2
+            for (; k + 4 <= n; k += 4)
+            {
+                dlb_wave_sse2_store24(blob + 3*k, dlb_wave_sse2_round_down(_mm_loadu_si128((const __m128i *)(pin + k)), 8));
+            }
+#endif
+            for (; k < n; k++)
+            {
+                le24mem(intmax_to_twos(pin[k], 0x7FFFFFul), blob + 3*k);
+            }
+            break;
+        case 2:
+#ifdef DLB_WAVE_SSE2
+            for (; k + 8 <= n; k += 8)
+            {
+                __m128i lo = dlb_wave_sse2_round_down(_mm_loadu_si128((const __m128i *)(pin + k)), 16);
+                __m128i hi = dlb_wave_sse2_round_down(_mm_loadu_si128((const __m128i *)(pin + k + 4)), 16);
+
+                /* sign-extend the 16-bit results so that packing cannot saturate */
+                lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+                hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+                _mm_storeu_si128((__m128i *)(blob + 2*k), _mm_packs_epi32(lo, hi));
+            }
+#endif
+            for (; k < n; k++)
+            {
+                le16mem((unsigned)intmax_to_twos(pin[k], 0x7FFFu), blob + 2*k);
+            }
+            break;
+        default:
+            for (; k < n; k++)
+            {
+                blob[k] = (unsigned char)intmax_to_twos(pin[k], 0x7Fu) ^ 0x80;
+            }
+            break;
+        }
+        done += n;
+    }
+    return dlb_wave_block_flush(pwr);
 }
 
 /** Read some audio data from the file. */
@@ -633,6 +818,25 @@ dlb_wave_int_left_read
     unsigned channel_count = dlb_wave_get_channel_count(pwf);
     size_t i = 0;
     int * const * const pdata = (int * const *) pvdata;
+    unsigned octets = dlb_wave_get_format(pwf)->octets_per_sample;
+    dlb_wave_block_reader reader;
+
+    dlb_wave_block_reader_init(&reader, pwf, ndata);
+
+    if  (   !(dlb_wave_get_format_flags(pwf) & DLB_WAVE_FLOAT)
+        &&  octets >= 1 && octets <= 4
+        &&  dlb_wave_block_is_interleaved((const void * const *)pvdata, sizeof(int), channel_count, nstride, ndata)
+        )
+    {
+        /* One interleaved array, as pmd_tool and most capture code use */
+        size_t nsamples = ndata * channel_count;
+        size_t done = dlb_wave_int_left_read_interleaved(&reader, pdata[0], nsamples, octets);
+
+        if (pnread)
+            *pnread = done / channel_count;
+        return (done < nsamples) ? reader.status : DLB_RIFF_OK;
+    }
+
     if (dlb_wave_get_format_flags(pwf) & DLB_WAVE_FLOAT)
     {
         /* Special case for IEEE_FLOAT files.
@@ -646,15 +850,14 @@ dlb_wave_int_left_read
             unsigned c;
             for (c = 0; c < channel_count; c++)
             {
-                unsigned char blob[4];
-                int status;
+                const unsigned char *blob;
 
-                status = dlb_wave_read_data(pwf, blob, 4, 0);
-                if (status)
+                blob = dlb_wave_block_read(&reader, 4);
+                if (!blob)
                 {
                     if (pnread)
                         *pnread = i;
-                    return status;
+                    return reader.status;
                 }
 
                 /* Write the resulting data to the array */
@@ -671,15 +874,14 @@ dlb_wave_int_left_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[4];
+                    const unsigned char *blob;
 
-                    status = dlb_wave_read_data(pwf, blob, 4, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 4);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     pdata[c][i*nstride] = twos_to_intmax(memle32(blob), 0x7FFFFFFFul);
@@ -692,15 +894,14 @@ dlb_wave_int_left_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[3];
+                    const unsigned char *blob;
 
-                    status = dlb_wave_read_data(pwf, blob, 3, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 3);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     pdata[c][i*nstride] = twos_to_intmax(memle24(blob), 0x7FFFFFul);
@@ -713,15 +914,14 @@ dlb_wave_int_left_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[2];
+                    const unsigned char *blob;
 
-                    status = dlb_wave_read_data(pwf, blob, 2, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 2);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     pdata[c][i*nstride] = twos_to_intmax(memle16(blob), 0x7FFFu);
@@ -734,15 +934,14 @@ dlb_wave_int_left_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[1];
+                    const unsigned char *blob;
 
-                    status = dlb_wave_read_data(pwf, blob, 1, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 1);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     pdata[c][i*nstride] = twos_to_intmax(blob[0] ^ 0x80u, 0x7Fu);
@@ -765,10 +964,22 @@ dlb_wave_int_left_write
     ,ptrdiff_t          nstride    /**< distance (chars) between samples of one channel */
     )
 {
-    int status;
     size_t i;
     unsigned channel_count = dlb_wave_get_channel_count(pwf);
     const int * const * const pdata = (const int * const *) pvdata;
+    unsigned octets = dlb_wave_get_format(pwf)->octets_per_sample;
+    dlb_wave_block_writer writer;
+
+    dlb_wave_block_writer_init(&writer, pwf);
+
+    if  (   !(dlb_wave_get_format_flags(pwf) & DLB_WAVE_FLOAT)
+        &&  octets >= 1 && octets <= 4
+        &&  dlb_wave_block_is_interleaved(pvdata, sizeof(int), channel_count, nstride, ndata)
+        )
+    {
+        return dlb_wave_int_left_write_interleaved(&writer, pdata[0], ndata * channel_count, octets);
+    }
+
     if (dlb_wave_get_format_flags(pwf) & DLB_WAVE_FLOAT)
     {
         /* Special case for IEEE_FLOAT files.
@@ -782,14 +993,13 @@ dlb_wave_int_left_write
             unsigned c;
             for (c = 0; c < channel_count; c++)
             {
-                unsigned char blob[4];
+                unsigned char *blob;
 
-                pack_long_float(blob, pdata[c][i*nstride], DLB_LOGRATIO2(INT_MAX, 1) + 1);
+                blob = dlb_wave_block_write(&writer, 4);
+                if (!blob)
+                    return writer.status;
 
-                /* write it to disk */
-                status = dlb_wave_write_data(pwf, blob, 4);
-                if (status)
-                    return status;
+                pack_long_float(blob, pdata[c][i*nstride], DLB_LOGRATIO2(INT_MAX, 1) + 1);
             }
         }
     }
@@ -803,13 +1013,13 @@ dlb_wave_int_left_write
 
                 for (c = 0; c < channel_count; c++)
                 {
-                    unsigned char blob[4];
+                    unsigned char *blob;
 
-                    le32mem(intmax_to_twos(pdata[c][i*nstride], 0x7FFFFFFFul), blob);
+                    blob = dlb_wave_block_write(&writer, 4);
+                    if (!blob)
+                        return writer.status;
 
-                    status = dlb_wave_write_data(pwf, blob, 4);
-                    if (status)
-                        return status;
+                    le32mem(intmax_to_twos(pdata[c][i*nstride], 0x7FFFFFFFul), blob);
                 }
             }
             break;
@@ -820,13 +1030,13 @@ dlb_wave_int_left_write
 
                 for (c = 0; c < channel_count; c++)
                 {
-                    unsigned char blob[3];
+                    unsigned char *blob;
 
-                    le24mem(intmax_to_twos(pdata[c][i*nstride], 0x7FFFFFul), blob);
+                    blob = dlb_wave_block_write(&writer, 3);
+                    if (!blob)
+                        return writer.status;
 
-                    status = dlb_wave_write_data(pwf, blob, 3);
-                    if (status)
-                        return status;
+                    le24mem(intmax_to_twos(pdata[c][i*nstride], 0x7FFFFFul), blob);
                 }
             }
             break;
@@ -837,13 +1047,13 @@ dlb_wave_int_left_write
 
                 for (c = 0; c < channel_count; c++)
                 {
-                    unsigned char blob[2];
+                    unsigned char *blob;
 
-                    le16mem((unsigned)intmax_to_twos(pdata[c][i*nstride], 0x7FFFu), blob);
+                    blob = dlb_wave_block_write(&writer, 2);
+                    if (!blob)
+                        return writer.status;
 
-                    status = dlb_wave_write_data(pwf, blob, 2);
-                    if (status)
-                        return status;
+                    le16mem((unsigned)intmax_to_twos(pdata[c][i*nstride], 0x7FFFu), blob);
                 }
             }
             break;
@@ -854,18 +1064,18 @@ dlb_wave_int_left_write
 
                 for (c = 0; c < channel_count; c++)
                 {
-                    unsigned char blob[1];
+                    unsigned char *blob;
 
-                    blob[0] = (unsigned char)intmax_to_twos(pdata[c][i*nstride], 0x7Fu) ^ 0x80;
+                    blob = dlb_wave_block_write(&writer, 1);
+                    if (!blob)
+                        return writer.status;
 
-                    status = dlb_wave_write_data(pwf, blob, 1);
-                    if (status)
-                        return status;
+                    blob[0] = (unsigned char)intmax_to_twos(pdata[c][i*nstride], 0x7Fu) ^ 0x80;
                 }
             }
             break;
         }
-    return DLB_RIFF_OK;
+    return dlb_wave_block_flush(&writer);
 }
 
 /** Read some audio data from the file. */
@@ -882,6 +1092,10 @@ dlb_wave_long_32_read
     unsigned channel_count = dlb_wave_get_channel_count(pwf);
     size_t i = 0;
     long * const * const pdata = (long * const *) pvdata;
+    dlb_wave_block_reader reader;
+
+    dlb_wave_block_reader_init(&reader, pwf, ndata);
+
     if (dlb_wave_get_format_flags(pwf) & DLB_WAVE_FLOAT)
     {
         /* Special case for IEEE_FLOAT files.
@@ -895,15 +1109,14 @@ dlb_wave_long_32_read
             unsigned c;
             for (c = 0; c < channel_count; c++)
             {
-                unsigned char blob[4];
-                int status;
+                const unsigned char *blob;
 
-                status = dlb_wave_read_data(pwf, blob, 4, 0);
-                if (status)
+                blob = dlb_wave_block_read(&reader, 4);
+                if (!blob)
                 {
                     if (pnread)
                         *pnread = i;
-                    return status;
+                    return reader.status;
                 }
 
                 /* Write the resulting data to the array */
@@ -920,15 +1133,14 @@ dlb_wave_long_32_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[4];
+                    const unsigned char *blob;
 
-                    status = dlb_wave_read_data(pwf, blob, 4, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 4);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     pdata[c][i*nstride] = twosu32(memle32(blob));
@@ -941,15 +1153,14 @@ dlb_wave_long_32_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[3];
+                    const unsigned char *blob;
 
-                    status = dlb_wave_read_data(pwf, blob, 3, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 3);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     pdata[c][i*nstride] = twosu32(memle24(blob) << 8);
@@ -962,15 +1173,14 @@ dlb_wave_long_32_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[2];
+                    const unsigned char *blob;
 
-                    status = dlb_wave_read_data(pwf, blob, 2, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 2);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     pdata[c][i*nstride] = twosu32((unsigned long)memle16(blob) << 16);
@@ -983,15 +1193,14 @@ dlb_wave_long_32_read
                 unsigned c;
                 for (c = 0; c < channel_count; c++)
                 {
-                    int status;
-                    unsigned char blob[1];
+                    const unsigned char *blob;
 
-                    status = dlb_wave_read_data(pwf, blob, 1, 0);
-                    if (status)
+                    blob = dlb_wave_block_read(&reader, 1);
+                    if (!blob)
                     {
                         if (pnread)
                             *pnread = i;
-                        return status;
+                        return reader.status;
                     }
 
                     pdata[c][i*nstride] = twosu32((unsigned long)((blob[0] & 0xFFu) ^ 0x80u) << 24);
@@ -1014,10 +1223,13 @@ dlb_wave_long_32_write
     ,ptrdiff_t          nstride    /**< distance (longs) between samples of one channel */
     )
 {
-    int status;
     size_t i;
     unsigned channel_count = dlb_wave_get_channel_count(pwf);
     const long * const * const pdata = (const long * const *) pvdata;
+    dlb_wave_block_writer writer;
+
+    dlb_wave_block_writer_init(&writer, pwf);
+
     if (dlb_wave_get_format_flags(pwf) & DLB_WAVE_FLOAT)
     {
         /* Special case for IEEE_FLOAT files.
@@ -1031,14 +1243,13 @@ dlb_wave_long_32_write
             unsigned c;
             for (c = 0; c < channel_count; c++)
             {
-                unsigned char blob[4];
+                unsigned char *blob;
 
-                pack_long_float(blob, pdata[c][i*nstride], 31);
+                blob = dlb_wave_block_write(&writer, 4);
+                if (!blob)
+                    return writer.status;
 
-                /* write it to disk */
-                status = dlb_wave_write_data(pwf, blob, 4);
-                if (status)
-                    return status;
+                pack_long_float(blob, pdata[c][i*nstride], 31);
             }
         }
     }
@@ -1053,13 +1264,13 @@ dlb_wave_long_32_write
                 for (c = 0; c < channel_count; c++)
                 {
                     unsigned long x = (unsigned long)pdata[c][i*nstride];
-                    unsigned char blob[4];
+                    unsigned char *blob;
 
-                    le32mem(x & 0xFFFFFFFFu, blob);
+                    blob = dlb_wave_block_write(&writer, 4);
+                    if (!blob)
+                        return writer.status;
 
-                    status = dlb_wave_write_data(pwf, blob, 4);
-                    if (status)
-                        return status;
+                    le32mem(x & 0xFFFFFFFFu, blob);
                 }
             }
             break;
@@ -1071,19 +1282,19 @@ dlb_wave_long_32_write
                 for (c = 0; c < channel_count; c++)
                 {
                     unsigned long x = (unsigned long)pdata[c][i*nstride];
-                    unsigned char blob[3];
+                    unsigned char *blob;
                     unsigned long valint;
                     unsigned valfrac;
 
+                    blob = dlb_wave_block_write(&writer, 3);
+                    if (!blob)
+                        return writer.status;
+
                     valint  = (x >> 8);
                     valfrac = (unsigned)(x & 0xFFu);
                     valint += (valint != 0x7FFFFFu && (valfrac > 0x80u || (valfrac == 0x80u && valint & 0x1u)));
 
                     le24mem(valint & 0xFFFFFFu, blob);
-
-                    status = dlb_wave_write_data(pwf, blob, 3);
-                    if (status)
-                        return status;
                 }
             }
             break;
@@ -1095,19 +1306,19 @@ dlb_wave_long_32_write
                 for (c = 0; c < channel_count; c++)
                 {
                     unsigned long x = (unsigned long)pdata[c][i*nstride];
-                    unsigned char blob[2];
+                    unsigned char *blob;
                     unsigned valint;
                     unsigned valfrac;
 
+                    blob = dlb_wave_block_write(&writer, 2);
+                    if (!blob)
+                        return writer.status;
+
                     valint  = (unsigned)(x >> 16);
                     valfrac = (unsigned)(x & 0xFFFFu);
                     valint += (valint != 0x7FFFu && (valfrac > 0x8000u || (valfrac == 0x8000u && valint & 0x1u)));
 
                     le16mem(valint & 0xFFFFu, blob);
-
-                    status = dlb_wave_write_data(pwf, blob, 2);
-                    if (status)
-                        return status;
                 }
             }
             break;
@@ -1119,24 +1330,24 @@ dlb_wave_long_32_write
                 for (c = 0; c < channel_count; c++)
                 {
                     unsigned long x = (unsigned long)pdata[c][i*nstride];
-                    unsigned char blob[1];
+                    unsigned char *blob;
                     unsigned valint;
                     unsigned long valfrac;
 
+                    blob = dlb_wave_block_write(&writer, 1);
+                    if (!blob)
+                        return writer.status;
+
                     valint  = (unsigned)(x >> 24);
                     valfrac = (x & 0xFFFFFFu);
                     valint += (valint != 0x7Fu && (valfrac > 0x800000u || (valfrac == 0x800000u && valint & 0x1u)));
 
                     blob[0] = (valint & 0xFFu) ^ 0x80u;
-
-                    status = dlb_wave_write_data(pwf, blob, 1);
-                    if (status)
-                        return status;
                 }
             }
             break;
         }
-    return DLB_RIFF_OK;
+    return dlb_wave_block_flush(&writer);
 }
 
 int
@@ -1155,6 +1155,432 @@ dlb_wave_write_test_proc
     }
 }
 
+/* The sample loops read and write through a block of octets. When the
+ * caller's dlb_buffer is a single interleaved array, whole runs of samples
+ * are converted at once; otherwise (and when a call asks for one frame) the
+ * samples are converted one at a time as before. These tests check that the
+ * two paths agree exactly for every sample format and buffer type, over
+ * files that span several blocks.
+ *
+ * Wave files are always little-endian. The sample data is chosen so that
+ * every octet of a sample differs from the others, in both positive and
+ * negative samples, so any octet order mix-up in either path shows. */
+
+#define BLOCK_TEST_CHANNELS (3)
+#define BLOCK_TEST_FRAMES   (5000)  /* at least one block even for 8 bit */
+#define BLOCK_TEST_CALL     (997)   /* frames per call on the run path */
+
+typedef struct {
+    unsigned                   format_flags;
+    unsigned                   bits_per_sample;
+} dlb_wave_block_test;
+
+static size_t get_dlb_buffer_element_size(int buffer_format)
+{
+    switch (buffer_format)
+    {
+    case DLB_BUFFER_SHORT_16:   return sizeof(short);
+    case DLB_BUFFER_INT_LEFT:   return sizeof(int);
+    case DLB_BUFFER_LONG_32:    return sizeof(long);
+    case DLB_BUFFER_FLOAT:      return sizeof(float);
+    default:                    return sizeof(double);
+    }
+}
+
+/* Fill the data chunk of a block test file. The first frames hold extreme
+ * and octet-order sensitive patterns, the rest are pseudo-random. */
+static void dlb_wave_block_test_fill(unsigned char *p_data, size_t size, unsigned octets)
+{
+    static const unsigned char patterns[][4] =
+        {{0x00, 0x00, 0x00, 0x00}
+        ,{0xFF, 0xFF, 0xFF, 0xFF}
+        ,{0x00, 0x00, 0x00, 0x80}
+        ,{0xFF, 0xFF, 0xFF, 0x7F}
+        ,{0x01, 0x23, 0x45, 0x67}
+        ,{0x67, 0x45, 0x23, 0x01}
+        ,{0xEF, 0xCD, 0xAB, 0x89}
+        ,{0x89, 0xAB, 0xCD, 0xEF}
+        ,{0x01, 0x00, 0x00, 0xFF}
+        ,{0xFF, 0x00, 0x00, 0x01}
+        ,{0x00, 0x00, 0x80, 0x3F}   /* 1.0f */
+        ,{0x00, 0x00, 0x80, 0xBF}   /* -1.0f */
+        };
+    const size_t nb_patterns = sizeof(patterns) / sizeof(patterns[0]);
+    unsigned long seed = 0x2545F491ul;
+    size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        size_t sample = i / octets;
+
+        if (sample < nb_patterns)
+        {
+            p_data[i] = patterns[sample][4 - octets + i % octets];
+        }
+        else
+        {
+            seed = (seed * 1103515245ul + 12345ul) & 0xFFFFFFFFul;
+            p_data[i] = (unsigned char)(seed >> 16);
+        }
+    }
+}
+
+/* Point the channels of a dlb_buffer at one interleaved array. */
+static void dlb_wave_block_test_interleave(dlb_buffer *p_buf, void **ap_pointers, void *p_array, int buffer_format, size_t first_frame)
+{
+    size_t element_size = get_dlb_buffer_element_size(buffer_format);
+    unsigned k;
+
+    for (k = 0; k < BLOCK_TEST_CHANNELS; k++)
+    {
+        ap_pointers[k] = (char *)p_array + ((first_frame * BLOCK_TEST_CHANNELS) + k) * element_size;
+    }
+    p_buf->data_type = buffer_format;
+    p_buf->nchannel  = BLOCK_TEST_CHANNELS;
+    p_buf->nstride   = BLOCK_TEST_CHANNELS;
+    p_buf->ppdata    = ap_pointers;
+}
+
+/* Point the channels of a dlb_buffer at one frame of a planar array, so that
+ * the samples are converted one at a time. */
+static void dlb_wave_block_test_planar(dlb_buffer *p_buf, void **ap_pointers, void *p_array, int buffer_format, size_t frame)
+{
+    size_t element_size = get_dlb_buffer_element_size(buffer_format);
+    unsigned k;
+
+    for (k = 0; k < BLOCK_TEST_CHANNELS; k++)
+    {
+        ap_pointers[k] = (char *)p_array + ((k * BLOCK_TEST_FRAMES) + frame) * element_size;
+    }
+    p_buf->data_type = buffer_format;
+    p_buf->nchannel  = BLOCK_TEST_CHANNELS;
+    p_buf->nstride   = 1;
+    p_buf->ppdata    = ap_pointers;
+}
+
+/* Read every frame of a wave file in memory, either BLOCK_TEST_CALL frames at
+ * a time into an interleaved array, or one frame at a time into a planar
+ * array, then try to read one frame more. Returns the number of frames read,
+ * and the status of the last read in *p_status. */
+static size_t dlb_wave_block_test_read(const void *p_riff, size_t riff_size, void *p_array, int buffer_format, int b_interleaved, int *p_status)
+{
+    dlb_octfile f;
+    dlb_octfile *p_f;
+    dlb_wave_file wave;
+    void *ap_pointers[BLOCK_TEST_CHANNELS];
+    double a_extra_frame[BLOCK_TEST_CHANNELS];
+    dlb_buffer buf;
+    size_t total = 0;
+    size_t frames_read;
+    int err;
+
+    p_f = dlb_octfile_open_memory_fixed(&f, riff_size, (char *)p_riff, "rb");
+    if (p_f == NULL)
+    {
+        abort();
+    }
+
+    err = dlb_wave_octfile_read(&wave, p_f, NULL);
+    if (!err)
+    {
+        while (!err && total < BLOCK_TEST_FRAMES)
+        {
+            size_t frames = 1;
+
+            if (b_interleaved)
+            {
+                frames = BLOCK_TEST_FRAMES - total;
+                if (frames > BLOCK_TEST_CALL)
+                {
+                    frames = BLOCK_TEST_CALL;
+                }
+                dlb_wave_block_test_interleave(&buf, ap_pointers, p_array, buffer_format, total);
+            }
+            else
+            {
+                dlb_wave_block_test_planar(&buf, ap_pointers, p_array, buffer_format, total);
+            }
+            frames_read = 0;
+            err = dlb_wave_float_read(&wave, &buf, frames, &frames_read);
+            total += frames_read;
+        }
+
+        if (!err)
+        {
+            /* The file is exhausted, so this should read nothing. */
+            dlb_wave_block_test_interleave(&buf, ap_pointers, a_extra_frame, buffer_format, 0);
+            frames_read = 0;
+            err = dlb_wave_float_read(&wave, &buf, 1, &frames_read);
+            total += frames_read;
+        }
+        dlb_wave_close(&wave);
+    }
+    *p_status = err;
+
+    dlb_octfile_close(p_f);
+    return total;
+}
+
+/* Write BLOCK_TEST_FRAMES frames into a new wave file in memory, either
+ * BLOCK_TEST_CALL frames at a time from an interleaved array, or one frame at
+ * a time from a planar array. */
+static int dlb_wave_block_test_write(dlb_octfile *p_f, const dlb_wave_block_test *p_test_info, void *p_array, int buffer_format, int b_interleaved)
+{
+    dlb_wave_file wave;
+    void *ap_pointers[BLOCK_TEST_CHANNELS];
+    dlb_buffer buf;
+    size_t total = 0;
+    int err;
+
+    err =
+        dlb_wave_octfile_write
+            (&wave
+            ,p_f
+            ,(int)p_test_info->format_flags
+            ,48000
+            ,BLOCK_TEST_CHANNELS
+            ,0
+            ,(int)p_test_info->bits_per_sample
+            );
+    if (err)
+    {
+        return err;
+    }
+
+    err = dlb_wave_begin_data(&wave);
+    while (!err && total < BLOCK_TEST_FRAMES)
+    {
+        size_t frames = 1;
+
+        if (b_interleaved)
+        {
+            frames = BLOCK_TEST_FRAMES - total;
+            if (frames > BLOCK_TEST_CALL)
+            {
+                frames = BLOCK_TEST_CALL;
+            }
+            dlb_wave_block_test_interleave(&buf, ap_pointers, p_array, buffer_format, total);
+        }
+        else
+        {
+            dlb_wave_block_test_planar(&buf, ap_pointers, p_array, buffer_format, total);
+        }
+        err = dlb_wave_float_write(&wave, &buf, frames);
+        total += frames;
+    }
+    if (!err)
+    {
+        err = dlb_wave_end_data(&wave);
+    }
+
+    dlb_wave_close(&wave);
+    return err;
+}
+
+/* Compare an interleaved array with a planar one. Returns the index of the
+ * first interleaved sample that differs, or BLOCK_TEST_FRAMES *
+ * BLOCK_TEST_CHANNELS if they are identical. */
+static size_t dlb_wave_block_test_compare(const void *p_interleaved, const void *p_planar, int buffer_format)
+{
+    size_t element_size = get_dlb_buffer_element_size(buffer_format);
+    size_t i;
+    unsigned k;
+
+    for (i = 0; i < BLOCK_TEST_FRAMES; i++)
+    {
+        for (k = 0; k < BLOCK_TEST_CHANNELS; k++)
+        {
+            const char *p_a = (const char *)p_interleaved + (i * BLOCK_TEST_CHANNELS + k) * element_size;
+            const char *p_b = (const char *)p_planar + (k * BLOCK_TEST_FRAMES + i) * element_size;
+
+            if (memcmp(p_a, p_b, element_size))
+            {
+                return i * BLOCK_TEST_CHANNELS + k;
+            }
+        }
+    }
+    return i * BLOCK_TEST_CHANNELS;
+}
+
+/* Compare the data chunks of two wave files in memory. */
+static int dlb_wave_block_test_data_equal(const dlb_octfile *p_a, const dlb_octfile *p_b)
+{
+    const unsigned char *p_data_a;
+    const unsigned char *p_data_b;
+    size_t size_a;
+    size_t size_b;
+
+    if  (   memwave_find_data(p_a->mem_base, p_a->mem_size, &p_data_a, &size_a)
+        ||  memwave_find_data(p_b->mem_base, p_b->mem_size, &p_data_b, &size_b)
+        )
+    {
+        return 0;
+    }
+    return size_a == size_b && !memcmp(p_data_a, p_data_b, size_a);
+}
+
+static
+void
+dlb_wave_block_test_proc
+    (const munit_test_case *p_def
+    ,const munit_collator  *p_collator
+    ,munit_test_memory     *p_mem
+    )
+{
+    const dlb_wave_block_test *p_test_info = munit_get_pointer_param(p_mem, "testdata");
+    const size_t nb_samples = BLOCK_TEST_FRAMES * BLOCK_TEST_CHANNELS;
+    size_t data_size;
+    unsigned octets;
+    unsigned i;
+    dlb_octfile source;
+    dlb_octfile *p_source;
+    void *p_interleaved;
+    void *p_planar;
+
+    /* Write the source file from raw octets. */
+    octets = (p_test_info->format_flags & DLB_WAVE_FLOAT) ? 4 : (p_test_info->bits_per_sample + 7) / 8;
+    data_size = nb_samples * octets;
+
+    p_source = dlb_octfile_open_memory(&source, "wb");
+    p_interleaved = malloc(nb_samples * sizeof(double));
+    p_planar = malloc(nb_samples * sizeof(double));
+    if (p_source == NULL || p_interleaved == NULL || p_planar == NULL)
+    {
+        abort();
+    }
+
+    {
+        dlb_wave_file wave;
+        int err;
+
+        dlb_wave_block_test_fill(p_interleaved, data_size, octets);
+        err =
+            dlb_wave_octfile_write
+                (&wave
+                ,p_source
+                ,(int)p_test_info->format_flags
+                ,48000
+                ,BLOCK_TEST_CHANNELS
+                ,0
+                ,(int)p_test_info->bits_per_sample
+                );
+        if (!err)
+        {
+            err = dlb_wave_begin_data(&wave);
+            if (!err)
+            {
+                err = dlb_wave_write_data(&wave, p_interleaved, data_size);
+            }
+            if (!err)
+            {
+                err = dlb_wave_end_data(&wave);
+            }
+            dlb_wave_close(&wave);
+        }
+        if (err)
+        {
+            p_collator->fail
+                (p_def
+                ,p_collator->context
+                ,"could not write the source wave (%d)"
+                ,err
+                );
+            dlb_octfile_close(p_source);
+            free(p_interleaved);
+            free(p_planar);
+            return;
+        }
+    }
+
+    for (i = 0; i < sizeof(buffer_format_codes) / sizeof(buffer_format_codes[0]); i++)
+    {
+        int buffer_format = buffer_format_codes[i];
+        size_t frames_interleaved;
+        size_t frames_planar;
+        int status_interleaved;
+        int status_planar;
+        size_t first_difference;
+
+        /* Reading: a run at a time and a sample at a time must agree. */
+        memset(p_interleaved, 0, nb_samples * sizeof(double));
+        memset(p_planar, 0, nb_samples * sizeof(double));
+        frames_interleaved = dlb_wave_block_test_read(source.mem_base, source.mem_size, p_interleaved, buffer_format, 1, &status_interleaved);
+        frames_planar = dlb_wave_block_test_read(source.mem_base, source.mem_size, p_planar, buffer_format, 0, &status_planar);
+
+        eval_assert
+            (p_def
+            ,p_collator
+            ,frames_interleaved == BLOCK_TEST_FRAMES && frames_planar == BLOCK_TEST_FRAMES
+            ,"dlb_wave_float_read() read an unexpected number of frames (mode: %s, expected: %lu, block: %lu, per sample: %lu)"
+            ,buffer_format_names[i]
+            ,(unsigned long)BLOCK_TEST_FRAMES
+            ,(unsigned long)frames_interleaved
+            ,(unsigned long)frames_planar
+            );
+        eval_assert
+            (p_def
+            ,p_collator
+            ,status_interleaved == DLB_RIFF_W_EOF && status_planar == DLB_RIFF_W_EOF
+            ,"dlb_wave_float_read() ended with an unexpected status (mode: %s, block: %d, per sample: %d)"
+            ,buffer_format_names[i]
+            ,status_interleaved
+            ,status_planar
+            );
+
+        first_difference = dlb_wave_block_test_compare(p_interleaved, p_planar, buffer_format);
+        eval_assert
+            (p_def
+            ,p_collator
+            ,first_difference == nb_samples
+            ,"dlb_wave_float_read() block and per sample reads differ (mode: %s, interleaved sample: %lu)"
+            ,buffer_format_names[i]
+            ,(unsigned long)first_difference
+            );
+
+        /* Writing the samples back: both paths must produce the same file. */
+        {
+            dlb_octfile block_file;
+            dlb_octfile sample_file;
+            dlb_octfile *p_block_file = dlb_octfile_open_memory(&block_file, "wb");
+            dlb_octfile *p_sample_file = dlb_octfile_open_memory(&sample_file, "wb");
+            int err_block;
+            int err_sample;
+
+            if (p_block_file == NULL || p_sample_file == NULL)
+            {
+                abort();
+            }
+
+            err_block = dlb_wave_block_test_write(p_block_file, p_test_info, p_interleaved, buffer_format, 1);
+            err_sample = dlb_wave_block_test_write(p_sample_file, p_test_info, p_planar, buffer_format, 0);
+
+            eval_assert
+                (p_def
+                ,p_collator
+                ,!err_block && !err_sample
+                ,"dlb_wave_float_write() failed unexpectedly (mode: %s, block: %d, per sample: %d)"
+                ,buffer_format_names[i]
+                ,err_block
+                ,err_sample
+                );
+            eval_assert
+                (p_def
+                ,p_collator
+                ,dlb_wave_block_test_data_equal(p_block_file, p_sample_file)
+                ,"dlb_wave_float_write() block and per sample writes differ (mode: %s)"
+                ,buffer_format_names[i]
+                );
+
+            dlb_octfile_close(p_block_file);
+            dlb_octfile_close(p_sample_file);
+        }
+    }
+
+    dlb_octfile_close(p_source);
+    free(p_interleaved);
+    free(p_planar);
+}
+
 /* Test data sets. */
 
 static const unsigned char basic_8bit_1ch_32khz[] =
@@ -1458,6 +1884,33 @@ DLB_WAVE_WRITE_TEST_DEF(basic_32bit_1ch_256hz, 0)
 DLB_WAVE_WRITE_TEST_DEF(basic_float_1ch_24khz, DLB_WAVE_FLOAT)
 DLB_WAVE_WRITE_TEST_DEF(comprehensive_32bit_1ch_256hz, 0)
 
+#define DLB_WAVE_BLOCK_TEST_DEF(name, flags, bits) \
+static const dlb_wave_block_test block_ ## name ## _test_data = \
+{   flags \
+,   bits \
+}; \
+static \
+const \
+munit_test_memory_def \
+block_ ## name ## _test_memory_def[] = \
+    {MUNIT_POINTER_PARAM("testdata", &block_ ## name ## _test_data) \
+    ,MUNIT_LAST_MEMORY_DEF \
+    }; \
+static \
+const \
+munit_test_case \
+block_ ## name ## _test_case = \
+    {/* name */    "block_" #name \
+    ,/* memory */  block_ ## name ## _test_memory_def \
+    ,/* test_fn */ &dlb_wave_block_test_proc \
+    };
+
+DLB_WAVE_BLOCK_TEST_DEF(8bit, 0, 8)
+DLB_WAVE_BLOCK_TEST_DEF(16bit, 0, 16)
+DLB_WAVE_BLOCK_TEST_DEF(24bit, 0, 24)
+DLB_WAVE_BLOCK_TEST_DEF(32bit, 0, 32)
+DLB_WAVE_BLOCK_TEST_DEF(float, DLB_WAVE_FLOAT, 32)
+
 static const munit_test_case *dlb_wave_tests[] =
     {&read_basic_8bit_1ch_32khz_test_case
     ,&read_basic_16bit_3ch_96khz_test_case
@@ -1473,6 +1926,11 @@ static const munit_test_case *dlb_wave_tests[] =
     ,&write_basic_32bit_1ch_256hz_test_case
     ,&write_basic_float_1ch_24khz_test_case
     ,&write_comprehensive_32bit_1ch_256hz_test_case
+    ,&block_8bit_test_case
+    ,&block_16bit_test_case
+    ,&block_24bit_test_case
+    ,&block_32bit_test_case
+    ,&block_float_test_case
     ,NULL
     };
 